@@ -0,0 +1,276 @@
+#include "DebugTextBatch.h"
+#include "DebugTextLabel.h"
+#include "DirectXCommon.h"
+#include "ShaderCompiler.h"
+#include "TextureAtlas.h"
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <d3dx12.h>
+
+DebugTextBatch* DebugTextBatch::GetInstance() {
+	static DebugTextBatch instance;
+	return &instance;
+}
+
+void DebugTextBatch::AppendGlyphs(
+    const char* text, size_t length, const Vector2& position, float scale, uint32_t color,
+    std::vector<GlyphInstance>& instances) {
+	float x = position.x;
+	float y = position.y;
+	for (size_t i = 0; i < length; i++) {
+		char character = text[i];
+		if (character == '\n') {
+			x = position.x;
+			y += kFontHeight * scale;
+			continue;
+		}
+		// 空白とフォントに無い文字は送るだけ
+		if (character > kFirstChar && character <= kLastChar) {
+			instances.push_back({{x, y}, scale, uint32_t(character - kFirstChar), color});
+		}
+		x += kFontWidth * scale;
+	}
+}
+
+void DebugTextBatch::Initialize(int windowWidth, int windowHeight) {
+	textureHandle_ = TextureStreamer::Load("debugfont.png");
+	D3D12_RESOURCE_DESC textureDesc =
+	    TextureStreamer::GetInstance()->GetResourceDesc(textureHandle_);
+
+	// 文字の切り出しとクリップ座標への変換はシェーダーで行う
+	constants_.clipScale = {2.0f / float(windowWidth), -2.0f / float(windowHeight)};
+	constants_.glyphSize = {float(kFontWidth), float(kFontHeight)};
+	constants_.glyphUvSize = {
+	    float(kFontWidth) / float(textureDesc.Width),
+	    float(kFontHeight) / float(textureDesc.Height)};
+	constants_.columnCount = kFontLineCount;
+	constants_.firstInstance = 0;
+	constants_.uvOffset = {0.0f, 0.0f};
+
+	CreateGraphicsPipeline();
+	CreateInstanceBuffer(kInitialCapacity);
+}
+
+void DebugTextBatch::SetFont(const TextureAtlas& atlas, const std::string& fileName) {
+	const TextureAtlas::Region& region = atlas.GetRegion(fileName);
+
+	// 単独で読んだフォント画像は手放す（参照が無くなれば予算超過時に追い出せる）
+	TextureStreamer::Release(textureHandle_);
+	TextureStreamer::AddRef(region.textureHandle);
+	textureHandle_ = region.textureHandle;
+
+	constants_.glyphUvSize = {
+	    region.uvScale.x * float(kFontWidth) / region.texSize.x,
+	    region.uvScale.y * float(kFontHeight) / region.texSize.y};
+	constants_.uvOffset = region.uvOffset;
+}
+
+void DebugTextBatch::Finalize() {
+	if (instanceBuff_ && instanceMap_) {
+		instanceBuff_->Unmap(0, nullptr);
+	}
+	instanceMap_ = nullptr;
+	instanceBuff_.Reset();
+	retiredBuffers_.clear();
+	rootSignature_.Reset();
+	pipelineState_.Reset();
+	capacity_ = 0;
+}
+
+void DebugTextBatch::CreateGraphicsPipeline() {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	ComPtr<ID3DBlob> vsBlob =
+	    CompileShaderFromFile(L"Resources/shaders/DebugTextVS.hlsl", "vs_5_0");
+	ComPtr<ID3DBlob> psBlob =
+	    CompileShaderFromFile(L"Resources/shaders/DebugTextPS.hlsl", "ps_5_0");
+
+	// ルートパラメータ
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+	CD3DX12_ROOT_PARAMETER rootparams[3];
+	// 定数（b0 レジスタ）
+	rootparams[0].InitAsConstants(
+	    sizeof(DrawConstants) / sizeof(uint32_t), 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	// インスタンス（t1 レジスタ。ディスクリプタを使わずアドレスで渡す）
+	rootparams[1].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	// フォント画像
+	rootparams[2].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// スタティックサンプラー
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc = CD3DX12_STATIC_SAMPLER_DESC(0);
+
+	// ルートシグネチャの設定（頂点バッファは使わない）
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	    _countof(rootparams), rootparams, 1, &samplerDesc, D3D12_ROOT_SIGNATURE_FLAG_NONE);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	ComPtr<ID3DBlob> errorBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	    &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+	// ルートシグネチャの生成
+	result = device->CreateRootSignature(
+	    0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	    IID_PPV_ARGS(&rootSignature_));
+	assert(SUCCEEDED(result));
+
+	// グラフィックスパイプラインの流れを設定
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	// デプスステンシルステート（常に上書き）
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+	gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	// レンダーターゲットのブレンド設定（半透明合成）
+	D3D12_RENDER_TARGET_BLEND_DESC& blenddesc = gpipeline.BlendState.RenderTarget[0];
+	blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL; // RBGA全てのチャンネルを描画
+	blenddesc.BlendEnable = true;
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;                            // 描画対象は1つ
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; // 0～255指定のRGBA
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	gpipeline.pRootSignature = rootSignature_.Get();
+
+	result = device->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelineState_));
+	assert(SUCCEEDED(result));
+}
+
+void DebugTextBatch::CreateInstanceBuffer(uint32_t capacity) {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	// 今のバッファはこのフレームの描画で読まれるので、GPUを待つまで残す
+	if (instanceBuff_) {
+		instanceBuff_->Unmap(0, nullptr);
+		retiredBuffers_.push_back(std::move(instanceBuff_));
+		stats_.growCount++;
+	}
+
+	// インスタンスバッファ生成（毎フレーム書き換えるのでマップしたままにする）
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	    CD3DX12_RESOURCE_DESC::Buffer(sizeof(GlyphInstance) * capacity);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&instanceBuff_));
+	assert(SUCCEEDED(result));
+	result = instanceBuff_->Map(0, nullptr, reinterpret_cast<void**>(&instanceMap_));
+	assert(SUCCEEDED(result));
+	capacity_ = capacity;
+	usedInstanceCount_ = 0;
+}
+
+void DebugTextBatch::Print(const std::string& text, float x, float y, float scale) {
+	AppendGlyphs(text.data(), text.size(), {x, y}, scale, color_, instances_);
+}
+
+void DebugTextBatch::Printf(const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	va_list copy;
+	va_copy(copy, args);
+	// 使い回しているバッファにまず展開し、入りきらなかったときだけ広げて展開し直す
+	int length = vsnprintf(buffer_.data(), buffer_.size(), fmt, args);
+	if (length >= 0 && size_t(length) >= buffer_.size()) {
+		buffer_.resize(size_t(length) + 1);
+		vsnprintf(buffer_.data(), buffer_.size(), fmt, copy);
+	}
+	va_end(copy);
+	va_end(args);
+	if (length > 0) {
+		AppendGlyphs(buffer_.data(), size_t(length), {posX_, posY_}, scale_, color_, instances_);
+	}
+}
+
+void DebugTextBatch::Draw(DebugTextLabel& label) {
+	uint32_t layoutCount = label.GetLayoutCount();
+	const std::vector<GlyphInstance>& glyphs = label.GetGlyphs();
+	instances_.insert(instances_.end(), glyphs.begin(), glyphs.end());
+	if (label.GetLayoutCount() == layoutCount) {
+		stats_.cachedGlyphCount += static_cast<uint32_t>(glyphs.size());
+	}
+}
+
+void DebugTextBatch::SetColor(const Vector4& color) {
+	const float* channels = &color.x;
+	color_ = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		float value = std::min(std::max(channels[i], 0.0f), 1.0f);
+		color_ |= uint32_t(value * 255.0f + 0.5f) << (i * 8);
+	}
+}
+
+void DebugTextBatch::DrawAll(ID3D12GraphicsCommandList* commandList) {
+	if (instances_.empty()) {
+		return;
+	}
+	assert(instanceBuff_);
+	uint32_t count = static_cast<uint32_t>(instances_.size());
+
+	// フレームの最初の描画なら、前フレームまでに作り直したバッファはGPUが読み終えている
+	if (usedInstanceCount_ == 0) {
+		retiredBuffers_.clear();
+	}
+	// 入りきらなければ倍々に広げた新しいバッファの先頭から使う
+	if (usedInstanceCount_ + count > capacity_) {
+		uint32_t capacity = capacity_ * 2;
+		while (capacity < count) {
+			capacity *= 2;
+		}
+		CreateInstanceBuffer(capacity);
+	}
+
+	// 今フレームの続きに書く（GPUが読み終わるのは Reset の後）
+	std::copy(instances_.begin(), instances_.end(), instanceMap_ + usedInstanceCount_);
+	constants_.firstInstance = usedInstanceCount_;
+
+	commandList->SetPipelineState(pipelineState_.Get());
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	commandList->SetGraphicsRoot32BitConstants(
+	    0, sizeof(DrawConstants) / sizeof(uint32_t), &constants_, 0);
+	commandList->SetGraphicsRootShaderResourceView(1, instanceBuff_->GetGPUVirtualAddress());
+	TextureStreamer::GetInstance()->SetGraphicsRootDescriptorTable(commandList, 2, textureHandle_);
+	// 4頂点の四角形を文字数分インスタンス描画
+	commandList->DrawInstanced(4, count, 0, 0);
+
+	usedInstanceCount_ += count;
+	stats_.glyphCount += count;
+	stats_.drawCount++;
+	stats_.uploadBytes += sizeof(GlyphInstance) * count;
+	instances_.clear();
+}
+
+void DebugTextBatch::Reset() {
+	lastFrameStats_ = stats_;
+	stats_ = Stats();
+	usedInstanceCount_ = 0;
+}
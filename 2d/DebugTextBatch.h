@@ -0,0 +1,215 @@
+#pragma once
+
+#include "Vector2.h"
+#include "Vector4.h"
+#include <cstdint>
+#include <d3d12.h>
+#include <string>
+#include <vector>
+#include <wrl.h>
+
+class DebugTextLabel;
+class TextureAtlas;
+
+/// <summary>
+/// デバッグ用文字表示（インスタンス描画版。1文字を1インスタンスとして構造化バッファに詰め、
+/// debugfont.png から1回の描画で全文字を描く。文字数の上限は無い）
+/// </summary>
+class DebugTextBatch {
+private: // エイリアス
+	// Microsoft::WRL::を省略
+	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public: // 定数
+	static const int kFontWidth = 9;      // フォント画像内1文字分の横幅
+	static const int kFontHeight = 18;    // フォント画像内1文字分の縦幅
+	static const int kFontLineCount = 14; // フォント画像内1行分の文字数
+	static const char kFirstChar = ' ';   // フォント画像の先頭の文字
+	static const char kLastChar = '~';    // フォント画像の末尾の文字
+	// インスタンスバッファの最初の容量（足りなくなったら倍にする）
+	static const uint32_t kInitialCapacity = 4096;
+
+public: // サブクラス
+	// 1文字分のインスタンスデータ（シェーダーの GlyphInstance と同じ並び）
+	struct GlyphInstance {
+		Vector2 position; // 左上座標（スクリーン座標）
+		float scale;      // 倍率
+		uint32_t glyph;   // フォント画像内の文字番号
+		uint32_t color;   // RGBA（8bit正規化）
+	};
+
+	// 描画統計（Reset で前フレームの分になる）
+	struct Stats {
+		// 描いた文字数
+		uint32_t glyphCount = 0;
+		// そのうち保持ラベルから並べ直さずに積んだ文字数
+		uint32_t cachedGlyphCount = 0;
+		// 描画コマンド数
+		uint32_t drawCount = 0;
+		// 書き込んだバイト数
+		size_t uploadBytes = 0;
+		// インスタンスバッファを作り直した回数
+		uint32_t growCount = 0;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static DebugTextBatch* GetInstance();
+
+	/// <summary>
+	/// 文字列をインスタンスに展開する（空白は送るだけで、改行で次の行に移る）
+	/// </summary>
+	/// <param name="text">文字列</param>
+	/// <param name="length">文字数</param>
+	/// <param name="position">左上座標</param>
+	/// <param name="scale">倍率</param>
+	/// <param name="color">RGBA（8bit正規化）</param>
+	/// <param name="instances">追加先</param>
+	static void AppendGlyphs(
+	    const char* text, size_t length, const Vector2& position, float scale, uint32_t color,
+	    std::vector<GlyphInstance>& instances);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="windowWidth">画面幅</param>
+	/// <param name="windowHeight">画面高さ</param>
+	void Initialize(int windowWidth, int windowHeight);
+
+	/// <summary>
+	/// 終了処理
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// フォント画像をアトラスの領域に切り替える（他の描画とテクスチャを切り替えずに済む）
+	/// </summary>
+	/// <param name="atlas">アトラス</param>
+	/// <param name="fileName">フォント画像のファイル名</param>
+	void SetFont(const TextureAtlas& atlas, const std::string& fileName);
+
+	/// <summary>
+	/// 文字列追加
+	/// </summary>
+	/// <param name="text">文字列</param>
+	/// <param name="x">表示座標X</param>
+	/// <param name="y">表示座標Y</param>
+	/// <param name="scale">倍率</param>
+	void Print(const std::string& text, float x, float y, float scale = 1.0f);
+
+	/// <summary>
+	/// 書式付き文字列追加（SetPos の位置に描く）
+	/// </summary>
+	/// <param name="fmt">書式付き文字列</param>
+	void Printf(const char* fmt, ...);
+
+	/// <summary>
+	/// 保持ラベルの追加（並べ済みの文字をそのまま積む）
+	/// </summary>
+	/// <param name="label">ラベル</param>
+	void Draw(DebugTextLabel& label);
+
+	/// <summary>
+	/// 描画フラッシュ（積んだ文字を1回の描画で描く）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	void DrawAll(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// フレームのリセット（インスタンスバッファを先頭から使い直す。そのフレームの描画を積み終えて
+	/// から呼ぶ。次に書き込むのは DirectXCommon::PostDraw でGPUを待った後になる）
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 描画座標の指定
+	/// </summary>
+	/// <param name="x"></param>
+	/// <param name="y"></param>
+	void SetPos(float x, float y) {
+		posX_ = x;
+		posY_ = y;
+	}
+
+	/// <summary>
+	/// 描画倍率の指定
+	/// </summary>
+	/// <param name="scale">倍率</param>
+	void SetScale(float scale) { scale_ = scale; }
+
+	/// <summary>
+	/// 文字色の指定
+	/// </summary>
+	/// <param name="color">色</param>
+	void SetColor(const Vector4& color);
+
+	/// <summary>
+	/// 前フレームの描画統計
+	/// </summary>
+	const Stats& GetLastFrameStats() const { return lastFrameStats_; }
+
+private: // サブクラス
+	// ルート定数（シェーダーの ConstBufferData と同じ並び）
+	struct DrawConstants {
+		Vector2 clipScale;      // スクリーン座標からクリップ座標への倍率
+		Vector2 glyphSize;      // 1文字の大きさ（ピクセル）
+		Vector2 glyphUvSize;    // 1文字の大きさ（uv）
+		uint32_t columnCount;   // フォント画像内1行分の文字数
+		uint32_t firstInstance; // 今回の描画の先頭インスタンス
+		Vector2 uvOffset;       // フォント画像の左上（uv）
+	};
+
+private: // メンバ関数
+	DebugTextBatch() = default;
+	~DebugTextBatch() = default;
+	DebugTextBatch(const DebugTextBatch&) = delete;
+	DebugTextBatch& operator=(const DebugTextBatch&) = delete;
+
+	/// <summary>
+	/// ルートシグネチャとパイプラインステートの生成
+	/// </summary>
+	void CreateGraphicsPipeline();
+
+	/// <summary>
+	/// インスタンスバッファの生成（古いバッファはこのフレームの描画が終わるまで残す）
+	/// </summary>
+	/// <param name="capacity">インスタンス数</param>
+	void CreateInstanceBuffer(uint32_t capacity);
+
+private: // メンバ変数
+	// ルートシグネチャ
+	ComPtr<ID3D12RootSignature> rootSignature_;
+	// パイプラインステートオブジェクト
+	ComPtr<ID3D12PipelineState> pipelineState_;
+	// インスタンスバッファ
+	ComPtr<ID3D12Resource> instanceBuff_;
+	// 作り直す前のインスタンスバッファ（次のフレームの最初の DrawAll で解放する）
+	std::vector<ComPtr<ID3D12Resource>> retiredBuffers_;
+	// インスタンスバッファマップ
+	GlyphInstance* instanceMap_ = nullptr;
+	// インスタンスバッファの容量
+	uint32_t capacity_ = 0;
+	// 今フレームに使ったインスタンス数（インスタンスバッファの書き込み位置）
+	uint32_t usedInstanceCount_ = 0;
+	// テクスチャハンドル（TextureStreamer）
+	uint32_t textureHandle_ = 0;
+	// ルート定数
+	DrawConstants constants_ = {};
+	// 積んだ文字
+	std::vector<GlyphInstance> instances_;
+	// 書式付き文字列展開用バッファ
+	std::string buffer_;
+
+	float posX_ = 0.0f;
+	float posY_ = 0.0f;
+	float scale_ = 1.0f;
+	uint32_t color_ = 0xffffffff;
+
+	// 描画統計（集計中と前フレーム）
+	Stats stats_;
+	Stats lastFrameStats_;
+};
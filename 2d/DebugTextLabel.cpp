@@ -0,0 +1,93 @@
+#include "DebugTextLabel.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// FNV-1a（64bit。掛け算の待ちを減らすため8バイトずつ混ぜ、端数は1バイトずつ）
+uint64_t Fnv1a(const char* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001b3ull;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ uint8_t(data[i])) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+} // namespace
+
+void DebugTextLabel::SetText(const std::string& text) { UpdateText(text.data(), text.size()); }
+
+void DebugTextLabel::Printf(const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	va_list copy;
+	va_copy(copy, args);
+	// 使い回しているバッファにまず展開し、入りきらなかったときだけ広げて展開し直す
+	int length = vsnprintf(buffer_.data(), buffer_.size(), fmt, args);
+	if (length >= 0 && size_t(length) >= buffer_.size()) {
+		buffer_.resize(size_t(length) + 1);
+		vsnprintf(buffer_.data(), buffer_.size(), fmt, copy);
+	}
+	va_end(copy);
+	va_end(args);
+	if (length >= 0) {
+		UpdateText(buffer_.data(), size_t(length));
+	}
+}
+
+void DebugTextLabel::UpdateText(const char* text, size_t length) {
+	// ハッシュ値と長さが同じなら中身も同じとみなす
+	uint64_t hash = Fnv1a(text, length);
+	if (hash == hash_ && length == text_.size()) {
+		return;
+	}
+	text_.assign(text, length);
+	hash_ = hash;
+	dirty_ = true;
+}
+
+void DebugTextLabel::SetPosition(const Vector2& position) {
+	if (position.x != position_.x || position.y != position_.y) {
+		position_ = position;
+		dirty_ = true;
+	}
+}
+
+void DebugTextLabel::SetScale(float scale) {
+	if (scale != scale_) {
+		scale_ = scale;
+		dirty_ = true;
+	}
+}
+
+void DebugTextLabel::SetColor(const Vector4& color) {
+	const float* channels = &color.x;
+	uint32_t packed = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		float value = std::min(std::max(channels[i], 0.0f), 1.0f);
+		packed |= uint32_t(value * 255.0f + 0.5f) << (i * 8);
+	}
+	if (packed != color_) {
+		color_ = packed;
+		dirty_ = true;
+	}
+}
+
+const std::vector<DebugTextBatch::GlyphInstance>& DebugTextLabel::GetGlyphs() {
+	if (dirty_) {
+		glyphs_.clear();
+		DebugTextBatch::AppendGlyphs(
+		    text_.data(), text_.size(), position_, scale_, color_, glyphs_);
+		dirty_ = false;
+		layoutCount_++;
+	}
+	return glyphs_;
+}
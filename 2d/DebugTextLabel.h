@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DebugTextBatch.h"
+#include "Vector2.h"
+#include "Vector4.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// デバッグ用文字表示の保持ラベル（並べた文字インスタンスを持ち続け、
+/// 文字列の内容・位置・倍率・色が変わったときだけ並べ直す）
+/// </summary>
+class DebugTextLabel {
+public: // メンバ関数
+	/// <summary>
+	/// 文字列の指定（前回と同じ内容なら何もしない）
+	/// </summary>
+	/// <param name="text">文字列</param>
+	void SetText(const std::string& text);
+
+	/// <summary>
+	/// 書式付き文字列の指定（展開した結果が前回と同じなら並べ直さない）
+	/// </summary>
+	/// <param name="fmt">書式付き文字列</param>
+	void Printf(const char* fmt, ...);
+
+	/// <summary>
+	/// 描画座標の指定
+	/// </summary>
+	/// <param name="position">左上座標</param>
+	void SetPosition(const Vector2& position);
+
+	/// <summary>
+	/// 描画倍率の指定
+	/// </summary>
+	/// <param name="scale">倍率</param>
+	void SetScale(float scale);
+
+	/// <summary>
+	/// 文字色の指定
+	/// </summary>
+	/// <param name="color">色</param>
+	void SetColor(const Vector4& color);
+
+	/// <summary>
+	/// 並べた文字インスタンスの取得（変更があればここで並べ直す）
+	/// </summary>
+	/// <returns>文字インスタンス</returns>
+	const std::vector<DebugTextBatch::GlyphInstance>& GetGlyphs();
+
+	const std::string& GetText() const { return text_; }
+	// 並べ直した回数
+	uint32_t GetLayoutCount() const { return layoutCount_; }
+
+private: // メンバ関数
+	/// <summary>
+	/// 内容が変わっていれば文字列を差し替える
+	/// </summary>
+	/// <param name="text">文字列</param>
+	/// <param name="length">文字数</param>
+	void UpdateText(const char* text, size_t length);
+
+private: // メンバ変数
+	// 文字列
+	std::string text_;
+	// 文字列のハッシュ値
+	uint64_t hash_ = 0;
+	// 書式付き文字列展開用バッファ
+	std::string buffer_;
+	// 左上座標
+	Vector2 position_ = {0.0f, 0.0f};
+	// 倍率
+	float scale_ = 1.0f;
+	// RGBA（8bit正規化）
+	uint32_t color_ = 0xffffffff;
+	// 並べた文字インスタンス
+	std::vector<DebugTextBatch::GlyphInstance> glyphs_;
+	// 並べ直しが必要か
+	bool dirty_ = false;
+	// 並べ直した回数
+	uint32_t layoutCount_ = 0;
+};
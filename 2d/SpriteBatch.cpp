@@ -0,0 +1,421 @@
+#include "SpriteBatch.h"
+#include "DirectXCommon.h"
+#include "ShaderCompiler.h"
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <d3dx12.h>
+#include <immintrin.h>
+#include <string>
+
+namespace {
+
+// 並べ替えキーの積んだ順の部分のビット数
+const uint32_t kSortIndexBits = 24;
+
+// ブレンドモード毎のレンダーターゲットのブレンド設定（Sprite と同じ式）
+D3D12_RENDER_TARGET_BLEND_DESC GetBlendDesc(Sprite::BlendMode blendMode) {
+	D3D12_RENDER_TARGET_BLEND_DESC blenddesc{};
+	blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL; // RBGA全てのチャンネルを描画
+	blenddesc.BlendEnable = blendMode != Sprite::BlendMode::kNone;
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	switch (blendMode) {
+	case Sprite::BlendMode::kNormal:
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+		break;
+	case Sprite::BlendMode::kAdd:
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		break;
+	case Sprite::BlendMode::kSubtract:
+		blenddesc.BlendOp = D3D12_BLEND_OP_REV_SUBTRACT;
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		break;
+	case Sprite::BlendMode::kMultily:
+		blenddesc.SrcBlend = D3D12_BLEND_ZERO;
+		blenddesc.DestBlend = D3D12_BLEND_SRC_COLOR;
+		break;
+	case Sprite::BlendMode::kScreen:
+		blenddesc.SrcBlend = D3D12_BLEND_INV_DEST_COLOR;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		break;
+	default:
+		blenddesc.SrcBlend = D3D12_BLEND_ONE;
+		blenddesc.DestBlend = D3D12_BLEND_ZERO;
+		break;
+	}
+	return blenddesc;
+}
+
+// 色を RGBA8 に詰める
+uint32_t PackColor(const Vector4& color) {
+	const float* channels = &color.x;
+	uint32_t packed = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		float value = std::min(std::max(channels[i], 0.0f), 1.0f);
+		packed |= uint32_t(value * 255.0f + 0.5f) << (i * 8);
+	}
+	return packed;
+}
+
+} // namespace
+
+SpriteBatch* SpriteBatch::GetInstance() {
+	static SpriteBatch instance;
+	return &instance;
+}
+
+void SpriteBatch::WriteVertices(
+    const Quad* quads, const uint32_t* order, uint32_t count, const Vector2& screenSize,
+    VertexPosUvColor* vertices, bool useSimd) {
+	// スクリーン座標（左上原点・下向き）からクリップ座標へ
+	float scaleX = 2.0f / screenSize.x;
+	float scaleY = -2.0f / screenSize.y;
+
+	for (uint32_t n = 0; n < count; n++) {
+		const Quad& quad = quads[order[n]];
+		VertexPosUvColor* out = vertices + size_t(n) * kVertexCountPerSprite;
+		float c = 1.0f;
+		float s = 0.0f;
+		if (quad.rotation != 0.0f) {
+			c = std::cos(quad.rotation);
+			s = std::sin(quad.rotation);
+		}
+		const Vector4& uv = quad.uvRect;
+
+		if (useSimd) {
+			// 4頂点（左上・右上・左下・右下）を各レーンで同時に計算する
+			__m128 cornerX = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+			__m128 cornerY = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+			__m128 localX = _mm_mul_ps(
+			    _mm_sub_ps(cornerX, _mm_set1_ps(quad.anchorPoint.x)), _mm_set1_ps(quad.size.x));
+			__m128 localY = _mm_mul_ps(
+			    _mm_sub_ps(cornerY, _mm_set1_ps(quad.anchorPoint.y)), _mm_set1_ps(quad.size.y));
+			__m128 cosine = _mm_set1_ps(c);
+			__m128 sine = _mm_set1_ps(s);
+			__m128 x = _mm_add_ps(
+			    _mm_sub_ps(_mm_mul_ps(localX, cosine), _mm_mul_ps(localY, sine)),
+			    _mm_set1_ps(quad.position.x));
+			__m128 y = _mm_add_ps(
+			    _mm_add_ps(_mm_mul_ps(localX, sine), _mm_mul_ps(localY, cosine)),
+			    _mm_set1_ps(quad.position.y));
+			x = _mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(scaleX)), _mm_set1_ps(1.0f));
+			y = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(scaleY)), _mm_set1_ps(1.0f));
+			__m128 u = _mm_setr_ps(uv.x, uv.z, uv.x, uv.z);
+			__m128 v = _mm_setr_ps(uv.y, uv.y, uv.w, uv.w);
+
+			// xy と uv を交互に並べて、頂点毎に16バイトずつ書く
+			__m128 xy01 = _mm_unpacklo_ps(x, y);
+			__m128 xy23 = _mm_unpackhi_ps(x, y);
+			__m128 uv01 = _mm_unpacklo_ps(u, v);
+			__m128 uv23 = _mm_unpackhi_ps(u, v);
+			_mm_storeu_ps(&out[0].pos.x, _mm_movelh_ps(xy01, uv01));
+			_mm_storeu_ps(&out[1].pos.x, _mm_movehl_ps(uv01, xy01));
+			_mm_storeu_ps(&out[2].pos.x, _mm_movelh_ps(xy23, uv23));
+			_mm_storeu_ps(&out[3].pos.x, _mm_movehl_ps(uv23, xy23));
+
+			// 色は [0, 1] に収めて 8bit に詰める
+			__m128 color = _mm_loadu_ps(&quad.color.x);
+			color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			color = _mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+			__m128i bytes = _mm_cvttps_epi32(color);
+			bytes = _mm_packus_epi16(_mm_packs_epi32(bytes, bytes), bytes);
+			uint32_t packed = static_cast<uint32_t>(_mm_cvtsi128_si32(bytes));
+			for (uint32_t k = 0; k < kVertexCountPerSprite; k++) {
+				out[k].color = packed;
+			}
+			continue;
+		}
+
+		uint32_t packed = PackColor(quad.color);
+		for (uint32_t k = 0; k < kVertexCountPerSprite; k++) {
+			float localX = (float(k & 1) - quad.anchorPoint.x) * quad.size.x;
+			float localY = (float(k >> 1) - quad.anchorPoint.y) * quad.size.y;
+			float x = (localX * c - localY * s) + quad.position.x;
+			float y = (localX * s + localY * c) + quad.position.y;
+			out[k].pos = {x * scaleX - 1.0f, y * scaleY + 1.0f};
+			out[k].uv = {(k & 1) ? uv.z : uv.x, (k >> 1) ? uv.w : uv.y};
+			out[k].color = packed;
+		}
+	}
+}
+
+void SpriteBatch::Initialize(int windowWidth, int windowHeight, uint32_t maxSpriteCount) {
+	assert(maxSpriteCount > 0 && maxSpriteCount <= kMaxSpriteCount);
+	screenSize_ = {float(windowWidth), float(windowHeight)};
+	maxSpriteCount_ = maxSpriteCount;
+	usedSpriteCount_ = 0;
+	quads_.reserve(maxSpriteCount_);
+	sortKeys_.reserve(maxSpriteCount_);
+	order_.reserve(maxSpriteCount_);
+
+	CreateGraphicsPipelines();
+	CreateBuffers();
+}
+
+void SpriteBatch::Finalize() {
+	if (vertBuff_ && vertMap_) {
+		vertBuff_->Unmap(0, nullptr);
+	}
+	vertMap_ = nullptr;
+	vertBuff_.Reset();
+	indexBuff_.Reset();
+	rootSignature_.Reset();
+	for (auto& pipelineState : pipelineStates_) {
+		pipelineState.Reset();
+	}
+}
+
+void SpriteBatch::CreateGraphicsPipelines() {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	ComPtr<ID3DBlob> vsBlob =
+	    CompileShaderFromFile(L"Resources/shaders/SpriteBatchVS.hlsl", "vs_5_0");
+	ComPtr<ID3DBlob> psBlob =
+	    CompileShaderFromFile(L"Resources/shaders/SpriteBatchPS.hlsl", "ps_5_0");
+
+	// ルートパラメータ（テクスチャだけ。変換は頂点に焼き込むので定数バッファは持たない）
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+	CD3DX12_ROOT_PARAMETER rootparams[1];
+	rootparams[0].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// スタティックサンプラー
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc = CD3DX12_STATIC_SAMPLER_DESC(0);
+
+	// ルートシグネチャの設定
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	    _countof(rootparams), rootparams, 1, &samplerDesc,
+	    D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	ComPtr<ID3DBlob> errorBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	    &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+	// ルートシグネチャの生成
+	result = device->CreateRootSignature(
+	    0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	    IID_PPV_ARGS(&rootSignature_));
+	assert(SUCCEEDED(result));
+
+	// 頂点レイアウト
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	    {// xy座標（クリップ座標）
+	     "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// uv座標
+	     "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// 色
+	     "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	// グラフィックスパイプラインの流れを設定
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート（反転したスプライトも描けるようカリングしない）
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	// デプスステンシルステート（常に上書き）
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+	gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 頂点レイアウトの設定
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;                            // 描画対象は1つ
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; // 0～255指定のRGBA
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	gpipeline.pRootSignature = rootSignature_.Get();
+
+	// ブレンドモード毎にパイプラインを生成
+	for (size_t i = 0; i < pipelineStates_.size(); i++) {
+		gpipeline.BlendState.RenderTarget[0] =
+		    GetBlendDesc(static_cast<Sprite::BlendMode>(i));
+		result =
+		    device->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelineStates_[i]));
+		assert(SUCCEEDED(result));
+	}
+}
+
+void SpriteBatch::CreateBuffers() {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	UINT sizeVB = static_cast<UINT>(
+	    sizeof(VertexPosUvColor) * kVertexCountPerSprite * maxSpriteCount_);
+	UINT sizeIB = static_cast<UINT>(sizeof(uint16_t) * kIndexCountPerSprite * maxSpriteCount_);
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+
+	// 頂点バッファ生成（毎フレーム書き換えるのでマップしたままにする）
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeVB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&vertBuff_));
+	assert(SUCCEEDED(result));
+	result = vertBuff_->Map(0, nullptr, reinterpret_cast<void**>(&vertMap_));
+	assert(SUCCEEDED(result));
+
+	// インデックスバッファ生成（どのスプライトも同じ並びなので最初に全部書いておく）
+	resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeIB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&indexBuff_));
+	assert(SUCCEEDED(result));
+	uint16_t* indexMap = nullptr;
+	result = indexBuff_->Map(0, nullptr, reinterpret_cast<void**>(&indexMap));
+	assert(SUCCEEDED(result));
+	for (uint32_t i = 0; i < maxSpriteCount_; i++) {
+		// 左上・右上・左下 と 左下・右上・右下
+		const uint16_t corners[kIndexCountPerSprite] = {0, 1, 2, 2, 1, 3};
+		for (uint32_t k = 0; k < kIndexCountPerSprite; k++) {
+			indexMap[i * kIndexCountPerSprite + k] =
+			    static_cast<uint16_t>(i * kVertexCountPerSprite + corners[k]);
+		}
+	}
+	indexBuff_->Unmap(0, nullptr);
+
+	// 頂点バッファビューの作成
+	vbView_.BufferLocation = vertBuff_->GetGPUVirtualAddress();
+	vbView_.SizeInBytes = sizeVB;
+	vbView_.StrideInBytes = sizeof(VertexPosUvColor);
+
+	// インデックスバッファビューの作成
+	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
+	ibView_.Format = DXGI_FORMAT_R16_UINT;
+	ibView_.SizeInBytes = sizeIB;
+}
+
+void SpriteBatch::PreDraw(ID3D12GraphicsCommandList* commandList) {
+	// PreDrawとPostDrawがペアで呼ばれていなければエラー
+	assert(commandList_ == nullptr);
+	commandList_ = commandList;
+	quads_.clear();
+}
+
+void SpriteBatch::Draw(const Quad& quad) {
+	assert(commandList_);
+	// 頂点バッファに入りきらない分は捨てる
+	if (usedSpriteCount_ + quads_.size() >= maxSpriteCount_) {
+		stats_.droppedCount++;
+		return;
+	}
+	quads_.push_back(quad);
+}
+
+void SpriteBatch::Draw(
+    uint32_t textureHandle, const Vector2& position, const Vector2& size, const Vector4& color) {
+	Quad quad;
+	quad.textureHandle = textureHandle;
+	quad.position = position;
+	quad.size = size;
+	quad.color = color;
+	Draw(quad);
+}
+
+void SpriteBatch::PostDraw() {
+	assert(commandList_);
+	ID3D12GraphicsCommandList* commandList = commandList_;
+	// コマンドリストを解除
+	commandList_ = nullptr;
+	if (quads_.empty()) {
+		return;
+	}
+	uint32_t count = static_cast<uint32_t>(quads_.size());
+
+	// レイヤー・ブレンドモード・テクスチャ・積んだ順で並べ替える（キーは全て異なるので順番は安定）
+	sortKeys_.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		const Quad& quad = quads_[i];
+		uint64_t layer = uint16_t(quad.layer + 0x8000);
+		uint64_t blendMode = static_cast<uint8_t>(quad.blendMode);
+		uint64_t texture = uint16_t(quad.textureHandle);
+		sortKeys_[i] = layer << 48 | blendMode << 40 | texture << kSortIndexBits | i;
+	}
+	std::sort(sortKeys_.begin(), sortKeys_.end());
+	order_.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		order_[i] = uint32_t(sortKeys_[i] & ((1u << kSortIndexBits) - 1));
+	}
+
+	// 今フレームの続きに頂点を書く（GPUが読み終わるのは Reset の後）
+	WriteVertices(
+	    quads_.data(), order_.data(), count, screenSize_,
+	    vertMap_ + size_t(usedSpriteCount_) * kVertexCountPerSprite, useSimd_);
+
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commandList->IASetVertexBuffers(0, 1, &vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+
+	// ブレンドモードかテクスチャが変わる所で描画を分ける
+	TextureStreamer* textureStreamer = TextureStreamer::GetInstance();
+	size_t currentBlendMode = pipelineStates_.size();
+	uint32_t currentTexture = UINT32_MAX;
+	uint32_t runBegin = 0;
+	auto flush = [&](uint32_t runEnd) {
+		if (runEnd == runBegin) {
+			return;
+		}
+		commandList->DrawIndexedInstanced(
+		    (runEnd - runBegin) * kIndexCountPerSprite, 1, 0,
+		    static_cast<INT>((usedSpriteCount_ + runBegin) * kVertexCountPerSprite), 0);
+		stats_.drawCount++;
+		runBegin = runEnd;
+	};
+	for (uint32_t i = 0; i < count; i++) {
+		const Quad& quad = quads_[order_[i]];
+		size_t blendMode = static_cast<size_t>(quad.blendMode);
+		if (blendMode != currentBlendMode) {
+			flush(i);
+			commandList->SetPipelineState(pipelineStates_[blendMode].Get());
+			currentBlendMode = blendMode;
+			stats_.pipelineSwitchCount++;
+		}
+		if (quad.textureHandle != currentTexture) {
+			flush(i);
+			textureStreamer->SetGraphicsRootDescriptorTable(commandList, 0, quad.textureHandle);
+			currentTexture = quad.textureHandle;
+			stats_.textureSwitchCount++;
+		}
+	}
+	flush(count);
+
+	usedSpriteCount_ += count;
+	stats_.spriteCount += count;
+	quads_.clear();
+}
+
+void SpriteBatch::Reset() {
+	// PreDrawとPostDrawがペアで呼ばれていなければエラー
+	assert(commandList_ == nullptr);
+	lastFrameStats_ = stats_;
+	stats_ = Stats();
+	usedSpriteCount_ = 0;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Sprite.h"
+#include "Vector2.h"
+#include "Vector4.h"
+#include <array>
+#include <cstdint>
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// スプライトの一括描画（1フレーム分の四角形を1本の頂点バッファに詰め、
+/// レイヤー・ブレンドモード・テクスチャ順に並べ替えて、状態が変わる所でだけ描画を分ける）
+/// </summary>
+class SpriteBatch {
+private: // エイリアス
+	// Microsoft::WRL::を省略
+	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public: // 定数
+	// 1フレームに描けるスプライト数の上限（16bitインデックスで引ける頂点数まで）
+	static const uint32_t kMaxSpriteCount = 0x4000;
+	// 1スプライトの頂点数
+	static const uint32_t kVertexCountPerSprite = 4;
+	// 1スプライトのインデックス数
+	static const uint32_t kIndexCountPerSprite = 6;
+
+public: // サブクラス
+	// 頂点データ（スクリーン座標は書き込み時にクリップ座標へ直す）
+	struct VertexPosUvColor {
+		Vector2 pos;    // xy座標（クリップ座標）
+		Vector2 uv;     // uv座標
+		uint32_t color; // RGBA（8bit正規化）
+	};
+
+	// 四角形1つ分
+	struct Quad {
+		// テクスチャハンドル（TextureStreamer）
+		uint32_t textureHandle = 0;
+		// 座標（スクリーン座標、アンカーポイントの位置）
+		Vector2 position = {0.0f, 0.0f};
+		// 幅・高さ（負にすると反転）
+		Vector2 size = {100.0f, 100.0f};
+		// アンカーポイント（0〜1）
+		Vector2 anchorPoint = {0.0f, 0.0f};
+		// Z軸回りの回転角（ラジアン）
+		float rotation = 0.0f;
+		// テクスチャ範囲（左上u, 左上v, 右下u, 右下v）
+		Vector4 uvRect = {0.0f, 0.0f, 1.0f, 1.0f};
+		// 色
+		Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+		// ブレンドモード
+		Sprite::BlendMode blendMode = Sprite::BlendMode::kNormal;
+		// レイヤー（小さいほど奥。同じレイヤー内は描画順が入れ替わることがある）
+		int16_t layer = 0;
+	};
+
+	// 描画統計（Reset で前フレームの分になる）
+	struct Stats {
+		// 描いたスプライト数
+		uint32_t spriteCount = 0;
+		// 描画コマンド数
+		uint32_t drawCount = 0;
+		// パイプラインを切り替えた回数
+		uint32_t pipelineSwitchCount = 0;
+		// テクスチャを切り替えた回数
+		uint32_t textureSwitchCount = 0;
+		// 頂点バッファが一杯で捨てたスプライト数
+		uint32_t droppedCount = 0;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static SpriteBatch* GetInstance();
+
+	/// <summary>
+	/// 四角形の頂点を書き込む（SIMDでは1スプライトの4頂点を同時に計算する）
+	/// </summary>
+	/// <param name="quads">四角形配列</param>
+	/// <param name="order">書き込む順番（quads の添え字）</param>
+	/// <param name="count">書き込む数</param>
+	/// <param name="screenSize">画面の幅・高さ</param>
+	/// <param name="vertices">書き込み先（count * kVertexCountPerSprite）</param>
+	/// <param name="useSimd">SIMDを使うか（結果は同じ）</param>
+	static void WriteVertices(
+	    const Quad* quads, const uint32_t* order, uint32_t count, const Vector2& screenSize,
+	    VertexPosUvColor* vertices, bool useSimd = true);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="windowWidth">画面幅</param>
+	/// <param name="windowHeight">画面高さ</param>
+	/// <param name="maxSpriteCount">1フレームに描ける数</param>
+	void Initialize(
+	    int windowWidth, int windowHeight, uint32_t maxSpriteCount = kMaxSpriteCount);
+
+	/// <summary>
+	/// 終了処理
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 描画前処理（PostDraw までの Draw をまとめて描く）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	void PreDraw(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 描画後処理（並べ替えて頂点を書き込み、描画コマンドを積む）
+	/// </summary>
+	void PostDraw();
+
+	/// <summary>
+	/// 描画（PreDraw と PostDraw の間で呼ぶ）
+	/// </summary>
+	/// <param name="quad">四角形</param>
+	void Draw(const Quad& quad);
+
+	/// <summary>
+	/// 描画（回転無し・テクスチャ全体・通常ブレンド）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル（TextureStreamer）</param>
+	/// <param name="position">左上座標</param>
+	/// <param name="size">幅・高さ</param>
+	/// <param name="color">色</param>
+	void Draw(
+	    uint32_t textureHandle, const Vector2& position, const Vector2& size,
+	    const Vector4& color = {1.0f, 1.0f, 1.0f, 1.0f});
+
+	/// <summary>
+	/// フレームのリセット（頂点バッファを先頭から使い直す。そのフレームの描画を積み終えてから呼ぶ。
+	/// 次に書き込むのは DirectXCommon::PostDraw でGPUを待った後になる）
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// SIMDを使うか
+	/// </summary>
+	void SetUseSimd(bool useSimd) { useSimd_ = useSimd; }
+
+	/// <summary>
+	/// 前フレームの描画統計
+	/// </summary>
+	const Stats& GetLastFrameStats() const { return lastFrameStats_; }
+
+private: // メンバ関数
+	SpriteBatch() = default;
+	~SpriteBatch() = default;
+	SpriteBatch(const SpriteBatch&) = delete;
+	SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+	/// <summary>
+	/// ルートシグネチャとブレンドモード毎のパイプラインステートの生成
+	/// </summary>
+	void CreateGraphicsPipelines();
+
+	/// <summary>
+	/// 頂点バッファ（毎フレーム書き換え）とインデックスバッファ（固定）の生成
+	/// </summary>
+	void CreateBuffers();
+
+private: // メンバ変数
+	// ルートシグネチャ
+	ComPtr<ID3D12RootSignature> rootSignature_;
+	// パイプラインステートオブジェクト（ブレンドモード毎）
+	std::array<ComPtr<ID3D12PipelineState>, size_t(Sprite::BlendMode::kCountOfBlendMode)>
+	    pipelineStates_;
+	// 頂点バッファ
+	ComPtr<ID3D12Resource> vertBuff_;
+	// インデックスバッファ
+	ComPtr<ID3D12Resource> indexBuff_;
+	// 頂点バッファマップ
+	VertexPosUvColor* vertMap_ = nullptr;
+	// 頂点バッファビュー
+	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
+	// インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW ibView_ = {};
+	// 1フレームに描ける数
+	uint32_t maxSpriteCount_ = 0;
+	// 今フレームに使ったスプライト数（頂点バッファの書き込み位置）
+	uint32_t usedSpriteCount_ = 0;
+	// 画面の幅・高さ
+	Vector2 screenSize_ = {0.0f, 0.0f};
+	// 描画中のコマンドリスト
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+	// PreDraw から積んだ四角形
+	std::vector<Quad> quads_;
+	// 並べ替えキー（上位がレイヤー・ブレンドモード・テクスチャ、下位が積んだ順）
+	std::vector<uint64_t> sortKeys_;
+	// 並べ替えた順番
+	std::vector<uint32_t> order_;
+	// SIMDを使うか
+	bool useSimd_ = true;
+	// 描画統計（集計中と前フレーム）
+	Stats stats_;
+	Stats lastFrameStats_;
+};
@@ -0,0 +1,284 @@
+#include "TextureAtlas.h"
+#include "TextureStreamer.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+using namespace DirectX;
+
+namespace {
+
+// 配置単位（ミップマップの最下段でも矩形の境界が画素の境界に乗る）
+const uint32_t kPlacementAlignment = 1u << (TextureAtlas::kMipLevels - 1);
+// 1画素のバイト数（R8G8B8A8）
+const size_t kBytesPerPixel = 4;
+
+uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t NextPowerOfTwo(uint32_t value) {
+	uint32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+// 配置前の画像
+struct SourceImage {
+	std::string fileName;
+	ScratchImage image;
+	// 余白込みの大きさ
+	uint32_t paddedWidth = 0;
+	uint32_t paddedHeight = 0;
+	// 配置した位置（余白込みの左上）
+	uint32_t x = 0;
+	uint32_t y = 0;
+};
+
+// 全画像を width x height に配置できるか試す
+bool Pack(std::vector<SourceImage>& sources, uint32_t width, uint32_t height) {
+	TextureAtlas::SkylinePacker packer;
+	packer.Initialize(width, height);
+	for (SourceImage& source : sources) {
+		if (!packer.Insert(source.paddedWidth, source.paddedHeight, source.x, source.y)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 余白を縁の色で埋めながら転写する
+void Blit(const SourceImage& source, uint32_t padding, const Image& atlas) {
+	const Image& src = *source.image.GetImage(0, 0, 0);
+	int32_t srcWidth = static_cast<int32_t>(src.width);
+	int32_t srcHeight = static_cast<int32_t>(src.height);
+	for (uint32_t dy = 0; dy < source.paddedHeight; dy++) {
+		int32_t sy = std::clamp(int32_t(dy) - int32_t(padding), 0, srcHeight - 1);
+		const uint8_t* srcRow = src.pixels + src.rowPitch * sy;
+		uint8_t* dstRow = atlas.pixels + atlas.rowPitch * (source.y + dy);
+		for (uint32_t dx = 0; dx < source.paddedWidth; dx++) {
+			int32_t sx = std::clamp(int32_t(dx) - int32_t(padding), 0, srcWidth - 1);
+			std::memcpy(
+			    dstRow + (source.x + dx) * kBytesPerPixel, srcRow + sx * kBytesPerPixel,
+			    kBytesPerPixel);
+		}
+	}
+}
+
+} // namespace
+
+void TextureAtlas::SkylinePacker::Initialize(uint32_t width, uint32_t height) {
+	width_ = width;
+	height_ = height;
+	skyline_.clear();
+	skyline_.push_back({0, 0, width});
+}
+
+bool TextureAtlas::SkylinePacker::Insert(
+    uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) {
+	// 上端が最も低く、同じなら残る区間が狭い位置を選ぶ
+	size_t bestIndex = SIZE_MAX;
+	uint32_t bestTop = UINT32_MAX;
+	uint32_t bestWidth = UINT32_MAX;
+	for (size_t i = 0; i < skyline_.size(); i++) {
+		uint32_t top = Fit(i, width, height);
+		if (top == UINT32_MAX) {
+			continue;
+		}
+		if (top < bestTop || (top == bestTop && skyline_[i].width < bestWidth)) {
+			bestIndex = i;
+			bestTop = top;
+			bestWidth = skyline_[i].width;
+		}
+	}
+	if (bestIndex == SIZE_MAX) {
+		return false;
+	}
+
+	x = skyline_[bestIndex].x;
+	y = bestTop - height;
+
+	// 新しい区間を挿入し、覆われた区間を削る
+	skyline_.insert(skyline_.begin() + bestIndex, {x, bestTop, width});
+	for (size_t i = bestIndex + 1; i < skyline_.size();) {
+		Node& node = skyline_[i];
+		uint32_t right = x + width;
+		if (right <= node.x) {
+			break;
+		}
+		uint32_t shrink = std::min(right - node.x, node.width);
+		node.x += shrink;
+		node.width -= shrink;
+		if (node.width == 0) {
+			skyline_.erase(skyline_.begin() + i);
+		} else {
+			break;
+		}
+	}
+
+	// 同じ高さの隣り合う区間をまとめる
+	for (size_t i = 0; i + 1 < skyline_.size();) {
+		if (skyline_[i].y == skyline_[i + 1].y) {
+			skyline_[i].width += skyline_[i + 1].width;
+			skyline_.erase(skyline_.begin() + i + 1);
+		} else {
+			i++;
+		}
+	}
+	return true;
+}
+
+uint32_t TextureAtlas::SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height) const {
+	uint32_t x = skyline_[index].x;
+	if (width_ < x + width) {
+		return UINT32_MAX;
+	}
+	// 矩形の幅に掛かる区間のうち最も高い位置に置く
+	uint32_t top = 0;
+	uint32_t remaining = width;
+	for (size_t i = index; remaining > 0; i++) {
+		assert(i < skyline_.size());
+		top = std::max(top, skyline_[i].y);
+		remaining -= std::min(remaining, skyline_[i].width);
+	}
+	if (height_ < top + height) {
+		return UINT32_MAX;
+	}
+	return top + height;
+}
+
+TextureAtlas* TextureAtlas::Create(
+    const std::string& name, const std::vector<std::string>& fileNames, uint32_t padding) {
+	assert(!fileNames.empty());
+	TextureStreamer* textureStreamer = TextureStreamer::GetInstance();
+
+	// 読み込み（配置しやすいよう R8G8B8A8 に揃える）
+	std::vector<SourceImage> sources(fileNames.size());
+	uint64_t area = 0;
+	uint64_t usedPixels = 0;
+	uint32_t maxWidth = 0;
+	uint32_t maxHeight = 0;
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		SourceImage& source = sources[i];
+		source.fileName = fileNames[i];
+
+		std::filesystem::path filePath(textureStreamer->GetFullPath(fileNames[i]));
+		TexMetadata metadata{};
+		HRESULT result = LoadFromWICFile(
+		    filePath.wstring().c_str(), WIC_FLAGS_NONE, &metadata, source.image);
+		assert(SUCCEEDED(result));
+		if (FAILED(result)) {
+			return nullptr;
+		}
+		if (metadata.format != DXGI_FORMAT_R8G8B8A8_UNORM) {
+			ScratchImage converted;
+			result = Convert(
+			    source.image.GetImages(), 1, metadata, DXGI_FORMAT_R8G8B8A8_UNORM,
+			    TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, converted);
+			assert(SUCCEEDED(result));
+			source.image = std::move(converted);
+		}
+
+		uint32_t width = static_cast<uint32_t>(metadata.width);
+		uint32_t height = static_cast<uint32_t>(metadata.height);
+		source.paddedWidth = AlignUp(width + padding * 2, kPlacementAlignment);
+		source.paddedHeight = AlignUp(height + padding * 2, kPlacementAlignment);
+		area += uint64_t(source.paddedWidth) * source.paddedHeight;
+		usedPixels += uint64_t(width) * height;
+		maxWidth = std::max(maxWidth, source.paddedWidth);
+		maxHeight = std::max(maxHeight, source.paddedHeight);
+	}
+
+	// 高い順に置くと隙間が少ない
+	std::sort(sources.begin(), sources.end(), [](const SourceImage& a, const SourceImage& b) {
+		return a.paddedHeight != b.paddedHeight ? a.paddedHeight > b.paddedHeight
+		                                        : a.paddedWidth > b.paddedWidth;
+	});
+
+	// 面積から見積もった2のべき乗の大きさから始め、入らなければ短い辺を倍にする
+	uint32_t width = NextPowerOfTwo(
+	    std::max(maxWidth, static_cast<uint32_t>(std::ceil(std::sqrt(double(area))))));
+	uint32_t height = NextPowerOfTwo(
+	    std::max(maxHeight, static_cast<uint32_t>((area + width - 1) / std::max(width, 1u))));
+	while (!Pack(sources, width, height)) {
+		if (width <= height) {
+			width *= 2;
+		} else {
+			height *= 2;
+		}
+		assert(width <= kMaxSize && height <= kMaxSize);
+		if (kMaxSize < width || kMaxSize < height) {
+			return nullptr;
+		}
+	}
+
+	// 合成
+	ScratchImage atlasImage;
+	HRESULT result = atlasImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1);
+	assert(SUCCEEDED(result));
+	const Image& atlas = *atlasImage.GetImage(0, 0, 0);
+	std::memset(atlas.pixels, 0, atlas.slicePitch);
+	for (const SourceImage& source : sources) {
+		Blit(source, padding, atlas);
+	}
+
+	// ミップマップ生成（余白が1画素以上残る段数まで）後、SRGBとして扱う
+	ScratchImage mipChain;
+	result = GenerateMipMaps(
+	    atlasImage.GetImages(), atlasImage.GetImageCount(), atlasImage.GetMetadata(),
+	    TEX_FILTER_DEFAULT, kMipLevels, mipChain);
+	assert(SUCCEEDED(result));
+	mipChain.OverrideFormat(MakeSRGB(mipChain.GetMetadata().format));
+
+	TextureAtlas* textureAtlas = new TextureAtlas();
+	textureAtlas->textureHandle_ = TextureStreamer::LoadFromImage(name, mipChain);
+
+	// 領域
+	for (const SourceImage& source : sources) {
+		const TexMetadata& metadata = source.image.GetMetadata();
+		Region region;
+		region.textureHandle = textureAtlas->textureHandle_;
+		region.texBase = {float(source.x + padding), float(source.y + padding)};
+		region.texSize = {float(metadata.width), float(metadata.height)};
+		region.uvOffset = {region.texBase.x / width, region.texBase.y / height};
+		region.uvScale = {region.texSize.x / width, region.texSize.y / height};
+		textureAtlas->regions_[source.fileName] = region;
+	}
+
+	Stats& stats = textureAtlas->stats_;
+	stats.textureCount = static_cast<uint32_t>(sources.size());
+	stats.width = width;
+	stats.height = height;
+	stats.occupancy = float(double(usedPixels) / (double(width) * height));
+
+	return textureAtlas;
+}
+
+const TextureAtlas::Region& TextureAtlas::GetRegion(const std::string& fileName) const {
+	auto it = regions_.find(fileName);
+	assert(it != regions_.end());
+	return it->second;
+}
+
+void TextureAtlas::Apply(SpriteBatch::Quad* quad, const std::string& fileName) const {
+	assert(quad);
+	const Region& region = GetRegion(fileName);
+	quad->textureHandle = region.textureHandle;
+	quad->uvRect = {
+	    region.uvOffset.x, region.uvOffset.y, region.uvOffset.x + region.uvScale.x,
+	    region.uvOffset.y + region.uvScale.y};
+	quad->size = region.texSize;
+}
+
+void TextureAtlas::Apply(Material* material, const std::string& fileName) const {
+	assert(material);
+	const Region& region = GetRegion(fileName);
+	material->uvScale_ = {region.uvScale.x, region.uvScale.y, 1.0f};
+	material->uvOffset_ = {region.uvOffset.x, region.uvOffset.y, 0.0f};
+	material->Update();
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Material.h"
+#include "SpriteBatch.h"
+#include "Vector2.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// テクスチャアトラス（小さなテクスチャを1枚にまとめてデスクリプタとテクスチャ切り替えを減らす）。
+/// アトラスは TextureStreamer に登録するので、SpriteBatch や StaticMesh の描画で使う
+/// </summary>
+class TextureAtlas {
+public: // 定数
+	// 既定の余白（ピクセル）。縁の色で埋めてフィルタのにじみを防ぐ
+	static const uint32_t kDefaultPadding = 4;
+	// アトラスの最大辺長
+	static const uint32_t kMaxSize = 4096;
+	// ミップマップ段数（配置を 1 << (kMipLevels - 1) ピクセル単位に揃え、余白が潰れない段数まで）
+	static const uint32_t kMipLevels = 3;
+
+public: // サブクラス
+	// アトラス内の領域
+	struct Region {
+		// アトラスのテクスチャハンドル（TextureStreamer）
+		uint32_t textureHandle = 0;
+		// 左上座標（ピクセル）
+		Vector2 texBase;
+		// 幅・高さ（ピクセル）
+		Vector2 texSize;
+		// UVオフセット（Material::uvOffset_ 用）
+		Vector2 uvOffset;
+		// UVスケール（Material::uvScale_ 用）
+		Vector2 uvScale;
+	};
+
+	// 構築統計（描画でのテクスチャ切り替え回数は TextureStreamer::GetLastFrameStats で計る）
+	struct Stats {
+		// まとめたテクスチャ数
+		uint32_t textureCount = 0;
+		// アトラスの幅
+		uint32_t width = 0;
+		// アトラスの高さ
+		uint32_t height = 0;
+		// 使用率（余白を除く画素 / アトラスの画素）
+		float occupancy = 0.0f;
+	};
+
+	/// <summary>
+	/// スカイライン法の矩形詰め込み
+	/// </summary>
+	class SkylinePacker {
+	public:
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="width">幅</param>
+		/// <param name="height">高さ</param>
+		void Initialize(uint32_t width, uint32_t height);
+
+		/// <summary>
+		/// 矩形を配置する（上端が最も低くなる位置、同じなら隙間が少ない位置）
+		/// </summary>
+		/// <param name="width">幅</param>
+		/// <param name="height">高さ</param>
+		/// <param name="x">配置したx座標</param>
+		/// <param name="y">配置したy座標</param>
+		/// <returns>配置できればtrue</returns>
+		bool Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+
+	private:
+		// スカイラインの区間
+		struct Node {
+			uint32_t x;
+			uint32_t y;
+			uint32_t width;
+		};
+
+		/// <summary>
+		/// 区間 index から幅 width の矩形を置いたときの上端
+		/// </summary>
+		/// <returns>置けなければ UINT32_MAX</returns>
+		uint32_t Fit(size_t index, uint32_t width, uint32_t height) const;
+
+		// 幅
+		uint32_t width_ = 0;
+		// 高さ
+		uint32_t height_ = 0;
+		// スカイライン（x昇順）
+		std::vector<Node> skyline_;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 画像ファイルをまとめてアトラスを生成する
+	/// </summary>
+	/// <param name="name">アトラス名（TextureStreamer への登録名）</param>
+	/// <param name="fileNames">ファイル名配列（TextureStreamer::Load と同じ指定）</param>
+	/// <param name="padding">余白（ピクセル）</param>
+	/// <returns>生成されたアトラス</returns>
+	static TextureAtlas* Create(
+	    const std::string& name, const std::vector<std::string>& fileNames,
+	    uint32_t padding = kDefaultPadding);
+
+public: // メンバ関数
+	/// <summary>
+	/// 領域を持っているか
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	bool HasRegion(const std::string& fileName) const { return regions_.contains(fileName); }
+
+	/// <summary>
+	/// 領域の取得
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>領域</returns>
+	const Region& GetRegion(const std::string& fileName) const;
+
+	/// <summary>
+	/// 一括描画の四角形に領域を設定（テクスチャハンドル、テクスチャ範囲、大きさ）
+	/// </summary>
+	/// <param name="quad">四角形</param>
+	/// <param name="fileName">ファイル名</param>
+	void Apply(SpriteBatch::Quad* quad, const std::string& fileName) const;
+
+	/// <summary>
+	/// マテリアルに領域のUV変換を設定（描画時は Region::textureHandle を差し替えて使う）
+	/// </summary>
+	/// <param name="material">マテリアル</param>
+	/// <param name="fileName">ファイル名</param>
+	void Apply(Material* material, const std::string& fileName) const;
+
+	/// <summary>
+	/// アトラスのテクスチャハンドル（TextureStreamer）
+	/// </summary>
+	uint32_t GetTextureHandle() const { return textureHandle_; }
+
+	/// <summary>
+	/// 構築統計
+	/// </summary>
+	const Stats& GetStats() const { return stats_; }
+
+private: // メンバ変数
+	// アトラスのテクスチャハンドル（TextureStreamer）
+	uint32_t textureHandle_ = 0;
+	// ファイル名毎の領域
+	std::unordered_map<std::string, Region> regions_;
+	// 構築統計
+	Stats stats_;
+};
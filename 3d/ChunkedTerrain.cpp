@@ -0,0 +1,270 @@
+#include "ChunkedTerrain.h"
+#include "DirectXCommon.h"
+#include "MathUtilityForText.h"
+#include "TerrainCommon.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cassert>
+#include <d3dx12.h>
+
+const float ChunkedTerrain::kDefaultLodDistance = 64.0f;
+
+void ChunkedTerrain::Initialize(Heightfield* heightfield) {
+	assert(heightfield);
+	uint32_t vertexCountHorizontal = heightfield->GetVertexCountHorizontal();
+	uint32_t vertexCountVertical = heightfield->GetVertexCountVertical();
+	assert((vertexCountHorizontal - 1) % kChunkCells == 0);
+	assert((vertexCountVertical - 1) % kChunkCells == 0);
+
+	heightfield_ = heightfield;
+	chunkCountX_ = (vertexCountHorizontal - 1) / kChunkCells;
+	chunkCountZ_ = (vertexCountVertical - 1) / kChunkCells;
+	chunks_.assign(size_t(chunkCountX_) * chunkCountZ_, Chunk());
+	quadtree_.Initialize(chunkCountX_, chunkCountZ_);
+
+	std::vector<uint16_t> indices;
+	BuildIndices(indices);
+	CreateBuffers(indices);
+	WriteVertices();
+	heightfield_->ClearDirty();
+}
+
+uint32_t ChunkedTerrain::TransferDirtyRows() {
+	uint32_t transferred = 0;
+	// 書き換えたチャンク（AABBを求め直す）
+	std::vector<bool> touched(chunks_.size(), false);
+	for (uint32_t z = heightfield_->GetDirtyRowBegin(); z < heightfield_->GetDirtyRowEnd(); z++) {
+		const Heightfield::DirtyRange& range = heightfield_->GetDirtyRange(z);
+		if (range.IsEmpty()) {
+			continue;
+		}
+		const VertexPosNormalUv* src = &heightfield_->GetVertex(0, z);
+
+		// 境界の行は上下2つのチャンクが重複して持つ
+		uint32_t czBegin = z > 0 ? (z - 1) / kChunkCells : 0;
+		uint32_t czEnd = std::min(z / kChunkCells + 1, chunkCountZ_);
+		for (uint32_t cz = czBegin; cz < czEnd; cz++) {
+			uint32_t lz = z - cz * kChunkCells;
+			// 境界の列も左右2つのチャンクが重複して持つ
+			uint32_t cxBegin = range.begin > 0 ? (range.begin - 1) / kChunkCells : 0;
+			uint32_t cxEnd = std::min((range.end - 1) / kChunkCells + 1, chunkCountX_);
+			for (uint32_t cx = cxBegin; cx < cxEnd; cx++) {
+				uint32_t x0 = std::max(range.begin, cx * kChunkCells);
+				uint32_t x1 = std::min(range.end, cx * kChunkCells + kChunkVertexCount);
+				if (x0 >= x1) {
+					continue;
+				}
+				Chunk& chunk = GetChunk(cx, cz);
+				VertexPosNormalUv* dst = vertMap_ + chunk.baseVertex + lz * kChunkVertexCount;
+				std::copy(src + x0, src + x1, dst + (x0 - cx * kChunkCells));
+				touched[size_t(cz) * chunkCountX_ + cx] = true;
+				transferred += x1 - x0;
+			}
+		}
+	}
+	// 下げた分も縮めるよう、書き換えたチャンクはAABBを丸ごと求め直す
+	for (uint32_t cz = 0; cz < chunkCountZ_; cz++) {
+		for (uint32_t cx = 0; cx < chunkCountX_; cx++) {
+			if (touched[size_t(cz) * chunkCountX_ + cx]) {
+				RecalculateChunkBounds(cx, cz);
+			}
+		}
+	}
+	heightfield_->ClearDirty();
+	return transferred;
+}
+
+void ChunkedTerrain::Draw(
+    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+    uint32_t textureHadle) {
+	// カメラ座標（ビュー行列の逆行列の平行移動成分）とローカル座標の視錐台で
+	// 見えるチャンクとLODを1回の走査で選ぶ
+	Matrix4x4 matCamera = Inverse(viewProjection.matView);
+	Vector3 eye = {matCamera.m[3][0], matCamera.m[3][1], matCamera.m[3][2]};
+	TerrainQuadtree::Frustum frustum = TerrainQuadtree::ExtractFrustum(
+	    worldTransform.matWorld_ * viewProjection.matView * viewProjection.matProjection);
+	uint32_t visitedNodeCount = quadtree_.Select(
+	    frustum, Transform(eye, Inverse(worldTransform.matWorld_)), lodDistance_, visibleChunks_);
+
+	ID3D12GraphicsCommandList* commandList = DirectXCommon::GetInstance()->GetCommandList();
+
+	// 全チャンク共通の設定
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commandList->IASetVertexBuffers(0, 1, &vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(TerrainCommon::RoomParameter::kWorldTransform),
+	    worldTransform.GetConstBuffer()->GetGPUVirtualAddress());
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(TerrainCommon::RoomParameter::kViewProjection),
+	    viewProjection.GetConstBuffer()->GetGPUVirtualAddress());
+	TextureManager::GetInstance()->SetGraphicsRootDescriptorTable(
+	    commandList, static_cast<UINT>(TerrainCommon::RoomParameter::kTexture), textureHadle);
+
+	// 見えるチャンクだけ、LODと隣の粗さに合ったインデックス範囲で描画する
+	stats_ = Stats();
+	stats_.chunkCount = static_cast<uint32_t>(chunks_.size());
+	stats_.visitedNodeCount = visitedNodeCount;
+	for (const TerrainQuadtree::VisibleChunk& visible : visibleChunks_) {
+		const IndexRange& range = indexRanges_[visible.lod][visible.stitchMask];
+		commandList->DrawIndexedInstanced(
+		    range.count, 1, range.start,
+		    static_cast<INT>(GetChunk(visible.cx, visible.cz).baseVertex), 0);
+
+		stats_.visibleCount++;
+		stats_.triangleCount += range.count / 3;
+		stats_.lodChunkCounts[visible.lod]++;
+	}
+}
+
+void ChunkedTerrain::BuildIndices(std::vector<uint16_t>& indices) {
+	indices.clear();
+	for (uint32_t lod = 0; lod < kLodCount; lod++) {
+		uint32_t step = 1u << lod;
+		uint32_t cells = kChunkCells >> lod;
+		for (uint32_t mask = 0; mask < kStitchVariantCount; mask++) {
+			// 粗い隣と接する辺は、奇数番目の頂点を1つ手前の頂点に寄せて隣の辺と一致させる
+			auto vertex = [&](uint32_t gx, uint32_t gz) {
+				if ((mask & kEdgeNegativeZ) && gz == 0 && (gx & 1)) {
+					gx--;
+				}
+				if ((mask & kEdgePositiveZ) && gz == cells && (gx & 1)) {
+					gx--;
+				}
+				if ((mask & kEdgeNegativeX) && gx == 0 && (gz & 1)) {
+					gz--;
+				}
+				if ((mask & kEdgePositiveX) && gx == cells && (gz & 1)) {
+					gz--;
+				}
+				return static_cast<uint16_t>(gz * step * kChunkVertexCount + gx * step);
+			};
+			// 面積0か（寄せた頂点が重なる・一直線に並ぶ）
+			auto isFlat = [](uint16_t v0, uint16_t v1, uint16_t v2) {
+				int32_t x0 = v0 % kChunkVertexCount, z0 = v0 / kChunkVertexCount;
+				int32_t x1 = v1 % kChunkVertexCount, z1 = v1 / kChunkVertexCount;
+				int32_t x2 = v2 % kChunkVertexCount, z2 = v2 / kChunkVertexCount;
+				return (x1 - x0) * (z2 - z0) == (z1 - z0) * (x2 - x0);
+			};
+			// 寄せて潰れた三角形は省く
+			auto addTriangle = [&](uint16_t v0, uint16_t v1, uint16_t v2) {
+				if (isFlat(v0, v1, v2)) {
+					return;
+				}
+				indices.push_back(v0);
+				indices.push_back(v1);
+				indices.push_back(v2);
+			};
+
+			IndexRange& range = indexRanges_[lod][mask];
+			range.start = static_cast<uint32_t>(indices.size());
+			for (uint32_t gz = 0; gz < cells; gz++) {
+				for (uint32_t gx = 0; gx < cells; gx++) {
+					// 1マス2枚の三角形（Heightfield と同じ向き）
+					uint16_t v00 = vertex(gx, gz);
+					uint16_t v01 = vertex(gx, gz + 1);
+					uint16_t v10 = vertex(gx + 1, gz);
+					uint16_t v11 = vertex(gx + 1, gz + 1);
+					// 両側が粗い角のマスは、対角線の向きを変えないと
+					// 一直線に並んだ三角形ができて T 字の継ぎ目が残る
+					bool flipDiagonal =
+					    (isFlat(v00, v01, v10) || isFlat(v01, v11, v10)) &&
+					    !isFlat(v00, v01, v11) && !isFlat(v00, v11, v10);
+					if (flipDiagonal) {
+						addTriangle(v00, v01, v11);
+						addTriangle(v00, v11, v10);
+					} else {
+						addTriangle(v00, v01, v10);
+						addTriangle(v01, v11, v10);
+					}
+				}
+			}
+			range.count = static_cast<uint32_t>(indices.size()) - range.start;
+		}
+	}
+}
+
+void ChunkedTerrain::CreateBuffers(const std::vector<uint16_t>& indices) {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	UINT sizeVB = static_cast<UINT>(
+	    sizeof(VertexPosNormalUv) * kChunkVertexCount * kChunkVertexCount * chunks_.size());
+	UINT sizeIB = static_cast<UINT>(sizeof(uint16_t) * indices.size());
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+
+	// 頂点バッファ生成
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeVB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&vertBuff_));
+	assert(SUCCEEDED(result));
+
+	// インデックスバッファ生成
+	resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeIB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&indexBuff_));
+	assert(SUCCEEDED(result));
+
+	// 頂点バッファは書き換えられるようマップしたままにする
+	result = vertBuff_->Map(0, nullptr, reinterpret_cast<void**>(&vertMap_));
+	assert(SUCCEEDED(result));
+
+	// インデックスは以後変わらないので転送してマップ解除
+	uint16_t* indexMap = nullptr;
+	result = indexBuff_->Map(0, nullptr, reinterpret_cast<void**>(&indexMap));
+	assert(SUCCEEDED(result));
+	std::copy(indices.begin(), indices.end(), indexMap);
+	indexBuff_->Unmap(0, nullptr);
+
+	// 頂点バッファビューの作成
+	vbView_.BufferLocation = vertBuff_->GetGPUVirtualAddress();
+	vbView_.SizeInBytes = sizeVB;
+	vbView_.StrideInBytes = sizeof(VertexPosNormalUv);
+
+	// インデックスバッファビューの作成
+	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
+	ibView_.Format = DXGI_FORMAT_R16_UINT;
+	ibView_.SizeInBytes = sizeIB;
+}
+
+void ChunkedTerrain::WriteVertices() {
+	const uint32_t kChunkVertexTotal = kChunkVertexCount * kChunkVertexCount;
+	for (uint32_t cz = 0; cz < chunkCountZ_; cz++) {
+		for (uint32_t cx = 0; cx < chunkCountX_; cx++) {
+			Chunk& chunk = GetChunk(cx, cz);
+			chunk.baseVertex = (cz * chunkCountX_ + cx) * kChunkVertexTotal;
+
+			// 高さ場の行をチャンク内の行へ写す
+			VertexPosNormalUv* dst = vertMap_ + chunk.baseVertex;
+			for (uint32_t lz = 0; lz < kChunkVertexCount; lz++) {
+				const VertexPosNormalUv* src =
+				    &heightfield_->GetVertex(cx * kChunkCells, cz * kChunkCells + lz);
+				std::copy(src, src + kChunkVertexCount, dst + lz * kChunkVertexCount);
+			}
+			RecalculateChunkBounds(cx, cz);
+		}
+	}
+}
+
+void ChunkedTerrain::RecalculateChunkBounds(uint32_t cx, uint32_t cz) {
+	// 書き込み結合メモリの vertMap_ は読まず、高さ場から求める
+	const Vector3& origin = heightfield_->GetVertex(cx * kChunkCells, cz * kChunkCells).pos;
+	Vector3 aabbMin = origin;
+	Vector3 aabbMax = origin;
+	for (uint32_t lz = 0; lz < kChunkVertexCount; lz++) {
+		const VertexPosNormalUv* src =
+		    &heightfield_->GetVertex(cx * kChunkCells, cz * kChunkCells + lz);
+		for (uint32_t lx = 0; lx < kChunkVertexCount; lx++) {
+			const Vector3& pos = src[lx].pos;
+			aabbMin = {
+			    std::min(aabbMin.x, pos.x), std::min(aabbMin.y, pos.y), std::min(aabbMin.z, pos.z)};
+			aabbMax = {
+			    std::max(aabbMax.x, pos.x), std::max(aabbMax.y, pos.y), std::max(aabbMax.z, pos.z)};
+		}
+	}
+	quadtree_.SetChunkBounds(cx, cz, aabbMin, aabbMax);
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Heightfield.h"
+#include "TerrainQuadtree.h"
+#include "Vector3.h"
+#include "ViewProjection.h"
+#include "WorldTransform.h"
+#include <array>
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// チャンク分割地形（四分木でカメラ距離のLODを選び、視錐台外のチャンクを描画しない）
+/// </summary>
+class ChunkedTerrain {
+private: // エイリアス
+	// Microsoft::WRL::を省略
+	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public: // エイリアス
+	// 頂点データ（Terrain と同じレイアウト）
+	using VertexPosNormalUv = Heightfield::VertexPosNormalUv;
+
+public: // 定数
+	// 1チャンクの一辺のマス数
+	static const uint32_t kChunkCells = 64;
+	// 1チャンクの一辺の頂点数（隣と境界の頂点を重複して持つ。16bitインデックスに収まる）
+	static const uint32_t kChunkVertexCount = kChunkCells + 1;
+	// LOD段数（1段毎に頂点間隔を2倍にする）
+	static const uint32_t kLodCount = TerrainQuadtree::kLodCount;
+	// 辺の番号（ビットが立った辺は隣のチャンクが1段粗い）
+	static const uint32_t kEdgeNegativeX = TerrainQuadtree::kEdgeNegativeX;
+	static const uint32_t kEdgePositiveX = TerrainQuadtree::kEdgePositiveX;
+	static const uint32_t kEdgeNegativeZ = TerrainQuadtree::kEdgeNegativeZ;
+	static const uint32_t kEdgePositiveZ = TerrainQuadtree::kEdgePositiveZ;
+	// 辺のつなぎ方の組み合わせ数
+	static const uint32_t kStitchVariantCount = 16;
+	// 既定の LOD1 に切り替える距離
+	static const float kDefaultLodDistance;
+
+public: // サブクラス
+	// 描画統計
+	struct Stats {
+		// チャンク数
+		uint32_t chunkCount = 0;
+		// 描画したチャンク数
+		uint32_t visibleCount = 0;
+		// 描画した三角形数
+		uint32_t triangleCount = 0;
+		// LOD毎の描画したチャンク数
+		std::array<uint32_t, kLodCount> lodChunkCounts = {};
+		// カリングとLOD選択で走査した四分木のノード数
+		uint32_t visitedNodeCount = 0;
+	};
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（頂点数は kChunkCells の倍数 + 1 であること）
+	/// </summary>
+	/// <param name="heightfield">高さ場（所有しない）</param>
+	void Initialize(Heightfield* heightfield);
+
+	/// <summary>
+	/// 高さ場の書き換えた行の範囲だけ頂点バッファへ写す（描画前に呼ぶ）
+	/// </summary>
+	/// <returns>写した頂点数</returns>
+	uint32_t TransferDirtyRows();
+
+	/// <summary>
+	/// 描画（TerrainCommon::PreDraw の後に呼ぶ）
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	/// <param name="textureHadle">テクスチャハンドル</param>
+	void Draw(
+	    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+	    uint32_t textureHadle);
+
+	/// <summary>
+	/// LOD1 に切り替える距離（ローカル座標。以降は距離が2倍になる毎に1段粗くする。
+	/// 隣とのLODの差を1段以内にするため、チャンクの幅より短い値は幅として扱う）
+	/// </summary>
+	void SetLodDistance(float lodDistance) { lodDistance_ = lodDistance; }
+
+	/// <summary>
+	/// 直前の描画統計
+	/// </summary>
+	const Stats& GetStats() const { return stats_; }
+
+	uint32_t GetChunkCountX() const { return chunkCountX_; }
+	uint32_t GetChunkCountZ() const { return chunkCountZ_; }
+
+private: // サブクラス
+	// チャンク（AABBは四分木が持つ）
+	struct Chunk {
+		// 先頭頂点の番号
+		uint32_t baseVertex = 0;
+	};
+
+	// インデックスバッファ内の範囲
+	struct IndexRange {
+		uint32_t start = 0;
+		uint32_t count = 0;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// LOD・辺のつなぎ方毎のインデックス生成（全チャンクで共有する）
+	/// </summary>
+	/// <param name="indices">インデックス配列</param>
+	void BuildIndices(std::vector<uint16_t>& indices);
+
+	/// <summary>
+	/// バッファ生成
+	/// </summary>
+	/// <param name="indices">インデックス配列</param>
+	void CreateBuffers(const std::vector<uint16_t>& indices);
+
+	/// <summary>
+	/// 高さ場からチャンク毎に頂点を書き込み、AABBを求める
+	/// </summary>
+	void WriteVertices();
+
+	/// <summary>
+	/// チャンクのAABBを高さ場から求め直して四分木に設定する
+	/// </summary>
+	/// <param name="cx">横方向番号</param>
+	/// <param name="cz">縦方向番号</param>
+	void RecalculateChunkBounds(uint32_t cx, uint32_t cz);
+
+	Chunk& GetChunk(uint32_t cx, uint32_t cz) { return chunks_[size_t(cz) * chunkCountX_ + cx]; }
+
+private: // メンバ変数
+	// 高さ場
+	Heightfield* heightfield_ = nullptr;
+	// 横方向チャンク数
+	uint32_t chunkCountX_ = 0;
+	// 縦方向チャンク数
+	uint32_t chunkCountZ_ = 0;
+	// チャンク配列（行優先）
+	std::vector<Chunk> chunks_;
+	// チャンクのAABBの四分木
+	TerrainQuadtree quadtree_;
+	// 直前の描画で見えたチャンク（毎フレーム確保し直さないよう持っておく）
+	std::vector<TerrainQuadtree::VisibleChunk> visibleChunks_;
+	// LOD・辺のつなぎ方毎のインデックス範囲
+	std::array<std::array<IndexRange, kStitchVariantCount>, kLodCount> indexRanges_ = {};
+	// 頂点バッファ
+	ComPtr<ID3D12Resource> vertBuff_;
+	// インデックスバッファ
+	ComPtr<ID3D12Resource> indexBuff_;
+	// 頂点バッファビュー
+	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
+	// インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW ibView_ = {};
+	// 頂点バッファマップ（チャンク毎に kChunkVertexCount x kChunkVertexCount 頂点）
+	VertexPosNormalUv* vertMap_ = nullptr;
+	// LOD1 に切り替える距離
+	float lodDistance_ = kDefaultLodDistance;
+	// 描画統計
+	Stats stats_;
+};
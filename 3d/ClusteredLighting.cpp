@@ -0,0 +1,420 @@
+#include "ClusteredLighting.h"
+#include "DirectXCommon.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <d3dx12.h>
+#include <immintrin.h>
+
+namespace {
+
+// 区画分けを複数スレッドに分けるライト数の下限
+const size_t kParallelThreshold = 64;
+// SIMDの幅
+const uint32_t kLaneCount = 4;
+// 区画の範囲の余りのレーンを埋める値（どの球とも重ならない）
+const float kOutside = 3.0e38f;
+
+// 座標変換（行ベクトル × 行列、w = 1）
+Vector3 TransformPoint(const Vector3& v, const Matrix4x4& m) {
+	return {
+	    v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0],
+	    v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1],
+	    v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2]};
+}
+
+// 区間 [min, max] から値までの距離（内側なら0）
+float DistanceOutside(float value, float min, float max) {
+	return std::max(std::max(min - value, value - max), 0.0f);
+}
+
+} // namespace
+
+float ClusteredLighting::CalculateRange(const Vector3& atten, float intensity) {
+	if (intensity <= 0.0f) {
+		return 0.0f;
+	}
+	// 減衰の逆数がこの値になる距離を求める
+	float target = intensity / kAttenuationCutoff - atten.x;
+	if (target <= 0.0f) {
+		return 0.0f;
+	}
+	float range = kMaxLightRange;
+	if (atten.z > 0.0f) {
+		range = (-atten.y + std::sqrt(atten.y * atten.y + 4.0f * atten.z * target)) /
+		        (2.0f * atten.z);
+	} else if (atten.y > 0.0f) {
+		range = target / atten.y;
+	}
+	return std::min(range, kMaxLightRange);
+}
+
+void ClusteredLighting::Initialize(int windowWidth, int windowHeight) {
+	screenWidth_ = float(windowWidth);
+	screenHeight_ = float(windowHeight);
+	slices_.resize(kClusterCountZ);
+	clusterCounts_.resize(kClusterCount);
+	clusterLights_.resize(size_t(kClusterCount) * kMaxLightsPerCluster);
+	headers_.resize(kClusterCount);
+}
+
+void ClusteredLighting::Build(const ViewProjection& viewProjection) {
+	assert(!slices_.empty());
+	stats_ = Stats();
+
+	GatherLights(viewProjection.matView);
+	CalculateSlices(viewProjection.matProjection);
+	std::fill(clusterCounts_.begin(), clusterCounts_.end(), 0u);
+
+	// 深度スライスを帯に分けて並列に登録する（区画は帯毎に別なので書き込みは重ならない）
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	uint32_t threadCount = threadCount_;
+	if (threadCount == 0) {
+		threadCount = threadPool->GetThreadCount();
+	}
+	if (spheres_.radius.size() < kParallelThreshold) {
+		threadCount = 1;
+	}
+	threadCount = std::min(threadCount, kClusterCountZ);
+	std::vector<uint32_t> overflowCounts(threadCount);
+	threadPool->ParallelFor(threadCount, kClusterCountZ, [&](size_t begin, size_t end, uint32_t t) {
+		overflowCounts[t] = BinSlices(uint32_t(begin), uint32_t(end));
+	});
+	for (uint32_t overflowCount : overflowCounts) {
+		stats_.overflowCount += overflowCount;
+	}
+
+	Compact();
+}
+
+void ClusteredLighting::Update(const ViewProjection& viewProjection) {
+	Build(viewProjection);
+
+	// 前フレームの描画は終わっているので、変わった範囲だけをそのまま書き換えられる
+	Upload(
+	    BufferType::kClusterHeaders, headers_.data(), sizeof(ClusterHeader) * headers_.size());
+	Upload(BufferType::kLightIndices, indices_.data(), sizeof(uint32_t) * indices_.size());
+	Upload(
+	    BufferType::kPointLights, pointLightData_.data(),
+	    sizeof(PointLightData) * pointLightData_.size());
+	Upload(
+	    BufferType::kSpotLights, spotLightData_.data(),
+	    sizeof(SpotLightData) * spotLightData_.size());
+	Upload(
+	    BufferType::kCircleShadows, circleShadowData_.data(),
+	    sizeof(CircleShadowData) * circleShadowData_.size());
+}
+
+void ClusteredLighting::SetGraphicsCommand(
+    ID3D12GraphicsCommandList* commandList, UINT rootParameterIndex) {
+	assert(buffers_[0].resource);
+	commandList->SetGraphicsRoot32BitConstants(
+	    rootParameterIndex, sizeof(ClusterConstants) / sizeof(uint32_t), &constants_, 0);
+	for (UINT i = 0; i < buffers_.size(); i++) {
+		commandList->SetGraphicsRootShaderResourceView(
+		    rootParameterIndex + 1 + i, buffers_[i].resource->GetGPUVirtualAddress());
+	}
+}
+
+void ClusteredLighting::GatherLights(const Matrix4x4& view) {
+	pointLightData_.clear();
+	spotLightData_.clear();
+	circleShadowData_.clear();
+	spheres_.x.clear();
+	spheres_.y.clear();
+	spheres_.z.clear();
+	spheres_.radius.clear();
+	auto addSphere = [&](const Vector3& center, float radius) {
+		Vector3 viewCenter = TransformPoint(center, view);
+		spheres_.x.push_back(viewCenter.x);
+		spheres_.y.push_back(viewCenter.y);
+		spheres_.z.push_back(viewCenter.z);
+		spheres_.radius.push_back(radius);
+	};
+
+	// 点光源（届く範囲の球）
+	for (const PointLight& light : pointLights_) {
+		if (!light.IsActive()) {
+			continue;
+		}
+		const Vector3& color = light.GetLightColor();
+		float range =
+		    CalculateRange(light.GetLightAtten(), std::max({color.x, color.y, color.z}));
+		pointLightData_.push_back(
+		    {light.GetLightPos(), range, color, light.GetLightAtten()});
+		addSphere(light.GetLightPos(), range);
+	}
+
+	// スポットライト（届く範囲の円錐を囲む球）
+	for (const SpotLight& light : spotLights_) {
+		if (!light.IsActive()) {
+			continue;
+		}
+		const Vector3& color = light.GetLightColor();
+		const Vector3& dir = light.GetLightDir();
+		const Vector2& angleCos = light.GetLightFactorAngleCos();
+		float range =
+		    CalculateRange(light.GetLightAtten(), std::max({color.x, color.y, color.z}));
+		spotLightData_.push_back(
+		    {{-dir.x, -dir.y, -dir.z}, range, light.GetLightPos(), color, light.GetLightAtten(),
+		     angleCos});
+
+		float outerCos = std::min(angleCos.x, angleCos.y);
+		Vector3 center = light.GetLightPos();
+		float radius = range;
+		if (outerCos > 0.0f) {
+			float offset = 0.0f;
+			if (outerCos < std::sqrt(0.5f)) {
+				// 45度より広い円錐は底面の円を囲む
+				offset = range * outerCos;
+				radius = range * std::sqrt(1.0f - outerCos * outerCos);
+			} else {
+				// 狭い円錐は頂点と底面の円を通る球
+				offset = range / (2.0f * outerCos);
+				radius = offset;
+			}
+			center = {center.x + dir.x * offset, center.y + dir.y * offset,
+			          center.z + dir.z * offset};
+		}
+		addSphere(center, radius);
+	}
+
+	// 丸影（キャスターから投影方向へ届く範囲の円錐台を囲む球）
+	for (const CircleShadow& shadow : circleShadows_) {
+		if (!shadow.IsActive()) {
+			continue;
+		}
+		const Vector3& dir = shadow.GetDir();
+		const Vector3& casterPos = shadow.GetCasterPos();
+		const Vector2& angleCos = shadow.GetFactorAngleCos();
+		float range = CalculateRange(shadow.GetAtten(), 1.0f);
+		circleShadowData_.push_back(
+		    {{-dir.x, -dir.y, -dir.z}, range, casterPos, shadow.GetDistanceCasterLight(),
+		     shadow.GetAtten(), angleCos});
+
+		float outerCos = std::min(angleCos.x, angleCos.y);
+		float radius = kMaxLightRange;
+		if (outerCos > 0.0f) {
+			float tangent = std::sqrt(1.0f - outerCos * outerCos) / outerCos;
+			float farRadius = tangent * (shadow.GetDistanceCasterLight() + range);
+			radius = std::min(
+			    std::sqrt(range * range * 0.25f + farRadius * farRadius), kMaxLightRange);
+		}
+		float offset = range * 0.5f;
+		addSphere(
+		    {casterPos.x + dir.x * offset, casterPos.y + dir.y * offset,
+		     casterPos.z + dir.z * offset},
+		    radius);
+	}
+	stats_.lightCount = static_cast<uint32_t>(spheres_.radius.size());
+}
+
+void ClusteredLighting::CalculateSlices(const Matrix4x4& projection) {
+	// 透視投影行列から視野と深度限界を取り出す
+	float scaleX = projection.m[0][0];
+	float scaleY = projection.m[1][1];
+	nearZ_ = -projection.m[3][2] / projection.m[2][2];
+	farZ_ = projection.m[2][2] * nearZ_ / (projection.m[2][2] - 1.0f);
+	if (!(farZ_ > nearZ_)) {
+		farZ_ = kMaxLightRange;
+	}
+
+	// 深度は指数的に分ける（手前ほど細かい）
+	float logRatio = std::log(farZ_ / nearZ_);
+	constants_.tileScaleX = float(kClusterCountX) / screenWidth_;
+	constants_.tileScaleY = float(kClusterCountY) / screenHeight_;
+	constants_.sliceScale = float(kClusterCountZ) / logRatio;
+	constants_.sliceBias = -float(kClusterCountZ) * std::log(nearZ_) / logRatio;
+
+	for (uint32_t k = 0; k < kClusterCountZ; k++) {
+		Slice& slice = slices_[k];
+		slice.minZ = k == 0 ? nearZ_ : slices_[k - 1].maxZ;
+		slice.maxZ = k + 1 == kClusterCountZ
+		                 ? farZ_
+		                 : nearZ_ * std::exp(logRatio * float(k + 1) / float(kClusterCountZ));
+		// 区画の左右・上下の面は視点を通るので、スライスの手前と奥で広い方を取る
+		for (uint32_t i = 0; i < _countof(slice.minX); i++) {
+			if (i >= kClusterCountX) {
+				slice.minX[i] = kOutside;
+				slice.maxX[i] = -kOutside;
+				continue;
+			}
+			float left = -1.0f + 2.0f * float(i) / float(kClusterCountX);
+			float right = -1.0f + 2.0f * float(i + 1) / float(kClusterCountX);
+			slice.minX[i] = std::min(left * slice.minZ, left * slice.maxZ) / scaleX;
+			slice.maxX[i] = std::max(right * slice.minZ, right * slice.maxZ) / scaleX;
+		}
+		// 区画Yは画面の上から数える
+		for (uint32_t j = 0; j < kClusterCountY; j++) {
+			float top = 1.0f - 2.0f * float(j) / float(kClusterCountY);
+			float bottom = 1.0f - 2.0f * float(j + 1) / float(kClusterCountY);
+			slice.minY[j] = std::min(bottom * slice.minZ, bottom * slice.maxZ) / scaleY;
+			slice.maxY[j] = std::max(top * slice.minZ, top * slice.maxZ) / scaleY;
+		}
+	}
+}
+
+uint32_t ClusteredLighting::BinSlices(uint32_t first, uint32_t last) {
+	uint32_t overflowCount = 0;
+	uint32_t lightCount = static_cast<uint32_t>(spheres_.radius.size());
+	for (uint32_t l = 0; l < lightCount; l++) {
+		float cx = spheres_.x[l];
+		float cy = spheres_.y[l];
+		float cz = spheres_.z[l];
+		float radius = spheres_.radius[l];
+		float radiusSq = radius * radius;
+
+		for (uint32_t k = first; k < last; k++) {
+			const Slice& slice = slices_[k];
+			if (cz + radius < slice.minZ || cz - radius > slice.maxZ) {
+				continue;
+			}
+			float dz = DistanceOutside(cz, slice.minZ, slice.maxZ);
+			float restZ = radiusSq - dz * dz;
+			for (uint32_t j = 0; j < kClusterCountY; j++) {
+				float dy = DistanceOutside(cy, slice.minY[j], slice.maxY[j]);
+				// 残りをX方向の距離の2乗と比べる（SIMDでも同じ式）
+				float rest = restZ - dy * dy;
+				if (rest < 0.0f) {
+					continue;
+				}
+				uint32_t rowBase = (k * kClusterCountY + j) * kClusterCountX;
+				auto add = [&](uint32_t i) {
+					uint32_t cluster = rowBase + i;
+					uint32_t& count = clusterCounts_[cluster];
+					if (count < kMaxLightsPerCluster) {
+						clusterLights_[size_t(cluster) * kMaxLightsPerCluster + count] = l;
+						count++;
+					} else {
+						overflowCount++;
+					}
+				};
+
+				if (useSimd_) {
+					// 区画X方向を4つずつ球と比べる
+					__m128 center = _mm_set1_ps(cx);
+					__m128 restLane = _mm_set1_ps(rest);
+					for (uint32_t i = 0; i < kClusterCountX; i += kLaneCount) {
+						__m128 dx = _mm_max_ps(
+						    _mm_max_ps(
+						        _mm_sub_ps(_mm_load_ps(&slice.minX[i]), center),
+						        _mm_sub_ps(center, _mm_load_ps(&slice.maxX[i]))),
+						    _mm_setzero_ps());
+						int mask = _mm_movemask_ps(_mm_cmple_ps(_mm_mul_ps(dx, dx), restLane));
+						while (mask) {
+							uint32_t lane = std::countr_zero(uint32_t(mask));
+							add(i + lane);
+							mask &= mask - 1;
+						}
+					}
+					continue;
+				}
+				for (uint32_t i = 0; i < kClusterCountX; i++) {
+					float dx = DistanceOutside(cx, slice.minX[i], slice.maxX[i]);
+					if (dx * dx <= rest) {
+						add(i);
+					}
+				}
+			}
+		}
+	}
+	return overflowCount;
+}
+
+void ClusteredLighting::Compact() {
+	uint32_t pointCount = static_cast<uint32_t>(pointLightData_.size());
+	uint32_t spotEnd = pointCount + static_cast<uint32_t>(spotLightData_.size());
+	indices_.clear();
+
+	// 一覧は番号の昇順なので、種類の境目で数を分けて種類毎の番号に直す
+	std::vector<bool> touched(spheres_.radius.size(), false);
+	for (uint32_t c = 0; c < kClusterCount; c++) {
+		ClusterHeader& header = headers_[c];
+		header = {static_cast<uint32_t>(indices_.size()), 0, 0, 0};
+		const uint32_t* lights = &clusterLights_[size_t(c) * kMaxLightsPerCluster];
+		for (uint32_t n = 0; n < clusterCounts_[c]; n++) {
+			uint32_t light = lights[n];
+			touched[light] = true;
+			if (light < pointCount) {
+				indices_.push_back(light);
+				header.pointCount++;
+			} else if (light < spotEnd) {
+				indices_.push_back(light - pointCount);
+				header.spotCount++;
+			} else {
+				indices_.push_back(light - spotEnd);
+				header.shadowCount++;
+			}
+		}
+		stats_.maxClusterLightCount = std::max(stats_.maxClusterLightCount, clusterCounts_[c]);
+	}
+	stats_.indexCount = static_cast<uint32_t>(indices_.size());
+	stats_.culledLightCount =
+	    static_cast<uint32_t>(std::count(touched.begin(), touched.end(), false));
+}
+
+void ClusteredLighting::Upload(BufferType type, const void* data, size_t size) {
+	[[maybe_unused]] HRESULT result = S_FALSE;
+	UploadBuffer& buffer = buffers_[static_cast<size_t>(type)];
+
+	// 足りなければ倍々に広げて作り直す（空でもアドレスを渡せるよう最低限は作る）
+	if (!buffer.resource || buffer.capacity < size) {
+		size_t newCapacity = std::max<size_t>(buffer.capacity, 256);
+		while (newCapacity < size) {
+			newCapacity *= 2;
+		}
+		ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+		CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(newCapacity);
+		buffer.resource.Reset();
+		result = device->CreateCommittedResource(
+		    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ,
+		    nullptr, IID_PPV_ARGS(&buffer.resource));
+		assert(SUCCEEDED(result));
+		result = buffer.resource->Map(0, nullptr, (void**)&buffer.map);
+		assert(SUCCEEDED(result));
+		buffer.capacity = newCapacity;
+		// 新しいバッファには何も書かれていない
+		buffer.contents.clear();
+	}
+
+	// 前回の内容と重なる範囲はブロック毎に比べ、変わったブロックが続く範囲をまとめて書き込む
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	size_t compareSize = uploadChangedOnly_ ? std::min(size, buffer.contents.size()) : 0;
+	buffer.contents.resize(size);
+	auto isChanged = [&](size_t offset) {
+		size_t blockSize = std::min(kUploadBlockSize, compareSize - offset);
+		return std::memcmp(bytes + offset, &buffer.contents[offset], blockSize) != 0;
+	};
+	auto write = [&](size_t offset, size_t rangeSize) {
+		std::memcpy(buffer.map + offset, bytes + offset, rangeSize);
+		std::memcpy(&buffer.contents[offset], bytes + offset, rangeSize);
+		stats_.bufferUploadBytes[static_cast<size_t>(type)] += rangeSize;
+		stats_.uploadBytes += rangeSize;
+		stats_.uploadRangeCount++;
+	};
+	size_t writtenSize = 0;
+	size_t offset = 0;
+	while (offset < compareSize) {
+		if (!isChanged(offset)) {
+			offset += kUploadBlockSize;
+			continue;
+		}
+		size_t first = offset;
+		do {
+			offset += kUploadBlockSize;
+		} while (offset < compareSize && isChanged(offset));
+		offset = std::min(offset, compareSize);
+		write(first, offset - first);
+		writtenSize += offset - first;
+	}
+	// 前回より後ろは全て書き込む
+	if (compareSize < size) {
+		write(compareSize, size - compareSize);
+		writtenSize += size - compareSize;
+	}
+	stats_.skippedBytes += size - writtenSize;
+}
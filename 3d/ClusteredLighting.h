@@ -0,0 +1,283 @@
+#pragma once
+
+#include "CircleShadow.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "ViewProjection.h"
+#include <array>
+#include <cstdint>
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// クラスター化ライティング（視錐台を画面タイル×深度スライスの区画に分け、
+/// 区画毎に届くライトの一覧をCPUで毎フレーム作る。ライトの数に上限は無い）
+/// </summary>
+class ClusteredLighting {
+private: // エイリアス
+	// Microsoft::WRL::を省略
+	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public: // 列挙子
+	/// <summary>
+	/// 構造化バッファ（SetGraphicsCommand でこの順に続くルートパラメータにセットする）
+	/// </summary>
+	enum class BufferType {
+		kClusterHeaders, // 区画毎の一覧の位置
+		kLightIndices,   // ライト番号
+		kPointLights,    // 点光源
+		kSpotLights,     // スポットライト
+		kCircleShadows,  // 丸影
+
+		kCountOfBufferType, // 種類数
+	};
+
+public: // 定数
+	// 区画数（画面横・画面縦・深度）
+	static constexpr uint32_t kClusterCountX = 16;
+	static constexpr uint32_t kClusterCountY = 9;
+	static constexpr uint32_t kClusterCountZ = 24;
+	static constexpr uint32_t kClusterCount = kClusterCountX * kClusterCountY * kClusterCountZ;
+	// 1区画に入れられるライト数（超えた分は捨てて統計に数える）
+	static constexpr uint32_t kMaxLightsPerCluster = 128;
+	// 減衰がこれを下回る距離をライトの届く範囲とする（シェーダーも範囲の外は足さない）
+	static constexpr float kAttenuationCutoff = 1.0f / 256.0f;
+	// 減衰しないライトの届く範囲
+	static constexpr float kMaxLightRange = 1.0e6f;
+	// 前回の転送と比べる単位（バイト。書き込み結合の単位に合わせる）
+	static constexpr size_t kUploadBlockSize = 64;
+
+public: // サブクラス
+	// 点光源（構造化バッファ用。シェーダーの ClusterPointLight と同じ並び）
+	struct PointLightData {
+		Vector3 lightpos;   // ライト座標
+		float range;        // 届く範囲
+		Vector3 lightcolor; // ライトの色(RGB)
+		Vector3 lightatten; // ライト距離減衰係数
+	};
+
+	// スポットライト（構造化バッファ用）
+	struct SpotLightData {
+		Vector3 lightv;              // ライトの光線方向の逆ベクトル（単位ベクトル）
+		float range;                 // 届く範囲
+		Vector3 lightpos;            // ライト座標
+		Vector3 lightcolor;          // ライトの色(RGB)
+		Vector3 lightatten;          // ライト距離減衰係数
+		Vector2 lightfactoranglecos; // ライト減衰角度のコサイン
+	};
+
+	// 丸影（構造化バッファ用）
+	struct CircleShadowData {
+		Vector3 dir;               // 投影方向の逆ベクトル（単位ベクトル）
+		float range;               // 届く範囲（キャスターからの距離）
+		Vector3 casterPos;         // キャスター座標
+		float distanceCasterLight; // キャスターとライトの距離
+		Vector3 atten;             // 距離減衰係数
+		Vector2 factorAngleCos;    // 減衰角度のコサイン
+	};
+
+	// 区画毎のライト一覧の位置（点光源・スポットライト・丸影の順に並ぶ）
+	struct ClusterHeader {
+		uint32_t offset;      // ライト番号配列の先頭
+		uint32_t pointCount;  // 点光源の数
+		uint32_t spotCount;   // スポットライトの数
+		uint32_t shadowCount; // 丸影の数
+	};
+
+	// 区画の求め方（ルート定数。シェーダーの ClusterConstants と同じ並び）
+	struct ClusterConstants {
+		float tileScaleX; // ピクセル座標から区画番号Xへの倍率
+		float tileScaleY; // ピクセル座標から区画番号Yへの倍率
+		float sliceScale; // log(ビュー空間Z) から区画番号Zへの倍率
+		float sliceBias;  // log(ビュー空間Z) から区画番号Zへのずらし
+	};
+
+	// 統計
+	struct Stats {
+		// 区画分けした（有効な）ライト数
+		uint32_t lightCount = 0;
+		// 視錐台の外で捨てたライト数
+		uint32_t culledLightCount = 0;
+		// 区画に登録したライト番号の数
+		uint32_t indexCount = 0;
+		// 1区画の最大ライト数
+		uint32_t maxClusterLightCount = 0;
+		// 区画が一杯で捨てた登録数
+		uint32_t overflowCount = 0;
+		// 転送したバイト数（前回から変わった範囲だけ）
+		size_t uploadBytes = 0;
+		// 構造化バッファ毎の転送したバイト数
+		std::array<size_t, static_cast<size_t>(BufferType::kCountOfBufferType)>
+		    bufferUploadBytes = {};
+		// 変わっていないので転送しなかったバイト数
+		size_t skippedBytes = 0;
+		// 書き込んだ範囲の数
+		uint32_t uploadRangeCount = 0;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 減衰係数から届く範囲を求める（a0 + a1*d + a2*d^2 = intensity / kAttenuationCutoff）
+	/// </summary>
+	/// <param name="atten">距離減衰係数</param>
+	/// <param name="intensity">最大の明るさ</param>
+	/// <returns>届く範囲</returns>
+	static float CalculateRange(const Vector3& atten, float intensity);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="windowWidth">画面幅</param>
+	/// <param name="windowHeight">画面高さ</param>
+	void Initialize(int windowWidth, int windowHeight);
+
+	/// <summary>
+	/// 区画分け（CPUだけで行う。GPUへは転送しない。matView と matProjection を使う）
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Build(const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 更新（区画分けしてGPUへ転送する。前フレームの描画が終わってから、描画前に1回呼ぶ。
+	/// 前回の転送から変わった範囲だけを書き込むので、動かないライトは転送しない）
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Update(const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 描画コマンドのセット（定数に続く5つのルートパラメータに構造化バッファをセットする）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="rootParameterIndex">定数のルートパラメータ番号</param>
+	void SetGraphicsCommand(ID3D12GraphicsCommandList* commandList, UINT rootParameterIndex);
+
+	// ライト（有効なものだけ区画分けする）
+	std::vector<PointLight>& GetPointLights() { return pointLights_; }
+	std::vector<SpotLight>& GetSpotLights() { return spotLights_; }
+	std::vector<CircleShadow>& GetCircleShadows() { return circleShadows_; }
+
+	// 区画分けの結果
+	const std::vector<ClusterHeader>& GetClusterHeaders() const { return headers_; }
+	const std::vector<uint32_t>& GetLightIndices() const { return indices_; }
+
+	/// <summary>
+	/// SIMDを使うか（結果は同じ）
+	/// </summary>
+	void SetUseSimd(bool useSimd) { useSimd_ = useSimd; }
+
+	/// <summary>
+	/// スレッド数（0ならハードウェアスレッド数。結果はスレッド数によらない）
+	/// </summary>
+	void SetThreadCount(uint32_t threadCount) { threadCount_ = threadCount; }
+
+	/// <summary>
+	/// 前回の転送から変わった範囲だけを書き込むか（false なら毎回全て書き込む）
+	/// </summary>
+	void SetUploadChangedOnly(bool uploadChangedOnly) { uploadChangedOnly_ = uploadChangedOnly; }
+
+	const Stats& GetStats() const { return stats_; }
+
+private: // サブクラス
+	// ビュー空間の境界球（SoA）
+	struct Spheres {
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<float> radius;
+	};
+
+	// 深度スライス毎の区画の範囲（ビュー空間）
+	struct Slice {
+		float minZ;
+		float maxZ;
+		// 区画X毎の範囲（4の倍数個に切り上げ、余りは届かない値で埋める）
+		alignas(16) float minX[(kClusterCountX + 3) & ~3u];
+		alignas(16) float maxX[(kClusterCountX + 3) & ~3u];
+		float minY[kClusterCountY];
+		float maxY[kClusterCountY];
+	};
+
+	// 構造化バッファ（アップロードヒープに置き、マップしたままにする）
+	struct UploadBuffer {
+		ComPtr<ID3D12Resource> resource;
+		uint8_t* map = nullptr;
+		// 容量（バイト）
+		size_t capacity = 0;
+		// 書き込み済みの内容（次の転送で変わった範囲を探すための写し）
+		std::vector<uint8_t> contents;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 有効なライトを構造化バッファ用に詰め、ビュー空間の境界球を求める
+	/// </summary>
+	/// <param name="view">ビュー行列</param>
+	void GatherLights(const Matrix4x4& view);
+
+	/// <summary>
+	/// 深度スライス毎の区画の範囲を求める
+	/// </summary>
+	/// <param name="projection">射影行列</param>
+	void CalculateSlices(const Matrix4x4& projection);
+
+	/// <summary>
+	/// 深度スライス first から last の手前までの区画にライトを登録する
+	/// </summary>
+	/// <returns>区画が一杯で捨てた登録数</returns>
+	uint32_t BinSlices(uint32_t first, uint32_t last);
+
+	/// <summary>
+	/// 区画毎の一覧を1本のライト番号配列に詰める
+	/// </summary>
+	void Compact();
+
+	/// <summary>
+	/// 構造化バッファを必要な大きさで用意し、前回の内容から変わったブロックが続く範囲だけ書き込む
+	/// </summary>
+	/// <param name="type">構造化バッファの種類</param>
+	/// <param name="data">書き込むデータ</param>
+	/// <param name="size">書き込むバイト数</param>
+	void Upload(BufferType type, const void* data, size_t size);
+
+private: // メンバ変数
+	// ライト
+	std::vector<PointLight> pointLights_;
+	std::vector<SpotLight> spotLights_;
+	std::vector<CircleShadow> circleShadows_;
+	// 構造化バッファ用に詰めたライト
+	std::vector<PointLightData> pointLightData_;
+	std::vector<SpotLightData> spotLightData_;
+	std::vector<CircleShadowData> circleShadowData_;
+	// 境界球（点光源・スポットライト・丸影の順）
+	Spheres spheres_;
+	// 深度スライス
+	std::vector<Slice> slices_;
+	// 手前・奥の深度限界
+	float nearZ_ = 0.0f;
+	float farZ_ = 0.0f;
+	// 区画毎のライト数と一覧（区画毎に kMaxLightsPerCluster 個分の場所を持つ）
+	std::vector<uint32_t> clusterCounts_;
+	std::vector<uint32_t> clusterLights_;
+	// 区画毎の一覧の位置と、詰めたライト番号（種類毎の番号）
+	std::vector<ClusterHeader> headers_;
+	std::vector<uint32_t> indices_;
+	// 区画の求め方
+	ClusterConstants constants_ = {};
+	// 画面の幅・高さ
+	float screenWidth_ = 0.0f;
+	float screenHeight_ = 0.0f;
+
+	// 構造化バッファ
+	std::array<UploadBuffer, static_cast<size_t>(BufferType::kCountOfBufferType)> buffers_;
+
+	// SIMDを使うか
+	bool useSimd_ = true;
+	// スレッド数
+	uint32_t threadCount_ = 0;
+	// 変わった範囲だけを書き込むか
+	bool uploadChangedOnly_ = true;
+	// 統計
+	Stats stats_;
+};
@@ -0,0 +1,701 @@
+#include "Heightfield.h"
+#include "MathUtilityForText.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <immintrin.h>
+#include <intrin.h>
+#include <limits>
+#include <numbers>
+
+// AVX2 の Perlin と1サンプルずつの Perlin を同じ結果にするため、積和を融合させない
+// （GCC / Clang はビルド設定の -ffp-contract=off で同じ指定をする）
+#ifdef _MSC_VER
+#pragma fp_contract(off)
+#endif
+
+namespace {
+
+// パーリンノイズの値域 [-√2/2, √2/2] を [-0.5, 0.5] に広げる係数
+const float kPerlinScale = 0.70710678f;
+
+// 格子の番号を勾配配列の範囲に収める（右・奥の格子点も参照するので2つ手前まで）
+int32_t ClampCell(int32_t index, uint32_t count) {
+	return std::clamp(index, 0, int32_t(count) - 2);
+}
+
+// ピラミッドのブロック境界で当たりを取りこぼさないよう広げる量（マス単位）
+const float kClipMargin = 1.0e-3f;
+
+Vector3 Cross(const Vector3& v1, const Vector3& v2) {
+	return {v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x};
+}
+
+float Dot(const Vector3& v1, const Vector3& v2) { return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+
+// 線分をXZの矩形 [x0, x1] x [z0, z1] に切り詰める
+bool ClipRay(
+    const Heightfield::Ray& ray, float x0, float z0, float x1, float z1, float& tMin,
+    float& tMax) {
+	auto clipAxis = [&](float origin, float delta, float lo, float hi) {
+		if (delta == 0.0f) {
+			return lo <= origin && origin <= hi;
+		}
+		float t0 = (lo - origin) / delta;
+		float t1 = (hi - origin) / delta;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		tMin = std::max(tMin, t0);
+		tMax = std::min(tMax, t1);
+		return tMin <= tMax;
+	};
+	return clipAxis(ray.origin.x, ray.delta.x, x0, x1) &&
+	       clipAxis(ray.origin.z, ray.delta.z, z0, z1);
+}
+
+// 三角形とのレイキャスト（Moller-Trumbore。両面）
+bool IntersectTriangle(
+    const Heightfield::Ray& ray, const Vector3& p0, const Vector3& p1, const Vector3& p2,
+    float& t) {
+	Vector3 edge1 = p1 - p0;
+	Vector3 edge2 = p2 - p0;
+	Vector3 p = Cross(ray.delta, edge2);
+	float det = Dot(edge1, p);
+	if (std::abs(det) < 1.0e-12f) {
+		return false;
+	}
+	float invDet = 1.0f / det;
+	Vector3 s = ray.origin - p0;
+	float u = Dot(s, p) * invDet;
+	if (u < 0.0f || u > 1.0f) {
+		return false;
+	}
+	Vector3 q = Cross(s, edge1);
+	float v = Dot(ray.delta, q) * invDet;
+	if (v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+	t = Dot(edge2, q) * invDet;
+	return 0.0f <= t && t <= 1.0f;
+}
+
+} // namespace
+
+bool Heightfield::IsAvx2Supported() {
+	static const bool supported = [] {
+		int info[4] = {};
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		// AVX と OSXSAVE
+		__cpuid(info, 1);
+		const int kOsxsave = 1 << 27;
+		const int kAvx = 1 << 28;
+		if ((info[2] & (kOsxsave | kAvx)) != (kOsxsave | kAvx)) {
+			return false;
+		}
+		// OSがYMMレジスタを退避するか
+		if ((_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+		// AVX2
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+	return supported;
+}
+
+void Heightfield::Initialize(
+    float modelWidth, float modelDepth, float modelHeight, uint32_t vertexCountHorizontal,
+    uint32_t vertexCountVertical) {
+	assert(vertexCountHorizontal >= 2 && vertexCountVertical >= 2);
+
+	modelWidth_ = modelWidth;
+	modelDepth_ = modelDepth;
+	modelHeight_ = modelHeight;
+	vertexCountHorizontal_ = vertexCountHorizontal;
+	vertexCountVertical_ = vertexCountVertical;
+
+	// 中心を原点とした平らな格子（行の帯毎に並列）
+	vertices_.resize(size_t(vertexCountHorizontal_) * vertexCountVertical_);
+	ParallelRows(vertexCountVertical_, [this](uint32_t beginRow, uint32_t endRow) {
+		for (uint32_t z = beginRow; z < endRow; z++) {
+			float v = float(z) / float(vertexCountVertical_ - 1);
+			VertexPosNormalUv* row = &vertices_[size_t(z) * vertexCountHorizontal_];
+			for (uint32_t x = 0; x < vertexCountHorizontal_; x++) {
+				float u = float(x) / float(vertexCountHorizontal_ - 1);
+				row[x].pos = {(u - 0.5f) * modelWidth_, 0.0f, (v - 0.5f) * modelDepth_};
+				row[x].normal = {0.0f, 1.0f, 0.0f};
+				row[x].uv = {u, v};
+			}
+		}
+	});
+
+	// 1マス2枚の三角形（上から見て時計回り）。マスの行毎の書き込み位置は決まっているので並列に書く
+	indices_.resize(size_t(vertexCountHorizontal_ - 1) * (vertexCountVertical_ - 1) * 6);
+	ParallelRows(vertexCountVertical_ - 1, [this](uint32_t beginRow, uint32_t endRow) {
+		uint32_t* index = &indices_[size_t(beginRow) * (vertexCountHorizontal_ - 1) * 6];
+		for (uint32_t z = beginRow; z < endRow; z++) {
+			for (uint32_t x = 0; x + 1 < vertexCountHorizontal_; x++) {
+				uint32_t v0 = z * vertexCountHorizontal_ + x;
+				uint32_t v1 = v0 + vertexCountHorizontal_;
+				*index++ = v0;
+				*index++ = v1;
+				*index++ = v0 + 1;
+				*index++ = v1;
+				*index++ = v1 + 1;
+				*index++ = v0 + 1;
+			}
+		}
+	});
+
+	// 全体を書き換えたものとする
+	dirtyRanges_.assign(vertexCountVertical_, DirtyRange());
+	dirtyRowBegin_ = 0;
+	dirtyRowEnd_ = 0;
+	MarkDirty(0, 0, vertexCountHorizontal_, vertexCountVertical_);
+}
+
+void Heightfield::DeformRandom(uint32_t gridSize) {
+	assert(gridSize > 0);
+
+	// 最後の頂点の右・奥の格子点まで用意する
+	GenerateGradients(
+	    (vertexCountHorizontal_ - 1) / gridSize + 2, (vertexCountVertical_ - 1) / gridSize + 2);
+
+	// 1行ずつまとめて評価して高さにする（行の帯毎に並列）
+	float step = 1.0f / float(gridSize);
+	ParallelRows(vertexCountVertical_, [this, step](uint32_t beginRow, uint32_t endRow) {
+		std::vector<float> noise(vertexCountHorizontal_);
+		for (uint32_t z = beginRow; z < endRow; z++) {
+			PerlinRow(0.0f, step, float(z) * step, vertexCountHorizontal_, noise.data());
+			VertexPosNormalUv* row = &vertices_[size_t(z) * vertexCountHorizontal_];
+			for (uint32_t x = 0; x < vertexCountHorizontal_; x++) {
+				row[x].pos.y = noise[x] * modelHeight_;
+			}
+		}
+	});
+	// 法線は隣の帯の高さも読むので、全ての高さが揃ってから帯毎に求める
+	ParallelRows(vertexCountVertical_, [this](uint32_t beginRow, uint32_t endRow) {
+		CalculateNormals(0, beginRow, vertexCountHorizontal_, endRow);
+	});
+	MarkDirty(0, 0, vertexCountHorizontal_, vertexCountVertical_);
+	UpdateHeightPyramid(0, 0, vertexCountHorizontal_, vertexCountVertical_);
+}
+
+void Heightfield::ApplyBrush(
+    BrushMode mode, float centerX, float centerZ, float radius, float strength,
+    float targetHeight) {
+	assert(radius > 0.0f);
+	float cellWidth = modelWidth_ / float(vertexCountHorizontal_ - 1);
+	float cellDepth = modelDepth_ / float(vertexCountVertical_ - 1);
+
+	// 円を囲む頂点の矩形 [beginX, endX) x [beginZ, endZ)
+	auto toGrid = [](float local, float model, float cell, uint32_t count) {
+		return std::clamp((local + model * 0.5f) / cell, 0.0f, float(count));
+	};
+	uint32_t beginX = uint32_t(
+	    std::ceil(toGrid(centerX - radius, modelWidth_, cellWidth, vertexCountHorizontal_)));
+	uint32_t endX = uint32_t(
+	    std::floor(toGrid(centerX + radius, modelWidth_, cellWidth, vertexCountHorizontal_ - 1)));
+	uint32_t beginZ = uint32_t(
+	    std::ceil(toGrid(centerZ - radius, modelDepth_, cellDepth, vertexCountVertical_)));
+	uint32_t endZ = uint32_t(
+	    std::floor(toGrid(centerZ + radius, modelDepth_, cellDepth, vertexCountVertical_ - 1)));
+	endX++;
+	endZ++;
+	if (beginX >= endX || beginZ >= endZ) {
+		return;
+	}
+
+	// 中心からの距離で滑らかに弱める
+	for (uint32_t z = beginZ; z < endZ; z++) {
+		VertexPosNormalUv* row = &vertices_[size_t(z) * vertexCountHorizontal_];
+		for (uint32_t x = beginX; x < endX; x++) {
+			float dx = row[x].pos.x - centerX;
+			float dz = row[x].pos.z - centerZ;
+			float distance = std::sqrt(dx * dx + dz * dz);
+			if (distance >= radius) {
+				continue;
+			}
+			float weight = SmoothStep(1.0f - distance / radius);
+			float& height = row[x].pos.y;
+			switch (mode) {
+			case BrushMode::kRaise:
+				height += strength * weight;
+				break;
+			case BrushMode::kLower:
+				height -= strength * weight;
+				break;
+			case BrushMode::kFlatten:
+				height += (targetHeight - height) * std::min(strength * weight, 1.0f);
+				break;
+			}
+		}
+	}
+
+	// 法線は隣の高さも使うので1頂点広げる
+	beginX = beginX > 0 ? beginX - 1 : 0;
+	beginZ = beginZ > 0 ? beginZ - 1 : 0;
+	endX = std::min(endX + 1, vertexCountHorizontal_);
+	endZ = std::min(endZ + 1, vertexCountVertical_);
+	CalculateNormals(beginX, beginZ, endX, endZ);
+	MarkDirty(beginX, beginZ, endX, endZ);
+	UpdateHeightPyramid(beginX, beginZ, endX, endZ);
+}
+
+void Heightfield::ClearDirty() {
+	for (uint32_t z = dirtyRowBegin_; z < dirtyRowEnd_; z++) {
+		dirtyRanges_[z] = DirtyRange();
+	}
+	dirtyRowBegin_ = 0;
+	dirtyRowEnd_ = 0;
+}
+
+float Heightfield::GetHeight(float x, float z) const {
+	float cellWidth = modelWidth_ / float(vertexCountHorizontal_ - 1);
+	float cellDepth = modelDepth_ / float(vertexCountVertical_ - 1);
+	// マス単位の座標（範囲外は端に寄せる）
+	float gx = std::clamp(
+	    (x + modelWidth_ * 0.5f) / cellWidth, 0.0f, float(vertexCountHorizontal_ - 1));
+	float gz = std::clamp(
+	    (z + modelDepth_ * 0.5f) / cellDepth, 0.0f, float(vertexCountVertical_ - 1));
+	uint32_t cx = std::min(uint32_t(gx), vertexCountHorizontal_ - 2);
+	uint32_t cz = std::min(uint32_t(gz), vertexCountVertical_ - 2);
+	float fx = gx - float(cx);
+	float fz = gz - float(cz);
+	// 四隅の高さの双線形補間
+	const VertexPosNormalUv* row0 = &vertices_[size_t(cz) * vertexCountHorizontal_ + cx];
+	const VertexPosNormalUv* row1 = row0 + vertexCountHorizontal_;
+	float h0 = row0[0].pos.y + (row0[1].pos.y - row0[0].pos.y) * fx;
+	float h1 = row1[0].pos.y + (row1[1].pos.y - row1[0].pos.y) * fx;
+	return h0 + (h1 - h0) * fz;
+}
+
+bool Heightfield::Raycast(const Ray& ray, RaycastHit* hit) const {
+	assert(hit);
+	*hit = RaycastHit();
+	float cellWidth = modelWidth_ / float(vertexCountHorizontal_ - 1);
+	float cellDepth = modelDepth_ / float(vertexCountVertical_ - 1);
+	uint32_t cellCountX = vertexCountHorizontal_ - 1;
+	uint32_t cellCountZ = vertexCountVertical_ - 1;
+
+	// XZをマス単位にした線分（t は変わらない）
+	Ray gridRay = {
+	    {(ray.origin.x + modelWidth_ * 0.5f) / cellWidth, ray.origin.y,
+	     (ray.origin.z + modelDepth_ * 0.5f) / cellDepth},
+	    {ray.delta.x / cellWidth, ray.delta.y, ray.delta.z / cellDepth},
+	};
+	float tMin = 0.0f;
+	float tMax = 1.0f;
+	if (!ClipRay(gridRay, 0.0f, 0.0f, float(cellCountX), float(cellCountZ), tMin, tMax)) {
+		return false;
+	}
+
+	// ピラミッドがあれば最上段から辿る
+	if (!heightPyramid_.empty()) {
+		uint32_t top = static_cast<uint32_t>(heightPyramid_.size() - 1);
+		return RaycastBlock(top, 0, 0, ray, gridRay, tMin, tMax, hit);
+	}
+
+	// 線分が通るマスを手前から順に辿る（DDA）
+	float startX = gridRay.origin.x + gridRay.delta.x * tMin;
+	float startZ = gridRay.origin.z + gridRay.delta.z * tMin;
+	int32_t cx = std::clamp(int32_t(std::floor(startX)), 0, int32_t(cellCountX) - 1);
+	int32_t cz = std::clamp(int32_t(std::floor(startZ)), 0, int32_t(cellCountZ) - 1);
+	auto setupAxis = [&](float origin, float delta, int32_t cell, int32_t& step, float& tNext,
+	                     float& tDelta) {
+		if (delta > 0.0f) {
+			step = 1;
+			tNext = (float(cell + 1) - origin) / delta;
+			tDelta = 1.0f / delta;
+		} else if (delta < 0.0f) {
+			step = -1;
+			tNext = (float(cell) - origin) / delta;
+			tDelta = -1.0f / delta;
+		} else {
+			step = 0;
+			tNext = std::numeric_limits<float>::infinity();
+			tDelta = 0.0f;
+		}
+	};
+	int32_t stepX = 0;
+	int32_t stepZ = 0;
+	float tNextX = 0.0f;
+	float tNextZ = 0.0f;
+	float tDeltaX = 0.0f;
+	float tDeltaZ = 0.0f;
+	setupAxis(gridRay.origin.x, gridRay.delta.x, cx, stepX, tNextX, tDeltaX);
+	setupAxis(gridRay.origin.z, gridRay.delta.z, cz, stepZ, tNextZ, tDeltaZ);
+	while (true) {
+		// 手前のマスから調べるので、最初の当たりが最も手前
+		if (RaycastCell(uint32_t(cx), uint32_t(cz), ray, hit)) {
+			return true;
+		}
+		if (tNextX < tNextZ) {
+			if (tNextX > tMax) {
+				break;
+			}
+			cx += stepX;
+			tNextX += tDeltaX;
+		} else {
+			if (tNextZ > tMax) {
+				break;
+			}
+			cz += stepZ;
+			tNextZ += tDeltaZ;
+		}
+		if (cx < 0 || cz < 0 || cx >= int32_t(cellCountX) || cz >= int32_t(cellCountZ)) {
+			break;
+		}
+	}
+	return false;
+}
+
+uint32_t Heightfield::RaycastBatch(const Ray* rays, RaycastHit* hits, uint32_t count) const {
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	uint32_t threadCount = threadCount_;
+	if (threadCount == 0) {
+		threadCount = threadPool->GetThreadCount();
+	}
+	if (count < kParallelRaycastThreshold) {
+		threadCount = 1;
+	}
+
+	// 線分毎の結果は別の要素に書くので、帯毎に当たった数だけ数えて最後に足す
+	std::vector<uint32_t> hitCounts(threadCount);
+	threadPool->ParallelFor(threadCount, count, [&](size_t begin, size_t end, uint32_t band) {
+		for (size_t i = begin; i < end; i++) {
+			if (Raycast(rays[i], &hits[i])) {
+				hitCounts[band]++;
+			}
+		}
+	});
+	uint32_t hitCount = 0;
+	for (uint32_t bandHitCount : hitCounts) {
+		hitCount += bandHitCount;
+	}
+	return hitCount;
+}
+
+void Heightfield::SetUseHeightPyramid(bool useHeightPyramid) {
+	heightPyramid_.clear();
+	if (!useHeightPyramid) {
+		return;
+	}
+	// 0段目はマス毎、以降は半分ずつ（端数は切り上げ）にして 1x1 まで重ねる
+	uint32_t width = vertexCountHorizontal_ - 1;
+	uint32_t depth = vertexCountVertical_ - 1;
+	while (true) {
+		PyramidLevel& level = heightPyramid_.emplace_back();
+		level.width = width;
+		level.depth = depth;
+		level.ranges.resize(size_t(width) * depth);
+		if (width == 1 && depth == 1) {
+			break;
+		}
+		width = (width + 1) / 2;
+		depth = (depth + 1) / 2;
+	}
+	UpdateHeightPyramid(0, 0, vertexCountHorizontal_, vertexCountVertical_);
+}
+
+float Heightfield::Perlin(float x, float y) const {
+	assert(!gradients_.empty());
+	uint32_t gradientRows = static_cast<uint32_t>(gradients_.size() / gradientPitch_);
+
+	// 格子の番号と格子内の位置
+	int32_t ix = ClampCell(int32_t(std::floor(x)), gradientPitch_);
+	int32_t iy = ClampCell(int32_t(std::floor(y)), gradientRows);
+	float fx = x - float(ix);
+	float fy = y - float(iy);
+
+	// 四隅の勾配と、四隅からの距離ベクトルの内積
+	const Vector2* g0 = &gradients_[size_t(iy) * gradientPitch_ + ix];
+	const Vector2* g1 = g0 + gradientPitch_;
+	float d00 = g0[0].x * fx + g0[0].y * fy;
+	float d10 = g0[1].x * (fx - 1.0f) + g0[1].y * fy;
+	float d01 = g1[0].x * fx + g1[0].y * (fy - 1.0f);
+	float d11 = g1[1].x * (fx - 1.0f) + g1[1].y * (fy - 1.0f);
+
+	// 補間
+	float u = SmoothStep(fx);
+	float v = SmoothStep(fy);
+	float n0 = d00 + (d10 - d00) * u;
+	float n1 = d01 + (d11 - d01) * u;
+	float n = n0 + (n1 - n0) * v;
+	return n * kPerlinScale + 0.5f;
+}
+
+void Heightfield::PerlinRow(float x0, float dx, float y, uint32_t count, float* out) const {
+	uint32_t i = 0;
+	if (useSimd_) {
+		for (; i + kSimdWidth <= count; i += kSimdWidth) {
+			PerlinAvx2(x0, dx, i, y, out + i);
+		}
+	}
+	// 端数（SIMDを使わなければ全部）は1サンプルずつ
+	for (; i < count; i++) {
+		out[i] = Perlin(x0 + float(i) * dx, y);
+	}
+}
+
+template<class Func> void Heightfield::ParallelRows(uint32_t rowCount, Func func) const {
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	uint32_t threadCount = threadCount_;
+	if (threadCount == 0) {
+		threadCount = threadPool->GetThreadCount();
+	}
+	if (vertices_.size() < kParallelThreshold) {
+		threadCount = 1;
+	}
+	threadCount = std::max(1u, std::min(threadCount, rowCount));
+
+	// 帯の境目はスレッド数で決まるが、各行の結果は帯の分け方によらない
+	threadPool->ParallelFor(threadCount, rowCount, [&func](size_t begin, size_t end, uint32_t) {
+		func(uint32_t(begin), uint32_t(end));
+	});
+}
+
+void Heightfield::GenerateGradients(uint32_t countX, uint32_t countY) {
+	// ランダムな向きの単位ベクトル
+	std::uniform_real_distribution<float> angle(0.0f, 2.0f * std::numbers::pi_v<float>);
+	gradientPitch_ = countX;
+	gradients_.resize(size_t(countX) * countY);
+	for (Vector2& gradient : gradients_) {
+		float theta = angle(randomEngine_);
+		gradient = {std::cos(theta), std::sin(theta)};
+	}
+}
+
+void Heightfield::PerlinAvx2(float x0, float dx, uint32_t first, float y, float* out) const {
+	assert(!gradients_.empty());
+	uint32_t gradientRows = static_cast<uint32_t>(gradients_.size() / gradientPitch_);
+
+	// 行内で共通の値
+	int32_t iy = ClampCell(int32_t(std::floor(y)), gradientRows);
+	float fy = y - float(iy);
+	float v = SmoothStep(fy);
+	const float* row0 = &gradients_[size_t(iy) * gradientPitch_].x;
+	const float* row1 = row0 + size_t(gradientPitch_) * 2;
+
+	// 8サンプルのX座標（Perlin(x0 + float(i) * dx, y) と同じ演算。融合積和は使わない）
+	__m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256 index = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(int32_t(first)), lane));
+	__m256 x = _mm256_add_ps(_mm256_set1_ps(x0), _mm256_mul_ps(index, _mm256_set1_ps(dx)));
+
+	// 格子の番号と格子内の位置
+	__m256i ix = _mm256_cvttps_epi32(_mm256_floor_ps(x));
+	ix = _mm256_max_epi32(ix, _mm256_setzero_si256());
+	ix = _mm256_min_epi32(ix, _mm256_set1_epi32(int32_t(gradientPitch_) - 2));
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 fx = _mm256_sub_ps(x, _mm256_cvtepi32_ps(ix));
+	__m256 fx1 = _mm256_sub_ps(fx, one);
+	__m256 fy0 = _mm256_set1_ps(fy);
+	__m256 fy1 = _mm256_set1_ps(fy - 1.0f);
+
+	// 勾配の収集（x,y が交互に並ぶので要素番号は 2*ix と 2*ix+1）
+	__m256i ex = _mm256_slli_epi32(ix, 1);
+	__m256i ey = _mm256_add_epi32(ex, _mm256_set1_epi32(1));
+	__m256 g00x = _mm256_i32gather_ps(row0, ex, 4);
+	__m256 g00y = _mm256_i32gather_ps(row0, ey, 4);
+	__m256 g10x = _mm256_i32gather_ps(row0 + 2, ex, 4);
+	__m256 g10y = _mm256_i32gather_ps(row0 + 2, ey, 4);
+	__m256 g01x = _mm256_i32gather_ps(row1, ex, 4);
+	__m256 g01y = _mm256_i32gather_ps(row1, ey, 4);
+	__m256 g11x = _mm256_i32gather_ps(row1 + 2, ex, 4);
+	__m256 g11y = _mm256_i32gather_ps(row1 + 2, ey, 4);
+
+	// 四隅の内積
+	__m256 d00 = _mm256_add_ps(_mm256_mul_ps(g00x, fx), _mm256_mul_ps(g00y, fy0));
+	__m256 d10 = _mm256_add_ps(_mm256_mul_ps(g10x, fx1), _mm256_mul_ps(g10y, fy0));
+	__m256 d01 = _mm256_add_ps(_mm256_mul_ps(g01x, fx), _mm256_mul_ps(g01y, fy1));
+	__m256 d11 = _mm256_add_ps(_mm256_mul_ps(g11x, fx1), _mm256_mul_ps(g11y, fy1));
+
+	// フェード関数 t * t * t * (t * (t * 6 - 15) + 10)
+	__m256 fx3 = _mm256_mul_ps(_mm256_mul_ps(fx, fx), fx);
+	__m256 poly = _mm256_sub_ps(_mm256_mul_ps(fx, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+	poly = _mm256_add_ps(_mm256_mul_ps(fx, poly), _mm256_set1_ps(10.0f));
+	__m256 u = _mm256_mul_ps(fx3, poly);
+
+	// 補間
+	__m256 n0 = _mm256_add_ps(d00, _mm256_mul_ps(_mm256_sub_ps(d10, d00), u));
+	__m256 n1 = _mm256_add_ps(d01, _mm256_mul_ps(_mm256_sub_ps(d11, d01), u));
+	__m256 n = _mm256_add_ps(n0, _mm256_mul_ps(_mm256_sub_ps(n1, n0), _mm256_set1_ps(v)));
+	__m256 result =
+	    _mm256_add_ps(_mm256_mul_ps(n, _mm256_set1_ps(kPerlinScale)), _mm256_set1_ps(0.5f));
+	_mm256_storeu_ps(out, result);
+}
+
+void Heightfield::CalculateNormals(
+    uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ) {
+	float cellWidth = modelWidth_ / float(vertexCountHorizontal_ - 1);
+	float cellDepth = modelDepth_ / float(vertexCountVertical_ - 1);
+
+	// 前後・左右の隣接頂点の高さの差（端は片側）から傾きを求める
+	for (uint32_t z = beginZ; z < endZ; z++) {
+		uint32_t z0 = z > 0 ? z - 1 : z;
+		uint32_t z1 = z + 1 < vertexCountVertical_ ? z + 1 : z;
+		VertexPosNormalUv* row = &vertices_[size_t(z) * vertexCountHorizontal_];
+		const VertexPosNormalUv* row0 = &vertices_[size_t(z0) * vertexCountHorizontal_];
+		const VertexPosNormalUv* row1 = &vertices_[size_t(z1) * vertexCountHorizontal_];
+		for (uint32_t x = beginX; x < endX; x++) {
+			uint32_t x0 = x > 0 ? x - 1 : x;
+			uint32_t x1 = x + 1 < vertexCountHorizontal_ ? x + 1 : x;
+			float slopeX = (row[x1].pos.y - row[x0].pos.y) / (float(x1 - x0) * cellWidth);
+			float slopeZ = (row1[x].pos.y - row0[x].pos.y) / (float(z1 - z0) * cellDepth);
+			float length = std::sqrt(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+			row[x].normal = {-slopeX / length, 1.0f / length, -slopeZ / length};
+		}
+	}
+}
+
+void Heightfield::MarkDirty(uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ) {
+	// 行毎に、既存の範囲と合わせて1つの範囲にまとめる
+	for (uint32_t z = beginZ; z < endZ; z++) {
+		DirtyRange& range = dirtyRanges_[z];
+		if (range.IsEmpty()) {
+			range = {beginX, endX};
+		} else {
+			range.begin = std::min(range.begin, beginX);
+			range.end = std::max(range.end, endX);
+		}
+	}
+	if (dirtyRowBegin_ >= dirtyRowEnd_) {
+		dirtyRowBegin_ = beginZ;
+		dirtyRowEnd_ = endZ;
+	} else {
+		dirtyRowBegin_ = std::min(dirtyRowBegin_, beginZ);
+		dirtyRowEnd_ = std::max(dirtyRowEnd_, endZ);
+	}
+}
+
+void Heightfield::UpdateHeightPyramid(
+    uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ) {
+	if (heightPyramid_.empty()) {
+		return;
+	}
+	// 頂点 [begin, end) を角に持つマス
+	beginX = beginX > 0 ? beginX - 1 : 0;
+	beginZ = beginZ > 0 ? beginZ - 1 : 0;
+	endX = std::min(endX, vertexCountHorizontal_ - 1);
+	endZ = std::min(endZ, vertexCountVertical_ - 1);
+
+	// 0段目は四隅の頂点の高さから
+	PyramidLevel& cells = heightPyramid_[0];
+	for (uint32_t z = beginZ; z < endZ; z++) {
+		const VertexPosNormalUv* row0 = &vertices_[size_t(z) * vertexCountHorizontal_];
+		const VertexPosNormalUv* row1 = row0 + vertexCountHorizontal_;
+		for (uint32_t x = beginX; x < endX; x++) {
+			auto [min, max] = std::minmax(
+			    {row0[x].pos.y, row0[x + 1].pos.y, row1[x].pos.y, row1[x + 1].pos.y});
+			cells.ranges[size_t(z) * cells.width + x] = {min, max};
+		}
+	}
+
+	// 上の段は下の段の 2x2 から
+	for (size_t i = 1; i < heightPyramid_.size(); i++) {
+		const PyramidLevel& lower = heightPyramid_[i - 1];
+		PyramidLevel& level = heightPyramid_[i];
+		beginX /= 2;
+		beginZ /= 2;
+		endX = (endX + 1) / 2;
+		endZ = (endZ + 1) / 2;
+		for (uint32_t z = beginZ; z < endZ; z++) {
+			for (uint32_t x = beginX; x < endX; x++) {
+				HeightRange range = lower.ranges[size_t(z * 2) * lower.width + x * 2];
+				for (uint32_t j = 0; j < 2; j++) {
+					for (uint32_t k = 0; k < 2; k++) {
+						uint32_t lx = x * 2 + k;
+						uint32_t lz = z * 2 + j;
+						if (lx >= lower.width || lz >= lower.depth) {
+							continue;
+						}
+						const HeightRange& child = lower.ranges[size_t(lz) * lower.width + lx];
+						range.min = std::min(range.min, child.min);
+						range.max = std::max(range.max, child.max);
+					}
+				}
+				level.ranges[size_t(z) * level.width + x] = range;
+			}
+		}
+	}
+}
+
+bool Heightfield::RaycastBlock(
+    uint32_t level, uint32_t bx, uint32_t bz, const Ray& ray, const Ray& gridRay, float tMin,
+    float tMax, RaycastHit* hit) const {
+	// ブロックが覆うマスの矩形に線分を切り詰める
+	float size = float(1u << level);
+	float x0 = float(bx) * size - kClipMargin;
+	float z0 = float(bz) * size - kClipMargin;
+	float x1 = std::min(float(bx + 1) * size, float(vertexCountHorizontal_ - 1)) + kClipMargin;
+	float z1 = std::min(float(bz + 1) * size, float(vertexCountVertical_ - 1)) + kClipMargin;
+	if (!ClipRay(gridRay, x0, z0, x1, z1, tMin, tMax)) {
+		return false;
+	}
+
+	// 線分がブロックの高さの範囲を通らなければ飛ばす
+	const PyramidLevel& pyramidLevel = heightPyramid_[level];
+	const HeightRange& range = pyramidLevel.ranges[size_t(bz) * pyramidLevel.width + bx];
+	float y0 = gridRay.origin.y + gridRay.delta.y * tMin;
+	float y1 = gridRay.origin.y + gridRay.delta.y * tMax;
+	if (std::min(y0, y1) > range.max || std::max(y0, y1) < range.min) {
+		return false;
+	}
+
+	if (level == 0) {
+		return RaycastCell(bx, bz, ray, hit);
+	}
+
+	// 4つの子を線分の進む向きに手前から辿る（通れるのは多くても3つで、横の2つは両方は通らない）
+	const PyramidLevel& lower = heightPyramid_[level - 1];
+	uint32_t nearX = gridRay.delta.x >= 0.0f ? 0 : 1;
+	uint32_t nearZ = gridRay.delta.z >= 0.0f ? 0 : 1;
+	const uint32_t kOrder[4][2] = {
+	    {nearX, nearZ}, {1 - nearX, nearZ}, {nearX, 1 - nearZ}, {1 - nearX, 1 - nearZ}};
+	for (const auto& [ox, oz] : kOrder) {
+		uint32_t childX = bx * 2 + ox;
+		uint32_t childZ = bz * 2 + oz;
+		if (childX >= lower.width || childZ >= lower.depth) {
+			continue;
+		}
+		if (RaycastBlock(level - 1, childX, childZ, ray, gridRay, tMin, tMax, hit)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Heightfield::RaycastCell(uint32_t cx, uint32_t cz, const Ray& ray, RaycastHit* hit) const {
+	// Initialize と同じ2枚の三角形
+	const Vector3& p00 = GetVertex(cx, cz).pos;
+	const Vector3& p10 = GetVertex(cx + 1, cz).pos;
+	const Vector3& p01 = GetVertex(cx, cz + 1).pos;
+	const Vector3& p11 = GetVertex(cx + 1, cz + 1).pos;
+	const Vector3* triangles[2][3] = {
+	    {&p00, &p01, &p10},
+	    {&p01, &p11, &p10},
+	};
+
+	bool found = false;
+	for (const auto& triangle : triangles) {
+		float t = 0.0f;
+		if (!IntersectTriangle(ray, *triangle[0], *triangle[1], *triangle[2], t)) {
+			continue;
+		}
+		if (found && t >= hit->t) {
+			continue;
+		}
+		found = true;
+		hit->hit = true;
+		hit->t = t;
+		hit->position = ray.origin + ray.delta * t;
+		// 時計回りで上を向く法線
+		hit->normal = Normalize(Cross(*triangle[1] - *triangle[0], *triangle[2] - *triangle[0]));
+	}
+	return found;
+}
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "Terrain.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/// <summary>
+/// 高さ場（Terrain の頂点・勾配を1次元配列に並べ、パーリンノイズをSIMDでまとめて評価する）
+/// </summary>
+class Heightfield {
+public: // エイリアス
+	// 頂点データ（Terrain と同じレイアウト）
+	using VertexPosNormalUv = Terrain::VertexPosNormalUv;
+
+public: // 定数
+	// SIMDで1度に評価するサンプル数（AVX2の1レーン）
+	static const uint32_t kSimdWidth = 8;
+	// これより頂点が少なければ並列化しない
+	static const size_t kParallelThreshold = 0x10000;
+	// これより線分が少なければまとめてレイキャストを並列化しない
+	static const uint32_t kParallelRaycastThreshold = 256;
+
+public: // サブクラス
+	// ブラシの種類
+	enum class BrushMode {
+		kRaise,   // 持ち上げる
+		kLower,   // 下げる
+		kFlatten, // 目標の高さに寄せる
+	};
+
+	// 1行の中で書き換えた頂点の範囲 [begin, end)
+	struct DirtyRange {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+
+		bool IsEmpty() const { return begin >= end; }
+	};
+
+	// 線分 origin + t * delta（0 <= t <= 1。ローカル座標）
+	struct Ray {
+		Vector3 origin;
+		Vector3 delta;
+	};
+
+	// レイキャストの結果
+	struct RaycastHit {
+		// 当たったか
+		bool hit = false;
+		// 線分上の位置 [0,1]
+		float t = 0.0f;
+		// 当たった座標（ローカル座標）
+		Vector3 position = {};
+		// 当たった三角形の法線
+		Vector3 normal = {};
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// AVX2 が使えるか（CPUとOSの両方の対応を調べる）
+	/// </summary>
+	static bool IsAvx2Supported();
+
+	/// <summary>
+	/// 改良パーリンノイズのフェード関数 6t^5 - 15t^4 + 10t^3
+	/// </summary>
+	static float SmoothStep(float t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（平らな格子を作る）
+	/// </summary>
+	/// <param name="modelWidth">左右幅</param>
+	/// <param name="modelDepth">奥行幅</param>
+	/// <param name="modelHeight">高さ</param>
+	/// <param name="vertexCountHorizontal">横方向頂点数</param>
+	/// <param name="vertexCountVertical">縦方向頂点数</param>
+	void Initialize(
+	    float modelWidth = Terrain::kDefaultModelWidth,
+	    float modelDepth = Terrain::kDefaultModelWidth,
+	    float modelHeight = Terrain::kDefaultHeight,
+	    uint32_t vertexCountHorizontal = Terrain::kDefaultVertexCountHorizontal,
+	    uint32_t vertexCountVertical = Terrain::kDefaultVertexCountHorizontal);
+
+	/// <summary>
+	/// 2Dパーリンノイズによる地形変動（高さと法線を作り直す）
+	/// </summary>
+	/// <param name="gridSize">1グリッドがまたぐ頂点数</param>
+	void DeformRandom(uint32_t gridSize = 5);
+
+	/// <summary>
+	/// ブラシによる地形変動（範囲を囲む矩形だけ高さと法線を作り直し、書き換えた行を記録する）
+	/// </summary>
+	/// <param name="mode">ブラシの種類</param>
+	/// <param name="centerX">中心のX座標（ローカル座標）</param>
+	/// <param name="centerZ">中心のZ座標（ローカル座標）</param>
+	/// <param name="radius">半径</param>
+	/// <param name="strength">中心での変化量（kFlatten では目標に寄せる割合 [0,1]）</param>
+	/// <param name="targetHeight">kFlatten の目標の高さ</param>
+	void ApplyBrush(
+	    BrushMode mode, float centerX, float centerZ, float radius, float strength,
+	    float targetHeight = 0.0f);
+
+	/// <summary>
+	/// 高さの取得（四隅の頂点の双線形補間。範囲外は端の高さ）
+	/// </summary>
+	/// <param name="x">X座標（ローカル座標）</param>
+	/// <param name="z">Z座標（ローカル座標）</param>
+	float GetHeight(float x, float z) const;
+
+	/// <summary>
+	/// レイキャスト（描画と同じ三角形に対して、線分が通るマスだけを手前から調べる）
+	/// </summary>
+	/// <param name="ray">線分</param>
+	/// <param name="hit">最も手前の当たり</param>
+	/// <returns>当たったか</returns>
+	bool Raycast(const Ray& ray, RaycastHit* hit) const;
+
+	/// <summary>
+	/// まとめてレイキャスト（弾など多数の線分向け。線分が多ければ帯に分けて並列に調べる）
+	/// </summary>
+	/// <param name="rays">線分配列</param>
+	/// <param name="hits">結果配列（rays と同じ数）</param>
+	/// <param name="count">線分の数</param>
+	/// <returns>当たった数</returns>
+	uint32_t RaycastBatch(const Ray* rays, RaycastHit* hits, uint32_t count) const;
+
+	/// <summary>
+	/// 高さの最小・最大ピラミッドを使うか（レイキャストで線分より低いブロックを飛ばす）
+	/// </summary>
+	void SetUseHeightPyramid(bool useHeightPyramid);
+
+	/// <summary>
+	/// パーリンノイズ（1サンプル）
+	/// </summary>
+	/// <param name="x">X座標（グリッド単位）</param>
+	/// <param name="y">Y座標（グリッド単位）</param>
+	/// <returns>[0,1]の値</returns>
+	float Perlin(float x, float y) const;
+
+	/// <summary>
+	/// パーリンノイズ（1行分。SIMDが有効なら kSimdWidth サンプルずつ評価する）
+	/// </summary>
+	/// <param name="x0">先頭のX座標（グリッド単位）</param>
+	/// <param name="dx">サンプル間隔（グリッド単位）</param>
+	/// <param name="y">Y座標（グリッド単位）</param>
+	/// <param name="count">サンプル数</param>
+	/// <param name="out">結果（[0,1]の値）</param>
+	void PerlinRow(float x0, float dx, float y, uint32_t count, float* out) const;
+
+	/// <summary>
+	/// 乱数のシード設定（同じシードなら DeformRandom の結果も同じになる）
+	/// </summary>
+	void SetSeed(uint32_t seed) { randomEngine_.seed(seed); }
+
+	/// <summary>
+	/// SIMDを使うか（AVX2 非対応なら常に使わない）
+	/// </summary>
+	void SetUseSimd(bool useSimd) { useSimd_ = useSimd && IsAvx2Supported(); }
+
+	/// <summary>
+	/// 生成に使うスレッド数（0ならハードウェアスレッド数。結果はスレッド数によらない）
+	/// </summary>
+	void SetThreadCount(uint32_t threadCount) { threadCount_ = threadCount; }
+
+	/// <summary>
+	/// 頂点配列の取得
+	/// </summary>
+	/// <returns>頂点配列（前後×左右の行優先）</returns>
+	const std::vector<VertexPosNormalUv>& GetVertices() const { return vertices_; }
+
+	/// <summary>
+	/// 頂点の取得
+	/// </summary>
+	/// <param name="x">横方向番号</param>
+	/// <param name="z">縦方向番号</param>
+	const VertexPosNormalUv& GetVertex(uint32_t x, uint32_t z) const {
+		return vertices_[size_t(z) * vertexCountHorizontal_ + x];
+	}
+
+	/// <summary>
+	/// 頂点インデックス配列の取得
+	/// </summary>
+	const std::vector<uint32_t>& GetIndices() const { return indices_; }
+
+	/// <summary>
+	/// 書き換えた行の範囲 [GetDirtyRowBegin, GetDirtyRowEnd)（無ければ空）
+	/// </summary>
+	uint32_t GetDirtyRowBegin() const { return dirtyRowBegin_; }
+	uint32_t GetDirtyRowEnd() const { return dirtyRowEnd_; }
+
+	/// <summary>
+	/// 行内の書き換えた範囲
+	/// </summary>
+	/// <param name="z">縦方向番号</param>
+	const DirtyRange& GetDirtyRange(uint32_t z) const { return dirtyRanges_[z]; }
+
+	/// <summary>
+	/// 書き換えた範囲の記録を消す（GPUへ転送した後に呼ぶ）
+	/// </summary>
+	void ClearDirty();
+
+	uint32_t GetVertexCountHorizontal() const { return vertexCountHorizontal_; }
+	uint32_t GetVertexCountVertical() const { return vertexCountVertical_; }
+	float GetModelWidth() const { return modelWidth_; }
+	float GetModelDepth() const { return modelDepth_; }
+	float GetModelHeight() const { return modelHeight_; }
+
+private: // サブクラス
+	// 高さの範囲
+	struct HeightRange {
+		float min = 0.0f;
+		float max = 0.0f;
+	};
+
+	// ピラミッドの1段（0段目は1マス、1段上がる毎に2x2をまとめる）
+	struct PyramidLevel {
+		uint32_t width = 0;
+		uint32_t depth = 0;
+		std::vector<HeightRange> ranges;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 勾配ベクトルの生成
+	/// </summary>
+	/// <param name="countX">横方向の格子点数</param>
+	/// <param name="countY">縦方向の格子点数</param>
+	void GenerateGradients(uint32_t countX, uint32_t countY);
+
+	/// <summary>
+	/// パーリンノイズ（AVX2で first 番目から kSimdWidth サンプル。PerlinRow と同じ演算順）
+	/// </summary>
+	void PerlinAvx2(float x0, float dx, uint32_t first, float y, float* out) const;
+
+	/// <summary>
+	/// 行を帯に分けて並列に処理する（頂点が少なければ1スレッド）
+	/// </summary>
+	/// <param name="rowCount">行数</param>
+	/// <param name="func">帯の処理 func(beginRow, endRow)</param>
+	template<class Func> void ParallelRows(uint32_t rowCount, Func func) const;
+
+	/// <summary>
+	/// 法線の計算（隣接頂点の高さの差から。範囲は [begin, end) の頂点番号）
+	/// </summary>
+	void CalculateNormals(uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ);
+
+	/// <summary>
+	/// 書き換えた範囲の記録（[begin, end) の頂点番号）
+	/// </summary>
+	void MarkDirty(uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ);
+
+	/// <summary>
+	/// 高さのピラミッドの更新（[begin, end) の頂点番号を含むブロックを作り直す）
+	/// </summary>
+	void UpdateHeightPyramid(uint32_t beginX, uint32_t beginZ, uint32_t endX, uint32_t endZ);
+
+	/// <summary>
+	/// ピラミッドのブロックを手前から辿るレイキャスト
+	/// </summary>
+	/// <param name="level">段</param>
+	/// <param name="bx">横方向番号</param>
+	/// <param name="bz">縦方向番号</param>
+	/// <param name="ray">線分（ローカル座標）</param>
+	/// <param name="gridRay">線分（XZをマス単位にしたもの）</param>
+	/// <param name="tMin">線分の範囲の始点</param>
+	/// <param name="tMax">線分の範囲の終点</param>
+	bool RaycastBlock(
+	    uint32_t level, uint32_t bx, uint32_t bz, const Ray& ray, const Ray& gridRay, float tMin,
+	    float tMax, RaycastHit* hit) const;
+
+	/// <summary>
+	/// 1マスの2枚の三角形とのレイキャスト
+	/// </summary>
+	/// <param name="cx">横方向番号</param>
+	/// <param name="cz">縦方向番号</param>
+	/// <param name="ray">線分（ローカル座標）</param>
+	bool RaycastCell(uint32_t cx, uint32_t cz, const Ray& ray, RaycastHit* hit) const;
+
+private: // メンバ変数
+	// 横方向頂点数
+	uint32_t vertexCountHorizontal_ = 0;
+	// 縦方向頂点数
+	uint32_t vertexCountVertical_ = 0;
+	// モデル左右幅
+	float modelWidth_ = 0.0f;
+	// モデル奥行幅
+	float modelDepth_ = 0.0f;
+	// モデル高さ
+	float modelHeight_ = 0.0f;
+	// 頂点配列（行優先）
+	std::vector<VertexPosNormalUv> vertices_;
+	// 頂点インデックス配列
+	std::vector<uint32_t> indices_;
+	// 行毎の書き換えた範囲
+	std::vector<DirtyRange> dirtyRanges_;
+	// 書き換えた行の範囲
+	uint32_t dirtyRowBegin_ = 0;
+	uint32_t dirtyRowEnd_ = 0;
+	// 高さの最小・最大ピラミッド（空なら使わない）
+	std::vector<PyramidLevel> heightPyramid_;
+	// 勾配ベクトル（行優先）
+	std::vector<Vector2> gradients_;
+	// 勾配ベクトルの横方向の数
+	uint32_t gradientPitch_ = 0;
+	// 乱数
+	std::mt19937 randomEngine_{std::random_device{}()};
+	// SIMDを使うか
+	bool useSimd_ = IsAvx2Supported();
+	// 生成に使うスレッド数（0ならハードウェアスレッド数）
+	uint32_t threadCount_ = 0;
+};
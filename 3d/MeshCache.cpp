@@ -0,0 +1,416 @@
+#include "MeshCache.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+
+// キャッシュファイルヘッダ
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t flags;
+	uint32_t sourceCount;
+	uint64_t sourceHash;
+	uint32_t materialCount;
+	uint32_t meshCount;
+};
+
+// ヘッダのフラグ
+const uint32_t kFlagSmoothing = 1u << 0;
+
+// キャッシュ書き込み用バッファ
+class ByteWriter {
+public:
+	template<class T> void Write(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		WriteBytes(&value, sizeof(T));
+	}
+
+	void WriteBytes(const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		buffer_.insert(buffer_.end(), bytes, bytes + size);
+	}
+
+	void WriteString(const std::string& str) {
+		Write(static_cast<uint32_t>(str.size()));
+		WriteBytes(str.data(), str.size());
+	}
+
+	void Align(size_t alignment) {
+		buffer_.resize((buffer_.size() + alignment - 1) & ~(alignment - 1));
+	}
+
+	const std::vector<uint8_t>& GetBuffer() const { return buffer_; }
+
+private:
+	std::vector<uint8_t> buffer_;
+};
+
+// マッピングしたキャッシュの読み取り（範囲外アクセスは失敗として扱う）
+class ByteReader {
+public:
+	ByteReader(const uint8_t* data, size_t size) : begin_(data), cursor_(data), end_(data + size) {}
+
+	template<class T> bool Read(T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (size_t(end_ - cursor_) < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, cursor_, sizeof(T));
+		cursor_ += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(std::string& str) {
+		uint32_t length = 0;
+		if (!Read(length) || size_t(end_ - cursor_) < length) {
+			return false;
+		}
+		str.assign(reinterpret_cast<const char*>(cursor_), length);
+		cursor_ += length;
+		return true;
+	}
+
+	// 配列を参照として取り出す（コピーしない）
+	const uint8_t* Skip(size_t size) {
+		if (size_t(end_ - cursor_) < size) {
+			return nullptr;
+		}
+		const uint8_t* head = cursor_;
+		cursor_ += size;
+		return head;
+	}
+
+	size_t GetOffset() const { return size_t(cursor_ - begin_); }
+
+	bool Align(size_t alignment) {
+		size_t offset = size_t(cursor_ - begin_);
+		size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+		return Skip(aligned - offset) != nullptr;
+	}
+
+private:
+	const uint8_t* begin_;
+	const uint8_t* cursor_;
+	const uint8_t* end_;
+};
+
+// 頂点数に応じたインデックスのバイト数（StaticMesh::ChooseIndexFormat と同じ規則）
+uint32_t IndexSize(size_t vertexCount) {
+	return vertexCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// インデックスがすべて頂点数未満か（壊れたキャッシュで頂点バッファの外を指さないように）
+template<class T>
+bool AreIndicesInRange(const void* indices, uint32_t indexCount, uint32_t vertexCount) {
+	const T* begin = static_cast<const T*>(indices);
+	return std::all_of(
+	    begin, begin + indexCount, [vertexCount](T index) { return index < vertexCount; });
+}
+
+bool ReadVector3(ByteReader& reader, Vector3& v) {
+	return reader.Read(v.x) && reader.Read(v.y) && reader.Read(v.z);
+}
+
+void WriteVector3(ByteWriter& writer, const Vector3& v) {
+	writer.Write(v.x);
+	writer.Write(v.y);
+	writer.Write(v.z);
+}
+
+// キャッシュ元ファイルのサイズと更新時刻をその場で書き直す（offsets は各ファイルのサイズの位置）
+bool RewriteStamps(
+    const std::string& cachePath, const std::vector<size_t>& offsets,
+    const std::vector<MeshCache::SourceFile>& sources) {
+	std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+	if (!file.is_open()) {
+		return false;
+	}
+	for (size_t i = 0; i < sources.size(); i++) {
+		file.seekp(std::streamoff(offsets[i]));
+		file.write(reinterpret_cast<const char*>(&sources[i].size), sizeof(sources[i].size));
+		file.write(
+		    reinterpret_cast<const char*>(&sources[i].writeTime), sizeof(sources[i].writeTime));
+	}
+	return bool(file);
+}
+
+} // namespace
+
+MeshCache::MappedFile::~MappedFile() { Close(); }
+
+bool MeshCache::MappedFile::Open(const std::string& path) {
+	Close();
+
+	std::filesystem::path filePath(path);
+	// キャッシュのヘッダはマッピングしたままその場で書き直すことがあるので、書き込みも共有する
+	file_ = CreateFileW(
+	    filePath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+	    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+
+	// ファイル全体を読み取り専用でマッピング
+	mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MeshCache::MappedFile::Close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+		data_ = nullptr;
+	}
+	if (mapping_) {
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+	if (file_ != INVALID_HANDLE_VALUE) {
+		CloseHandle(file_);
+		file_ = INVALID_HANDLE_VALUE;
+	}
+	size_ = 0;
+}
+
+bool MeshCache::Reader::Open(const std::string& cachePath, bool smoothing) {
+	meshes_.clear();
+	materials_.clear();
+	materialFilename_.clear();
+
+	if (!file_.Open(cachePath)) {
+		return false;
+	}
+	ByteReader reader(file_.GetData(), file_.GetSize());
+
+	// ヘッダ検証
+	FileHeader header{};
+	if (!reader.Read(header) || header.magic != kMagic || header.version != kVersion) {
+		return false;
+	}
+	if (((header.flags & kFlagSmoothing) != 0) != smoothing) {
+		return false;
+	}
+	// 壊れたヘッダで巨大な確保をしないよう、要素数はファイルサイズで頭打ち
+	size_t fileSize = file_.GetSize();
+	if (fileSize < header.sourceCount || fileSize < header.materialCount ||
+	    fileSize < header.meshCount) {
+		return false;
+	}
+
+	// キャッシュ元ファイルの検証。サイズと更新時刻が一致すれば有効、
+	// 一致しなければ内容ハッシュで判定する（チェックアウトし直しただけの場合など）
+	std::vector<SourceFile> sources(header.sourceCount);
+	std::vector<size_t> stampOffsets(header.sourceCount);
+	bool stampMatched = true;
+	for (uint32_t i = 0; i < header.sourceCount; i++) {
+		SourceFile& source = sources[i];
+		SourceFile cached;
+		stampOffsets[i] = reader.GetOffset();
+		if (!reader.Read(cached.size) || !reader.Read(cached.writeTime) ||
+		    !reader.ReadString(cached.path)) {
+			return false;
+		}
+		if (!GetSourceFile(cached.path, source)) {
+			return false;
+		}
+		if (source.size != cached.size || source.writeTime != cached.writeTime) {
+			stampMatched = false;
+		}
+	}
+	if (!stampMatched) {
+		if (HashSources(sources) != header.sourceHash) {
+			return false;
+		}
+		// 内容は同じなので、次回からハッシュを計算せずに済むよう記録を今の値に書き直す
+		// （書けなくても読み込みは続ける）
+		RewriteStamps(cachePath, stampOffsets, sources);
+	}
+
+	if (!reader.ReadString(materialFilename_)) {
+		return false;
+	}
+
+	// マテリアル
+	materials_.resize(header.materialCount);
+	for (ObjLoader::MaterialData& material : materials_) {
+		if (!reader.ReadString(material.name) || !ReadVector3(reader, material.ambient) ||
+		    !ReadVector3(reader, material.diffuse) || !ReadVector3(reader, material.specular) ||
+		    !reader.Read(material.alpha) || !reader.ReadString(material.textureFilename)) {
+			return false;
+		}
+	}
+
+	// メッシュ（頂点・インデックスはマッピング領域を直接参照する）
+	meshes_.resize(header.meshCount);
+	for (MeshView& mesh : meshes_) {
+		if (!reader.ReadString(mesh.name) || !reader.ReadString(mesh.materialName) ||
+		    !reader.Read(mesh.vertexCount) || !reader.Read(mesh.indexCount) ||
+		    !reader.Align(kDataAlignment)) {
+			return false;
+		}
+		mesh.indexSize = IndexSize(mesh.vertexCount);
+		const uint8_t* vertices =
+		    reader.Skip(size_t(mesh.vertexCount) * sizeof(Mesh::VertexPosNormalUv));
+		const uint8_t* indices = reader.Skip(size_t(mesh.indexCount) * mesh.indexSize);
+		if ((mesh.vertexCount && !vertices) || (mesh.indexCount && !indices)) {
+			return false;
+		}
+		// 三角形単位で、すべての番号が頂点を指していること（満たさなければキャッシュ無し扱い）
+		bool indicesValid =
+		    mesh.indexSize == sizeof(uint16_t)
+		        ? AreIndicesInRange<uint16_t>(indices, mesh.indexCount, mesh.vertexCount)
+		        : AreIndicesInRange<uint32_t>(indices, mesh.indexCount, mesh.vertexCount);
+		if (mesh.indexCount % 3 != 0 || !indicesValid) {
+			return false;
+		}
+		mesh.vertices = reinterpret_cast<const Mesh::VertexPosNormalUv*>(vertices);
+		mesh.indices = indices;
+	}
+
+	return true;
+}
+
+void MeshCache::Reader::CopyTo(ObjLoader::ModelData& modelData) const {
+	modelData.materials = materials_;
+	modelData.materialFilename = materialFilename_;
+	modelData.meshes.resize(meshes_.size());
+	for (size_t i = 0; i < meshes_.size(); i++) {
+		const MeshView& view = meshes_[i];
+		ObjLoader::MeshData& mesh = modelData.meshes[i];
+		mesh.name = view.name;
+		mesh.materialName = view.materialName;
+		mesh.vertices.assign(view.vertices, view.vertices + view.vertexCount);
+		if (view.indexSize == sizeof(uint16_t)) {
+			const uint16_t* indices = static_cast<const uint16_t*>(view.indices);
+			mesh.indices.assign(indices, indices + view.indexCount);
+		} else {
+			const uint32_t* indices = static_cast<const uint32_t*>(view.indices);
+			mesh.indices.assign(indices, indices + view.indexCount);
+		}
+	}
+}
+
+bool MeshCache::Write(
+    const std::string& cachePath, bool smoothing, const std::vector<SourceFile>& sources,
+    const ObjLoader::ModelData& modelData) {
+	ByteWriter writer;
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.flags = smoothing ? kFlagSmoothing : 0u;
+	header.sourceCount = static_cast<uint32_t>(sources.size());
+	header.sourceHash = HashSources(sources);
+	header.materialCount = static_cast<uint32_t>(modelData.materials.size());
+	header.meshCount = static_cast<uint32_t>(modelData.meshes.size());
+	writer.Write(header);
+
+	for (const SourceFile& source : sources) {
+		writer.Write(source.size);
+		writer.Write(source.writeTime);
+		writer.WriteString(source.path);
+	}
+
+	writer.WriteString(modelData.materialFilename);
+
+	for (const ObjLoader::MaterialData& material : modelData.materials) {
+		writer.WriteString(material.name);
+		WriteVector3(writer, material.ambient);
+		WriteVector3(writer, material.diffuse);
+		WriteVector3(writer, material.specular);
+		writer.Write(material.alpha);
+		writer.WriteString(material.textureFilename);
+	}
+
+	for (const ObjLoader::MeshData& mesh : modelData.meshes) {
+		writer.WriteString(mesh.name);
+		writer.WriteString(mesh.materialName);
+		writer.Write(static_cast<uint32_t>(mesh.vertices.size()));
+		writer.Write(static_cast<uint32_t>(mesh.indices.size()));
+		writer.Align(kDataAlignment);
+		writer.WriteBytes(
+		    mesh.vertices.data(), mesh.vertices.size() * sizeof(Mesh::VertexPosNormalUv));
+		// 16bitに収まるメッシュは16bitで保存する
+		if (IndexSize(mesh.vertices.size()) == sizeof(uint16_t)) {
+			for (uint32_t index : mesh.indices) {
+				writer.Write(static_cast<uint16_t>(index));
+			}
+		} else {
+			writer.WriteBytes(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		}
+	}
+
+	// 書きかけのキャッシュを読まないよう、一時ファイルに書いてから置き換える
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		const std::vector<uint8_t>& buffer = writer.GetBuffer();
+		file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		if (!file) {
+			return false;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::rename(tempPath, cachePath, ec);
+	return !ec;
+}
+
+bool MeshCache::GetSourceFile(const std::string& path, SourceFile& sourceFile) {
+	std::error_code ec;
+	uint64_t size = std::filesystem::file_size(path, ec);
+	if (ec) {
+		return false;
+	}
+	auto writeTime = std::filesystem::last_write_time(path, ec);
+	if (ec) {
+		return false;
+	}
+	sourceFile.path = path;
+	sourceFile.size = size;
+	sourceFile.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+	return true;
+}
+
+uint64_t MeshCache::HashSources(const std::vector<SourceFile>& sources) {
+	uint64_t hash = Fnv1a(nullptr, 0);
+	std::vector<char> buffer(64 * 1024);
+	for (const SourceFile& source : sources) {
+		std::ifstream file(source.path, std::ios::binary);
+		while (file) {
+			file.read(buffer.data(), buffer.size());
+			hash = Fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+		}
+	}
+	return hash;
+}
+
+uint64_t MeshCache::Fnv1a(const void* data, size_t size, uint64_t hash) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "ObjLoader.h"
+#include <Windows.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// メッシュのバイナリキャッシュ
+/// </summary>
+class MeshCache {
+public: // 定数
+	// ファイル識別子 'KMSH'
+	static const uint32_t kMagic = 0x48534D4B;
+	// フォーマットバージョン（レイアウトを変えたら上げる）
+	static const uint32_t kVersion = 3;
+	// 頂点・インデックス配列のファイル内アライメント
+	static const size_t kDataAlignment = 16;
+
+public: // サブクラス
+	// キャッシュ元ファイル情報
+	struct SourceFile {
+		// パス
+		std::string path;
+		// ファイルサイズ
+		uint64_t size = 0;
+		// 最終更新時刻
+		int64_t writeTime = 0;
+	};
+
+	// キャッシュ内メッシュ参照（マッピングしたファイルを直接指す）
+	struct MeshView {
+		// 名前
+		std::string name;
+		// マテリアル名
+		std::string materialName;
+		// 頂点データ
+		const Mesh::VertexPosNormalUv* vertices = nullptr;
+		// 頂点数
+		uint32_t vertexCount = 0;
+		// 頂点インデックス（indexSize が2なら uint16_t、4なら uint32_t の配列）
+		const void* indices = nullptr;
+		// インデックス数
+		uint32_t indexCount = 0;
+		// インデックス1個のバイト数
+		uint32_t indexSize = 0;
+	};
+
+	/// <summary>
+	/// 読み取り専用ファイルマッピング
+	/// </summary>
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// <summary>
+		/// ファイルをマッピングする
+		/// </summary>
+		/// <param name="path">ファイルパス</param>
+		/// <returns>成否</returns>
+		bool Open(const std::string& path);
+
+		/// <summary>
+		/// マッピング解除
+		/// </summary>
+		void Close();
+
+		const uint8_t* GetData() const { return data_; }
+		size_t GetSize() const { return size_; }
+
+	private:
+		// ファイルハンドル
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		// マッピングハンドル
+		HANDLE mapping_ = nullptr;
+		// 先頭アドレス
+		const uint8_t* data_ = nullptr;
+		// サイズ
+		size_t size_ = 0;
+	};
+
+	/// <summary>
+	/// キャッシュ読み取り
+	/// </summary>
+	class Reader {
+	public:
+		/// <summary>
+		/// キャッシュを開いて検証する
+		/// </summary>
+		/// <param name="cachePath">キャッシュファイルパス</param>
+		/// <param name="smoothing">エッジ平滑化フラグ</param>
+		/// <returns>有効なキャッシュならtrue</returns>
+		bool Open(const std::string& cachePath, bool smoothing);
+
+		/// <summary>
+		/// メッシュ参照配列を取得（Readerが生きている間のみ有効）
+		/// </summary>
+		const std::vector<MeshView>& GetMeshes() const { return meshes_; }
+
+		/// <summary>
+		/// マテリアル配列を取得
+		/// </summary>
+		const std::vector<ObjLoader::MaterialData>& GetMaterials() const { return materials_; }
+
+		/// <summary>
+		/// マテリアルファイル名を取得
+		/// </summary>
+		const std::string& GetMaterialFilename() const { return materialFilename_; }
+
+		/// <summary>
+		/// モデルデータにコピーする
+		/// </summary>
+		/// <param name="modelData">コピー先</param>
+		void CopyTo(ObjLoader::ModelData& modelData) const;
+
+	private:
+		// マッピングしたキャッシュファイル
+		MappedFile file_;
+		// メッシュ参照配列
+		std::vector<MeshView> meshes_;
+		// マテリアル配列
+		std::vector<ObjLoader::MaterialData> materials_;
+		// マテリアルファイル名
+		std::string materialFilename_;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// キャッシュ書き込み
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルパス</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="sources">キャッシュ元ファイル</param>
+	/// <param name="modelData">モデルデータ</param>
+	/// <returns>成否</returns>
+	static bool Write(
+	    const std::string& cachePath, bool smoothing, const std::vector<SourceFile>& sources,
+	    const ObjLoader::ModelData& modelData);
+
+	/// <summary>
+	/// キャッシュ元ファイル情報の取得
+	/// </summary>
+	/// <param name="path">ファイルパス</param>
+	/// <param name="sourceFile">ファイル情報</param>
+	/// <returns>ファイルが存在すればtrue</returns>
+	static bool GetSourceFile(const std::string& path, SourceFile& sourceFile);
+
+	/// <summary>
+	/// キャッシュ元ファイル群の内容ハッシュ（FNV-1a 64bit）
+	/// </summary>
+	/// <param name="sources">キャッシュ元ファイル</param>
+	/// <returns>ハッシュ値</returns>
+	static uint64_t HashSources(const std::vector<SourceFile>& sources);
+
+	/// <summary>
+	/// FNV-1a 64bitハッシュ
+	/// </summary>
+	/// <param name="data">データ</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="hash">初期値（連結時は前回の結果）</param>
+	/// <returns>ハッシュ値</returns>
+	static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull);
+};
@@ -0,0 +1,391 @@
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Forsyth法のキャッシュモデル（LRU）のサイズ
+const uint32_t kScoreCacheSize = 32;
+// キャッシュ位置スコアの減衰指数
+const float kCacheDecayPower = 1.5f;
+// 直前の三角形で使った頂点のスコア
+const float kLastTriangleScore = 0.75f;
+// 残り三角形数によるスコアの係数と指数
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+// 残り三角形数スコアの表の大きさ
+const uint32_t kValenceTableSize = 64;
+
+// 基数ソートの1桁のビット数
+const uint32_t kRadixBits = 11;
+const uint32_t kRadixSize = 1u << kRadixBits;
+
+// 上位32bitをキーとして安定な並列LSD基数ソートを行う（maxKey を超える桁は省略）
+void RadixSortByKey(
+    std::vector<uint64_t>& items, std::vector<uint64_t>& temp, uint32_t maxKey,
+    uint32_t threadCount) {
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	// スレッド毎・桁の値毎の個数（書き込み位置に置き換えて使う）
+	std::vector<size_t> histograms(size_t(threadCount) * kRadixSize);
+
+	for (uint32_t shift = 32; shift < 64 && (uint64_t(maxKey) >> (shift - 32)) != 0;
+	     shift += kRadixBits) {
+		std::fill(histograms.begin(), histograms.end(), size_t(0));
+		threadPool->ParallelFor(
+		    threadCount, items.size(), [&](size_t begin, size_t end, uint32_t t) {
+			    size_t* histogram = &histograms[size_t(t) * kRadixSize];
+			    for (size_t i = begin; i < end; i++) {
+				    histogram[(items[i] >> shift) & (kRadixSize - 1)]++;
+			    }
+		    });
+
+		// 桁の値が小さい順、同じ値ならスレッド順に並ぶよう書き込み位置を決める
+		size_t offset = 0;
+		for (uint32_t digit = 0; digit < kRadixSize; digit++) {
+			for (uint32_t t = 0; t < threadCount; t++) {
+				size_t count = histograms[size_t(t) * kRadixSize + digit];
+				histograms[size_t(t) * kRadixSize + digit] = offset;
+				offset += count;
+			}
+		}
+
+		threadPool->ParallelFor(
+		    threadCount, items.size(), [&](size_t begin, size_t end, uint32_t t) {
+			    size_t* position = &histograms[size_t(t) * kRadixSize];
+			    for (size_t i = begin; i < end; i++) {
+				    temp[position[(items[i] >> shift) & (kRadixSize - 1)]++] = items[i];
+			    }
+		    });
+		items.swap(temp);
+	}
+}
+
+// 頂点のビット列をキーにする
+struct VertexKey {
+	uint32_t words[sizeof(Mesh::VertexPosNormalUv) / sizeof(uint32_t)];
+
+	bool operator==(const VertexKey& other) const {
+		return std::memcmp(words, other.words, sizeof(words)) == 0;
+	}
+};
+
+struct VertexKeyHash {
+	size_t operator()(const VertexKey& key) const {
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (uint32_t word : key.words) {
+			hash = (hash ^ word) * 0x100000001b3ull;
+		}
+		return size_t(hash ^ (hash >> 32));
+	}
+};
+
+// Forsyth法の頂点スコア表
+struct ScoreTable {
+	float cache[kScoreCacheSize];
+	float valence[kValenceTableSize];
+
+	ScoreTable() {
+		for (uint32_t i = 0; i < kScoreCacheSize; i++) {
+			if (i < 3) {
+				cache[i] = kLastTriangleScore;
+			} else {
+				float scaler = 1.0f / float(kScoreCacheSize - 3);
+				cache[i] = std::pow(1.0f - float(i - 3) * scaler, kCacheDecayPower);
+			}
+		}
+		valence[0] = 0.0f;
+		for (uint32_t i = 1; i < kValenceTableSize; i++) {
+			valence[i] = kValenceBoostScale * std::pow(float(i), -kValenceBoostPower);
+		}
+	}
+
+	float Get(int32_t cachePosition, uint32_t remaining) const {
+		// 使い切った頂点は選ばれないようにする
+		if (remaining == 0) {
+			return -1.0f;
+		}
+		float score = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+		score += remaining < kValenceTableSize
+		             ? valence[remaining]
+		             : kValenceBoostScale * std::pow(float(remaining), -kValenceBoostPower);
+		return score;
+	}
+};
+
+} // namespace
+
+void MeshOptimizer::Stats::Accumulate(const Stats& other) {
+	vertexCountBefore += other.vertexCountBefore;
+	vertexCountAfter += other.vertexCountAfter;
+	triangleCount += other.triangleCount;
+	cacheMissBefore += other.cacheMissBefore;
+	cacheMissAfter += other.cacheMissAfter;
+}
+
+MeshOptimizer::Stats MeshOptimizer::Optimize(
+    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices) {
+	Stats stats;
+	stats.vertexCountBefore = vertices.size();
+	stats.triangleCount = indices.size() / 3;
+	stats.cacheMissBefore = CountCacheMiss(indices, vertices.size());
+
+	WeldVertices(vertices, indices);
+	OptimizeVertexCache(indices, vertices.size());
+	OptimizeVertexFetch(vertices, indices);
+
+	stats.vertexCountAfter = vertices.size();
+	stats.cacheMissAfter = CountCacheMiss(indices, vertices.size());
+	return stats;
+}
+
+void MeshOptimizer::SmoothNormals(
+    std::vector<Mesh::VertexPosNormalUv>& vertices, const std::vector<uint32_t>& positionIndices,
+    uint32_t threadCount) {
+	assert(vertices.size() == positionIndices.size());
+	size_t count = vertices.size();
+	if (count == 0) {
+		return;
+	}
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	if (threadCount == 0) {
+		threadCount = threadPool->GetThreadCount();
+	}
+	if (count < kParallelThreshold) {
+		threadCount = 1;
+	}
+
+	// (座標番号, 頂点番号) の組を座標番号でソートすると、座標を共有する頂点が連続する
+	// 作業領域は頂点あたり16バイトで済む
+	std::vector<uint64_t> items(count);
+	std::vector<uint64_t> temp(count);
+	uint32_t maxKey = 0;
+	for (size_t i = 0; i < count; i++) {
+		items[i] = (uint64_t(positionIndices[i]) << 32) | uint64_t(i);
+		maxKey = std::max(maxKey, positionIndices[i]);
+	}
+	RadixSortByKey(items, temp, maxKey, threadCount);
+
+	// 区間の境界をグループの先頭に合わせ、グループ単位で並列に平均する
+	threadPool->ParallelFor(threadCount, count, [&](size_t begin, size_t end, uint32_t) {
+		auto keyOf = [&](size_t i) { return uint32_t(items[i] >> 32); };
+		while (begin != 0 && begin < count && keyOf(begin) == keyOf(begin - 1)) {
+			begin++;
+		}
+		while (end < count && end != 0 && keyOf(end) == keyOf(end - 1)) {
+			end++;
+		}
+
+		size_t groupBegin = begin;
+		while (groupBegin < end) {
+			uint32_t key = keyOf(groupBegin);
+			size_t groupEnd = groupBegin + 1;
+			while (groupEnd < end && keyOf(groupEnd) == key) {
+				groupEnd++;
+			}
+
+			Vector3 normal = {0.0f, 0.0f, 0.0f};
+			for (size_t i = groupBegin; i < groupEnd; i++) {
+				const Vector3& n = vertices[uint32_t(items[i])].normal;
+				normal.x += n.x;
+				normal.y += n.y;
+				normal.z += n.z;
+			}
+			float length =
+			    std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if (length != 0.0f) {
+				normal = {normal.x / length, normal.y / length, normal.z / length};
+			}
+			for (size_t i = groupBegin; i < groupEnd; i++) {
+				vertices[uint32_t(items[i])].normal = normal;
+			}
+			groupBegin = groupEnd;
+		}
+	});
+}
+
+void MeshOptimizer::WeldVertices(
+    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices) {
+	static_assert(sizeof(VertexKey) == sizeof(Mesh::VertexPosNormalUv));
+
+	std::unordered_map<VertexKey, uint32_t, VertexKeyHash> unique;
+	unique.reserve(vertices.size());
+
+	// 旧頂点番号 → 新頂点番号
+	std::vector<uint32_t> remap(vertices.size());
+	size_t uniqueCount = 0;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		VertexKey key;
+		std::memcpy(key.words, &vertices[i], sizeof(key.words));
+		auto [it, inserted] = unique.try_emplace(key, static_cast<uint32_t>(uniqueCount));
+		if (inserted) {
+			vertices[uniqueCount++] = vertices[i];
+		}
+		remap[i] = it->second;
+	}
+	vertices.resize(uniqueCount);
+
+	for (uint32_t& index : indices) {
+		index = remap[index];
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+	static const ScoreTable kScoreTable;
+
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 頂点毎の隣接三角形リスト（未出力の三角形だけを先頭に詰めて持つ）
+	std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		remaining[indices[i]]++;
+	}
+	for (size_t v = 0; v < vertexCount; v++) {
+		adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+	}
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; i++) {
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// 頂点スコアと三角形スコアの初期化
+	std::vector<int32_t> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		vertexScore[v] = kScoreTable.Get(-1, remaining[v]);
+	}
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<uint8_t> emitted(triangleCount, 0);
+	uint32_t best = 0;
+	float bestScore = -1.0f;
+	for (size_t t = 0; t < triangleCount; t++) {
+		const uint32_t* tri = &indices[t * 3];
+		triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+		if (triangleScore[t] > bestScore) {
+			bestScore = triangleScore[t];
+			best = static_cast<uint32_t>(t);
+		}
+	}
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(kScoreCacheSize + 3);
+	newCache.reserve(kScoreCacheSize + 3);
+	// キャッシュ内に候補が無いときに入力順で探す位置
+	size_t cursor = 0;
+
+	while (result.size() < triangleCount * 3) {
+		if (bestScore < 0.0f) {
+			while (emitted[cursor]) {
+				cursor++;
+			}
+			best = static_cast<uint32_t>(cursor);
+		}
+
+		// 三角形を出力
+		const uint32_t* tri = &indices[size_t(best) * 3];
+		result.insert(result.end(), tri, tri + 3);
+		emitted[best] = 1;
+
+		// 隣接リストから外す
+		for (int k = 0; k < 3; k++) {
+			uint32_t v = tri[k];
+			uint32_t* begin = &adjacency[adjacencyOffset[v]];
+			uint32_t* end = begin + remaining[v];
+			uint32_t* found = std::find(begin, end, best);
+			assert(found != end);
+			*found = end[-1];
+			remaining[v]--;
+		}
+
+		// LRUキャッシュの更新（出力した頂点を先頭へ）
+		newCache.clear();
+		for (int k = 0; k < 3; k++) {
+			if (std::find(newCache.begin(), newCache.end(), tri[k]) == newCache.end()) {
+				newCache.push_back(tri[k]);
+			}
+		}
+		for (uint32_t v : cache) {
+			if (v != tri[0] && v != tri[1] && v != tri[2]) {
+				newCache.push_back(v);
+			}
+		}
+		for (size_t i = 0; i < newCache.size(); i++) {
+			uint32_t v = newCache[i];
+			cachePosition[v] = i < kScoreCacheSize ? int32_t(i) : -1;
+			vertexScore[v] = kScoreTable.Get(cachePosition[v], remaining[v]);
+		}
+
+		// 影響を受けた三角形のスコアを更新して次の候補を選ぶ
+		bestScore = -1.0f;
+		for (uint32_t v : newCache) {
+			const uint32_t* adjacent = &adjacency[adjacencyOffset[v]];
+			for (uint32_t i = 0; i < remaining[v]; i++) {
+				uint32_t t = adjacent[i];
+				const uint32_t* other = &indices[size_t(t) * 3];
+				float score = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+				triangleScore[t] = score;
+				if (score > bestScore) {
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+
+		if (newCache.size() > kScoreCacheSize) {
+			newCache.resize(kScoreCacheSize);
+		}
+		cache.swap(newCache);
+	}
+
+	// 三角形の端数（3で割り切れない分）は捨てる
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(
+    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices) {
+	const uint32_t kUnused = 0xffffffff;
+
+	// インデックスで初めて参照された順に番号を振り直す
+	std::vector<uint32_t> remap(vertices.size(), kUnused);
+	std::vector<Mesh::VertexPosNormalUv> reordered;
+	reordered.reserve(vertices.size());
+	for (uint32_t& index : indices) {
+		if (remap[index] == kUnused) {
+			remap[index] = static_cast<uint32_t>(reordered.size());
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(reordered);
+}
+
+size_t MeshOptimizer::CountCacheMiss(
+    const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+	// 各頂点がキャッシュに入った時刻。現在時刻との差がキャッシュサイズ未満ならヒット
+	std::vector<size_t> cacheTime(vertexCount, 0);
+	size_t timestamp = size_t(cacheSize) + 1;
+	size_t cacheMiss = 0;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		for (int k = 0; k < 3; k++) {
+			uint32_t v = indices[i + k];
+			if (timestamp - cacheTime[v] > cacheSize) {
+				cacheTime[v] = timestamp++;
+				cacheMiss++;
+			}
+		}
+	}
+	return cacheMiss;
+}
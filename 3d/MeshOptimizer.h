@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Mesh.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// メッシュ最適化（法線平滑化、頂点の統合、頂点キャッシュ・フェッチ順の並べ替え）
+/// </summary>
+class MeshOptimizer {
+public: // 定数
+	// ACMR計測に使う頂点キャッシュ（FIFO）のサイズ
+	static const uint32_t kDefaultCacheSize = 16;
+	// これより頂点が少なければ並列化しない
+	static const size_t kParallelThreshold = 0x10000;
+
+public: // サブクラス
+	// 最適化統計
+	struct Stats {
+		// 最適化前の頂点数
+		size_t vertexCountBefore = 0;
+		// 最適化後の頂点数
+		size_t vertexCountAfter = 0;
+		// 三角形数
+		size_t triangleCount = 0;
+		// 最適化前のキャッシュミス数
+		size_t cacheMissBefore = 0;
+		// 最適化後のキャッシュミス数
+		size_t cacheMissAfter = 0;
+
+		// 三角形あたりのキャッシュミス数（ACMR）
+		float GetACMRBefore() const { return CalcRatio(cacheMissBefore); }
+		float GetACMRAfter() const { return CalcRatio(cacheMissAfter); }
+
+		// 複数メッシュの統計を合算する
+		void Accumulate(const Stats& other);
+
+	private:
+		float CalcRatio(size_t cacheMiss) const {
+			return triangleCount ? float(cacheMiss) / float(triangleCount) : 0.0f;
+		}
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 全工程をまとめて実行（統合 → 三角形並べ替え → 頂点並べ替え）
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="indices">インデックス配列（三角形リスト）</param>
+	/// <returns>最適化統計</returns>
+	static Stats Optimize(
+	    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// 同じ座標を共有する頂点の法線を平均する（座標番号で基数ソートし、グループ毎に並列で平均）
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="positionIndices">頂点毎の座標番号（vertices と同じ要素数）</param>
+	/// <param name="threadCount">スレッド数（0ならハードウェアスレッド数）</param>
+	static void SmoothNormals(
+	    std::vector<Mesh::VertexPosNormalUv>& vertices,
+	    const std::vector<uint32_t>& positionIndices, uint32_t threadCount = 0);
+
+	/// <summary>
+	/// 同一頂点の統合（座標・法線・UVがビット単位で一致するものをまとめる）
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="indices">インデックス配列</param>
+	static void WeldVertices(
+	    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// 頂点キャッシュ効率のための三角形並べ替え（Forsyth法）
+	/// </summary>
+	/// <param name="indices">インデックス配列（三角形リスト）</param>
+	/// <param name="vertexCount">頂点数</param>
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+	/// <summary>
+	/// 頂点フェッチ局所性のための頂点並べ替え（インデックス初出順に詰め、未使用頂点を除く）
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="indices">インデックス配列</param>
+	static void OptimizeVertexFetch(
+	    std::vector<Mesh::VertexPosNormalUv>& vertices, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// FIFO頂点キャッシュをシミュレートしてキャッシュミス数を数える
+	/// </summary>
+	/// <param name="indices">インデックス配列（三角形リスト）</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="cacheSize">キャッシュサイズ</param>
+	/// <returns>キャッシュミス数</returns>
+	static size_t CountCacheMiss(
+	    const std::vector<uint32_t>& indices, size_t vertexCount,
+	    uint32_t cacheSize = kDefaultCacheSize);
+};
@@ -0,0 +1,350 @@
+#include "ObjLoader.h"
+#include "MeshCache.h"
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+using namespace std::chrono;
+
+const std::string ObjLoader::kBaseDirectory = "Resources/";
+ObjLoader::LoadStats ObjLoader::sLastLoadStats_;
+
+namespace {
+
+// 空白を読み飛ばす
+void SkipSpaces(const char*& p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t')) {
+		++p;
+	}
+}
+
+// 空白区切りの単語を1つ取り出す
+std::string_view NextToken(const char*& p, const char* end) {
+	SkipSpaces(p, end);
+	const char* begin = p;
+	while (p < end && *p != ' ' && *p != '\t' && *p != '\r') {
+		++p;
+	}
+	return std::string_view(begin, size_t(p - begin));
+}
+
+// 行末までの残りを取り出す（ファイル名に空白を含む場合用）
+std::string_view RestOfLine(const char*& p, const char* end) {
+	SkipSpaces(p, end);
+	const char* begin = p;
+	const char* last = end;
+	while (begin < last && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) {
+		--last;
+	}
+	p = end;
+	return std::string_view(begin, size_t(last - begin));
+}
+
+bool ParseFloat(const char*& p, const char* end, float& value) {
+	SkipSpaces(p, end);
+	auto result = std::from_chars(p, end, value);
+	if (result.ec != std::errc()) {
+		return false;
+	}
+	p = result.ptr;
+	return true;
+}
+
+bool ParseVector3(const char*& p, const char* end, Vector3& v) {
+	return ParseFloat(p, end, v.x) && ParseFloat(p, end, v.y) && ParseFloat(p, end, v.z);
+}
+
+// OBJの頂点番号（1始まり、負数は末尾からの相対）を0始まりに変換する
+bool ParseObjIndex(std::string_view token, size_t count, int32_t& index) {
+	int32_t value = 0;
+	auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+	if (result.ec != std::errc() || value == 0) {
+		return false;
+	}
+	index = value > 0 ? value - 1 : int32_t(count) + value;
+	return 0 <= index && size_t(index) < count;
+}
+
+// ファイルを1行ずつ処理する
+template<class Func> void ForEachLine(const char* data, size_t size, Func func) {
+	const char* p = data;
+	const char* end = data + size;
+	while (p < end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+		if (lineEnd == nullptr) {
+			lineEnd = end;
+		}
+		func(p, lineEnd);
+		p = lineEnd + 1;
+	}
+}
+
+} // namespace
+
+bool ObjLoader::Load(const std::string& modelname, bool smoothing, ModelData& modelData) {
+	steady_clock::time_point start = steady_clock::now();
+
+	// 有効なキャッシュがあれば解析せずに使う
+	{
+		MeshCache::Reader reader;
+		if (reader.Open(GetCachePath(modelname), smoothing)) {
+			reader.CopyTo(modelData);
+			sLastLoadStats_ = {};
+			sLastLoadStats_.cacheHit = true;
+			sLastLoadStats_.cacheTime = duration_cast<microseconds>(steady_clock::now() - start);
+			sLastLoadStats_.totalTime = sLastLoadStats_.cacheTime;
+			return true;
+		}
+	}
+
+	if (!LoadFromSource(modelname, smoothing, modelData)) {
+		return false;
+	}
+	sLastLoadStats_.totalTime = duration_cast<microseconds>(steady_clock::now() - start);
+	return true;
+}
+
+bool ObjLoader::LoadFromSource(
+    const std::string& modelname, bool smoothing, ModelData& modelData) {
+	steady_clock::time_point start = steady_clock::now();
+	sLastLoadStats_ = {};
+
+	const std::string directoryPath = GetDirectoryPath(modelname);
+	const std::string filename = modelname + ".obj";
+
+	// OBJ/MTL解析
+	if (!ParseObj(directoryPath, filename, smoothing, modelData)) {
+		return false;
+	}
+	steady_clock::time_point parsed = steady_clock::now();
+
+	// 頂点の統合と描画順の最適化
+	for (MeshData& mesh : modelData.meshes) {
+		sLastLoadStats_.optimizeStats.Accumulate(
+		    MeshOptimizer::Optimize(mesh.vertices, mesh.indices));
+	}
+	steady_clock::time_point optimized = steady_clock::now();
+
+	// 次回起動用にキャッシュを書き出す（失敗しても読み込み自体は成功扱い）
+	std::vector<MeshCache::SourceFile> sources;
+	MeshCache::SourceFile source;
+	if (MeshCache::GetSourceFile(directoryPath + filename, source)) {
+		sources.push_back(source);
+	}
+	if (!modelData.materialFilename.empty() &&
+	    MeshCache::GetSourceFile(directoryPath + modelData.materialFilename, source)) {
+		sources.push_back(source);
+	}
+	MeshCache::Write(GetCachePath(modelname), smoothing, sources, modelData);
+
+	steady_clock::time_point end = steady_clock::now();
+	sLastLoadStats_.parseTime = duration_cast<microseconds>(parsed - start);
+	sLastLoadStats_.optimizeTime = duration_cast<microseconds>(optimized - parsed);
+	sLastLoadStats_.cacheTime = duration_cast<microseconds>(end - optimized);
+	sLastLoadStats_.totalTime = duration_cast<microseconds>(end - start);
+	return true;
+}
+
+std::string ObjLoader::GetDirectoryPath(const std::string& modelname) {
+	return kBaseDirectory + modelname + "/";
+}
+
+std::string ObjLoader::GetCachePath(const std::string& modelname) {
+	return GetDirectoryPath(modelname) + modelname + ".meshcache";
+}
+
+bool ObjLoader::ParseObj(
+    const std::string& directoryPath, const std::string& filename, bool smoothing,
+    ModelData& modelData) {
+	modelData = {};
+
+	MeshCache::MappedFile file;
+	if (!file.Open(directoryPath + filename)) {
+		return false;
+	}
+
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texcoords;
+	// 頂点法線スムージング用データ（頂点毎の座標インデックス）
+	std::vector<uint32_t> positionIndices;
+
+	MeshData mesh;
+	bool succeeded = true;
+
+	// メッシュを確定して次のメッシュを開始する
+	auto flushMesh = [&]() {
+		if (!mesh.indices.empty()) {
+			if (smoothing) {
+				MeshOptimizer::SmoothNormals(mesh.vertices, positionIndices);
+			}
+			modelData.meshes.push_back(std::move(mesh));
+		}
+		mesh = {};
+		positionIndices.clear();
+	};
+
+	auto parseLine = [&](const char* p, const char* end) {
+		if (!succeeded) {
+			return;
+		}
+		std::string_view key = NextToken(p, end);
+
+		if (key == "v") {
+			// 頂点座標
+			Vector3 position{};
+			succeeded = ParseVector3(p, end, position);
+			positions.push_back(position);
+		} else if (key == "vt") {
+			// テクスチャ座標（V方向反転）
+			Vector2 texcoord{};
+			succeeded = ParseFloat(p, end, texcoord.x) && ParseFloat(p, end, texcoord.y);
+			texcoord.y = 1.0f - texcoord.y;
+			texcoords.push_back(texcoord);
+		} else if (key == "vn") {
+			// 法線ベクトル
+			Vector3 normal{};
+			succeeded = ParseVector3(p, end, normal);
+			normals.push_back(normal);
+		} else if (key == "f") {
+			// ポリゴン。4頂点目以降は扇状に三角形分割する
+			size_t faceIndexCount = 0;
+			size_t base = mesh.vertices.size();
+			for (std::string_view token = NextToken(p, end); !token.empty();
+			     token = NextToken(p, end)) {
+				Mesh::VertexPosNormalUv vertex{};
+				int32_t indexPosition = 0;
+				size_t slash1 = token.find('/');
+				if (!ParseObjIndex(token.substr(0, slash1), positions.size(), indexPosition)) {
+					succeeded = false;
+					return;
+				}
+				vertex.pos = positions[indexPosition];
+				if (slash1 != std::string_view::npos) {
+					std::string_view rest = token.substr(slash1 + 1);
+					size_t slash2 = rest.find('/');
+					int32_t index = 0;
+					if (ParseObjIndex(rest.substr(0, slash2), texcoords.size(), index)) {
+						vertex.uv = texcoords[index];
+					}
+					if (slash2 != std::string_view::npos &&
+					    ParseObjIndex(rest.substr(slash2 + 1), normals.size(), index)) {
+						vertex.normal = normals[index];
+					}
+				}
+
+				uint32_t indexVertex = static_cast<uint32_t>(mesh.vertices.size());
+				mesh.vertices.push_back(vertex);
+				if (smoothing) {
+					positionIndices.push_back(uint32_t(indexPosition));
+				}
+
+				// 三角形は3頂点揃ってから出す（途中で終わる面が後の三角形をずらさないように）
+				if (faceIndexCount == 2) {
+					mesh.indices.push_back(static_cast<uint32_t>(base));
+					mesh.indices.push_back(indexVertex - 1);
+					mesh.indices.push_back(indexVertex);
+				} else if (faceIndexCount >= 3) {
+					mesh.indices.push_back(indexVertex - 1);
+					mesh.indices.push_back(indexVertex);
+					mesh.indices.push_back(static_cast<uint32_t>(base));
+				}
+				faceIndexCount++;
+			}
+			// 3頂点に満たない面は壊れたファイルとして扱う
+			if (faceIndexCount < 3) {
+				succeeded = false;
+			}
+		} else if (key == "o" || key == "g") {
+			// グループ毎にメッシュを分ける
+			flushMesh();
+			mesh.name = std::string(NextToken(p, end));
+		} else if (key == "usemtl") {
+			mesh.materialName = std::string(NextToken(p, end));
+		} else if (key == "mtllib") {
+			modelData.materialFilename = std::string(RestOfLine(p, end));
+			succeeded = ParseMtl(directoryPath, modelData.materialFilename, modelData.materials);
+		}
+	};
+	ForEachLine(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), parseLine);
+	flushMesh();
+
+	return succeeded;
+}
+
+bool ObjLoader::ParseMtl(
+    const std::string& directoryPath, const std::string& filename,
+    std::vector<MaterialData>& materials) {
+	MeshCache::MappedFile file;
+	if (!file.Open(directoryPath + filename)) {
+		return false;
+	}
+
+	MaterialData* material = nullptr;
+	bool succeeded = true;
+	auto parseLine = [&](const char* p, const char* end) {
+		std::string_view key = NextToken(p, end);
+		if (key == "newmtl") {
+			material = &materials.emplace_back();
+			material->name = std::string(NextToken(p, end));
+			return;
+		}
+		if (material == nullptr) {
+			return;
+		}
+		if (key == "Ka") {
+			succeeded = ParseVector3(p, end, material->ambient) && succeeded;
+		} else if (key == "Kd") {
+			succeeded = ParseVector3(p, end, material->diffuse) && succeeded;
+		} else if (key == "Ks") {
+			succeeded = ParseVector3(p, end, material->specular) && succeeded;
+		} else if (key == "d") {
+			succeeded = ParseFloat(p, end, material->alpha) && succeeded;
+		} else if (key == "map_Kd") {
+			material->textureFilename = std::string(RestOfLine(p, end));
+		}
+	};
+	ForEachLine(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), parseLine);
+	return succeeded;
+}
+
+Material* ObjLoader::CreateMaterial(const MaterialData& materialData) {
+	Material* material = Material::Create();
+	material->name_ = materialData.name;
+	material->ambient_ = materialData.ambient;
+	material->diffuse_ = materialData.diffuse;
+	material->specular_ = materialData.specular;
+	material->alpha_ = materialData.alpha;
+	material->textureFilename_ = materialData.textureFilename;
+	material->Update();
+	return material;
+}
+
+std::string
+    ObjLoader::GetTexturePath(const MaterialData& materialData, const std::string& directoryPath) {
+	// テクスチャ指定が無ければ白テクスチャ
+	if (materialData.textureFilename.empty()) {
+		return "white1x1.png";
+	}
+	return directoryPath + materialData.textureFilename;
+}
+
+Mesh* ObjLoader::CreateMesh(const MeshData& meshData, Material* material) {
+	// Mesh::AddIndex は16bit
+	if (meshData.vertices.size() > 0x10000) {
+		return nullptr;
+	}
+
+	Mesh* mesh = new Mesh();
+	mesh->SetName(meshData.name);
+	for (const Mesh::VertexPosNormalUv& vertex : meshData.vertices) {
+		mesh->AddVertex(vertex);
+	}
+	for (uint32_t index : meshData.indices) {
+		mesh->AddIndex(static_cast<unsigned short>(index));
+	}
+	mesh->SetMaterial(material);
+	mesh->CreateBuffers();
+	return mesh;
+}
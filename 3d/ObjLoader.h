@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// OBJファイル高速読み込み
+/// </summary>
+class ObjLoader {
+public: // サブクラス
+	// マテリアルデータ
+	struct MaterialData {
+		std::string name;                      // マテリアル名
+		Vector3 ambient = {0.3f, 0.3f, 0.3f}; // アンビエント影響度
+		Vector3 diffuse = {0.0f, 0.0f, 0.0f}; // ディフューズ影響度
+		Vector3 specular = {0.0f, 0.0f, 0.0f}; // スペキュラー影響度
+		float alpha = 1.0f;                    // アルファ
+		std::string textureFilename;           // テクスチャファイル名
+	};
+
+	// メッシュデータ
+	struct MeshData {
+		// 名前
+		std::string name;
+		// マテリアル名
+		std::string materialName;
+		// 頂点データ配列
+		std::vector<Mesh::VertexPosNormalUv> vertices;
+		// 頂点インデックス配列（GPU転送時に頂点数から16bit/32bitを選ぶ）
+		std::vector<uint32_t> indices;
+	};
+
+	// モデルデータ
+	struct ModelData {
+		// メッシュ配列
+		std::vector<MeshData> meshes;
+		// マテリアル配列
+		std::vector<MaterialData> materials;
+		// マテリアルファイル名
+		std::string materialFilename;
+	};
+
+	// 読み込み統計
+	struct LoadStats {
+		// キャッシュから読み込んだか
+		bool cacheHit = false;
+		// OBJ/MTL解析時間
+		std::chrono::microseconds parseTime{};
+		// メッシュ最適化時間
+		std::chrono::microseconds optimizeTime{};
+		// キャッシュ読み書き時間
+		std::chrono::microseconds cacheTime{};
+		// 合計時間
+		std::chrono::microseconds totalTime{};
+		// メッシュ最適化統計（キャッシュから読んだ場合は空）
+		MeshOptimizer::Stats optimizeStats;
+	};
+
+public: // 定数
+	// モデル格納ディレクトリ
+	static const std::string kBaseDirectory;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// モデル読み込み（キャッシュが有効ならキャッシュから、無効ならOBJを解析・最適化して
+	/// キャッシュを作る）
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="modelData">読み込んだモデルデータ</param>
+	/// <returns>成否</returns>
+	static bool Load(const std::string& modelname, bool smoothing, ModelData& modelData);
+
+	/// <summary>
+	/// OBJを解析・最適化してキャッシュを作る（キャッシュは見ない。Load で外れた場合の処理）
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="modelData">読み込んだモデルデータ</param>
+	/// <returns>成否</returns>
+	static bool LoadFromSource(const std::string& modelname, bool smoothing, ModelData& modelData);
+
+	/// <summary>
+	/// モデルのディレクトリパス（テクスチャもここから読む）
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <returns>ディレクトリパス（末尾に / が付く）</returns>
+	static std::string GetDirectoryPath(const std::string& modelname);
+
+	/// <summary>
+	/// モデルのキャッシュファイルパス（MeshCache::Reader で直接開ける）
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <returns>キャッシュファイルパス</returns>
+	static std::string GetCachePath(const std::string& modelname);
+
+	/// <summary>
+	/// OBJファイル解析（キャッシュを使わない）
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリパス</param>
+	/// <param name="filename">OBJファイル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="modelData">解析したモデルデータ</param>
+	/// <returns>成否</returns>
+	static bool ParseObj(
+	    const std::string& directoryPath, const std::string& filename, bool smoothing,
+	    ModelData& modelData);
+
+	/// <summary>
+	/// MTLファイル解析
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリパス</param>
+	/// <param name="filename">MTLファイル名</param>
+	/// <param name="materials">解析したマテリアルの追加先</param>
+	/// <returns>成否</returns>
+	static bool ParseMtl(
+	    const std::string& directoryPath, const std::string& filename,
+	    std::vector<MaterialData>& materials);
+
+	/// <summary>
+	/// マテリアル生成（テクスチャは読み込まない。Mesh で使うなら Material::LoadTexture、
+	/// StaticMesh なら GetTexturePath のテクスチャを TextureStreamer から読む）
+	/// </summary>
+	/// <param name="materialData">マテリアルデータ</param>
+	/// <returns>生成されたマテリアル</returns>
+	static Material* CreateMaterial(const MaterialData& materialData);
+
+	/// <summary>
+	/// マテリアルのテクスチャのパス（テクスチャ指定が無ければ白テクスチャ）
+	/// </summary>
+	/// <param name="materialData">マテリアルデータ</param>
+	/// <param name="directoryPath">テクスチャ読み込みディレクトリパス</param>
+	/// <returns>TextureStreamer::Load と同じ指定のパス</returns>
+	static std::string
+	    GetTexturePath(const MaterialData& materialData, const std::string& directoryPath);
+
+	/// <summary>
+	/// メッシュ生成（Meshは16bitインデックス専用。超える場合は StaticMesh を使う）
+	/// </summary>
+	/// <param name="meshData">メッシュデータ</param>
+	/// <param name="material">割り当てるマテリアル</param>
+	/// <returns>生成されたメッシュ。頂点数が16bitに収まらなければnullptr</returns>
+	static Mesh* CreateMesh(const MeshData& meshData, Material* material);
+
+	/// <summary>
+	/// 直近の読み込み統計を取得
+	/// </summary>
+	/// <returns>読み込み統計</returns>
+	static const LoadStats& GetLastLoadStats() { return sLastLoadStats_; }
+
+private: // 静的メンバ変数
+	// 直近の読み込み統計
+	static LoadStats sLastLoadStats_;
+};
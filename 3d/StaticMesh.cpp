@@ -0,0 +1,554 @@
+#include "StaticMesh.h"
+#include "DirectXCommon.h"
+#include "ShaderCompiler.h"
+#include "Model.h"
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <d3dx12.h>
+#include <string>
+
+std::unique_ptr<LightGroup> StaticMesh::sDefaultLightGroup_;
+LightGroup* StaticMesh::sLightGroup_ = nullptr;
+ID3D12GraphicsCommandList* StaticMesh::sCommandListPacked_ = nullptr;
+Microsoft::WRL::ComPtr<ID3D12RootSignature> StaticMesh::sRootSignaturePacked_;
+Microsoft::WRL::ComPtr<ID3D12PipelineState> StaticMesh::sPipelineStatePacked_;
+ID3D12GraphicsCommandList* StaticMesh::sCommandListBindless_ = nullptr;
+StaticMesh::VertexFormat StaticMesh::sVertexFormatBindless_ = StaticMesh::VertexFormat::kFull;
+Microsoft::WRL::ComPtr<ID3D12RootSignature> StaticMesh::sRootSignatureBindless_;
+std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 2> StaticMesh::sPipelineStatesBindless_;
+ID3D12GraphicsCommandList* StaticMesh::sCommandListClustered_ = nullptr;
+StaticMesh::VertexFormat StaticMesh::sVertexFormatClustered_ = StaticMesh::VertexFormat::kFull;
+Microsoft::WRL::ComPtr<ID3D12RootSignature> StaticMesh::sRootSignatureClustered_;
+std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 2> StaticMesh::sPipelineStatesClustered_;
+
+void StaticMesh::StaticInitialize() {
+	// Model と同じ既定ライトを持っておく
+	sDefaultLightGroup_.reset(LightGroup::Create());
+	sDefaultLightGroup_->Update();
+	sLightGroup_ = sDefaultLightGroup_.get();
+
+	// パイプライン初期化
+	InitializeGraphicsPipeline();
+}
+
+void StaticMesh::StaticFinalize() {
+	sLightGroup_ = nullptr;
+	sDefaultLightGroup_.reset();
+	sRootSignaturePacked_.Reset();
+	sPipelineStatePacked_.Reset();
+	sRootSignatureBindless_.Reset();
+	for (auto& pipelineState : sPipelineStatesBindless_) {
+		pipelineState.Reset();
+	}
+	sRootSignatureClustered_.Reset();
+	for (auto& pipelineState : sPipelineStatesClustered_) {
+		pipelineState.Reset();
+	}
+}
+
+void StaticMesh::InitializeGraphicsPipeline() {
+	// 量子化頂点（ピクセルシェーダは通常のOBJと共通）
+	ComPtr<ID3DBlob> vsPackedBlob =
+	    CompileShaderFromFile(L"Resources/shaders/ObjPackedVS.hlsl", "vs_5_0");
+	ComPtr<ID3DBlob> psBlob = CompileShaderFromFile(L"Resources/shaders/ObjPS.hlsl", "ps_5_0");
+	sRootSignaturePacked_ = CreateRootSignature(false);
+	sPipelineStatePacked_ = CreatePipelineState(
+	    VertexFormat::kPacked, vsPackedBlob.Get(), psBlob.Get(), sRootSignaturePacked_.Get());
+	ComPtr<ID3DBlob> vsFullBlob =
+	    CompileShaderFromFile(L"Resources/shaders/ObjVS.hlsl", "vs_5_0");
+
+	// クラスター化ライティング（点光源・スポットライト・丸影を区画毎の一覧から引く）
+	const D3D_SHADER_MACRO clusteredDefines[] = {
+	    {"CLUSTERED", "1"},
+	    {nullptr, nullptr},
+	};
+	ComPtr<ID3DBlob> psClusteredBlob =
+	    CompileShaderFromFile(L"Resources/shaders/ObjPS.hlsl", "ps_5_0", clusteredDefines);
+	sRootSignatureClustered_ = CreateRootSignature(false, true);
+	sPipelineStatesClustered_[static_cast<size_t>(VertexFormat::kFull)] = CreatePipelineState(
+	    VertexFormat::kFull, vsFullBlob.Get(), psClusteredBlob.Get(),
+	    sRootSignatureClustered_.Get());
+	sPipelineStatesClustered_[static_cast<size_t>(VertexFormat::kPacked)] = CreatePipelineState(
+	    VertexFormat::kPacked, vsPackedBlob.Get(), psClusteredBlob.Get(),
+	    sRootSignatureClustered_.Get());
+
+	// バインドレス（ヒープ全体を配列として引くので SM5.1 でコンパイルする）
+	if (!TextureStreamer::GetInstance()->IsBindlessSupported()) {
+		return;
+	}
+	const D3D_SHADER_MACRO defines[] = {
+	    {"BINDLESS", "1"},
+	    {nullptr, nullptr},
+	};
+	ComPtr<ID3DBlob> psBindlessBlob =
+	    CompileShaderFromFile(L"Resources/shaders/ObjPS.hlsl", "ps_5_1", defines);
+	sRootSignatureBindless_ = CreateRootSignature(true);
+	sPipelineStatesBindless_[static_cast<size_t>(VertexFormat::kFull)] = CreatePipelineState(
+	    VertexFormat::kFull, vsFullBlob.Get(), psBindlessBlob.Get(),
+	    sRootSignatureBindless_.Get());
+	sPipelineStatesBindless_[static_cast<size_t>(VertexFormat::kPacked)] = CreatePipelineState(
+	    VertexFormat::kPacked, vsPackedBlob.Get(), psBindlessBlob.Get(),
+	    sRootSignatureBindless_.Get());
+}
+
+Microsoft::WRL::ComPtr<ID3D12RootSignature> StaticMesh::CreateRootSignature(
+    bool bindless, bool clustered) {
+	HRESULT result = S_FALSE;
+
+	// デスクリプタレンジ（バインドレスはヒープ全体を非有界配列として別空間に割り当てる）
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	if (bindless) {
+		descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, kBindlessRegisterSpace);
+	} else {
+		descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+	}
+
+	// ルートパラメータ（Model と同じ並びに復元パラメータ、バインドレスはテクスチャ番号、
+	// クラスター化ライティングは区画定数と構造化バッファを足す）
+	CD3DX12_ROOT_PARAMETER rootparams[kRootParameterClusterConstants + 6];
+	rootparams[static_cast<size_t>(Model::RoomParameter::kWorldTransform)]
+	    .InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_ALL);
+	rootparams[static_cast<size_t>(Model::RoomParameter::kViewProjection)]
+	    .InitAsConstantBufferView(1, 0, D3D12_SHADER_VISIBILITY_ALL);
+	rootparams[static_cast<size_t>(Model::RoomParameter::kMaterial)].InitAsConstantBufferView(
+	    2, 0, D3D12_SHADER_VISIBILITY_ALL);
+	rootparams[static_cast<size_t>(Model::RoomParameter::kTexture)].InitAsDescriptorTable(
+	    1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+	rootparams[static_cast<size_t>(Model::RoomParameter::kLight)].InitAsConstantBufferView(
+	    3, 0, D3D12_SHADER_VISIBILITY_ALL);
+	rootparams[kRootParameterDequantize].InitAsConstantBufferView(
+	    4, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	rootparams[kRootParameterTextureIndex].InitAsConstants(
+	    1, 5, 0, D3D12_SHADER_VISIBILITY_PIXEL); // b5 レジスタ
+	rootparams[kRootParameterClusterConstants].InitAsConstants(
+	    sizeof(ClusteredLighting::ClusterConstants) / sizeof(uint32_t), 6, 0,
+	    D3D12_SHADER_VISIBILITY_PIXEL); // b6 レジスタ
+	for (UINT i = 0; i < 5; i++) {
+		// 区画の位置・ライト番号・点光源・スポットライト・丸影（t1～t5 レジスタ）
+		rootparams[kRootParameterClusterConstants + 1 + i].InitAsShaderResourceView(
+		    1 + i, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+	}
+	UINT numParameters = bindless ? kRootParameterTextureIndex + 1 : kRootParameterTextureIndex;
+	if (clustered) {
+		numParameters = _countof(rootparams);
+	}
+
+	// スタティックサンプラー
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc = CD3DX12_STATIC_SAMPLER_DESC(0);
+
+	// ルートシグネチャの設定
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	    numParameters, rootparams, 1, &samplerDesc,
+	    D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	ComPtr<ID3DBlob> errorBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	    &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+	// ルートシグネチャの生成
+	ComPtr<ID3D12RootSignature> rootSignature;
+	result = device->CreateRootSignature(
+	    0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	    IID_PPV_ARGS(&rootSignature));
+	assert(SUCCEEDED(result));
+	return rootSignature;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> StaticMesh::CreatePipelineState(
+    VertexFormat vertexFormat, ID3DBlob* vsBlob, ID3DBlob* psBlob,
+    ID3D12RootSignature* rootSignature) {
+	// 頂点レイアウト
+	D3D12_INPUT_ELEMENT_DESC inputLayoutFull[] = {
+	    {// xyz座標
+	     "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// 法線ベクトル
+	     "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// uv座標
+	     "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	D3D12_INPUT_ELEMENT_DESC inputLayoutPacked[] = {
+	    {// xyz座標（AABB相対、snorm16）
+	     "POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// 法線ベクトル（八面体符号化、snorm16）
+	     "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {// uv座標（UV範囲相対、unorm16）
+	     "TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	// グラフィックスパイプラインの流れを設定
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob);
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob);
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	// デプスステンシルステート
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+
+	// レンダーターゲットのブレンド設定
+	D3D12_RENDER_TARGET_BLEND_DESC blenddesc{};
+	blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL; // RBGA全てのチャンネルを描画
+	blenddesc.BlendEnable = true;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+
+	// ブレンドステートの設定
+	gpipeline.BlendState.RenderTarget[0] = blenddesc;
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 頂点レイアウトの設定
+	if (vertexFormat == VertexFormat::kPacked) {
+		gpipeline.InputLayout.pInputElementDescs = inputLayoutPacked;
+		gpipeline.InputLayout.NumElements = _countof(inputLayoutPacked);
+	} else {
+		gpipeline.InputLayout.pInputElementDescs = inputLayoutFull;
+		gpipeline.InputLayout.NumElements = _countof(inputLayoutFull);
+	}
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;                            // 描画対象は1つ
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; // 0～255指定のRGBA
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	gpipeline.pRootSignature = rootSignature;
+
+	// グラフィックスパイプラインの生成
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+	ComPtr<ID3D12PipelineState> pipelineState;
+	HRESULT result =
+	    device->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelineState));
+	assert(SUCCEEDED(result));
+	return pipelineState;
+}
+
+void StaticMesh::SetLightGroup(LightGroup* lightGroup) {
+	sLightGroup_ = lightGroup ? lightGroup : sDefaultLightGroup_.get();
+}
+
+void StaticMesh::PreDrawPacked(ID3D12GraphicsCommandList* commandList) {
+	// PreDrawとPostDrawがペアで呼ばれていなければエラー
+	assert(sCommandListPacked_ == nullptr);
+
+	sCommandListPacked_ = commandList;
+
+	// パイプラインステートの設定
+	commandList->SetPipelineState(sPipelineStatePacked_.Get());
+	// ルートシグネチャの設定
+	commandList->SetGraphicsRootSignature(sRootSignaturePacked_.Get());
+	// プリミティブ形状を設定
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void StaticMesh::PostDrawPacked() {
+	// コマンドリストを解除
+	sCommandListPacked_ = nullptr;
+}
+
+void StaticMesh::PreDrawBindless(
+    ID3D12GraphicsCommandList* commandList, VertexFormat vertexFormat) {
+	// PreDrawとPostDrawがペアで呼ばれていなければエラー
+	assert(sCommandListBindless_ == nullptr);
+	assert(IsBindlessSupported());
+
+	sCommandListBindless_ = commandList;
+	sVertexFormatBindless_ = vertexFormat;
+
+	// パイプラインステートの設定
+	commandList->SetPipelineState(
+	    sPipelineStatesBindless_[static_cast<size_t>(vertexFormat)].Get());
+	// ルートシグネチャの設定
+	commandList->SetGraphicsRootSignature(sRootSignatureBindless_.Get());
+	// プリミティブ形状を設定
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// デスクリプタヒープとヒープ全体のテーブルは描画毎ではなくここで1回だけセットする
+	TextureStreamer* textureStreamer = TextureStreamer::GetInstance();
+	textureStreamer->SetDescriptorHeap(commandList);
+	textureStreamer->SetGraphicsRootDescriptorTableBindless(
+	    commandList, static_cast<UINT>(Model::RoomParameter::kTexture));
+}
+
+void StaticMesh::PostDrawBindless() {
+	// コマンドリストを解除
+	sCommandListBindless_ = nullptr;
+}
+
+void StaticMesh::PreDrawClustered(
+    ID3D12GraphicsCommandList* commandList, VertexFormat vertexFormat,
+    ClusteredLighting* lighting) {
+	// PreDrawとPostDrawがペアで呼ばれていなければエラー
+	assert(sCommandListClustered_ == nullptr);
+	assert(lighting);
+
+	sCommandListClustered_ = commandList;
+	sVertexFormatClustered_ = vertexFormat;
+
+	// パイプラインステートの設定
+	commandList->SetPipelineState(
+	    sPipelineStatesClustered_[static_cast<size_t>(vertexFormat)].Get());
+	// ルートシグネチャの設定
+	commandList->SetGraphicsRootSignature(sRootSignatureClustered_.Get());
+	// プリミティブ形状を設定
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 区画定数と構造化バッファは描画毎ではなくここで1回だけセットする
+	lighting->SetGraphicsCommand(commandList, kRootParameterClusterConstants);
+}
+
+void StaticMesh::PostDrawClustered() {
+	// コマンドリストを解除
+	sCommandListClustered_ = nullptr;
+}
+
+StaticMesh* StaticMesh::Create(
+    const ObjLoader::MeshData& meshData, Material* material, uint32_t textureHandle,
+    VertexFormat vertexFormat) {
+	assert(material);
+
+	StaticMesh* mesh = new StaticMesh();
+	mesh->material_ = material;
+	mesh->textureHandle_ = textureHandle;
+	mesh->vertexFormat_ = vertexFormat;
+
+	uint32_t vertexCount = static_cast<uint32_t>(meshData.vertices.size());
+	uint32_t indexCount = static_cast<uint32_t>(meshData.indices.size());
+	DXGI_FORMAT indexFormat = ChooseIndexFormat(vertexCount);
+
+	void* vertMap = nullptr;
+	void* indexMap = nullptr;
+	mesh->CreateBuffers(vertexCount, indexCount, indexFormat, &vertMap, &indexMap);
+	mesh->WriteVertices(meshData.vertices.data(), vertMap);
+
+	// インデックスは選んだ形式に詰める
+	if (indexFormat == DXGI_FORMAT_R16_UINT) {
+		uint16_t* indices16 = static_cast<uint16_t*>(indexMap);
+		for (uint32_t i = 0; i < indexCount; i++) {
+			indices16[i] = static_cast<uint16_t>(meshData.indices[i]);
+		}
+	} else {
+		std::memcpy(indexMap, meshData.indices.data(), indexCount * sizeof(uint32_t));
+	}
+
+	mesh->UnmapBuffers();
+	return mesh;
+}
+
+StaticMesh* StaticMesh::Create(
+    const MeshCache::MeshView& meshView, Material* material, uint32_t textureHandle,
+    VertexFormat vertexFormat) {
+	assert(material);
+
+	StaticMesh* mesh = new StaticMesh();
+	mesh->material_ = material;
+	mesh->textureHandle_ = textureHandle;
+	mesh->vertexFormat_ = vertexFormat;
+
+	// キャッシュは書き出し時に同じ規則でインデックス形式を選んでいるので、そのままコピーできる
+	DXGI_FORMAT indexFormat = ChooseIndexFormat(meshView.vertexCount);
+	assert(meshView.indexSize == (indexFormat == DXGI_FORMAT_R16_UINT ? 2u : 4u));
+
+	void* vertMap = nullptr;
+	void* indexMap = nullptr;
+	mesh->CreateBuffers(
+	    meshView.vertexCount, meshView.indexCount, indexFormat, &vertMap, &indexMap);
+
+	// マッピングしたファイルからアップロードバッファへ直接書き込む
+	mesh->WriteVertices(meshView.vertices, vertMap);
+	std::memcpy(indexMap, meshView.indices, size_t(meshView.indexCount) * meshView.indexSize);
+
+	mesh->UnmapBuffers();
+	return mesh;
+}
+
+void StaticMesh::Draw(const WorldTransform& worldTransform, const ViewProjection& viewProjection) {
+	Draw(worldTransform, viewProjection, textureHandle_);
+}
+
+void StaticMesh::Draw(
+    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+    uint32_t textureHadle) {
+	if (sCommandListBindless_) {
+		DrawBindless(worldTransform, viewProjection, textureHadle);
+		return;
+	}
+
+	ID3D12GraphicsCommandList* commandList = GetDrawCommandList();
+	assert(commandList);
+
+	// マテリアル
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(Model::RoomParameter::kMaterial),
+	    material_->GetConstantBuffer()->GetGPUVirtualAddress());
+	// テクスチャ（TextureStreamer のヒープから引く）
+	TextureStreamer::GetInstance()->SetGraphicsRootDescriptorTable(
+	    commandList, static_cast<UINT>(Model::RoomParameter::kTexture), textureHadle);
+
+	IssueDraw(commandList, worldTransform, viewProjection);
+}
+
+void StaticMesh::CreateBuffers(
+    uint32_t vertexCount, uint32_t indexCount, DXGI_FORMAT indexFormat, void** vertMap,
+    void** indexMap) {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	vertexCount_ = vertexCount;
+	indexCount_ = indexCount;
+
+	UINT vertexStride = vertexFormat_ == VertexFormat::kPacked
+	                        ? sizeof(VertexQuantizer::VertexPacked)
+	                        : sizeof(Mesh::VertexPosNormalUv);
+	UINT sizeVB = static_cast<UINT>(vertexStride * vertexCount);
+	UINT sizeIB = static_cast<UINT>((indexFormat == DXGI_FORMAT_R16_UINT ? 2 : 4) * indexCount);
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+
+	// 頂点バッファ生成
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeVB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&vertBuff_));
+	assert(SUCCEEDED(result));
+
+	// インデックスバッファ生成
+	resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeIB);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&indexBuff_));
+	assert(SUCCEEDED(result));
+
+	// マッピング
+	result = vertBuff_->Map(0, nullptr, vertMap);
+	assert(SUCCEEDED(result));
+	result = indexBuff_->Map(0, nullptr, indexMap);
+	assert(SUCCEEDED(result));
+
+	// 頂点バッファビューの作成
+	vbView_.BufferLocation = vertBuff_->GetGPUVirtualAddress();
+	vbView_.SizeInBytes = sizeVB;
+	vbView_.StrideInBytes = vertexStride;
+
+	// インデックスバッファビューの作成
+	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
+	ibView_.Format = indexFormat;
+	ibView_.SizeInBytes = sizeIB;
+}
+
+void StaticMesh::WriteVertices(const Mesh::VertexPosNormalUv* vertices, void* vertMap) {
+	if (vertexFormat_ == VertexFormat::kFull) {
+		// 頂点はそのまま転送
+		std::memcpy(vertMap, vertices, vertexCount_ * sizeof(Mesh::VertexPosNormalUv));
+		return;
+	}
+
+	// 量子化して直接書き込む
+	VertexQuantizer::DequantizeParams params =
+	    VertexQuantizer::CalculateParams(vertices, vertexCount_);
+	VertexQuantizer::Encode(
+	    vertices, vertexCount_, params, static_cast<VertexQuantizer::VertexPacked*>(vertMap));
+
+	// 復元パラメータの定数バッファ
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	    CD3DX12_RESOURCE_DESC::Buffer((sizeof(VertexQuantizer::DequantizeParams) + 0xff) & ~0xff);
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&constBuffDequantize_));
+	assert(SUCCEEDED(result));
+
+	VertexQuantizer::DequantizeParams* constMap = nullptr;
+	result = constBuffDequantize_->Map(0, nullptr, (void**)&constMap);
+	assert(SUCCEEDED(result));
+	*constMap = params;
+	constBuffDequantize_->Unmap(0, nullptr);
+}
+
+void StaticMesh::UnmapBuffers() {
+	vertBuff_->Unmap(0, nullptr);
+	indexBuff_->Unmap(0, nullptr);
+}
+
+ID3D12GraphicsCommandList* StaticMesh::GetDrawCommandList() const {
+	// クラスター化ライティングのパイプラインは PreDrawClustered で頂点形式毎に選んでいる
+	if (sCommandListClustered_) {
+		assert(vertexFormat_ == sVertexFormatClustered_);
+		return sCommandListClustered_;
+	}
+	return vertexFormat_ == VertexFormat::kPacked ? sCommandListPacked_
+	                                              : DirectXCommon::GetInstance()->GetCommandList();
+}
+
+void StaticMesh::DrawBindless(
+    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+    uint32_t textureHandle) {
+	// パイプラインは PreDrawBindless で頂点形式毎に選んでいる
+	assert(vertexFormat_ == sVertexFormatBindless_);
+	ID3D12GraphicsCommandList* commandList = sCommandListBindless_;
+
+	// マテリアル
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(Model::RoomParameter::kMaterial),
+	    material_->GetConstantBuffer()->GetGPUVirtualAddress());
+	// テクスチャはテーブルを張り替えず、ヒープ内の番号だけを渡す
+	uint32_t textureIndex = TextureStreamer::GetInstance()->GetDescriptorIndex(textureHandle);
+	commandList->SetGraphicsRoot32BitConstant(kRootParameterTextureIndex, textureIndex, 0);
+
+	IssueDraw(commandList, worldTransform, viewProjection);
+}
+
+void StaticMesh::IssueDraw(
+    ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+    const ViewProjection& viewProjection) {
+	assert(sLightGroup_);
+
+	// ライトの定数バッファをセットする（更新は描画毎ではなく、既定ライトは生成時、
+	// SetLightGroup で渡したライトは持ち主が毎フレーム1回行う）
+	sLightGroup_->Draw(commandList, static_cast<UINT>(Model::RoomParameter::kLight));
+
+	// CBVをセット（ワールド行列、ビュープロジェクション）
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(Model::RoomParameter::kWorldTransform),
+	    worldTransform.GetConstBuffer()->GetGPUVirtualAddress());
+	commandList->SetGraphicsRootConstantBufferView(
+	    static_cast<UINT>(Model::RoomParameter::kViewProjection),
+	    viewProjection.GetConstBuffer()->GetGPUVirtualAddress());
+
+	// 量子化頂点の復元パラメータ
+	if (vertexFormat_ == VertexFormat::kPacked) {
+		commandList->SetGraphicsRootConstantBufferView(
+		    kRootParameterDequantize, constBuffDequantize_->GetGPUVirtualAddress());
+	}
+
+	// 頂点バッファ・インデックスバッファの設定
+	commandList->IASetVertexBuffers(0, 1, &vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+
+	// 描画コマンド
+	commandList->DrawIndexedInstanced(indexCount_, 1, 0, 0, 0);
+}
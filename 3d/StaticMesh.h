@@ -0,0 +1,297 @@
+#pragma once
+
+#include "ClusteredLighting.h"
+#include "LightGroup.h"
+#include "Material.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "VertexQuantizer.h"
+#include "ViewProjection.h"
+#include "WorldTransform.h"
+#include <array>
+#include <d3d12.h>
+#include <memory>
+#include <wrl.h>
+
+/// <summary>
+/// 静的メッシュ（インデックス形式を頂点数から自動選択する）
+/// </summary>
+class StaticMesh {
+private: // エイリアス
+	// Microsoft::WRL::を省略
+	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public: // 列挙子
+	/// <summary>
+	/// 頂点形式
+	/// </summary>
+	enum class VertexFormat {
+		kFull,   // float3 座標 + float3 法線 + float2 UV（32バイト）
+		kPacked, // 量子化頂点（16バイト）
+	};
+
+public: // 定数
+	// 16bitインデックスで表せる最大頂点数
+	static const size_t kMaxVertexCount16 = 0x10000;
+	// 量子化頂点の復元パラメータのルートパラメータ番号（それ以外は Model::RoomParameter と同じ）
+	static const UINT kRootParameterDequantize = 5;
+	// バインドレス描画のテクスチャ番号（ルート定数）のルートパラメータ番号
+	static const UINT kRootParameterTextureIndex = 6;
+	// バインドレス描画でヒープ全体を割り当てるレジスタ空間
+	static const UINT kBindlessRegisterSpace = 1;
+	// クラスター化ライティングの区画定数のルートパラメータ番号（続く5つが構造化バッファ）
+	static const UINT kRootParameterClusterConstants = 7;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 静的初期化
+	/// </summary>
+	static void StaticInitialize();
+
+	/// <summary>
+	/// 静的終了処理
+	/// </summary>
+	static void StaticFinalize();
+
+	/// <summary>
+	/// 量子化頂点用グラフィックスパイプラインの初期化
+	/// </summary>
+	static void InitializeGraphicsPipeline();
+
+	/// <summary>
+	/// 描画に使うライトの設定（所有しない。ライトの Update は持ち主が毎フレーム1回呼ぶ）
+	/// </summary>
+	/// <param name="lightGroup">ライト（nullptr なら Model と同じ既定ライトに戻す）</param>
+	static void SetLightGroup(LightGroup* lightGroup);
+
+	/// <summary>
+	/// 量子化頂点の描画前処理（Model::PreDraw の代わりに呼ぶ）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	static void PreDrawPacked(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 量子化頂点の描画後処理
+	/// </summary>
+	static void PostDrawPacked();
+
+	/// <summary>
+	/// バインドレス描画の前処理（ヒープとテーブルをここで1回だけセットし、
+	/// 描画毎にはテクスチャ番号だけを渡す。Model::PreDraw/PreDrawPacked の代わりに呼ぶ）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="vertexFormat">この間に描画するメッシュの頂点形式</param>
+	static void PreDrawBindless(ID3D12GraphicsCommandList* commandList, VertexFormat vertexFormat);
+
+	/// <summary>
+	/// バインドレス描画の後処理
+	/// </summary>
+	static void PostDrawBindless();
+
+	/// <summary>
+	/// クラスター化ライティングの描画前処理（点光源・スポットライト・丸影は LightGroup の代わりに
+	/// lighting の区画毎の一覧から引く。平行光源と環境光は LightGroup のまま）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="vertexFormat">この間に描画するメッシュの頂点形式</param>
+	/// <param name="lighting">今フレームの Update を済ませたクラスター化ライティング</param>
+	static void PreDrawClustered(
+	    ID3D12GraphicsCommandList* commandList, VertexFormat vertexFormat,
+	    ClusteredLighting* lighting);
+
+	/// <summary>
+	/// クラスター化ライティングの描画後処理
+	/// </summary>
+	static void PostDrawClustered();
+
+	/// <summary>
+	/// バインドレス描画が使えるか
+	/// </summary>
+	static bool IsBindlessSupported() { return sRootSignatureBindless_.Get() != nullptr; }
+
+	/// <summary>
+	/// 頂点数からインデックス形式を選ぶ
+	/// </summary>
+	/// <param name="vertexCount">頂点数</param>
+	/// <returns>DXGI_FORMAT_R16_UINT か DXGI_FORMAT_R32_UINT</returns>
+	static DXGI_FORMAT ChooseIndexFormat(size_t vertexCount) {
+		return vertexCount <= kMaxVertexCount16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	}
+
+	/// <summary>
+	/// メッシュデータから生成
+	/// </summary>
+	/// <param name="meshData">メッシュデータ</param>
+	/// <param name="material">マテリアル（所有しない。テクスチャは使わない）</param>
+	/// <param name="textureHandle">テクスチャハンドル（TextureStreamer。参照は呼び出し側）</param>
+	/// <param name="vertexFormat">頂点形式</param>
+	/// <returns>生成されたメッシュ</returns>
+	static StaticMesh* Create(
+	    const ObjLoader::MeshData& meshData, Material* material, uint32_t textureHandle,
+	    VertexFormat vertexFormat = VertexFormat::kFull);
+
+	/// <summary>
+	/// マッピングしたキャッシュから直接生成
+	/// </summary>
+	/// <param name="meshView">キャッシュ内メッシュ参照</param>
+	/// <param name="material">マテリアル（所有しない。テクスチャは使わない）</param>
+	/// <param name="textureHandle">テクスチャハンドル（TextureStreamer。参照は呼び出し側）</param>
+	/// <param name="vertexFormat">頂点形式</param>
+	/// <returns>生成されたメッシュ</returns>
+	static StaticMesh* Create(
+	    const MeshCache::MeshView& meshView, Material* material, uint32_t textureHandle,
+	    VertexFormat vertexFormat = VertexFormat::kFull);
+
+private: // 静的メンバ変数
+	// 既定ライト（設定を変えないので生成時に1回だけ更新する）
+	static std::unique_ptr<LightGroup> sDefaultLightGroup_;
+	// 描画に使うライト
+	static LightGroup* sLightGroup_;
+	// 量子化頂点の描画中のコマンドリスト
+	static ID3D12GraphicsCommandList* sCommandListPacked_;
+	// 量子化頂点用ルートシグネチャ
+	static ComPtr<ID3D12RootSignature> sRootSignaturePacked_;
+	// 量子化頂点用パイプラインステートオブジェクト
+	static ComPtr<ID3D12PipelineState> sPipelineStatePacked_;
+	// バインドレス描画中のコマンドリスト
+	static ID3D12GraphicsCommandList* sCommandListBindless_;
+	// バインドレス描画中の頂点形式
+	static VertexFormat sVertexFormatBindless_;
+	// バインドレス用ルートシグネチャ
+	static ComPtr<ID3D12RootSignature> sRootSignatureBindless_;
+	// バインドレス用パイプラインステートオブジェクト（頂点形式毎）
+	static std::array<ComPtr<ID3D12PipelineState>, 2> sPipelineStatesBindless_;
+	// クラスター化ライティングの描画中のコマンドリスト
+	static ID3D12GraphicsCommandList* sCommandListClustered_;
+	// クラスター化ライティングの描画中の頂点形式
+	static VertexFormat sVertexFormatClustered_;
+	// クラスター化ライティング用ルートシグネチャ
+	static ComPtr<ID3D12RootSignature> sRootSignatureClustered_;
+	// クラスター化ライティング用パイプラインステートオブジェクト（頂点形式毎）
+	static std::array<ComPtr<ID3D12PipelineState>, 2> sPipelineStatesClustered_;
+
+private: // 静的メンバ関数
+	/// <summary>
+	/// ルートシグネチャの生成
+	/// </summary>
+	/// <param name="bindless">テクスチャをヒープ全体のテーブルとテクスチャ番号で渡すか</param>
+	/// <param name="clustered">クラスター化ライティングの区画定数と構造化バッファを足すか</param>
+	/// <returns>ルートシグネチャ</returns>
+	static ComPtr<ID3D12RootSignature> CreateRootSignature(bool bindless, bool clustered = false);
+
+	/// <summary>
+	/// パイプラインステートオブジェクトの生成
+	/// </summary>
+	/// <param name="vertexFormat">頂点形式</param>
+	/// <param name="vsBlob">頂点シェーダオブジェクト</param>
+	/// <param name="psBlob">ピクセルシェーダオブジェクト</param>
+	/// <param name="rootSignature">ルートシグネチャ</param>
+	/// <returns>パイプラインステートオブジェクト</returns>
+	static ComPtr<ID3D12PipelineState> CreatePipelineState(
+	    VertexFormat vertexFormat, ID3DBlob* vsBlob, ID3DBlob* psBlob,
+	    ID3D12RootSignature* rootSignature);
+
+public: // メンバ関数
+	/// <summary>
+	/// 描画（kFull は Model::PreDraw/PostDraw、kPacked は PreDrawPacked/PostDrawPacked、
+	/// バインドレスは PreDrawBindless/PostDrawBindless、
+	/// クラスター化ライティングは PreDrawClustered/PostDrawClustered の間で呼ぶ）
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Draw(const WorldTransform& worldTransform, const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 描画（テクスチャ差し替え）
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	/// <param name="textureHadle">テクスチャハンドル（TextureStreamer）</param>
+	void Draw(
+	    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+	    uint32_t textureHadle);
+
+	/// <summary>
+	/// インデックスバッファ取得
+	/// </summary>
+	/// <returns>インデックスバッファ</returns>
+	const D3D12_INDEX_BUFFER_VIEW& GetIBView() const { return ibView_; }
+
+	/// <summary>
+	/// GPUメモリ使用量（頂点バッファ + インデックスバッファ）
+	/// </summary>
+	/// <returns>バイト数</returns>
+	size_t GetBufferSize() const { return size_t(vbView_.SizeInBytes) + ibView_.SizeInBytes; }
+
+	uint32_t GetVertexCount() const { return vertexCount_; }
+	uint32_t GetIndexCount() const { return indexCount_; }
+	VertexFormat GetVertexFormat() const { return vertexFormat_; }
+	Material* GetMaterial() const { return material_; }
+	uint32_t GetTextureHandle() const { return textureHandle_; }
+
+private: // メンバ変数
+	// 頂点バッファ
+	ComPtr<ID3D12Resource> vertBuff_;
+	// インデックスバッファ
+	ComPtr<ID3D12Resource> indexBuff_;
+	// 復元パラメータ定数バッファ（kPacked のみ）
+	ComPtr<ID3D12Resource> constBuffDequantize_;
+	// 頂点バッファビュー
+	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
+	// インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW ibView_ = {};
+	// 頂点数
+	uint32_t vertexCount_ = 0;
+	// インデックス数
+	uint32_t indexCount_ = 0;
+	// 頂点形式
+	VertexFormat vertexFormat_ = VertexFormat::kFull;
+	// マテリアル
+	Material* material_ = nullptr;
+	// テクスチャハンドル（TextureStreamer）
+	uint32_t textureHandle_ = 0;
+
+private: // メンバ関数
+	/// <summary>
+	/// バッファの生成
+	/// </summary>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="indexCount">インデックス数</param>
+	/// <param name="indexFormat">インデックス形式</param>
+	/// <param name="vertMap">マップした頂点バッファ</param>
+	/// <param name="indexMap">マップしたインデックスバッファ</param>
+	void CreateBuffers(
+	    uint32_t vertexCount, uint32_t indexCount, DXGI_FORMAT indexFormat, void** vertMap,
+	    void** indexMap);
+
+	/// <summary>
+	/// 頂点の書き込み（kPacked なら量子化して復元パラメータを用意する）
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="vertMap">マップした頂点バッファ</param>
+	void WriteVertices(const Mesh::VertexPosNormalUv* vertices, void* vertMap);
+
+	/// <summary>
+	/// マップ解除
+	/// </summary>
+	void UnmapBuffers();
+
+	/// <summary>
+	/// 通常の描画に使うコマンドリスト（PreDraw 系で選ばれたもの）
+	/// </summary>
+	ID3D12GraphicsCommandList* GetDrawCommandList() const;
+
+	/// <summary>
+	/// バインドレス描画（テーブルを張り替えず、テクスチャ番号をルート定数で渡す）
+	/// </summary>
+	void DrawBindless(
+	    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+	    uint32_t textureHandle);
+
+	/// <summary>
+	/// 描画コマンド発行
+	/// </summary>
+	void IssueDraw(
+	    ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+	    const ViewProjection& viewProjection);
+};
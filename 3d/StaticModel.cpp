@@ -0,0 +1,78 @@
+#include "StaticModel.h"
+#include "MeshCache.h"
+#include "TextureStreamer.h"
+
+using namespace std::chrono;
+
+StaticModel* StaticModel::CreateFromOBJ(
+    const std::string& modelname, bool smoothing, StaticMesh::VertexFormat vertexFormat) {
+	steady_clock::time_point start = steady_clock::now();
+	std::unique_ptr<StaticModel> model = std::make_unique<StaticModel>();
+	const std::string directoryPath = ObjLoader::GetDirectoryPath(modelname);
+
+	// 有効なキャッシュがあれば、マッピングした頂点・インデックスをそのままバッファへ書く
+	MeshCache::Reader reader;
+	if (reader.Open(ObjLoader::GetCachePath(modelname), smoothing)) {
+		model->CreateMaterials(reader.GetMaterials(), directoryPath);
+		for (const MeshCache::MeshView& meshView : reader.GetMeshes()) {
+			size_t material = model->FindMaterial(meshView.materialName);
+			model->meshes_.emplace_back(StaticMesh::Create(
+			    meshView, model->materials_[material].get(), model->textureHandles_[material],
+			    vertexFormat));
+		}
+		model->loadStats_.cacheHit = true;
+		model->loadStats_.cacheTime = duration_cast<microseconds>(steady_clock::now() - start);
+		model->loadStats_.totalTime = model->loadStats_.cacheTime;
+		return model.release();
+	}
+
+	// 無ければ解析してキャッシュを作り、解析結果から生成する
+	ObjLoader::ModelData modelData;
+	if (!ObjLoader::LoadFromSource(modelname, smoothing, modelData)) {
+		return nullptr;
+	}
+	model->CreateMaterials(modelData.materials, directoryPath);
+	for (const ObjLoader::MeshData& meshData : modelData.meshes) {
+		size_t material = model->FindMaterial(meshData.materialName);
+		model->meshes_.emplace_back(StaticMesh::Create(
+		    meshData, model->materials_[material].get(), model->textureHandles_[material],
+		    vertexFormat));
+	}
+	model->loadStats_ = ObjLoader::GetLastLoadStats();
+	model->loadStats_.totalTime = duration_cast<microseconds>(steady_clock::now() - start);
+	return model.release();
+}
+
+StaticModel::~StaticModel() {
+	// テクスチャの参照を返す（予算を超えたら TextureStreamer が追い出す）
+	for (uint32_t textureHandle : textureHandles_) {
+		TextureStreamer::Release(textureHandle);
+	}
+}
+
+void StaticModel::Draw(const WorldTransform& worldTransform, const ViewProjection& viewProjection) {
+	for (const std::unique_ptr<StaticMesh>& mesh : meshes_) {
+		mesh->Draw(worldTransform, viewProjection);
+	}
+}
+
+void StaticModel::CreateMaterials(
+    const std::vector<ObjLoader::MaterialData>& materials, const std::string& directoryPath) {
+	// マテリアル指定の無いメッシュ用（Model と同じく白テクスチャ）
+	std::vector<ObjLoader::MaterialData> materialDatas = {ObjLoader::MaterialData()};
+	materialDatas.insert(materialDatas.end(), materials.begin(), materials.end());
+	for (const ObjLoader::MaterialData& materialData : materialDatas) {
+		materials_.emplace_back(ObjLoader::CreateMaterial(materialData));
+		textureHandles_.push_back(
+		    TextureStreamer::Load(ObjLoader::GetTexturePath(materialData, directoryPath)));
+	}
+}
+
+size_t StaticModel::FindMaterial(const std::string& materialName) const {
+	for (size_t i = 1; i < materials_.size(); i++) {
+		if (materials_[i]->name_ == materialName) {
+			return i;
+		}
+	}
+	return 0;
+}
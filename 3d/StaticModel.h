@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Material.h"
+#include "ObjLoader.h"
+#include "StaticMesh.h"
+#include "ViewProjection.h"
+#include "WorldTransform.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// OBJモデルを StaticMesh で持つモデル（キャッシュが有効なら、マッピングしたキャッシュから
+/// 頂点・インデックスを直接アップロードバッファへ書く。Model::CreateFromOBJ の代わりに使う）
+/// </summary>
+class StaticModel {
+public: // 静的メンバ関数
+	/// <summary>
+	/// OBJファイルから生成
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="vertexFormat">頂点形式</param>
+	/// <returns>生成されたモデル。読み込めなければnullptr</returns>
+	static StaticModel* CreateFromOBJ(
+	    const std::string& modelname, bool smoothing = false,
+	    StaticMesh::VertexFormat vertexFormat = StaticMesh::VertexFormat::kFull);
+
+public: // メンバ関数
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~StaticModel();
+
+	/// <summary>
+	/// 描画（頂点形式に合わせて Model::PreDraw/PostDraw などの間で呼ぶ）
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Draw(const WorldTransform& worldTransform, const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 読み込み統計（キャッシュから読んだ場合の cacheTime はバッファへの書き込みまで含む）
+	/// </summary>
+	const ObjLoader::LoadStats& GetLoadStats() const { return loadStats_; }
+
+private: // メンバ関数
+	/// <summary>
+	/// マテリアル生成（テクスチャは TextureStreamer から読む）
+	/// </summary>
+	/// <param name="materials">マテリアルデータ配列</param>
+	/// <param name="directoryPath">テクスチャ読み込みディレクトリパス</param>
+	void CreateMaterials(
+	    const std::vector<ObjLoader::MaterialData>& materials, const std::string& directoryPath);
+
+	/// <summary>
+	/// マテリアル名から探す（無ければ既定マテリアル）
+	/// </summary>
+	/// <param name="materialName">マテリアル名</param>
+	/// <returns>マテリアル番号</returns>
+	size_t FindMaterial(const std::string& materialName) const;
+
+private: // メンバ変数
+	// マテリアル（先頭は名前の無いメッシュ用の既定マテリアル）
+	std::vector<std::unique_ptr<Material>> materials_;
+	// マテリアル毎のテクスチャハンドル（TextureStreamer）
+	std::vector<uint32_t> textureHandles_;
+	// メッシュ
+	std::vector<std::unique_ptr<StaticMesh>> meshes_;
+	// 読み込み統計
+	ObjLoader::LoadStats loadStats_;
+};
@@ -0,0 +1,239 @@
+#include "TerrainQuadtree.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+TerrainQuadtree::Frustum TerrainQuadtree::ExtractFrustum(const Matrix4x4& matrix) {
+	auto column = [&](int j) {
+		return Plane{matrix.m[0][j], matrix.m[1][j], matrix.m[2][j], matrix.m[3][j]};
+	};
+	auto add = [](const Plane& p, const Plane& q) {
+		return Plane{p.a + q.a, p.b + q.b, p.c + q.c, p.d + q.d};
+	};
+	auto sub = [](const Plane& p, const Plane& q) {
+		return Plane{p.a - q.a, p.b - q.b, p.c - q.c, p.d - q.d};
+	};
+	Plane x = column(0);
+	Plane y = column(1);
+	Plane z = column(2);
+	Plane w = column(3);
+	return {add(w, x), sub(w, x), add(w, y), sub(w, y), z, sub(w, z)};
+}
+
+bool TerrainQuadtree::IsAabbVisible(
+    const Frustum& frustum, const Vector3& min, const Vector3& max) {
+	for (const Plane& plane : frustum) {
+		float x = plane.a >= 0.0f ? max.x : min.x;
+		float y = plane.b >= 0.0f ? max.y : min.y;
+		float z = plane.c >= 0.0f ? max.z : min.z;
+		if (plane.a * x + plane.b * y + plane.c * z + plane.d < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TerrainQuadtree::Initialize(uint32_t chunkCountX, uint32_t chunkCountZ) {
+	assert(chunkCountX > 0 && chunkCountZ > 0);
+	chunkCountX_ = chunkCountX;
+	chunkCountZ_ = chunkCountZ;
+	nodes_.clear();
+	leafNodes_.assign(size_t(chunkCountX) * chunkCountZ, UINT32_MAX);
+	maxChunkExtent_ = 0.0f;
+
+	// 根は両方向のチャンク数を覆う2のべき乗の正方形にする
+	uint32_t size = 1;
+	while (size < chunkCountX || size < chunkCountZ) {
+		size *= 2;
+	}
+	BuildNode(0, 0, size, UINT32_MAX);
+}
+
+uint32_t TerrainQuadtree::BuildNode(uint32_t cx, uint32_t cz, uint32_t size, uint32_t parent) {
+	if (cx >= chunkCountX_ || cz >= chunkCountZ_) {
+		return UINT32_MAX;
+	}
+	// AABBは空にしておき、SetChunkBounds で広げる
+	uint32_t nodeIndex = static_cast<uint32_t>(nodes_.size());
+	Node node;
+	node.aabbMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+	node.aabbMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	node.cx = cx;
+	node.cz = cz;
+	node.size = size;
+	node.parent = parent;
+	nodes_.push_back(node);
+
+	if (size == 1) {
+		leafNodes_[size_t(cz) * chunkCountX_ + cx] = nodeIndex;
+		return nodeIndex;
+	}
+	// 子は -x-z, +x-z, -x+z, +x+z の順
+	uint32_t half = size / 2;
+	for (uint32_t i = 0; i < 4; i++) {
+		uint32_t child = BuildNode(cx + (i & 1) * half, cz + (i >> 1) * half, half, nodeIndex);
+		nodes_[nodeIndex].children[i] = child;
+	}
+	return nodeIndex;
+}
+
+void TerrainQuadtree::SetChunkBounds(
+    uint32_t cx, uint32_t cz, const Vector3& min, const Vector3& max) {
+	assert(cx < chunkCountX_ && cz < chunkCountZ_);
+	uint32_t nodeIndex = leafNodes_[size_t(cz) * chunkCountX_ + cx];
+	nodes_[nodeIndex].aabbMin = min;
+	nodes_[nodeIndex].aabbMax = max;
+	maxChunkExtent_ = std::max({maxChunkExtent_, max.x - min.x, max.z - min.z});
+
+	// 祖先は子のAABBを合わせ直す（広げるだけだと掘り下げた分のカリングが甘くなる）
+	for (nodeIndex = nodes_[nodeIndex].parent; nodeIndex != UINT32_MAX;
+	     nodeIndex = nodes_[nodeIndex].parent) {
+		Node& node = nodes_[nodeIndex];
+		node.aabbMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+		node.aabbMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+		for (uint32_t childIndex : node.children) {
+			if (childIndex == UINT32_MAX) {
+				continue;
+			}
+			const Node& child = nodes_[childIndex];
+			node.aabbMin = {
+			    std::min(node.aabbMin.x, child.aabbMin.x),
+			    std::min(node.aabbMin.y, child.aabbMin.y),
+			    std::min(node.aabbMin.z, child.aabbMin.z)};
+			node.aabbMax = {
+			    std::max(node.aabbMax.x, child.aabbMax.x),
+			    std::max(node.aabbMax.y, child.aabbMax.y),
+			    std::max(node.aabbMax.z, child.aabbMax.z)};
+		}
+	}
+}
+
+uint32_t TerrainQuadtree::Select(
+    const Frustum& frustum, const Vector3& eye, float lodDistance,
+    std::vector<VisibleChunk>& visibleChunks) const {
+	visibleChunks.clear();
+	SelectContext context = CreateContext(&frustum, eye, lodDistance);
+	context.visibleChunks = &visibleChunks;
+	SelectNode(0, (1u << frustum.size()) - 1, nullptr, 0, context);
+	return context.visitedNodeCount;
+}
+
+uint32_t TerrainQuadtree::CalculateLod(
+    uint32_t cx, uint32_t cz, const Vector3& eye, float lodDistance) const {
+	return CalculateLod(cx, cz, CreateContext(nullptr, eye, lodDistance));
+}
+
+TerrainQuadtree::SelectContext TerrainQuadtree::CreateContext(
+    const Frustum* frustum, const Vector3& eye, float lodDistance) const {
+	SelectContext context = {};
+	context.frustum = frustum;
+	context.eye = eye;
+	// 切り替え距離がチャンクの幅以上なら、隣との距離の差は幅以内なのでLODの差も1段以内になる
+	context.lodDistance = std::max(lodDistance, maxChunkExtent_);
+	const Node& root = nodes_[0];
+	context.heightDistance = std::max({root.aabbMin.y - eye.y, eye.y - root.aabbMax.y, 0.0f});
+	return context;
+}
+
+void TerrainQuadtree::SelectNode(
+    uint32_t nodeIndex, uint32_t planeMask, const Node* uniformNode, uint32_t uniformLod,
+    SelectContext& context) const {
+	const Node& node = nodes_[nodeIndex];
+	context.visitedNodeCount++;
+
+	// まだ判定の要る平面だけ調べ、全体が内側の平面は子に渡さない
+	for (uint32_t i = 0; i < context.frustum->size(); i++) {
+		if (!(planeMask & (1u << i))) {
+			continue;
+		}
+		const Plane& plane = (*context.frustum)[i];
+		float inX = plane.a >= 0.0f ? node.aabbMax.x : node.aabbMin.x;
+		float inY = plane.b >= 0.0f ? node.aabbMax.y : node.aabbMin.y;
+		float inZ = plane.c >= 0.0f ? node.aabbMax.z : node.aabbMin.z;
+		if (plane.a * inX + plane.b * inY + plane.c * inZ + plane.d < 0.0f) {
+			return;
+		}
+		float outX = plane.a >= 0.0f ? node.aabbMin.x : node.aabbMax.x;
+		float outY = plane.b >= 0.0f ? node.aabbMin.y : node.aabbMax.y;
+		float outZ = plane.c >= 0.0f ? node.aabbMin.z : node.aabbMax.z;
+		if (plane.a * outX + plane.b * outY + plane.c * outZ + plane.d >= 0.0f) {
+			planeMask &= ~(1u << i);
+		}
+	}
+
+	// 最短・最長の距離で同じLODになれば、子孫はすべてそのLODになる
+	if (!uniformNode) {
+		float nearest = 0.0f;
+		float farthest = 0.0f;
+		CalculateDistanceRange(node, context, nearest, farthest);
+		uint32_t nearestLod = LodFromDistance(nearest, context.lodDistance);
+		if (nearestLod == LodFromDistance(farthest, context.lodDistance)) {
+			uniformNode = &node;
+			uniformLod = nearestLod;
+		}
+	}
+
+	if (node.size > 1) {
+		for (uint32_t childIndex : node.children) {
+			if (childIndex != UINT32_MAX) {
+				SelectNode(childIndex, planeMask, uniformNode, uniformLod, context);
+			}
+		}
+		return;
+	}
+
+	// 葉は隣のLODと比べて辺のつなぎ方を決める（同じLODのノード内の隣は計算しない）
+	VisibleChunk chunk;
+	chunk.cx = node.cx;
+	chunk.cz = node.cz;
+	chunk.lod = uniformNode ? uniformLod : CalculateLod(node.cx, node.cz, context);
+	auto neighborLod = [&](uint32_t cx, uint32_t cz) {
+		if (uniformNode && cx - uniformNode->cx < uniformNode->size &&
+		    cz - uniformNode->cz < uniformNode->size) {
+			return uniformLod;
+		}
+		return CalculateLod(cx, cz, context);
+	};
+	if (node.cx > 0 && neighborLod(node.cx - 1, node.cz) > chunk.lod) {
+		chunk.stitchMask |= kEdgeNegativeX;
+	}
+	if (node.cx + 1 < chunkCountX_ && neighborLod(node.cx + 1, node.cz) > chunk.lod) {
+		chunk.stitchMask |= kEdgePositiveX;
+	}
+	if (node.cz > 0 && neighborLod(node.cx, node.cz - 1) > chunk.lod) {
+		chunk.stitchMask |= kEdgeNegativeZ;
+	}
+	if (node.cz + 1 < chunkCountZ_ && neighborLod(node.cx, node.cz + 1) > chunk.lod) {
+		chunk.stitchMask |= kEdgePositiveZ;
+	}
+	context.visibleChunks->push_back(chunk);
+}
+
+uint32_t TerrainQuadtree::CalculateLod(
+    uint32_t cx, uint32_t cz, const SelectContext& context) const {
+	float nearest = 0.0f;
+	float farthest = 0.0f;
+	CalculateDistanceRange(GetLeaf(cx, cz), context, nearest, farthest);
+	return LodFromDistance(nearest, context.lodDistance);
+}
+
+uint32_t TerrainQuadtree::LodFromDistance(float distance, float lodDistance) {
+	uint32_t lod = 0;
+	for (float limit = lodDistance; lod + 1 < kLodCount && distance >= limit; limit *= 2.0f) {
+		lod++;
+	}
+	return lod;
+}
+
+void TerrainQuadtree::CalculateDistanceRange(
+    const Node& node, const SelectContext& context, float& nearest, float& farthest) {
+	const Vector3& eye = context.eye;
+	float nearX = std::max({node.aabbMin.x - eye.x, eye.x - node.aabbMax.x, 0.0f});
+	float nearZ = std::max({node.aabbMin.z - eye.z, eye.z - node.aabbMax.z, 0.0f});
+	float farX = std::max(std::abs(eye.x - node.aabbMin.x), std::abs(eye.x - node.aabbMax.x));
+	float farZ = std::max(std::abs(eye.z - node.aabbMin.z), std::abs(eye.z - node.aabbMax.z));
+	float dy = context.heightDistance;
+	nearest = std::sqrt(nearX * nearX + nearZ * nearZ + dy * dy);
+	farthest = std::sqrt(farX * farX + farZ * farZ + dy * dy);
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 地形チャンクの四分木（視錐台カリングとLOD選択を1回の走査で行う）。
+/// LODはチャンクの幅以上の間隔で切り替えるので、隣り合うチャンクの差は必ず1段以内になる
+/// </summary>
+class TerrainQuadtree {
+public: // 定数
+	// LOD段数（1段毎に頂点間隔を2倍にする）
+	static constexpr uint32_t kLodCount = 4;
+	// 辺の番号（ビットが立った辺は隣のチャンクが1段粗い）
+	static constexpr uint32_t kEdgeNegativeX = 1 << 0;
+	static constexpr uint32_t kEdgePositiveX = 1 << 1;
+	static constexpr uint32_t kEdgeNegativeZ = 1 << 2;
+	static constexpr uint32_t kEdgePositiveZ = 1 << 3;
+
+public: // サブクラス
+	// 平面（ax + by + cz + d = 0、法線側が内側）
+	struct Plane {
+		float a;
+		float b;
+		float c;
+		float d;
+	};
+
+	// 視錐台の6平面
+	using Frustum = std::array<Plane, 6>;
+
+	// 描画するチャンク
+	struct VisibleChunk {
+		// 横方向番号
+		uint32_t cx = 0;
+		// 縦方向番号
+		uint32_t cz = 0;
+		// 選んだLOD
+		uint32_t lod = 0;
+		// 1段粗い隣接チャンクの辺（kEdge～ の組み合わせ）
+		uint32_t stitchMask = 0;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 行列から視錐台の6平面を取り出す（行ベクトル × 行列、クリップ空間の z は 0～w）
+	/// </summary>
+	/// <param name="matrix">ローカル座標からクリップ座標への行列</param>
+	/// <returns>視錐台</returns>
+	static Frustum ExtractFrustum(const Matrix4x4& matrix);
+
+	/// <summary>
+	/// AABBが視錐台と重なるか（各平面で最も内側の頂点が外なら見えない）
+	/// </summary>
+	/// <param name="frustum">視錐台</param>
+	/// <param name="min">AABBの最小点</param>
+	/// <param name="max">AABBの最大点</param>
+	/// <returns>重なればtrue</returns>
+	static bool IsAabbVisible(const Frustum& frustum, const Vector3& min, const Vector3& max);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（AABBは SetChunkBounds で全チャンク分を設定する）
+	/// </summary>
+	/// <param name="chunkCountX">横方向チャンク数</param>
+	/// <param name="chunkCountZ">縦方向チャンク数</param>
+	void Initialize(uint32_t chunkCountX, uint32_t chunkCountZ);
+
+	/// <summary>
+	/// チャンクのAABBを設定し、祖先のAABBを子から求め直す（縮んだ分も縮める）
+	/// </summary>
+	/// <param name="cx">横方向番号</param>
+	/// <param name="cz">縦方向番号</param>
+	/// <param name="min">AABBの最小点（ローカル座標）</param>
+	/// <param name="max">AABBの最大点（ローカル座標）</param>
+	void SetChunkBounds(uint32_t cx, uint32_t cz, const Vector3& min, const Vector3& max);
+
+	/// <summary>
+	/// 見えるチャンクとそのLOD・辺のつなぎ方を集める（全体が内側のノードは子の判定を省き、
+	/// 全体が同じLODになるノードは子の距離計算を省く）
+	/// </summary>
+	/// <param name="frustum">視錐台（ローカル座標）</param>
+	/// <param name="eye">カメラ座標（ローカル座標）</param>
+	/// <param name="lodDistance">LOD1 に切り替える距離（チャンクの幅より短ければ幅を使う）</param>
+	/// <param name="visibleChunks">見えるチャンク（上書きする）</param>
+	/// <returns>走査したノード数</returns>
+	uint32_t Select(
+	    const Frustum& frustum, const Vector3& eye, float lodDistance,
+	    std::vector<VisibleChunk>& visibleChunks) const;
+
+	/// <summary>
+	/// チャンクのLOD（Select と同じ選び方）
+	/// </summary>
+	/// <param name="cx">横方向番号</param>
+	/// <param name="cz">縦方向番号</param>
+	/// <param name="eye">カメラ座標（ローカル座標）</param>
+	/// <param name="lodDistance">LOD1 に切り替える距離</param>
+	/// <returns>LOD</returns>
+	uint32_t CalculateLod(uint32_t cx, uint32_t cz, const Vector3& eye, float lodDistance) const;
+
+	/// <summary>
+	/// 全体のAABB
+	/// </summary>
+	const Vector3& GetBoundsMin() const { return nodes_[0].aabbMin; }
+	const Vector3& GetBoundsMax() const { return nodes_[0].aabbMax; }
+
+	uint32_t GetNodeCount() const { return static_cast<uint32_t>(nodes_.size()); }
+
+private: // サブクラス
+	// ノード（[cx, cx + size) x [cz, cz + size) のうち地形内のチャンクを持つ）
+	struct Node {
+		// AABB（ローカル座標。子のAABBを合わせたもの）
+		Vector3 aabbMin;
+		Vector3 aabbMax;
+		// 最小のチャンク番号
+		uint32_t cx = 0;
+		uint32_t cz = 0;
+		// 一辺のチャンク数（2のべき乗。1なら葉）
+		uint32_t size = 0;
+		// 親ノード
+		uint32_t parent = UINT32_MAX;
+		// 子ノード（地形外なら UINT32_MAX）
+		std::array<uint32_t, 4> children = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+	};
+
+	// 1回の走査で共有する値
+	struct SelectContext {
+		const Frustum* frustum;
+		Vector3 eye;
+		// LODを切り替える距離（チャンクの幅で下限をかけたもの）
+		float lodDistance;
+		// カメラと地形全体の高さの差（全チャンク共通にして、隣との距離の差を幅までに抑える）
+		float heightDistance;
+		std::vector<VisibleChunk>* visibleChunks;
+		uint32_t visitedNodeCount;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// ノードを再帰的に作る
+	/// </summary>
+	/// <returns>ノード番号（地形外なら UINT32_MAX）</returns>
+	uint32_t BuildNode(uint32_t cx, uint32_t cz, uint32_t size, uint32_t parent);
+
+	/// <summary>
+	/// ノードを再帰的に走査する
+	/// </summary>
+	/// <param name="nodeIndex">ノード番号</param>
+	/// <param name="planeMask">まだ判定の要る平面（全体が内側と分かった平面は外す）</param>
+	/// <param name="uniformNode">全体が同じLODになる祖先（無ければ nullptr）</param>
+	/// <param name="uniformLod">そのLOD</param>
+	/// <param name="context">走査で共有する値</param>
+	void SelectNode(
+	    uint32_t nodeIndex, uint32_t planeMask, const Node* uniformNode, uint32_t uniformLod,
+	    SelectContext& context) const;
+
+	/// <summary>
+	/// 走査と同じ条件でのチャンクのLOD
+	/// </summary>
+	uint32_t CalculateLod(uint32_t cx, uint32_t cz, const SelectContext& context) const;
+
+	/// <summary>
+	/// 距離からLOD（lodDistance の2倍になる毎に1段粗くする）
+	/// </summary>
+	static uint32_t LodFromDistance(float distance, float lodDistance);
+
+	/// <summary>
+	/// カメラから矩形までの最短・最長の距離（水平はAABBのxz、高さは heightDistance）
+	/// </summary>
+	static void CalculateDistanceRange(
+	    const Node& node, const SelectContext& context, float& nearest, float& farthest);
+
+	/// <summary>
+	/// 走査の共有値を作る
+	/// </summary>
+	SelectContext
+	    CreateContext(const Frustum* frustum, const Vector3& eye, float lodDistance) const;
+
+	const Node& GetLeaf(uint32_t cx, uint32_t cz) const {
+		return nodes_[leafNodes_[size_t(cz) * chunkCountX_ + cx]];
+	}
+
+private: // メンバ変数
+	// 横方向チャンク数
+	uint32_t chunkCountX_ = 0;
+	// 縦方向チャンク数
+	uint32_t chunkCountZ_ = 0;
+	// ノード配列（先頭が根）
+	std::vector<Node> nodes_;
+	// チャンク毎の葉ノード番号（行優先）
+	std::vector<uint32_t> leafNodes_;
+	// チャンクのxzの幅の最大（LODを切り替える距離の下限）
+	float maxChunkExtent_ = 0.0f;
+};
@@ -0,0 +1,251 @@
+#include "VertexQuantizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+const float kSnorm16Max = 32767.0f;
+const float kUnorm16Max = 65535.0f;
+const float kRadToDeg = 57.2957795f;
+
+int16_t ToSnorm16(float value) {
+	value = std::clamp(value, -1.0f, 1.0f);
+	return static_cast<int16_t>(std::lround(value * kSnorm16Max));
+}
+
+// D3Dのsnorm変換と同じく -32768 は -1 に丸める
+float FromSnorm16(int16_t value) { return std::max(float(value) / kSnorm16Max, -1.0f); }
+
+uint16_t ToUnorm16(float value) {
+	value = std::clamp(value, 0.0f, 1.0f);
+	return static_cast<uint16_t>(std::lround(value * kUnorm16Max));
+}
+
+float FromUnorm16(uint16_t value) { return float(value) / kUnorm16Max; }
+
+// 大きさ0の範囲は0除算を避ける
+float SafeInverse(float value) { return value > 0.0f ? 1.0f / value : 0.0f; }
+
+float SignNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+// Mesh/Terrain の頂点型は同じレイアウトなので共通処理にする
+template<class Vertex>
+VertexQuantizer::DequantizeParams CalculateParamsImpl(const Vertex* vertices, size_t count) {
+	VertexQuantizer::DequantizeParams params{};
+	if (count == 0) {
+		return params;
+	}
+
+	Vector3 minPos = {FLT_MAX, FLT_MAX, FLT_MAX};
+	Vector3 maxPos = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	Vector2 minUv = {FLT_MAX, FLT_MAX};
+	Vector2 maxUv = {-FLT_MAX, -FLT_MAX};
+	for (size_t i = 0; i < count; i++) {
+		const Vertex& v = vertices[i];
+		minPos.x = std::min(minPos.x, v.pos.x);
+		minPos.y = std::min(minPos.y, v.pos.y);
+		minPos.z = std::min(minPos.z, v.pos.z);
+		maxPos.x = std::max(maxPos.x, v.pos.x);
+		maxPos.y = std::max(maxPos.y, v.pos.y);
+		maxPos.z = std::max(maxPos.z, v.pos.z);
+		minUv.x = std::min(minUv.x, v.uv.x);
+		minUv.y = std::min(minUv.y, v.uv.y);
+		maxUv.x = std::max(maxUv.x, v.uv.x);
+		maxUv.y = std::max(maxUv.y, v.uv.y);
+	}
+
+	params.positionCenter = {
+	    (minPos.x + maxPos.x) * 0.5f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f};
+	params.positionExtent = {
+	    (maxPos.x - minPos.x) * 0.5f, (maxPos.y - minPos.y) * 0.5f, (maxPos.z - minPos.z) * 0.5f};
+	params.uvMin = minUv;
+	params.uvExtent = {maxUv.x - minUv.x, maxUv.y - minUv.y};
+	return params;
+}
+
+template<class Vertex>
+void EncodeImpl(
+    const Vertex* vertices, size_t count, const VertexQuantizer::DequantizeParams& params,
+    VertexQuantizer::VertexPacked* packed) {
+	const Vector3& center = params.positionCenter;
+	Vector3 invExtent = {
+	    SafeInverse(params.positionExtent.x), SafeInverse(params.positionExtent.y),
+	    SafeInverse(params.positionExtent.z)};
+	Vector2 invUvExtent = {SafeInverse(params.uvExtent.x), SafeInverse(params.uvExtent.y)};
+
+	for (size_t i = 0; i < count; i++) {
+		const Vertex& v = vertices[i];
+		VertexQuantizer::VertexPacked& p = packed[i];
+		p.pos[0] = ToSnorm16((v.pos.x - center.x) * invExtent.x);
+		p.pos[1] = ToSnorm16((v.pos.y - center.y) * invExtent.y);
+		p.pos[2] = ToSnorm16((v.pos.z - center.z) * invExtent.z);
+		p.pos[3] = 0;
+		VertexQuantizer::EncodeOctahedral(v.normal, p.normal);
+		p.uv[0] = ToUnorm16((v.uv.x - params.uvMin.x) * invUvExtent.x);
+		p.uv[1] = ToUnorm16((v.uv.y - params.uvMin.y) * invUvExtent.y);
+	}
+}
+
+template<class Vertex>
+void DecodeImpl(
+    const VertexQuantizer::VertexPacked* packed, size_t count,
+    const VertexQuantizer::DequantizeParams& params, Vertex* vertices) {
+	const Vector3& center = params.positionCenter;
+	const Vector3& extent = params.positionExtent;
+
+	for (size_t i = 0; i < count; i++) {
+		const VertexQuantizer::VertexPacked& p = packed[i];
+		Vertex& v = vertices[i];
+		v.pos = {
+		    center.x + extent.x * FromSnorm16(p.pos[0]),
+		    center.y + extent.y * FromSnorm16(p.pos[1]),
+		    center.z + extent.z * FromSnorm16(p.pos[2])};
+		v.normal = VertexQuantizer::DecodeOctahedral(p.normal);
+		v.uv = {
+		    params.uvMin.x + params.uvExtent.x * FromUnorm16(p.uv[0]),
+		    params.uvMin.y + params.uvExtent.y * FromUnorm16(p.uv[1])};
+	}
+}
+
+template<class Vertex>
+VertexQuantizer::ErrorStats MeasureErrorImpl(
+    const Vertex* vertices, const VertexQuantizer::VertexPacked* packed, size_t count,
+    const VertexQuantizer::DequantizeParams& params) {
+	VertexQuantizer::ErrorStats stats;
+	const Vector3& center = params.positionCenter;
+	const Vector3& extent = params.positionExtent;
+	// 量子化幅の半分に、復元時のfloat演算の丸め誤差を加える
+	float maxExtent = std::max({extent.x, extent.y, extent.z});
+	float maxAbs = std::max({std::fabs(center.x), std::fabs(center.y), std::fabs(center.z)}) +
+	               maxExtent;
+	stats.positionErrorBound = maxExtent / kSnorm16Max * 0.5f + maxAbs * FLT_EPSILON * 2.0f;
+	float maxUvExtent = std::max(params.uvExtent.x, params.uvExtent.y);
+	float maxUvAbs = std::max(std::fabs(params.uvMin.x), std::fabs(params.uvMin.y)) + maxUvExtent;
+	stats.uvErrorBound = maxUvExtent / kUnorm16Max * 0.5f + maxUvAbs * FLT_EPSILON * 2.0f;
+
+	for (size_t i = 0; i < count; i++) {
+		const Vertex& v = vertices[i];
+		Vertex decoded;
+		DecodeImpl(&packed[i], 1, params, &decoded);
+
+		stats.maxPositionError = std::max(
+		    {stats.maxPositionError, std::fabs(decoded.pos.x - v.pos.x),
+		     std::fabs(decoded.pos.y - v.pos.y), std::fabs(decoded.pos.z - v.pos.z)});
+		stats.maxUvError = std::max(
+		    {stats.maxUvError, std::fabs(decoded.uv.x - v.uv.x), std::fabs(decoded.uv.y - v.uv.y)});
+
+		// 長さ0の法線は比較しない
+		float length = std::sqrt(
+		    v.normal.x * v.normal.x + v.normal.y * v.normal.y + v.normal.z * v.normal.z);
+		if (length > 0.0f) {
+			// 小さな角度でも精度が落ちないよう弦の長さから求める
+			float dx = v.normal.x / length - decoded.normal.x;
+			float dy = v.normal.y / length - decoded.normal.y;
+			float dz = v.normal.z / length - decoded.normal.z;
+			float chord = std::sqrt(dx * dx + dy * dy + dz * dz);
+			float angle = 2.0f * std::asin(std::min(chord * 0.5f, 1.0f)) * kRadToDeg;
+			stats.maxNormalErrorDegrees = std::max(stats.maxNormalErrorDegrees, angle);
+		}
+	}
+	return stats;
+}
+
+} // namespace
+
+// 16bit x2 の八面体符号化の最大角度誤差は約0.004度。float演算の誤差を見込んだ値
+const float VertexQuantizer::kNormalErrorBoundDegrees = 0.01f;
+
+VertexQuantizer::DequantizeParams
+    VertexQuantizer::CalculateParams(const Mesh::VertexPosNormalUv* vertices, size_t count) {
+	return CalculateParamsImpl(vertices, count);
+}
+
+VertexQuantizer::DequantizeParams
+    VertexQuantizer::CalculateParams(const Terrain::VertexPosNormalUv* vertices, size_t count) {
+	return CalculateParamsImpl(vertices, count);
+}
+
+void VertexQuantizer::Encode(
+    const Mesh::VertexPosNormalUv* vertices, size_t count, const DequantizeParams& params,
+    VertexPacked* packed) {
+	EncodeImpl(vertices, count, params, packed);
+}
+
+void VertexQuantizer::Encode(
+    const Terrain::VertexPosNormalUv* vertices, size_t count, const DequantizeParams& params,
+    VertexPacked* packed) {
+	EncodeImpl(vertices, count, params, packed);
+}
+
+void VertexQuantizer::Decode(
+    const VertexPacked* packed, size_t count, const DequantizeParams& params,
+    Mesh::VertexPosNormalUv* vertices) {
+	DecodeImpl(packed, count, params, vertices);
+}
+
+void VertexQuantizer::Decode(
+    const VertexPacked* packed, size_t count, const DequantizeParams& params,
+    Terrain::VertexPosNormalUv* vertices) {
+	DecodeImpl(packed, count, params, vertices);
+}
+
+VertexQuantizer::ErrorStats VertexQuantizer::MeasureError(
+    const Mesh::VertexPosNormalUv* vertices, const VertexPacked* packed, size_t count,
+    const DequantizeParams& params) {
+	return MeasureErrorImpl(vertices, packed, count, params);
+}
+
+VertexQuantizer::ErrorStats VertexQuantizer::MeasureError(
+    const Terrain::VertexPosNormalUv* vertices, const VertexPacked* packed, size_t count,
+    const DequantizeParams& params) {
+	return MeasureErrorImpl(vertices, packed, count, params);
+}
+
+VertexQuantizer::MemoryReport VertexQuantizer::GetMemoryReport(size_t vertexCount) {
+	MemoryReport report;
+	report.vertexCount = vertexCount;
+	report.sourceBytes = vertexCount * sizeof(Mesh::VertexPosNormalUv);
+	report.packedBytes = vertexCount * sizeof(VertexPacked);
+	return report;
+}
+
+void VertexQuantizer::EncodeOctahedral(const Vector3& normal, int16_t encoded[2]) {
+	// 八面体へ射影
+	float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (sum == 0.0f) {
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x = normal.x / sum;
+	float y = normal.y / sum;
+
+	// 下半分は外側の三角形へ折り返す
+	if (normal.z < 0.0f) {
+		float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+	encoded[0] = ToSnorm16(x);
+	encoded[1] = ToSnorm16(y);
+}
+
+Vector3 VertexQuantizer::DecodeOctahedral(const int16_t encoded[2]) {
+	float x = FromSnorm16(encoded[0]);
+	float y = FromSnorm16(encoded[1]);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	// 折り返した下半分を戻す
+	if (z < 0.0f) {
+		float unfoldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float unfoldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	float length = std::sqrt(x * x + y * y + z * z);
+	return {x / length, y / length, z / length};
+}
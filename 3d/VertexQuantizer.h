@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Terrain.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstdint>
+
+/// <summary>
+/// 頂点の量子化（32バイト頂点を16バイトに詰める）
+/// </summary>
+class VertexQuantizer {
+public: // サブクラス
+	// 量子化頂点（16バイト）
+	struct VertexPacked {
+		int16_t pos[4];    // AABB中心からの相対座標（snorm16、wは未使用）
+		int16_t normal[2]; // 八面体符号化した法線（snorm16）
+		uint16_t uv[2];    // UV範囲内の相対座標（unorm16）
+	};
+
+	// 復元パラメータ（シェーダーの定数バッファと同じレイアウト）
+	struct DequantizeParams {
+		Vector3 positionCenter; // AABB中心
+		float pad0;
+		Vector3 positionExtent; // AABBの半分の大きさ
+		float pad1;
+		Vector2 uvMin;    // UV最小値
+		Vector2 uvExtent; // UV範囲の大きさ
+	};
+
+	// 誤差統計
+	struct ErrorStats {
+		// 座標の最大誤差（各軸の最大値）
+		float maxPositionError = 0.0f;
+		// 法線の最大角度誤差（度）
+		float maxNormalErrorDegrees = 0.0f;
+		// UVの最大誤差
+		float maxUvError = 0.0f;
+		// 座標誤差の理論上限（量子化幅の半分）
+		float positionErrorBound = 0.0f;
+		// UV誤差の理論上限（量子化幅の半分）
+		float uvErrorBound = 0.0f;
+	};
+
+	// メモリ使用量
+	struct MemoryReport {
+		// 頂点数
+		size_t vertexCount = 0;
+		// 量子化前のバイト数
+		size_t sourceBytes = 0;
+		// 量子化後のバイト数
+		size_t packedBytes = 0;
+
+		// 量子化後 / 量子化前
+		float GetRatio() const {
+			return sourceBytes ? float(packedBytes) / float(sourceBytes) : 0.0f;
+		}
+	};
+
+public: // 定数
+	// 八面体符号化した法線の角度誤差の理論上限（度）
+	static const float kNormalErrorBoundDegrees;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 頂点群から復元パラメータを求める
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="count">頂点数</param>
+	/// <returns>復元パラメータ</returns>
+	static DequantizeParams CalculateParams(const Mesh::VertexPosNormalUv* vertices, size_t count);
+	static DequantizeParams
+	    CalculateParams(const Terrain::VertexPosNormalUv* vertices, size_t count);
+
+	/// <summary>
+	/// 量子化
+	/// </summary>
+	/// <param name="vertices">頂点配列</param>
+	/// <param name="count">頂点数</param>
+	/// <param name="params">復元パラメータ</param>
+	/// <param name="packed">出力先（count 個）</param>
+	static void Encode(
+	    const Mesh::VertexPosNormalUv* vertices, size_t count, const DequantizeParams& params,
+	    VertexPacked* packed);
+	static void Encode(
+	    const Terrain::VertexPosNormalUv* vertices, size_t count, const DequantizeParams& params,
+	    VertexPacked* packed);
+
+	/// <summary>
+	/// 復元
+	/// </summary>
+	/// <param name="packed">量子化頂点配列</param>
+	/// <param name="count">頂点数</param>
+	/// <param name="params">復元パラメータ</param>
+	/// <param name="vertices">出力先（count 個）</param>
+	static void Decode(
+	    const VertexPacked* packed, size_t count, const DequantizeParams& params,
+	    Mesh::VertexPosNormalUv* vertices);
+	static void Decode(
+	    const VertexPacked* packed, size_t count, const DequantizeParams& params,
+	    Terrain::VertexPosNormalUv* vertices);
+
+	/// <summary>
+	/// 量子化誤差の計測
+	/// </summary>
+	/// <param name="vertices">元の頂点配列</param>
+	/// <param name="packed">量子化頂点配列</param>
+	/// <param name="count">頂点数</param>
+	/// <param name="params">復元パラメータ</param>
+	/// <returns>誤差統計</returns>
+	static ErrorStats MeasureError(
+	    const Mesh::VertexPosNormalUv* vertices, const VertexPacked* packed, size_t count,
+	    const DequantizeParams& params);
+	static ErrorStats MeasureError(
+	    const Terrain::VertexPosNormalUv* vertices, const VertexPacked* packed, size_t count,
+	    const DequantizeParams& params);
+
+	/// <summary>
+	/// メモリ使用量の見積もり
+	/// </summary>
+	/// <param name="vertexCount">頂点数</param>
+	/// <returns>メモリ使用量</returns>
+	static MemoryReport GetMemoryReport(size_t vertexCount);
+
+	/// <summary>
+	/// 単位ベクトルを八面体符号化する
+	/// </summary>
+	/// <param name="normal">単位ベクトル</param>
+	/// <param name="encoded">符号化した値（snorm16 x2）</param>
+	static void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+
+	/// <summary>
+	/// 八面体符号化した値を単位ベクトルに戻す
+	/// </summary>
+	/// <param name="encoded">符号化した値（snorm16 x2）</param>
+	/// <returns>単位ベクトル</returns>
+	static Vector3 DecodeOctahedral(const int16_t encoded[2]);
+};
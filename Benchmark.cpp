@@ -0,0 +1,620 @@
+#include "Benchmark.h"
+#include "ClusteredLighting.h"
+#include "DebugTextBatch.h"
+#include "DebugTextLabel.h"
+#include "Heightfield.h"
+#include "MathUtilityForText.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "Resampler.h"
+#include "SoftwareMixer.h"
+#include "SpriteBatch.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include <DirectXTex.h>
+#include <Windows.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 4096x4096 の高さ場生成（1サンプルずつ評価 / AVX2 で8サンプルずつ評価）
+void BenchmarkHeightfield() {
+	const uint32_t kVertexCount = 4096;
+	const uint32_t kGridSize = 64;
+
+	Heightfield heightfield;
+	heightfield.Initialize(
+	    float(kVertexCount), float(kVertexCount), 100.0f, kVertexCount, kVertexCount);
+	std::vector<float> noise(kVertexCount);
+	for (bool useSimd : {false, true}) {
+		heightfield.SetSeed(0);
+		heightfield.SetUseSimd(useSimd);
+
+		// 高さと法線の生成全体
+		auto deformTime = Benchmark::Measure([&] { heightfield.DeformRandom(kGridSize); });
+
+		// ノイズの評価のみ
+		float step = 1.0f / float(kGridSize);
+		auto noiseTime = Benchmark::Measure([&] {
+			for (uint32_t z = 0; z < kVertexCount; z++) {
+				heightfield.PerlinRow(0.0f, step, float(z) * step, kVertexCount, noise.data());
+			}
+		});
+
+		Benchmark::Report(
+		    "heightfield {}x{} {}: deform {} us, noise {} us", kVertexCount, kVertexCount,
+		    useSimd ? "avx2" : "scalar", deformTime.count(), noiseTime.count());
+	}
+}
+
+// 4096x4096 の高さ場生成と10万本のまとめてレイキャストのスレッド数によるスケーリング
+// （結果が1スレッドと一致するかも調べる）
+void BenchmarkHeightfieldThreads() {
+	const uint32_t kVertexCount = 4096;
+	const uint32_t kGridSize = 64;
+	const uint32_t kRayCount = 100000;
+
+	// 上空から地面を斜めに貫く線分
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(
+	    -float(kVertexCount) / 2.0f, float(kVertexCount) / 2.0f);
+	std::vector<Heightfield::Ray> rays(kRayCount);
+	for (Heightfield::Ray& ray : rays) {
+		ray.origin = {position(random), 150.0f, position(random)};
+		ray.delta = {position(random) / 8.0f, -200.0f, position(random) / 8.0f};
+	}
+	std::vector<Heightfield::RaycastHit> hits(kRayCount);
+
+	std::vector<Heightfield::VertexPosNormalUv> reference;
+	uint32_t maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+	for (uint32_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+		Heightfield heightfield;
+		heightfield.SetSeed(0);
+		heightfield.SetThreadCount(threadCount);
+
+		auto initializeTime = Benchmark::Measure([&] {
+			heightfield.Initialize(
+			    float(kVertexCount), float(kVertexCount), 100.0f, kVertexCount, kVertexCount);
+		});
+		auto deformTime = Benchmark::Measure([&] { heightfield.DeformRandom(kGridSize); });
+		uint32_t hitCount = 0;
+		auto raycastTime = Benchmark::Measure(
+		    [&] { hitCount = heightfield.RaycastBatch(rays.data(), hits.data(), kRayCount); });
+
+		const std::vector<Heightfield::VertexPosNormalUv>& vertices = heightfield.GetVertices();
+		if (reference.empty()) {
+			reference = vertices;
+		}
+		bool identical = std::memcmp(
+		                     reference.data(), vertices.data(),
+		                     sizeof(Heightfield::VertexPosNormalUv) * vertices.size()) == 0;
+
+		Benchmark::Report(
+		    "heightfield {}x{} {} threads: initialize {} us, deform {} us, identical {}, "
+		    "raycast {} rays {} us ({} hits)",
+		    kVertexCount, kVertexCount, threadCount, initializeTime.count(), deformTime.count(),
+		    identical, kRayCount, raycastTime.count(), hitCount);
+	}
+}
+
+// ソフトウェアミキサーで256ボイスを10秒分ミックスする（出力は捨てる）
+void BenchmarkMixer() {
+	const uint32_t kSampleRate = 48000;
+	const uint32_t kVoiceCount = 256;
+	const uint32_t kSeconds = 10;
+
+	for (bool useSimd : {false, true}) {
+		NullAudioOutput output(kSampleRate);
+		SoftwareMixer mixer;
+		mixer.Initialize(&output, kVoiceCount);
+		mixer.SetUseSimd(useSimd);
+		uint32_t sounds[] = {
+		    mixer.LoadWave("Resources/fanfare.wav"), mixer.LoadWave("Resources/mokugyo.wav")};
+		// 上限の2倍鳴らして半分は止めさせる
+		for (uint32_t i = 0; i < kVoiceCount * 2; i++) {
+			float pan = float(i % 9) / 4.0f - 1.0f;
+			mixer.PlayWave(sounds[i % 2], true, 1.0f / kVoiceCount, pan);
+		}
+
+		auto mixTime = Benchmark::Measure([&] { mixer.Render(kSampleRate * kSeconds); });
+
+		SoftwareMixer::Stats stats = mixer.GetStats();
+		Benchmark::Report(
+		    "mixer {} voices {} s {}: {} us ({:.1f}x realtime), stolen {}", kVoiceCount, kSeconds,
+		    useSimd ? "sse" : "scalar", mixTime.count(),
+		    double(kSeconds) * 1.0e6 / double(std::max<int64_t>(mixTime.count(), 1)),
+		    stats.stealCount);
+	}
+}
+
+// 読み込み時のサンプリングレート変換の速さと精度（256タップの変換結果との差で比べる）
+void BenchmarkResampler() {
+	for (const char* fileName : {"fanfare.wav", "mokugyo.wav"}) {
+		WaveFile::Format format;
+		std::vector<uint8_t> data;
+		if (!WaveFile::Load(std::string("Resources/") + fileName, format, data)) {
+			continue;
+		}
+		std::vector<float> samples;
+		uint32_t channelCount = WaveFile::Decode(format, data, 2, samples);
+		// もう一方のよく使うレートへ変換する
+		uint32_t srcRate = format.samplesPerSec;
+		uint32_t dstRate = srcRate == 48000 ? 44100 : 48000;
+
+		Resampler reference;
+		reference.Initialize(srcRate, dstRate, 256);
+		std::vector<float> expected = reference.Convert(samples, channelCount);
+
+		Resampler resampler;
+		resampler.Initialize(srcRate, dstRate);
+		const char* methodNames[] = {"linear", "sinc scalar", "sinc sse"};
+		for (uint32_t method = 0; method < 3; method++) {
+			std::vector<float> converted;
+			auto convertTime = Benchmark::Measure([&] {
+				converted = method == 0
+				                ? Resampler::ConvertLinear(samples, channelCount, srcRate, dstRate)
+				                : resampler.Convert(samples, channelCount, method == 2);
+			});
+
+			// 信号対雑音比（長さは同じになる）
+			double signal = 0.0;
+			double noise = 0.0;
+			for (size_t i = 0; i < std::min(converted.size(), expected.size()); i++) {
+				signal += double(expected[i]) * expected[i];
+				noise += double(converted[i] - expected[i]) * (converted[i] - expected[i]);
+			}
+			Benchmark::Report(
+			    "resample {} {}bit {} -> {} Hz {}: {} us, {:.1f} dB", fileName,
+			    format.bitsPerSample, srcRate, dstRate, methodNames[method], convertTime.count(),
+			    10.0 * std::log10(signal / std::max(noise, 1.0e-30)));
+		}
+	}
+}
+
+// スプライト一括描画の頂点生成（GPUは使わない）
+void BenchmarkSpriteBatch() {
+	const uint32_t kIterationCount = 100;
+	const Vector2 kScreenSize = {1280.0f, 720.0f};
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<SpriteBatch::Quad> quads(SpriteBatch::kMaxSpriteCount);
+	std::vector<uint32_t> order(quads.size());
+	for (uint32_t i = 0; i < quads.size(); i++) {
+		SpriteBatch::Quad& quad = quads[i];
+		quad.position = {unit(random) * kScreenSize.x, unit(random) * kScreenSize.y};
+		quad.size = {8.0f + unit(random) * 64.0f, 8.0f + unit(random) * 64.0f};
+		quad.anchorPoint = {0.5f, 0.5f};
+		quad.rotation = unit(random) * 6.28f;
+		quad.color = {unit(random), unit(random), unit(random), 1.0f};
+		order[i] = i;
+	}
+
+	std::vector<SpriteBatch::VertexPosUvColor> vertices[2];
+	for (bool useSimd : {false, true}) {
+		std::vector<SpriteBatch::VertexPosUvColor>& output = vertices[useSimd];
+		output.resize(quads.size() * SpriteBatch::kVertexCountPerSprite);
+		auto writeTime = Benchmark::Measure(
+		    [&] {
+			    SpriteBatch::WriteVertices(
+			        quads.data(), order.data(), static_cast<uint32_t>(quads.size()),
+			        kScreenSize, output.data(), useSimd);
+		    },
+		    kIterationCount);
+		Benchmark::Report(
+		    "sprite batch {} quads {}: {} us/frame", quads.size(), useSimd ? "sse" : "scalar",
+		    writeTime.count());
+	}
+	bool identical = std::memcmp(
+	                     vertices[0].data(), vertices[1].data(),
+	                     vertices[0].size() * sizeof(SpriteBatch::VertexPosUvColor)) == 0;
+	Benchmark::Report("sprite batch: identical {}", identical);
+}
+
+// デバッグ文字のインスタンス生成（GPUは使わない。スプライト一括描画の頂点生成と比べる）
+void BenchmarkDebugText() {
+	const uint32_t kIterationCount = 100;
+	const uint32_t kLineCount = 250;
+	const uint32_t kLineLength = 80;
+	const Vector2 kScreenSize = {1280.0f, 720.0f};
+
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> printable('!', '~');
+	std::vector<std::string> lines(kLineCount);
+	for (std::string& line : lines) {
+		for (uint32_t i = 0; i < kLineLength; i++) {
+			line += char(printable(random));
+		}
+	}
+
+	// 1文字1インスタンス（20バイト）をアップロード先へ書くまで
+	std::vector<DebugTextBatch::GlyphInstance> instances;
+	std::vector<DebugTextBatch::GlyphInstance> upload(kLineCount * kLineLength);
+	auto instanceTime = Benchmark::Measure(
+	    [&] {
+		    instances.clear();
+		    for (uint32_t i = 0; i < kLineCount; i++) {
+			    DebugTextBatch::AppendGlyphs(
+			        lines[i].data(), lines[i].size(), {0.0f, float(i % 40) * 18.0f}, 1.0f,
+			        0xffffffff, instances);
+		    }
+		    std::copy(instances.begin(), instances.end(), upload.begin());
+	    },
+	    kIterationCount);
+
+	// 同じ文字を1文字1四角形（4頂点80バイト）で書く場合
+	std::vector<SpriteBatch::Quad> quads(instances.size());
+	std::vector<uint32_t> order(quads.size());
+	for (uint32_t i = 0; i < quads.size(); i++) {
+		const DebugTextBatch::GlyphInstance& glyph = instances[i];
+		quads[i].position = glyph.position;
+		quads[i].size = {float(DebugTextBatch::kFontWidth), float(DebugTextBatch::kFontHeight)};
+		order[i] = i;
+	}
+	std::vector<SpriteBatch::VertexPosUvColor> vertices(
+	    quads.size() * SpriteBatch::kVertexCountPerSprite);
+	auto quadTime = Benchmark::Measure(
+	    [&] {
+		    SpriteBatch::WriteVertices(
+		        quads.data(), order.data(), static_cast<uint32_t>(quads.size()), kScreenSize,
+		        vertices.data());
+	    },
+	    kIterationCount);
+
+	Benchmark::Report(
+	    "debug text {} glyphs: instanced {} us/frame {} KB, quads {} us/frame {} KB",
+	    instances.size(), instanceTime.count(),
+	    instances.size() * sizeof(DebugTextBatch::GlyphInstance) / 1024, quadTime.count(),
+	    vertices.size() * sizeof(SpriteBatch::VertexPosUvColor) / 1024);
+}
+
+// デバッグ文字の保持ラベル（毎フレーム展開して並べる場合と、内容が変わらないラベルを積む場合）
+void BenchmarkDebugTextLabel() {
+	const uint32_t kIterationCount = 100;
+	const uint32_t kLineCount = 250;
+	const uint32_t kLineLength = 72;
+
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> printable('!', '~');
+	std::vector<std::string> lines(kLineCount);
+	for (std::string& line : lines) {
+		for (uint32_t i = 0; i < kLineLength; i++) {
+			line += char(printable(random));
+		}
+	}
+
+	std::vector<DebugTextLabel> labels(kLineCount);
+	for (uint32_t i = 0; i < kLineCount; i++) {
+		labels[i].SetPosition({0.0f, float(i % 40) * 18.0f});
+	}
+	const char* modeNames[] = {"printf", "label printf", "label static"};
+	std::vector<DebugTextBatch::GlyphInstance> instances;
+	std::vector<char> buffer(kLineLength + 16);
+	for (uint32_t mode = 0; mode < 3; mode++) {
+		auto frameTime = Benchmark::Measure(
+		    [&] {
+			    instances.clear();
+			    for (uint32_t i = 0; i < kLineCount; i++) {
+				    if (mode == 0) {
+					    // DebugTextBatch::Printf と同じく毎回展開して並べる
+					    int length = snprintf(
+					        buffer.data(), buffer.size(), "%3u: %s", i, lines[i].c_str());
+					    DebugTextBatch::AppendGlyphs(
+					        buffer.data(), size_t(length), {0.0f, float(i % 40) * 18.0f}, 1.0f,
+					        0xffffffff, instances);
+					    continue;
+				    }
+				    if (mode == 1) {
+					    labels[i].Printf("%3u: %s", i, lines[i].c_str());
+				    }
+				    const std::vector<DebugTextBatch::GlyphInstance>& glyphs =
+				        labels[i].GetGlyphs();
+				    instances.insert(instances.end(), glyphs.begin(), glyphs.end());
+			    }
+		    },
+		    kIterationCount);
+		Benchmark::Report(
+		    "debug text label {} glyphs {}: {} us/frame, {} layouts", instances.size(),
+		    modeNames[mode], frameTime.count(),
+		    mode == 0 ? kLineCount * kIterationCount : labels[0].GetLayoutCount() * kLineCount);
+	}
+}
+
+// 1000灯のクラスター化ライティングの区画分け（スカラー1スレッド / SIMD1スレッド / SIMD全スレッド。
+// 結果が最初と一致するかも調べる）
+void BenchmarkClusteredLighting() {
+	const uint32_t kIterationCount = 100;
+	const float kNearZ = 0.1f;
+	const float kFarZ = 1000.0f;
+
+	// 原点から +Z を向くカメラ（縦画角45度、16:9）
+	ViewProjection viewProjection;
+	viewProjection.matView = MakeIdentityMatrix();
+	float scaleY = 1.0f / std::tan(45.0f * 3.14159265f / 180.0f / 2.0f);
+	viewProjection.matProjection = {};
+	viewProjection.matProjection.m[0][0] = scaleY * 9.0f / 16.0f;
+	viewProjection.matProjection.m[1][1] = scaleY;
+	viewProjection.matProjection.m[2][2] = kFarZ / (kFarZ - kNearZ);
+	viewProjection.matProjection.m[2][3] = 1.0f;
+	viewProjection.matProjection.m[3][2] = -kNearZ * kFarZ / (kFarZ - kNearZ);
+
+	// 200x200 の床の上に点光源700・スポットライト200・丸影100
+	ClusteredLighting lighting;
+	lighting.Initialize(1280, 720);
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (uint32_t i = 0; i < 700; i++) {
+		PointLight& light = lighting.GetPointLights().emplace_back();
+		light.SetLightPos(
+		    {unit(random) * 200.0f - 100.0f, unit(random) * 40.0f - 20.0f, unit(random) * 200.0f});
+		light.SetLightAtten({1.0f, 0.0f, 2.0f + 4.0f * unit(random)});
+		light.SetActive(true);
+	}
+	for (uint32_t i = 0; i < 200; i++) {
+		SpotLight& light = lighting.GetSpotLights().emplace_back();
+		light.SetLightPos({unit(random) * 200.0f - 100.0f, 10.0f, unit(random) * 200.0f});
+		light.SetLightDir({0.0f, -1.0f, 0.0f});
+		light.SetLightAtten({1.0f, 0.0f, 2.0f});
+		light.SetLightFactorAngle({0.3f, 0.6f});
+		light.SetActive(true);
+	}
+	for (uint32_t i = 0; i < 100; i++) {
+		CircleShadow& shadow = lighting.GetCircleShadows().emplace_back();
+		shadow.SetCasterPos({unit(random) * 200.0f - 100.0f, 1.0f, unit(random) * 200.0f});
+		shadow.SetDir({0.0f, -1.0f, 0.0f});
+		shadow.SetAtten({1.0f, 1.0f, 1.0f});
+		shadow.SetDistanceCasterLight(10.0f);
+		shadow.SetFactorAngle({0.1f, 0.2f});
+		shadow.SetActive(true);
+	}
+
+	const char* modeNames[] = {"scalar 1 thread", "simd 1 thread", "simd all threads"};
+	std::vector<ClusteredLighting::ClusterHeader> referenceHeaders;
+	std::vector<uint32_t> referenceIndices;
+	for (uint32_t mode = 0; mode < 3; mode++) {
+		lighting.SetUseSimd(mode != 0);
+		lighting.SetThreadCount(mode == 2 ? 0 : 1);
+		auto buildTime =
+		    Benchmark::Measure([&] { lighting.Build(viewProjection); }, kIterationCount);
+
+		const std::vector<ClusteredLighting::ClusterHeader>& headers =
+		    lighting.GetClusterHeaders();
+		if (mode == 0) {
+			referenceHeaders = headers;
+			referenceIndices = lighting.GetLightIndices();
+		}
+		bool identical = referenceIndices == lighting.GetLightIndices() &&
+		                 std::memcmp(
+		                     referenceHeaders.data(), headers.data(),
+		                     headers.size() * sizeof(ClusteredLighting::ClusterHeader)) == 0;
+		const ClusteredLighting::Stats& stats = lighting.GetStats();
+		Benchmark::Report(
+		    "clustered lighting {} lights {}: {} us, {} indices, max {} per cluster, "
+		    "{} overflow, identical {}",
+		    stats.lightCount, modeNames[mode], buildTime.count(), stats.indexCount,
+		    stats.maxClusterLightCount, stats.overflowCount, identical);
+	}
+}
+
+// 空の処理を全スレッドに1000回配る時間（毎回スレッドを作って合流する場合と常駐ワーカーの場合）
+void BenchmarkThreadPool() {
+	const uint32_t kDispatchCount = 1000;
+
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	uint32_t threadCount = threadPool->GetThreadCount();
+	auto spawnTime = Benchmark::Measure([&] {
+		for (uint32_t n = 0; n < kDispatchCount; n++) {
+			std::vector<std::thread> threads;
+			for (uint32_t t = 1; t < threadCount; t++) {
+				threads.emplace_back([] {});
+			}
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+		}
+	});
+	auto poolTime = Benchmark::Measure([&] {
+		for (uint32_t n = 0; n < kDispatchCount; n++) {
+			threadPool->ParallelFor(threadCount, threadCount, [](size_t, size_t, uint32_t) {});
+		}
+	});
+	Benchmark::Report(
+	    "thread pool {} threads x {} dispatches: spawn+join {} us, pool {} us", threadCount,
+	    kDispatchCount, spawnTime.count(), poolTime.count());
+}
+
+// 格子状のOBJを書き出す（大きいメッシュの読み込み計測用。division×division 四角形）
+bool WriteGridObj(const std::string& path, uint32_t division) {
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+	for (uint32_t z = 0; z <= division; z++) {
+		for (uint32_t x = 0; x <= division; x++) {
+			float u = float(x) / division;
+			float v = float(z) / division;
+			float height = std::sin(u * 20.0f) * std::cos(v * 20.0f);
+			file << std::format("v {} {} {}\nvt {} {}\n", u * 100.0f, height, v * 100.0f, u, v);
+		}
+	}
+	file << "vn 0 1 0\n";
+	for (uint32_t z = 0; z < division; z++) {
+		for (uint32_t x = 0; x < division; x++) {
+			uint32_t i = z * (division + 1) + x + 1;
+			uint32_t j = i + division + 1;
+			file << std::format(
+			    "f {}/{}/1 {}/{}/1 {}/{}/1 {}/{}/1\n", i, i, j, j, j + 1, j + 1, i + 1, i + 1);
+		}
+	}
+	return bool(file);
+}
+
+// キャッシュ無し（解析＋最適化＋キャッシュ書き出し）と、キャッシュから
+// 中間配列へ複製してバッファへ書く場合・マッピングから直接バッファへ書く場合の読み込み時間
+// （アップロードバッファへの書き込みはCPU側の配列への複製で代用する）
+void BenchmarkMeshLoad(const std::string& modelname, bool smoothing) {
+	const uint32_t kIterationCount = 10;
+
+	const std::string cachePath = ObjLoader::GetCachePath(modelname);
+	std::vector<uint8_t> uploadBuffer;
+	auto upload = [&uploadBuffer](const void* data, size_t size) {
+		uploadBuffer.resize(size);
+		std::memcpy(uploadBuffer.data(), data, size);
+	};
+
+	std::error_code ec;
+	std::filesystem::remove(cachePath, ec);
+	ObjLoader::ModelData modelData;
+	bool loaded = false;
+	auto coldTime = Benchmark::Measure(
+	    [&] { loaded = ObjLoader::LoadFromSource(modelname, smoothing, modelData); });
+	if (!loaded) {
+		Benchmark::Report("mesh load {}: not found", modelname);
+		return;
+	}
+	size_t vertexCount = 0;
+	for (const ObjLoader::MeshData& mesh : modelData.meshes) {
+		vertexCount += mesh.vertices.size();
+	}
+
+	auto copyTime = Benchmark::Measure(
+	    [&] {
+		    MeshCache::Reader reader;
+		    ObjLoader::ModelData copied;
+		    if (reader.Open(cachePath, smoothing)) {
+			    reader.CopyTo(copied);
+		    }
+		    for (const ObjLoader::MeshData& mesh : copied.meshes) {
+			    upload(mesh.vertices.data(), mesh.vertices.size() * sizeof(mesh.vertices[0]));
+			    upload(mesh.indices.data(), mesh.indices.size() * sizeof(mesh.indices[0]));
+		    }
+	    },
+	    kIterationCount);
+	auto directTime = Benchmark::Measure(
+	    [&] {
+		    MeshCache::Reader reader;
+		    if (reader.Open(cachePath, smoothing)) {
+			    for (const MeshCache::MeshView& mesh : reader.GetMeshes()) {
+				    upload(mesh.vertices, mesh.vertexCount * sizeof(mesh.vertices[0]));
+				    upload(mesh.indices, size_t(mesh.indexCount) * mesh.indexSize);
+			    }
+		    }
+	    },
+	    kIterationCount);
+	Benchmark::Report(
+	    "mesh load {} ({} vertices): cold {} us, warm copy {} us, warm mapped {} us", modelname,
+	    vertexCount, coldTime.count(), copyTime.count(), directTime.count());
+}
+
+// 天球と大きい格子メッシュの読み込み時間
+void BenchmarkMeshLoads() {
+	// 計測はキャッシュを消して始めるので、天球は元のキャッシュに触れないよう別名の複製で計る
+	std::error_code ec;
+	const std::string skydomeName = "bench_skydome";
+	const std::string skydomePath = ObjLoader::GetDirectoryPath(skydomeName);
+	std::filesystem::remove_all(skydomePath, ec);
+	std::filesystem::create_directories(skydomePath, ec);
+	for (const auto& entry :
+	     std::filesystem::directory_iterator(ObjLoader::GetDirectoryPath("skydome"), ec)) {
+		std::string filename = entry.path().filename().string();
+		if (entry.path().extension() == ".meshcache") {
+			continue;
+		}
+		if (filename == "skydome.obj") {
+			filename = skydomeName + ".obj";
+		}
+		std::filesystem::copy_file(entry.path(), skydomePath + filename, ec);
+	}
+	BenchmarkMeshLoad(skydomeName, true);
+	std::filesystem::remove_all(skydomePath, ec);
+
+	const std::string gridName = "bench_grid";
+	const std::string directoryPath = ObjLoader::GetDirectoryPath(gridName);
+	std::filesystem::create_directories(directoryPath);
+	if (WriteGridObj(directoryPath + gridName + ".obj", 512)) {
+		BenchmarkMeshLoad(gridName, false);
+	}
+	std::filesystem::remove_all(directoryPath, ec);
+}
+
+// Resources 以下の全テクスチャの起動時の読み込み時間
+// （キャッシュ無しのデコード＋ミップマップ生成・初回のキャッシュ書き出しと、キャッシュを
+// マッピングして各ミップをアップロード用に複製するまで。GPUへの転送は含まない）
+void BenchmarkTextureLoads() {
+	HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	assert(SUCCEEDED(result));
+
+	// 調理済みのキャッシュを上書きしないよう、計測用のキャッシュは別名にする
+	const std::string kBenchExtension = ".bench";
+	uint32_t fileCount = 0;
+	uint32_t failedCount = 0;
+	std::chrono::microseconds coldTime{};
+	std::chrono::microseconds writeTime{};
+	std::chrono::microseconds warmTime{};
+	std::vector<uint8_t> uploadBuffer;
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator("Resources/", ec)) {
+		std::string sourcePath = entry.path().generic_string();
+		if (!entry.is_regular_file() || !TextureCache::IsImageFile(sourcePath)) {
+			continue;
+		}
+		std::string cachePath = TextureCache::GetCachePath(sourcePath) + kBenchExtension;
+
+		DirectX::ScratchImage image;
+		coldTime += Benchmark::Measure([&] { result = TextureCache::Decode(sourcePath, image); });
+		bool written = false;
+		writeTime += Benchmark::Measure([&] {
+			written = SUCCEEDED(result) && TextureCache::Write(cachePath, sourcePath, image);
+		});
+		bool opened = false;
+		warmTime += Benchmark::Measure([&] {
+			TextureCache::Reader reader;
+			opened = written && reader.Open(cachePath, sourcePath);
+			for (const TextureCache::Subresource& subresource : reader.GetSubresources()) {
+				uploadBuffer.resize(subresource.slicePitch);
+				std::memcpy(uploadBuffer.data(), subresource.data, subresource.slicePitch);
+			}
+		});
+		std::filesystem::remove(cachePath, ec);
+		fileCount++;
+		if (!opened) {
+			failedCount++;
+		}
+	}
+	Benchmark::Report(
+	    "texture load {} files ({} failed): cold decode+mips {} us, cache write {} us, "
+	    "warm mapped {} us",
+	    fileCount, failedCount, coldTime.count(), writeTime.count(), warmTime.count());
+
+	CoUninitialize();
+}
+
+} // namespace
+
+int Benchmark::RunAll() {
+	BenchmarkHeightfield();
+	BenchmarkHeightfieldThreads();
+	BenchmarkMixer();
+	BenchmarkResampler();
+	BenchmarkSpriteBatch();
+	BenchmarkDebugText();
+	BenchmarkDebugTextLabel();
+	BenchmarkClusteredLighting();
+	BenchmarkThreadPool();
+	BenchmarkMeshLoads();
+	BenchmarkTextureLoads();
+	return 0;
+}
+
+void Benchmark::WriteLine(const std::string& line) {
+	std::string text = line + "\n";
+	OutputDebugStringA(text.c_str());
+}
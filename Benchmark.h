@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <utility>
+
+/// <summary>
+/// ベンチマーク（-bench で起動したときに実行する。GPUは使わず、結果はデバッグ出力へ書く）
+/// </summary>
+class Benchmark {
+public: // 静的メンバ関数
+	/// <summary>
+	/// 全ベンチマークの実行
+	/// </summary>
+	/// <returns>終了コード</returns>
+	static int RunAll();
+
+	/// <summary>
+	/// 計測（func を iterationCount 回呼んだ1回あたりの時間）
+	/// </summary>
+	/// <param name="func">計測する処理</param>
+	/// <param name="iterationCount">繰り返し回数</param>
+	/// <returns>1回あたりの時間</returns>
+	template<class Func>
+	static std::chrono::microseconds Measure(Func&& func, uint32_t iterationCount = 1) {
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < iterationCount; i++) {
+			func();
+		}
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		    std::chrono::steady_clock::now() - start);
+		return elapsed / iterationCount;
+	}
+
+	/// <summary>
+	/// 結果を1行出力
+	/// </summary>
+	/// <param name="fmt">std::format の書式</param>
+	/// <param name="args">引数</param>
+	template<class... Args> static void Report(std::format_string<Args...> fmt, Args&&... args) {
+		WriteLine(std::format(fmt, std::forward<Args>(args)...));
+	}
+
+private: // 静的メンバ関数
+	/// <summary>
+	/// デバッグ出力へ1行書く
+	/// </summary>
+	/// <param name="line">改行を含まない文字列</param>
+	static void WriteLine(const std::string& line);
+};
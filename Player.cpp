@@ -3,6 +3,7 @@
 #include "ImGuiManager.h"
 #include "Vector3.h"
 #include "DirectXCommon.h"
+#include "TextureAtlas.h"
 #include <algorithm>
 
 Player::~Player() {
@@ -10,13 +11,14 @@ Player::~Player() {
 	for (PlayerBullet* bullet : bullets_) {
 		delete bullet;
 	}
-	delete sprite2DReticle_;
 }
 
-void Player::Initialize(Model* model, uint32_t textureHandle, const Vector3& position) {
+void Player::Initialize(
+    Model* model, uint32_t textureHandle, const Vector3& position, const TextureAtlas* uiAtlas) {
 
 	// NULLポインタチェック
 	assert(model);
+	assert(uiAtlas);
 
 	textureHandle_ = textureHandle;
 	model_ = model;
@@ -31,14 +33,10 @@ void Player::Initialize(Model* model, uint32_t textureHandle, const Vector3& pos
 	// 3Dレティクルのワールドトランスフォーム初期化
 	worldTransform3DReticle_.Initialize();
 
-	// レティクル用テクスチャ取得
-	uint32_t textureReticle = TextureManager::Load("reticle.png");
-
-	// スプライト生成
-	//sprite2DReticle_ = Sprite::Create(textureReticle, 座標, 色, アンカーポイント);
-	sprite2DReticle_ = Sprite::Create(
-	    textureReticle, Vector2(WinApp::kWindowWidth / 2.0f, WinApp::kWindowHeight / 2.0f),
-	    Vector4(1, 1, 1, 1), Vector2(0.5f, 0.5f));
+	// レティクルはUIアトラスの領域を画面中央に置く
+	uiAtlas->Apply(&reticle_, "reticle.png");
+	reticle_.position = Vector2(WinApp::kWindowWidth / 2.0f, WinApp::kWindowHeight / 2.0f);
+	reticle_.anchorPoint = Vector2(0.5f, 0.5f);
 }
 
 void Player::Update(const ViewProjection& viewProjection) {
@@ -122,8 +120,8 @@ void Player::Update(const ViewProjection& viewProjection) {
 		// ワールド→スクリーン座標変換（ここで3Dから2Dになる）
 		positionReticle = Transform(positionReticle, matViewProjectionViewport);
 
-		// スプライトのレティクルに座標設定
-		sprite2DReticle_->SetPosition(Vector2(positionReticle.x, positionReticle.y));
+		// 2Dレティクルに座標設定
+		reticle_.position = Vector2(positionReticle.x, positionReticle.y);
 	}
 }
 
@@ -235,7 +233,7 @@ void Player::SetParent(const WorldTransform* parent) {
 
 void Player::DrawUI() {
 	// 2Dレティクルを描画
-	sprite2DReticle_->Draw();
+	SpriteBatch::GetInstance()->Draw(reticle_);
 }
 
 Vector3 Player::GetWorldPosition2DReticle() {
@@ -5,10 +5,12 @@
 #include "Input.h"
 #include "MathUtilityforText.h"
 #include "PlayerBullet.h"
-#include "Sprite.h"
+#include "SpriteBatch.h"
 
 #include <list>
 
+class TextureAtlas;
+
 class Player {
 
 public:
@@ -22,7 +24,9 @@ public:
 	/// </summary>
 	/// <param name="model">モデル</param>
 	/// <param name="textureHandle">テクスチャハンドル</param>
-	void Initialize(Model* model, uint32_t textureHandle, const Vector3& position);
+	/// <param name="uiAtlas">レティクルの入ったUIアトラス</param>
+	void Initialize(
+	    Model* model, uint32_t textureHandle, const Vector3& position, const TextureAtlas* uiAtlas);
 
 	/// <summary>
 	/// 更新
@@ -68,7 +72,7 @@ public:
 	void SetParent(const WorldTransform* parent);
 
 	/// <summary>
-	/// UI描画
+	/// UI描画（SpriteBatch の PreDraw と PostDraw の間で呼ぶ）
 	/// </summary>
 	void DrawUI();
 
@@ -91,6 +95,6 @@ public:
     // 3Dレティクル用ワールドトランスフォーム
 	WorldTransform worldTransform3DReticle_;
 
-	// 2Dレティクル用スプライト
-	Sprite* sprite2DReticle_ = nullptr;
+	// 2Dレティクル（UIアトラスの領域を一括描画する）
+	SpriteBatch::Quad reticle_;
 };
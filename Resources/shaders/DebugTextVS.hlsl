@@ -0,0 +1,38 @@
+#include "DebugText.hlsli"
+
+// ルート定数
+cbuffer ConstBufferData : register(b0) {
+	float2 clipScale;   // スクリーン座標からクリップ座標への倍率
+	float2 glyphSize;   // 1文字の大きさ（ピクセル）
+	float2 glyphUvSize; // 1文字の大きさ（uv）
+	uint columnCount;   // フォント画像内1行分の文字数
+	uint firstInstance; // 今回の描画の先頭インスタンス
+	float2 uvOffset;    // フォント画像の左上（uv）
+};
+
+// 1文字分のインスタンスデータ
+struct GlyphInstance {
+	float2 position; // 左上座標（スクリーン座標）
+	float scale;     // 倍率
+	uint glyph;      // フォント画像内の文字番号
+	uint color;      // RGBA（8bit正規化）
+};
+
+StructuredBuffer<GlyphInstance> instances : register(t1); // 1番スロットに設定されたインスタンス
+
+// 頂点番号 0〜3 が左上・右上・左下・右下（トライアングルストリップ）
+VSOutput main(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID) {
+	GlyphInstance instance = instances[firstInstance + instanceId];
+	float2 corner = float2(vertexId & 1, vertexId >> 1);
+
+	float2 pos = instance.position + corner * glyphSize * instance.scale;
+	float2 cell = float2(instance.glyph % columnCount, instance.glyph / columnCount);
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = float4(pos * clipScale + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+	output.uv = uvOffset + (cell + corner) * glyphUvSize;
+	output.color = float4(
+	    instance.color & 0xff, (instance.color >> 8) & 0xff, (instance.color >> 16) & 0xff,
+	    instance.color >> 24) / 255.0f;
+	return output;
+}
@@ -1,17 +1,156 @@
 #include "Obj.hlsli"
 
+#ifdef BINDLESS
+// TextureStreamer のデスクリプタヒープ全体（SM5.1、テクスチャ番号で引く）
+Texture2D<float4> textures[] : register(t0, space1);
+
+cbuffer DrawConstants : register(b5) {
+	uint textureIndex; // テクスチャのデスクリプタ番号
+};
+#else
 Texture2D<float4> tex : register(t0); // 0番スロットに設定されたテクスチャ
+#endif
 SamplerState smp : register(s0);      // 0番スロットに設定されたサンプラー
 
+#ifdef CLUSTERED
+// クラスター化ライティング（ClusteredLighting と同じ区画の分け方・並び）
+static const uint CLUSTER_COUNT_X = 16;
+static const uint CLUSTER_COUNT_Y = 9;
+static const uint CLUSTER_COUNT_Z = 24;
+
+struct ClusterPointLight {
+	float3 lightpos;   // ライト座標
+	float range;       // 届く範囲
+	float3 lightcolor; // ライトの色(RGB)
+	float3 lightatten; // ライト距離減衰係数
+};
+
+struct ClusterSpotLight {
+	float3 lightv;              // ライトの光線方向の逆ベクトル（単位ベクトル）
+	float range;                // 届く範囲
+	float3 lightpos;            // ライト座標
+	float3 lightcolor;          // ライトの色(RGB)
+	float3 lightatten;          // ライト距離減衰係数
+	float2 lightfactoranglecos; // ライト減衰角度のコサイン
+};
+
+struct ClusterCircleShadow {
+	float3 dir;                // 投影方向の逆ベクトル（単位ベクトル）
+	float range;               // 届く範囲（キャスターからの距離）
+	float3 casterPos;          // キャスター座標
+	float distanceCasterLight; // キャスターとライトの距離
+	float3 atten;              // 距離減衰係数
+	float2 factorAngleCos;     // 減衰角度のコサイン
+};
+
+cbuffer ClusterConstants : register(b6) {
+	float tileScaleX; // ピクセル座標から区画番号Xへの倍率
+	float tileScaleY; // ピクセル座標から区画番号Yへの倍率
+	float sliceScale; // log(ビュー空間Z) から区画番号Zへの倍率
+	float sliceBias;  // log(ビュー空間Z) から区画番号Zへのずらし
+};
+
+// 区画毎の一覧の位置（先頭, 点光源の数, スポットライトの数, 丸影の数）
+StructuredBuffer<uint4> clusterHeaders : register(t1);
+// 区画毎の一覧（種類毎のライト番号）
+StructuredBuffer<uint> clusterLightIndices : register(t2);
+StructuredBuffer<ClusterPointLight> clusterPointLights : register(t3);
+StructuredBuffer<ClusterSpotLight> clusterSpotLights : register(t4);
+StructuredBuffer<ClusterCircleShadow> clusterCircleShadows : register(t5);
+#endif
+
+// 光沢度
+static const float shininess = 4.0f;
+
+// 拡散反射光と鏡面反射光（lightv はライトへの方向の単位ベクトル）
+float3 DiffuseSpecular(float3 lightv, float3 normal, float3 eyedir) {
+	// ライトに向かうベクトルと法線の内積
+	float3 dotlightnormal = dot(lightv, normal);
+	// 反射光ベクトル
+	float3 reflect = normalize(-lightv + 2 * dotlightnormal * normal);
+	// 拡散反射光
+	float3 diffuse = dotlightnormal * m_diffuse;
+	// 鏡面反射光
+	float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
+	return diffuse + specular;
+}
+
+// 点光源による色
+float3 PointLightColor(
+    float3 lightpos, float3 lightcolor, float3 lightatten, float3 worldpos, float3 normal,
+    float3 eyedir) {
+	// ライトへの方向ベクトル
+	float3 lightv = lightpos - worldpos;
+	float d = length(lightv);
+	lightv = normalize(lightv);
+
+	// 距離減衰係数
+	float atten = 1.0f / (lightatten.x + lightatten.y * d + lightatten.z * d * d);
+
+	return atten * DiffuseSpecular(lightv, normal, eyedir) * lightcolor;
+}
+
+// スポットライトによる色
+float3 SpotLightColor(
+    float3 spotv, float3 lightpos, float3 lightcolor, float3 lightatten, float2 factoranglecos,
+    float3 worldpos, float3 normal, float3 eyedir) {
+	// ライトへの方向ベクトル
+	float3 lightv = lightpos - worldpos;
+	float d = length(lightv);
+	lightv = normalize(lightv);
+
+	// 距離減衰係数
+	float atten = saturate(1.0f / (lightatten.x + lightatten.y * d + lightatten.z * d * d));
+
+	// 角度減衰
+	float cos = dot(lightv, spotv);
+	// 減衰開始角度から、減衰終了角度にかけて減衰
+	// 減衰開始角度の内側は1倍 減衰終了角度の外側は0倍の輝度
+	float angleatten = smoothstep(factoranglecos.y, factoranglecos.x, cos);
+	// 角度減衰を乗算
+	atten *= angleatten;
+
+	return atten * DiffuseSpecular(lightv, normal, eyedir) * lightcolor;
+}
+
+// 丸影による暗さ
+float CircleShadowAtten(
+    float3 dir, float3 casterPos, float distanceCasterLight, float3 shadowatten,
+    float2 factorAngleCos, float3 worldpos) {
+	// オブジェクト表面からキャスターへのベクトル
+	float3 casterv = casterPos - worldpos;
+	// 光線方向での距離
+	float d = dot(casterv, dir);
+
+	// 距離減衰係数
+	float atten = saturate(1.0f / (shadowatten.x + shadowatten.y * d + shadowatten.z * d * d));
+	// 距離がマイナスなら0にする
+	atten *= step(0, d);
+
+	// ライトの座標
+	float3 lightpos = casterPos + dir * distanceCasterLight;
+	//  オブジェクト表面からライトへのベクトル（単位ベクトル）
+	float3 lightv = normalize(lightpos - worldpos);
+	// 角度減衰
+	float cos = dot(lightv, dir);
+	// 減衰開始角度から、減衰終了角度にかけて減衰
+	// 減衰開始角度の内側は1倍 減衰終了角度の外側は0倍の輝度
+	float angleatten = smoothstep(factorAngleCos.y, factorAngleCos.x, cos);
+	// 角度減衰を乗算
+	return atten * angleatten;
+}
+
 float4 main(VSOutput input) : SV_TARGET {
 	// UV変換
 	float2 uv = float2(
 	    input.uv.x * m_uv_scale.x + m_uv_offset.x, input.uv.y * m_uv_scale.y + m_uv_offset.y);
 	// テクスチャマッピング
+#ifdef BINDLESS
+	float4 texcolor = textures[textureIndex].Sample(smp, uv);
+#else
 	float4 texcolor = tex.Sample(smp, uv);
+#endif
 
-	// 光沢度
-	const float shininess = 4.0f;
 	// 頂点から視点への方向ベクトル
 	float3 eyedir = normalize(cameraPos - input.worldpos.xyz);
 
@@ -24,115 +163,85 @@ float4 main(VSOutput input) : SV_TARGET {
 	// 平行光源
 	for (int i = 0; i < DIRLIGHT_NUM; i++) {
 		if (dirLights[i].active) {
-			// ライトに向かうベクトルと法線の内積
-			float3 dotlightnormal = dot(dirLights[i].lightv, input.normal);
-			// 反射光ベクトル
-			float3 reflect = normalize(-dirLights[i].lightv + 2 * dotlightnormal * input.normal);
-			// 拡散反射光
-			float3 diffuse = dotlightnormal * m_diffuse;
-			// 鏡面反射光
-			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
-
 			// 全て加算する
-			shadecolor.rgb += (diffuse + specular) * dirLights[i].lightcolor;
+			shadecolor.rgb += DiffuseSpecular(dirLights[i].lightv, input.normal, eyedir) *
+			                  dirLights[i].lightcolor;
+		}
+	}
+
+#ifdef CLUSTERED
+	// 画素の区画（画面タイルとビュー空間Zの対数から求める）
+	uint tileX = min(uint(input.svpos.x * tileScaleX), CLUSTER_COUNT_X - 1);
+	uint tileY = min(uint(input.svpos.y * tileScaleY), CLUSTER_COUNT_Y - 1);
+	float viewZ = mul(float4(input.worldpos.xyz, 1), view).z;
+	uint slice = uint(clamp(
+	    floor(log(max(viewZ, 1e-6f)) * sliceScale + sliceBias), 0, CLUSTER_COUNT_Z - 1));
+	uint4 header = clusterHeaders[(slice * CLUSTER_COUNT_Y + tileY) * CLUSTER_COUNT_X + tileX];
+	uint index = header.x;
+
+	// 点光源（届く範囲の外は足さないので、結果は区画の分け方によらない）
+	for (uint p = 0; p < header.y; p++, index++) {
+		ClusterPointLight light = clusterPointLights[clusterLightIndices[index]];
+		if (distance(light.lightpos, input.worldpos.xyz) <= light.range) {
+			shadecolor.rgb += PointLightColor(
+			    light.lightpos, light.lightcolor, light.lightatten, input.worldpos.xyz,
+			    input.normal, eyedir);
+		}
+	}
+
+	// スポットライト
+	for (uint s = 0; s < header.z; s++, index++) {
+		ClusterSpotLight light = clusterSpotLights[clusterLightIndices[index]];
+		if (distance(light.lightpos, input.worldpos.xyz) <= light.range) {
+			shadecolor.rgb += SpotLightColor(
+			    light.lightv, light.lightpos, light.lightcolor, light.lightatten,
+			    light.lightfactoranglecos, input.worldpos.xyz, input.normal, eyedir);
 		}
 	}
 
+	// 丸影
+	for (uint c = 0; c < header.w; c++, index++) {
+		ClusterCircleShadow shadow = clusterCircleShadows[clusterLightIndices[index]];
+		if (dot(shadow.casterPos - input.worldpos.xyz, shadow.dir) <= shadow.range) {
+			// 全て減算する
+			shadecolor.rgb -= CircleShadowAtten(
+			    shadow.dir, shadow.casterPos, shadow.distanceCasterLight, shadow.atten,
+			    shadow.factorAngleCos, input.worldpos.xyz);
+		}
+	}
+#else
 	// 点光源
 	for (i = 0; i < POINTLIGHT_NUM; i++) {
 		if (pointLights[i].active) {
-			// ライトへの方向ベクトル
-			float3 lightv = pointLights[i].lightpos - input.worldpos.xyz;
-			float d = length(lightv);
-			lightv = normalize(lightv);
-
-			// 距離減衰係数
-			float atten = 1.0f / (pointLights[i].lightatten.x + pointLights[i].lightatten.y * d +
-			                      pointLights[i].lightatten.z * d * d);
-
-			// ライトに向かうベクトルと法線の内積
-			float3 dotlightnormal = dot(lightv, input.normal);
-			// 反射光ベクトル
-			float3 reflect = normalize(-lightv + 2 * dotlightnormal * input.normal);
-			// 拡散反射光
-			float3 diffuse = dotlightnormal * m_diffuse;
-			// 鏡面反射光
-			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
-
 			// 全て加算する
-			shadecolor.rgb += atten * (diffuse + specular) * pointLights[i].lightcolor;
+			shadecolor.rgb += PointLightColor(
+			    pointLights[i].lightpos, pointLights[i].lightcolor, pointLights[i].lightatten,
+			    input.worldpos.xyz, input.normal, eyedir);
 		}
 	}
 
 	// スポットライト
 	for (i = 0; i < SPOTLIGHT_NUM; i++) {
 		if (spotLights[i].active) {
-			// ライトへの方向ベクトル
-			float3 lightv = spotLights[i].lightpos - input.worldpos.xyz;
-			float d = length(lightv);
-			lightv = normalize(lightv);
-
-			// 距離減衰係数
-			float atten = saturate(
-			    1.0f / (spotLights[i].lightatten.x + spotLights[i].lightatten.y * d +
-			            spotLights[i].lightatten.z * d * d));
-
-			// 角度減衰
-			float cos = dot(lightv, spotLights[i].lightv);
-			// 減衰開始角度から、減衰終了角度にかけて減衰
-			// 減衰開始角度の内側は1倍 減衰終了角度の外側は0倍の輝度
-			float angleatten = smoothstep(
-			    spotLights[i].lightfactoranglecos.y, spotLights[i].lightfactoranglecos.x, cos);
-			// 角度減衰を乗算
-			atten *= angleatten;
-
-			// ライトに向かうベクトルと法線の内積
-			float3 dotlightnormal = dot(lightv, input.normal);
-			// 反射光ベクトル
-			float3 reflect = normalize(-lightv + 2 * dotlightnormal * input.normal);
-			// 拡散反射光
-			float3 diffuse = dotlightnormal * m_diffuse;
-			// 鏡面反射光
-			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
-
 			// 全て加算する
-			shadecolor.rgb += atten * (diffuse + specular) * spotLights[i].lightcolor;
+			shadecolor.rgb += SpotLightColor(
+			    spotLights[i].lightv, spotLights[i].lightpos, spotLights[i].lightcolor,
+			    spotLights[i].lightatten, spotLights[i].lightfactoranglecos, input.worldpos.xyz,
+			    input.normal, eyedir);
 		}
 	}
 
 	// 丸影
 	for (i = 0; i < CIRCLESHADOW_NUM; i++) {
 		if (circleShadows[i].active) {
-			// オブジェクト表面からキャスターへのベクトル
-			float3 casterv = circleShadows[i].casterPos - input.worldpos.xyz;
-			// 光線方向での距離
-			float d = dot(casterv, circleShadows[i].dir);
-
-			// 距離減衰係数
-			float atten = saturate(
-			    1.0f / (circleShadows[i].atten.x + circleShadows[i].atten.y * d +
-			            circleShadows[i].atten.z * d * d));
-			// 距離がマイナスなら0にする
-			atten *= step(0, d);
-
-			// ライトの座標
-			float3 lightpos = circleShadows[i].casterPos +
-			                  circleShadows[i].dir * circleShadows[i].distanceCasterLight;
-			//  オブジェクト表面からライトへのベクトル（単位ベクトル）
-			float3 lightv = normalize(lightpos - input.worldpos.xyz);
-			// 角度減衰
-			float cos = dot(lightv, circleShadows[i].dir);
-			// 減衰開始角度から、減衰終了角度にかけて減衰
-			// 減衰開始角度の内側は1倍 減衰終了角度の外側は0倍の輝度
-			float angleatten = smoothstep(
-			    circleShadows[i].factorAngleCos.y, circleShadows[i].factorAngleCos.x, cos);
-			// 角度減衰を乗算
-			atten *= angleatten;
-
 			// 全て減算する
-			shadecolor.rgb -= atten;
+			shadecolor.rgb -= CircleShadowAtten(
+			    circleShadows[i].dir, circleShadows[i].casterPos,
+			    circleShadows[i].distanceCasterLight, circleShadows[i].atten,
+			    circleShadows[i].factorAngleCos, input.worldpos.xyz);
 		}
 	}
+#endif
 
 	// シェーディングによる色で描画
 	return shadecolor * texcolor;
@@ -0,0 +1,39 @@
+#include "Obj.hlsli"
+
+cbuffer Dequantize : register(b4) {
+	float3 positionCenter; // AABB中心
+	float3 positionExtent; // AABBの半分の大きさ
+	float2 uvMin;          // UV最小値
+	float2 uvExtent;       // UV範囲の大きさ
+};
+
+// 八面体符号化した法線を戻す
+float3 DecodeOctahedral(float2 e) {
+	float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	if (n.z < 0) {
+		n.xy = (1.0f - abs(n.yx)) * float2(n.x >= 0 ? 1.0f : -1.0f, n.y >= 0 ? 1.0f : -1.0f);
+	}
+	return normalize(n);
+}
+
+VSOutput main(
+    float4 packedPos : POSITION, float2 packedNormal : NORMAL, float2 packedUv : TEXCOORD) {
+	// 量子化された頂点を復元
+	float4 pos = float4(positionCenter + positionExtent * packedPos.xyz, 1);
+	float3 normal = DecodeOctahedral(packedNormal);
+	float2 uv = uvMin + uvExtent * packedUv;
+
+	// 法線にワールド行列によるスケーリング・回転を適用
+	// ※スケーリングが一様な場合のみ正しい
+	float4 worldNormal = normalize(mul(float4(normal, 0), world));
+	float4 worldPos = mul(pos, world);
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(pos, mul(world, mul(view, projection)));
+
+	output.worldpos = worldPos;
+	output.normal = worldNormal.xyz;
+	output.uv = uv;
+
+	return output;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "SpriteBatch.hlsli"
+
+// 座標はCPUでクリップ座標まで変換済み
+VSOutput main(float2 pos : POSITION, float2 uv : TEXCOORD, float4 color : COLOR) {
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = float4(pos, 0.0f, 1.0f);
+	output.uv = uv;
+	output.color = color;
+	return output;
+}
\ No newline at end of file
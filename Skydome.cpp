@@ -2,7 +2,7 @@
 #include "MathUtilityForText.h"
 #include <cassert>
 
-void Skydome::Initialize(Model* model) {
+void Skydome::Initialize(StaticModel* model) {
 	// NULLポインタチェック
 	assert(model);
 
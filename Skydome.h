@@ -1,6 +1,6 @@
 ﻿#pragma once
 
-#include "Model.h"
+#include "StaticModel.h"
 #include "ViewProjection.h"
 #include "WorldTransform.h"
 
@@ -12,7 +12,7 @@ public:
 	/// <summary>
 	/// 初期化
 	/// </summary>
-	void Initialize(Model* model);
+	void Initialize(StaticModel* model);
 
 	/// <summary>
 	/// 更新
@@ -29,5 +29,5 @@ private:
 	// ワールド変換データ
 	WorldTransform worldTransform_;
 	// モデル
-	Model* model_ = nullptr;
+	StaticModel* model_ = nullptr;
 };
@@ -0,0 +1,31 @@
+#include "AudioEngine.h"
+#include <cassert>
+
+#pragma comment(lib, "xaudio2.lib")
+
+AudioEngine* AudioEngine::GetInstance() {
+	static AudioEngine instance;
+	return &instance;
+}
+
+void AudioEngine::Initialize() {
+	HRESULT result = XAudio2Create(&xAudio2_, 0, XAUDIO2_DEFAULT_PROCESSOR);
+	assert(SUCCEEDED(result));
+	result = xAudio2_->CreateMasteringVoice(&masterVoice_);
+	assert(SUCCEEDED(result));
+
+	output_.Initialize(xAudio2_.Get(), kSampleRate, SoftwareMixer::kBlockFrameCount);
+	mixer_.Initialize(&output_);
+	mixer_.StartThread();
+}
+
+void AudioEngine::Finalize() {
+	// 出力を先に閉じると、空きを待っているミキサーのスレッドも起きて止まる
+	output_.Finalize();
+	mixer_.Finalize();
+	if (masterVoice_) {
+		masterVoice_->DestroyVoice();
+		masterVoice_ = nullptr;
+	}
+	xAudio2_.Reset();
+}
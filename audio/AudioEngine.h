@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SoftwareMixer.h"
+#include "XAudio2AudioOutput.h"
+#include <wrl.h>
+#include <xaudio2.h>
+
+/// <summary>
+/// ミキサー方式のオーディオ（効果音は SoftwareMixer で1本にミックスして XAudio2 へ送り、
+/// BGM は StreamingVoice に渡す XAudio2 を持つ）
+/// </summary>
+class AudioEngine {
+public: // 定数
+	// 出力のサンプリングレート
+	static const uint32_t kSampleRate = 48000;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static AudioEngine* GetInstance();
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（ミキサーのスレッドも動かす）
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// 終了処理（StreamingVoice は先に終了しておく）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// XAudio2のインスタンスの取得（StreamingVoice 用）
+	/// </summary>
+	/// <returns>XAudio2のインスタンス</returns>
+	IXAudio2* GetXAudio2() const { return xAudio2_.Get(); }
+
+	/// <summary>
+	/// 効果音ミキサーの取得
+	/// </summary>
+	/// <returns>ミキサー</returns>
+	SoftwareMixer* GetMixer() { return &mixer_; }
+
+private: // メンバ関数
+	AudioEngine() = default;
+	~AudioEngine() = default;
+	AudioEngine(const AudioEngine&) = delete;
+	AudioEngine& operator=(const AudioEngine&) = delete;
+
+private: // メンバ変数
+	// XAudio2のインスタンス
+	Microsoft::WRL::ComPtr<IXAudio2> xAudio2_;
+	// マスターボイス
+	IXAudio2MasteringVoice* masterVoice_ = nullptr;
+	// ミックス結果の出力先
+	XAudio2AudioOutput output_;
+	// 効果音ミキサー
+	SoftwareMixer mixer_;
+};
@@ -0,0 +1,70 @@
+#include "AudioOutput.h"
+#include "WaveFile.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 32bit浮動小数WAVのヘッダ（RIFF・fmt・data）
+struct FloatWaveHeader {
+	char riff[4] = {'R', 'I', 'F', 'F'};
+	uint32_t riffSize = 0;
+	char wave[4] = {'W', 'A', 'V', 'E'};
+	char fmt[4] = {'f', 'm', 't', ' '};
+	uint32_t fmtSize = 16;
+	uint16_t formatTag = WaveFile::kFormatIeeeFloat;
+	uint16_t channels = AudioOutput::kChannelCount;
+	uint32_t samplesPerSec = 0;
+	uint32_t avgBytesPerSec = 0;
+	uint16_t blockAlign = sizeof(float) * AudioOutput::kChannelCount;
+	uint16_t bitsPerSample = 32;
+	char data[4] = {'d', 'a', 't', 'a'};
+	uint32_t dataSize = 0;
+};
+
+} // namespace
+
+void NullAudioOutput::Submit(const float* samples, uint32_t frameCount) {
+	for (uint32_t i = 0; i < frameCount * kChannelCount; i++) {
+		peak_ = std::max(peak_, std::abs(samples[i]));
+	}
+	frameCount_ += frameCount;
+}
+
+WaveFileAudioOutput::~WaveFileAudioOutput() { Close(); }
+
+bool WaveFileAudioOutput::Open(const std::string& filePath) {
+	Close();
+	file_.open(filePath, std::ios_base::binary | std::ios_base::trunc);
+	if (!file_.is_open()) {
+		return false;
+	}
+	// サイズは仮の値で書いておく
+	FloatWaveHeader header;
+	file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	dataBytes_ = 0;
+	return true;
+}
+
+void WaveFileAudioOutput::Close() {
+	if (!file_.is_open()) {
+		return;
+	}
+	FloatWaveHeader header;
+	header.riffSize = static_cast<uint32_t>(sizeof(header) - 8 + dataBytes_);
+	header.samplesPerSec = sampleRate_;
+	header.avgBytesPerSec = sampleRate_ * header.blockAlign;
+	header.dataSize = dataBytes_;
+	file_.seekp(0);
+	file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file_.close();
+}
+
+void WaveFileAudioOutput::Submit(const float* samples, uint32_t frameCount) {
+	if (!file_.is_open()) {
+		return;
+	}
+	uint32_t bytes = static_cast<uint32_t>(sizeof(float) * kChannelCount * frameCount);
+	file_.write(reinterpret_cast<const char*>(samples), bytes);
+	dataBytes_ += bytes;
+}
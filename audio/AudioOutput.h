@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/// <summary>
+/// ミキサーの出力先（32bit浮動小数・ステレオのインターリーブ）
+/// </summary>
+class AudioOutput {
+public: // 定数
+	// チャンネル数
+	static constexpr uint32_t kChannelCount = 2;
+
+public: // メンバ関数
+	virtual ~AudioOutput() = default;
+
+	/// <summary>
+	/// サンプリングレート
+	/// </summary>
+	virtual uint32_t GetSampleRate() const = 0;
+
+	/// <summary>
+	/// ミックス結果を渡す（実デバイスは空きが出るまで待つので、ミキサーの進み方を決める）
+	/// </summary>
+	/// <param name="samples">サンプル（frameCount * kChannelCount 個）</param>
+	/// <param name="frameCount">フレーム数</param>
+	virtual void Submit(const float* samples, uint32_t frameCount) = 0;
+};
+
+/// <summary>
+/// 何も鳴らさない出力（テスト・ベンチマーク用。受け取ったフレーム数だけ数える）
+/// </summary>
+class NullAudioOutput : public AudioOutput {
+public: // メンバ関数
+	explicit NullAudioOutput(uint32_t sampleRate) : sampleRate_(sampleRate) {}
+
+	uint32_t GetSampleRate() const override { return sampleRate_; }
+	void Submit(const float* samples, uint32_t frameCount) override;
+
+	/// <summary>
+	/// 受け取ったフレーム数
+	/// </summary>
+	uint64_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 受け取ったサンプルの絶対値の最大（無音でないかの確認用）
+	/// </summary>
+	float GetPeak() const { return peak_; }
+
+private: // メンバ変数
+	// サンプリングレート
+	uint32_t sampleRate_;
+	// 受け取ったフレーム数
+	uint64_t frameCount_ = 0;
+	// 絶対値の最大
+	float peak_ = 0.0f;
+};
+
+/// <summary>
+/// WAVファイルへの出力（32bit浮動小数。オーディオデバイスの無い環境での確認用）
+/// </summary>
+class WaveFileAudioOutput : public AudioOutput {
+public: // メンバ関数
+	explicit WaveFileAudioOutput(uint32_t sampleRate) : sampleRate_(sampleRate) {}
+	~WaveFileAudioOutput() override;
+
+	/// <summary>
+	/// ファイルを作る（ヘッダのサイズは Close で書き直す）
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>作れたらtrue</returns>
+	bool Open(const std::string& filePath);
+
+	/// <summary>
+	/// ヘッダを確定してファイルを閉じる
+	/// </summary>
+	void Close();
+
+	uint32_t GetSampleRate() const override { return sampleRate_; }
+	void Submit(const float* samples, uint32_t frameCount) override;
+
+private: // メンバ変数
+	// サンプリングレート
+	uint32_t sampleRate_;
+	// ファイル
+	std::ofstream file_;
+	// 書いたバイト数
+	uint32_t dataBytes_ = 0;
+};
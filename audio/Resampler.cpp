@@ -0,0 +1,159 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <immintrin.h>
+#include <numbers>
+#include <numeric>
+
+namespace {
+
+// 通過域の幅（変換後のナイキスト周波数に対する割合。残りを遷移域にする）
+const double kPassband = 0.9;
+// カイザー窓のβ（阻止域の減衰はおよそ80dB）
+const double kKaiserBeta = 8.0;
+
+// 第1種変形ベッセル関数 I0（級数展開）
+double BesselI0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// 4の倍数個の積和（4レーンで足してから (0+2)+(1+3) の順にまとめる。SIMDと同じ順番）
+float Dot(const float* samples, const float* coefficients, uint32_t count, bool useSimd) {
+	if (useSimd) {
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t i = 0; i < count; i += 4) {
+			__m128 product = _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(coefficients + i));
+			sum = _mm_add_ps(sum, product);
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(sum);
+	}
+	float lane[4] = {};
+	for (uint32_t i = 0; i < count; i += 4) {
+		for (uint32_t j = 0; j < 4; j++) {
+			lane[j] += samples[i + j] * coefficients[i + j];
+		}
+	}
+	return (lane[0] + lane[2]) + (lane[1] + lane[3]);
+}
+
+} // namespace
+
+std::vector<float> Resampler::ConvertLinear(
+    const std::vector<float>& samples, uint32_t channelCount, uint32_t srcRate,
+    uint32_t dstRate) {
+	uint64_t srcFrameCount = samples.size() / channelCount;
+	uint64_t dstFrameCount = srcFrameCount * dstRate / srcRate;
+	std::vector<float> result(dstFrameCount * channelCount);
+	double step = double(srcRate) / double(dstRate);
+	for (uint64_t i = 0; i < dstFrameCount; i++) {
+		double position = double(i) * step;
+		uint64_t index = uint64_t(position);
+		uint64_t next = std::min(index + 1, srcFrameCount - 1);
+		float t = float(position - double(index));
+		for (uint32_t c = 0; c < channelCount; c++) {
+			float a = samples[index * channelCount + c];
+			float b = samples[next * channelCount + c];
+			result[i * channelCount + c] = a + (b - a) * t;
+		}
+	}
+	return result;
+}
+
+void Resampler::Initialize(uint32_t srcRate, uint32_t dstRate, uint32_t tapCount) {
+	assert(srcRate > 0 && dstRate > 0);
+	assert(tapCount > 0);
+
+	// 比を約分する（44100→48000 なら 160位相で147サンプルずつ進む）
+	uint32_t divisor = std::gcd(srcRate, dstRate);
+	phaseCount_ = dstRate / divisor;
+	step_ = srcRate / divisor;
+	// 約分しきれない比は表を間引いて、使うときに隣の位相と補間する
+	tablePhaseCount_ = std::min(phaseCount_, kMaxPhaseCount);
+	uint32_t interpolate = tablePhaseCount_ < phaseCount_ ? 1 : 0;
+
+	// ダウンサンプリングは変換後のナイキスト周波数で切るので、その分タップを増やす
+	double bandwidth = std::min(1.0, double(phaseCount_) / double(step_));
+	tapCount_ = uint32_t(std::ceil(double(tapCount) / bandwidth));
+	tapCount_ = (tapCount_ + 3) & ~3u;
+	double cutoff = bandwidth * kPassband;
+	double half = double(tapCount_ / 2);
+
+	// 位相 p のタップ k は、出力位置から見て k - (half - 1) - p / tablePhaseCount_ の入力に掛ける
+	coefficients_.resize(size_t(tablePhaseCount_ + interpolate) * tapCount_);
+	double windowScale = 1.0 / BesselI0(kKaiserBeta);
+	std::vector<double> weights(tapCount_);
+	for (uint32_t p = 0; p < tablePhaseCount_ + interpolate; p++) {
+		float* phase = &coefficients_[size_t(p) * tapCount_];
+		double sum = 0.0;
+		for (uint32_t k = 0; k < tapCount_; k++) {
+			double t = double(k) - (half - 1.0) - double(p) / double(tablePhaseCount_);
+			double x = t / half;
+			double window = 0.0;
+			if (std::abs(x) < 1.0) {
+				window = BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) * windowScale;
+			}
+			double arg = std::numbers::pi * cutoff * t;
+			double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+			weights[k] = cutoff * sinc * window;
+			sum += weights[k];
+		}
+		// 直流の利得を1にそろえる
+		for (uint32_t k = 0; k < tapCount_; k++) {
+			phase[k] = float(weights[k] / sum);
+		}
+	}
+}
+
+std::vector<float> Resampler::Convert(
+    const std::vector<float>& samples, uint32_t channelCount, bool useSimd) const {
+	assert(tapCount_ > 0);
+	uint64_t srcFrameCount = samples.size() / channelCount;
+	uint64_t dstFrameCount = srcFrameCount * phaseCount_ / step_;
+	std::vector<float> result(dstFrameCount * channelCount);
+
+	// チャンネル毎に前後を0で埋めた連続の配列にして、タップ分をそのまま読めるようにする
+	uint32_t offset = tapCount_ / 2 - 1;
+	std::vector<float> padded(srcFrameCount + tapCount_, 0.0f);
+	std::vector<float> blended(tapCount_);
+	for (uint32_t c = 0; c < channelCount; c++) {
+		for (uint64_t i = 0; i < srcFrameCount; i++) {
+			padded[offset + i] = samples[i * channelCount + c];
+		}
+		uint64_t base = 0;
+		uint32_t phase = 0;
+		for (uint64_t i = 0; i < dstFrameCount; i++) {
+			const float* coefficients = nullptr;
+			if (tablePhaseCount_ == phaseCount_) {
+				coefficients = &coefficients_[size_t(phase) * tapCount_];
+			} else {
+				// 表の位相の間にあるので、前後の位相の係数を混ぜる
+				double position = double(phase) * tablePhaseCount_ / phaseCount_;
+				uint32_t index = uint32_t(position);
+				float t = float(position - index);
+				const float* c0 = &coefficients_[size_t(index) * tapCount_];
+				const float* c1 = c0 + tapCount_;
+				for (uint32_t k = 0; k < tapCount_; k++) {
+					blended[k] = c0[k] + (c1[k] - c0[k]) * t;
+				}
+				coefficients = blended.data();
+			}
+			result[i * channelCount + c] = Dot(&padded[base], coefficients, tapCount_, useSimd);
+			base += step_ / phaseCount_;
+			phase += step_ % phaseCount_;
+			if (phase >= phaseCount_) {
+				phase -= phaseCount_;
+				base++;
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// サンプリングレート変換（カイザー窓付きsincのポリフェーズフィルタ）
+/// </summary>
+class Resampler {
+public: // 定数
+	// 既定のタップ数（アップサンプリング時。ダウンサンプリングでは帯域に合わせて増やす）
+	static const uint32_t kDefaultTapCount = 32;
+	// 係数表の位相数の上限（変換比の分母がこれを超えるときは表の間を補間する）
+	static constexpr uint32_t kMaxPhaseCount = 4096;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 線形補間による変換（速いが折り返し雑音が残る。比較用）
+	/// </summary>
+	/// <param name="samples">チャンネルを交互に並べたサンプル</param>
+	/// <param name="channelCount">チャンネル数</param>
+	/// <param name="srcRate">変換元のサンプリングレート</param>
+	/// <param name="dstRate">変換先のサンプリングレート</param>
+	/// <returns>変換後のサンプル</returns>
+	static std::vector<float> ConvertLinear(
+	    const std::vector<float>& samples, uint32_t channelCount, uint32_t srcRate,
+	    uint32_t dstRate);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（位相ごとのフィルタ係数を作る）
+	/// </summary>
+	/// <param name="srcRate">変換元のサンプリングレート</param>
+	/// <param name="dstRate">変換先のサンプリングレート</param>
+	/// <param name="tapCount">タップ数（4の倍数に切り上げる）</param>
+	void Initialize(uint32_t srcRate, uint32_t dstRate, uint32_t tapCount = kDefaultTapCount);
+
+	/// <summary>
+	/// 変換
+	/// </summary>
+	/// <param name="samples">チャンネルを交互に並べたサンプル</param>
+	/// <param name="channelCount">チャンネル数</param>
+	/// <param name="useSimd">SIMDを使うか（結果は同じ）</param>
+	/// <returns>変換後のサンプル</returns>
+	std::vector<float> Convert(
+	    const std::vector<float>& samples, uint32_t channelCount, bool useSimd = true) const;
+
+	uint32_t GetTapCount() const { return tapCount_; }
+	uint32_t GetPhaseCount() const { return tablePhaseCount_; }
+
+private: // メンバ変数
+	// 出力1サンプルごとに進む入力の量（phaseCount_ 分の1単位）
+	uint32_t step_ = 1;
+	// 位相数（出力 phaseCount_ サンプルで入力 step_ サンプル進む）
+	uint32_t phaseCount_ = 1;
+	// 係数表の位相数（phaseCount_ より少なければ隣の位相と補間する）
+	uint32_t tablePhaseCount_ = 1;
+	// タップ数
+	uint32_t tapCount_ = 0;
+	// フィルタ係数（位相ごとに tapCount_ 個。補間するときは末尾に1位相多く持つ）
+	std::vector<float> coefficients_;
+};
@@ -0,0 +1,443 @@
+#include "SoftwareMixer.h"
+#include "Resampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+#include <numbers>
+#include <utility>
+
+SoftwareMixer::~SoftwareMixer() { Finalize(); }
+
+void SoftwareMixer::Initialize(AudioOutput* output, uint32_t maxVoiceCount) {
+	assert(output);
+	assert(maxVoiceCount > 0);
+	assert(maxVoiceCount <= kMaxVoiceCount);
+	Finalize();
+	output_ = output;
+	sounds_.resize(kMaxSoundCount);
+	soundCount_ = 0;
+	slots_ = std::vector<VoiceSlot>(maxVoiceCount);
+	voices_.assign(maxVoiceCount, Voice());
+	commandQueue_.Clear();
+	mixBuffer_.assign(size_t(kBlockFrameCount) * kChannelCount, 0.0f);
+	startOrder_ = 0;
+	stats_ = Stats();
+	mixedFrameCount_ = 0;
+}
+
+void SoftwareMixer::Finalize() {
+	StopThread();
+	slots_.clear();
+	voices_.clear();
+	sounds_.clear();
+	soundCount_ = 0;
+	output_ = nullptr;
+}
+
+uint32_t SoftwareMixer::LoadWave(const std::string& filePath) {
+	WaveFile::Format format;
+	std::vector<uint8_t> data;
+	bool loaded = WaveFile::Load(filePath, format, data);
+	assert(loaded);
+	(void)loaded;
+	return AddSound(format, data);
+}
+
+uint32_t SoftwareMixer::AddSound(const WaveFile::Format& format, const std::vector<uint8_t>& data) {
+	assert(output_);
+	// 浮動小数にする（3チャンネル以上は先頭の2チャンネルだけ使う）
+	Sound sound;
+	std::vector<float> samples;
+	sound.channelCount = WaveFile::Decode(format, data, kChannelCount, samples);
+	// ミックス時に変換しないよう、読み込み時に出力のサンプリングレートに揃える
+	uint32_t sampleRate = output_->GetSampleRate();
+	if (format.samplesPerSec != sampleRate && !samples.empty()) {
+		Resampler resampler;
+		resampler.Initialize(format.samplesPerSec, sampleRate);
+		samples = resampler.Convert(samples, sound.channelCount, useSimd_);
+	}
+	sound.frameCount = static_cast<uint32_t>(samples.size() / sound.channelCount);
+	sound.samples = std::move(samples);
+
+	// 確保済みの枠に入れる（ミックス側は再生コマンドが届いてから読むので排他は要らない）
+	assert(soundCount_ < kMaxSoundCount);
+	sounds_[soundCount_] = std::move(sound);
+	return soundCount_++;
+}
+
+uint32_t SoftwareMixer::PlayWave(
+    uint32_t soundDataHandle, bool loopFlag, float volume, float pan, uint32_t priority) {
+	assert(soundDataHandle < soundCount_);
+	stats_.playCount++;
+	Sound& sound = sounds_[soundDataHandle];
+	if (sound.frameCount == 0) {
+		return 0;
+	}
+
+	// 前回の再生から間が無ければ鳴らさない（時刻はミックスしたフレーム数で測る）
+	uint64_t now = mixedFrameCount_.load(std::memory_order_relaxed);
+	if (sound.hasPlayed && now - sound.lastPlayFrame < sound.minRetriggerFrameCount) {
+		stats_.throttleCount++;
+		return 0;
+	}
+	if (!commandQueue_.CanPush()) {
+		stats_.droppedCommandCount++;
+		stats_.rejectCount++;
+		return 0;
+	}
+
+	// 空きの枠・止める候補（優先度が最も低く最も古いボイス）・同じサウンドの最も古いボイスを探す
+	// 同じサウンドを数える必要が無ければ、空きが見つかった所で打ち切る
+	const uint32_t kNone = UINT32_MAX;
+	uint32_t freeIndex = kNone;
+	uint32_t stealIndex = kNone;
+	uint32_t oldestInstance = kNone;
+	uint32_t instanceCount = 0;
+	for (uint32_t i = 0; i < slots_.size(); i++) {
+		const VoiceSlot& candidate = slots_[i];
+		if (candidate.handle.load(std::memory_order_acquire) == 0) {
+			if (freeIndex == kNone) {
+				freeIndex = i;
+			}
+			if (sound.maxInstanceCount == 0) {
+				break;
+			}
+			continue;
+		}
+		if (candidate.sound == soundDataHandle) {
+			instanceCount++;
+			if (oldestInstance == kNone ||
+			    candidate.startOrder < slots_[oldestInstance].startOrder) {
+				oldestInstance = i;
+			}
+		}
+		if (stealIndex == kNone || candidate.priority < slots_[stealIndex].priority ||
+		    (candidate.priority == slots_[stealIndex].priority &&
+		     candidate.startOrder < slots_[stealIndex].startOrder)) {
+			stealIndex = i;
+		}
+	}
+
+	uint32_t index = freeIndex;
+	if (sound.maxInstanceCount > 0 && instanceCount >= sound.maxInstanceCount) {
+		// 同時再生数に達していたら、同じサウンドの最も古いボイスを鳴らし直す
+		index = oldestInstance;
+		stats_.instanceLimitCount++;
+	} else if (freeIndex == kNone) {
+		if (slots_[stealIndex].priority > priority) {
+			stats_.rejectCount++;
+			return 0;
+		}
+		index = stealIndex;
+		stats_.stealCount++;
+	}
+	VoiceSlot& slot = slots_[index];
+	sound.hasPlayed = true;
+	sound.lastPlayFrame = now;
+
+	// 世代を進めて、止めたボイスの古いハンドルを無効にする（世代0は使わない）
+	slot.generation = (slot.generation + 1) & ((1u << (32 - kVoiceIndexBits)) - 1);
+	if (slot.generation == 0) {
+		slot.generation = 1;
+	}
+	uint32_t handle = slot.generation << kVoiceIndexBits | index;
+	slot.sound = soundDataHandle;
+	slot.priority = priority;
+	slot.startOrder = startOrder_++;
+	slot.handle.store(handle, std::memory_order_release);
+
+	Command command;
+	command.type = Command::Type::kPlay;
+	command.handle = handle;
+	command.sound = soundDataHandle;
+	command.volume = volume;
+	command.pan = std::clamp(pan, -1.0f, 1.0f);
+	command.loop = loopFlag;
+	commandQueue_.Push(command);
+	return handle;
+}
+
+void SoftwareMixer::SetSoundLimit(
+    uint32_t soundDataHandle, uint32_t maxInstanceCount, float minRetriggerInterval) {
+	assert(soundDataHandle < soundCount_);
+	Sound& sound = sounds_[soundDataHandle];
+	sound.maxInstanceCount = maxInstanceCount;
+	sound.minRetriggerFrameCount =
+	    uint64_t(std::max(0.0f, minRetriggerInterval) * float(output_->GetSampleRate()));
+}
+
+void SoftwareMixer::StopWave(uint32_t voiceHandle) {
+	VoiceSlot* slot = FindSlot(voiceHandle);
+	if (!slot) {
+		return;
+	}
+	// 停止を伝えられないのに枠だけ空けると、ミックス側は鳴らし続けたまま枠が上書きされる
+	// （積むのはこのスレッドだけなので、ここで空きがあれば下の Push は失敗しない）
+	if (!commandQueue_.CanPush()) {
+		stats_.droppedCommandCount++;
+		return;
+	}
+	// ミックス側が先に再生を終えていたら何もしない
+	uint32_t expected = voiceHandle;
+	if (slot->handle.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+		Command command;
+		command.type = Command::Type::kStop;
+		command.handle = voiceHandle;
+		PushCommand(command);
+	}
+}
+
+bool SoftwareMixer::IsPlaying(uint32_t voiceHandle) const {
+	return FindSlot(voiceHandle) != nullptr;
+}
+
+void SoftwareMixer::SetVolume(uint32_t voiceHandle, float volume) {
+	if (FindSlot(voiceHandle)) {
+		Command command;
+		command.type = Command::Type::kSetVolume;
+		command.handle = voiceHandle;
+		command.volume = volume;
+		PushCommand(command);
+	}
+}
+
+void SoftwareMixer::SetPan(uint32_t voiceHandle, float pan) {
+	if (FindSlot(voiceHandle)) {
+		Command command;
+		command.type = Command::Type::kSetPan;
+		command.handle = voiceHandle;
+		command.pan = std::clamp(pan, -1.0f, 1.0f);
+		PushCommand(command);
+	}
+}
+
+void SoftwareMixer::Render(uint32_t frameCount) {
+	assert(output_);
+	while (frameCount > 0) {
+		uint32_t blockFrameCount = std::min(frameCount, kBlockFrameCount);
+		ProcessCommands();
+		MixBlock(blockFrameCount);
+		output_->Submit(mixBuffer_.data(), blockFrameCount);
+		frameCount -= blockFrameCount;
+	}
+}
+
+void SoftwareMixer::StartThread() {
+	assert(output_);
+	StopThread();
+	running_ = true;
+	thread_ = std::thread([this] {
+		while (running_) {
+			Render(kBlockFrameCount);
+		}
+	});
+}
+
+void SoftwareMixer::StopThread() {
+	running_ = false;
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+SoftwareMixer::Stats SoftwareMixer::GetStats() const {
+	Stats stats = stats_;
+	stats.activeVoiceCount = static_cast<uint32_t>(
+	    std::count_if(slots_.begin(), slots_.end(), [](const VoiceSlot& slot) {
+		    return slot.handle.load(std::memory_order_relaxed) != 0;
+	    }));
+	stats.mixedFrameCount = mixedFrameCount_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void SoftwareMixer::MixMono(
+    const float* src, float* dst, uint32_t frameCount, float gainL, float gainR, bool useSimd) {
+	uint32_t i = 0;
+	if (useSimd) {
+		// 4サンプルを LLRR に広げて、左右のゲインを交互に掛ける
+		__m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+		for (; i + 4 <= frameCount; i += 4) {
+			__m128 sample = _mm_loadu_ps(src + i);
+			__m128 lo = _mm_unpacklo_ps(sample, sample);
+			__m128 hi = _mm_unpackhi_ps(sample, sample);
+			float* out = dst + i * kChannelCount;
+			_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(lo, gain)));
+			_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(hi, gain)));
+		}
+	}
+	for (; i < frameCount; i++) {
+		dst[i * kChannelCount + 0] += src[i] * gainL;
+		dst[i * kChannelCount + 1] += src[i] * gainR;
+	}
+}
+
+void SoftwareMixer::MixStereo(
+    const float* src, float* dst, uint32_t frameCount, float gainL, float gainR, bool useSimd) {
+	uint32_t i = 0;
+	if (useSimd) {
+		__m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+		for (; i + 4 <= frameCount; i += 4) {
+			const float* in = src + i * kChannelCount;
+			float* out = dst + i * kChannelCount;
+			__m128 sample0 = _mm_loadu_ps(in);
+			__m128 sample1 = _mm_loadu_ps(in + 4);
+			_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(sample0, gain)));
+			_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(sample1, gain)));
+		}
+	}
+	for (; i < frameCount; i++) {
+		dst[i * kChannelCount + 0] += src[i * kChannelCount + 0] * gainL;
+		dst[i * kChannelCount + 1] += src[i * kChannelCount + 1] * gainR;
+	}
+}
+
+void SoftwareMixer::Clip(float* samples, uint32_t sampleCount, bool useSimd) {
+	uint32_t i = 0;
+	if (useSimd) {
+		__m128 lower = _mm_set1_ps(-1.0f);
+		__m128 upper = _mm_set1_ps(1.0f);
+		for (; i + 4 <= sampleCount; i += 4) {
+			__m128 sample = _mm_loadu_ps(samples + i);
+			_mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(sample, lower), upper));
+		}
+	}
+	for (; i < sampleCount; i++) {
+		samples[i] = std::min(std::max(samples[i], -1.0f), 1.0f);
+	}
+}
+
+void SoftwareMixer::ProcessCommands() {
+	Command command;
+	while (commandQueue_.Pop(command)) {
+		Voice& voice = voices_[command.handle & (kMaxVoiceCount - 1)];
+		if (command.type == Command::Type::kPlay) {
+			// 同じ枠の前のボイスは上書きして止める
+			voice.handle = command.handle;
+			voice.sound = command.sound;
+			voice.position = 0;
+			voice.volume = command.volume;
+			voice.pan = command.pan;
+			voice.loop = command.loop;
+			continue;
+		}
+		// 既に終わったボイスへの操作は捨てる
+		if (voice.handle != command.handle) {
+			continue;
+		}
+		switch (command.type) {
+		case Command::Type::kStop:
+			voice.handle = 0;
+			break;
+		case Command::Type::kSetVolume:
+			voice.volume = command.volume;
+			break;
+		case Command::Type::kSetPan:
+			voice.pan = command.pan;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void SoftwareMixer::MixBlock(uint32_t frameCount) {
+	std::fill(mixBuffer_.begin(), mixBuffer_.end(), 0.0f);
+	for (uint32_t index = 0; index < voices_.size(); index++) {
+		Voice& voice = voices_[index];
+		if (voice.handle == 0) {
+			continue;
+		}
+		const Sound& sound = sounds_[voice.sound];
+		float gainL = 0.0f;
+		float gainR = 0.0f;
+		if (sound.channelCount == 1) {
+			// モノラルは等パワーで定位させる
+			float angle = (voice.pan + 1.0f) * std::numbers::pi_v<float> * 0.25f;
+			gainL = std::cos(angle) * voice.volume;
+			gainR = std::sin(angle) * voice.volume;
+		} else {
+			// ステレオは反対側を絞るバランス
+			gainL = std::min(1.0f, 1.0f - voice.pan) * voice.volume;
+			gainR = std::min(1.0f, 1.0f + voice.pan) * voice.volume;
+		}
+
+		// 末尾に達したらループなら先頭から続け、そうでなければ空きにする
+		uint32_t mixed = 0;
+		while (mixed < frameCount && voice.handle != 0) {
+			uint32_t count = std::min(frameCount - mixed, sound.frameCount - voice.position);
+			const float* src = &sound.samples[size_t(voice.position) * sound.channelCount];
+			float* dst = &mixBuffer_[size_t(mixed) * kChannelCount];
+			if (sound.channelCount == 1) {
+				MixMono(src, dst, count, gainL, gainR, useSimd_);
+			} else {
+				MixStereo(src, dst, count, gainL, gainR, useSimd_);
+			}
+			mixed += count;
+			voice.position += count;
+			if (voice.position >= sound.frameCount) {
+				voice.position = 0;
+				if (!voice.loop) {
+					// 枠がまだこのボイスのものなら空ける（次の再生に使われていたら触らない）
+					uint32_t expected = voice.handle;
+					slots_[index].handle.compare_exchange_strong(
+					    expected, 0, std::memory_order_acq_rel);
+					voice.handle = 0;
+				}
+			}
+		}
+	}
+	Clip(mixBuffer_.data(), frameCount * kChannelCount, useSimd_);
+	mixedFrameCount_.fetch_add(frameCount, std::memory_order_relaxed);
+}
+
+SoftwareMixer::VoiceSlot* SoftwareMixer::FindSlot(uint32_t voiceHandle) {
+	return const_cast<VoiceSlot*>(std::as_const(*this).FindSlot(voiceHandle));
+}
+
+const SoftwareMixer::VoiceSlot* SoftwareMixer::FindSlot(uint32_t voiceHandle) const {
+	// 下位ビットが枠の番号。世代まで一致すれば再生中
+	uint32_t index = voiceHandle & (kMaxVoiceCount - 1);
+	if (voiceHandle == 0 || index >= slots_.size()) {
+		return nullptr;
+	}
+	const VoiceSlot& slot = slots_[index];
+	return slot.handle.load(std::memory_order_acquire) == voiceHandle ? &slot : nullptr;
+}
+
+void SoftwareMixer::PushCommand(const Command& command) {
+	if (!commandQueue_.Push(command)) {
+		stats_.droppedCommandCount++;
+	}
+}
+
+bool SoftwareMixer::CommandQueue::Push(const Command& command) {
+	uint32_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) == kCommandQueueSize) {
+		return false;
+	}
+	commands_[tail & (kCommandQueueSize - 1)] = command;
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool SoftwareMixer::CommandQueue::Pop(Command& command) {
+	uint32_t head = head_.load(std::memory_order_relaxed);
+	if (head == tail_.load(std::memory_order_acquire)) {
+		return false;
+	}
+	command = commands_[head & (kCommandQueueSize - 1)];
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+bool SoftwareMixer::CommandQueue::CanPush() const {
+	return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) <
+	       kCommandQueueSize;
+}
+
+void SoftwareMixer::CommandQueue::Clear() {
+	head_ = 0;
+	tail_ = 0;
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "AudioOutput.h"
+#include "WaveFile.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ソフトウェアミキサー（全ての再生を1本のステレオ出力にまとめる。OSのボイスは出力1つだけ）
+/// 再生の操作はゲームスレッド1本から、Render はミックス用スレッド1本から呼ぶ。
+/// 間はロックの無いコマンドキューでつなぐので、ミックス側が待つことは無い
+/// </summary>
+class SoftwareMixer {
+public: // 定数
+	// 1回にミックスするフレーム数
+	static constexpr uint32_t kBlockFrameCount = 256;
+	// 既定の同時再生数
+	static constexpr uint32_t kDefaultMaxVoiceCount = 64;
+	// 再生ハンドルのうちボイス番号のビット数（残りは世代）
+	static constexpr uint32_t kVoiceIndexBits = 12;
+	// 同時再生数の上限
+	static constexpr uint32_t kMaxVoiceCount = 1u << kVoiceIndexBits;
+	// サウンドデータ数の上限（ミックス中に配列を伸ばさないよう固定で確保する）
+	static constexpr uint32_t kMaxSoundCount = 256;
+	// コマンドキューの長さ（2の累乗）
+	static constexpr uint32_t kCommandQueueSize = 1024;
+	// 出力チャンネル数
+	static constexpr uint32_t kChannelCount = AudioOutput::kChannelCount;
+
+public: // サブクラス
+	// 統計
+	struct Stats {
+		// 再生中のボイス数
+		uint32_t activeVoiceCount = 0;
+		// 再生要求数
+		uint64_t playCount = 0;
+		// 優先度の低いボイスを止めて再生した数
+		uint64_t stealCount = 0;
+		// 空きが無く再生しなかった数
+		uint64_t rejectCount = 0;
+		// 同じサウンドの同時再生数に達して、古いものを鳴らし直した数
+		uint64_t instanceLimitCount = 0;
+		// 再トリガー間隔より早く、鳴らさなかった数
+		uint64_t throttleCount = 0;
+		// コマンドキューが一杯で捨てた操作の数
+		uint64_t droppedCommandCount = 0;
+		// ミックスしたフレーム数
+		uint64_t mixedFrameCount = 0;
+	};
+
+public: // メンバ関数
+	SoftwareMixer() = default;
+	~SoftwareMixer();
+	SoftwareMixer(const SoftwareMixer&) = delete;
+	SoftwareMixer& operator=(const SoftwareMixer&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="output">出力先（所有しない。サンプリングレートは出力に合わせる）</param>
+	/// <param name="maxVoiceCount">同時再生数の上限</param>
+	void Initialize(AudioOutput* output, uint32_t maxVoiceCount = kDefaultMaxVoiceCount);
+
+	/// <summary>
+	/// 終了処理
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// WAV音声読み込み（浮動小数・出力のサンプリングレートに変換して持つ）
+	/// </summary>
+	/// <param name="filePath">WAVファイルパス</param>
+	/// <returns>サウンドデータハンドル</returns>
+	uint32_t LoadWave(const std::string& filePath);
+
+	/// <summary>
+	/// サウンドデータの追加
+	/// </summary>
+	/// <param name="format">波形フォーマット</param>
+	/// <param name="data">波形データ</param>
+	/// <returns>サウンドデータハンドル</returns>
+	uint32_t AddSound(const WaveFile::Format& format, const std::vector<uint8_t>& data);
+
+	/// <summary>
+	/// 連続して鳴らすサウンドの制限（連射の効果音などで、鳴らす数と処理量を一定に抑える）
+	/// 同時再生数に達したら、そのサウンドの最も古いボイスを鳴らし直す
+	/// </summary>
+	/// <param name="soundDataHandle">サウンドデータハンドル</param>
+	/// <param name="maxInstanceCount">同時再生数（0で無制限）</param>
+	/// <param name="minRetriggerInterval">前回の再生から次に鳴らせるまでの秒数</param>
+	void SetSoundLimit(
+	    uint32_t soundDataHandle, uint32_t maxInstanceCount, float minRetriggerInterval = 0.0f);
+
+	/// <summary>
+	/// 音声再生（上限に達していたら、優先度が同じか低いボイスのうち最も古いものを止める）
+	/// SetSoundLimit の制限はこれより先に効く
+	/// </summary>
+	/// <param name="soundDataHandle">サウンドデータハンドル</param>
+	/// <param name="loopFlag">ループ再生フラグ</param>
+	/// <param name="volume">ボリューム</param>
+	/// <param name="pan">定位（-1で左、0で中央、1で右）</param>
+	/// <param name="priority">優先度（大きいほど止められにくい）</param>
+	/// <returns>再生ハンドル（再生しなかったら0）</returns>
+	uint32_t PlayWave(
+	    uint32_t soundDataHandle, bool loopFlag = false, float volume = 1.0f, float pan = 0.0f,
+	    uint32_t priority = 0);
+
+	/// <summary>
+	/// 音声停止
+	/// </summary>
+	void StopWave(uint32_t voiceHandle);
+
+	/// <summary>
+	/// 音声再生中かどうか（ハンドルの世代を比べるだけなので O(1)）
+	/// </summary>
+	bool IsPlaying(uint32_t voiceHandle) const;
+
+	/// <summary>
+	/// 音量設定
+	/// </summary>
+	void SetVolume(uint32_t voiceHandle, float volume);
+
+	/// <summary>
+	/// 定位設定
+	/// </summary>
+	void SetPan(uint32_t voiceHandle, float pan);
+
+	/// <summary>
+	/// ミックスして出力へ渡す（kBlockFrameCount 毎）
+	/// </summary>
+	/// <param name="frameCount">フレーム数</param>
+	void Render(uint32_t frameCount);
+
+	/// <summary>
+	/// ミックス用スレッドを動かす（出力が待つことで再生の速さに合う。XAudio2 出力向け）
+	/// </summary>
+	void StartThread();
+
+	/// <summary>
+	/// ミックス用スレッドを止める
+	/// </summary>
+	void StopThread();
+
+	/// <summary>
+	/// SIMDを使うか
+	/// </summary>
+	void SetUseSimd(bool useSimd) { useSimd_ = useSimd; }
+
+	/// <summary>
+	/// 統計
+	/// </summary>
+	Stats GetStats() const;
+
+private: // サブクラス
+	// サウンドデータ（1か2チャンネルの浮動小数）
+	struct Sound {
+		uint32_t channelCount = 0;
+		uint32_t frameCount = 0;
+		std::vector<float> samples;
+		// 以下はゲームスレッドだけが使う
+		// 同時再生数（0で無制限）
+		uint32_t maxInstanceCount = 0;
+		// 再トリガー間隔（フレーム数）
+		uint64_t minRetriggerFrameCount = 0;
+		// 前回鳴らした時刻（ミックスしたフレーム数）
+		uint64_t lastPlayFrame = 0;
+		bool hasPlayed = false;
+	};
+
+	// ボイスの枠（ゲームスレッド側）
+	struct VoiceSlot {
+		// 再生中のハンドル（0なら空き。ミックス側は再生を終えたときだけ0にする）
+		std::atomic<uint32_t> handle = 0;
+		// 世代（使い回すたびに進めて、古いハンドルを無効にする）
+		uint32_t generation = 0;
+		// 鳴らしているサウンド（同時再生数を数えるのに使う）
+		uint32_t sound = 0;
+		uint32_t priority = 0;
+		// 再生を始めた順番（止める候補の新旧の比較に使う）
+		uint64_t startOrder = 0;
+	};
+
+	// ボイス（ミックス側。枠と同じ番号）
+	struct Voice {
+		// 再生ハンドル（0なら止まっている）
+		uint32_t handle = 0;
+		uint32_t sound = 0;
+		// 次にミックスするフレーム
+		uint32_t position = 0;
+		float volume = 1.0f;
+		float pan = 0.0f;
+		bool loop = false;
+	};
+
+	// ゲームスレッドからミックス側への操作
+	struct Command {
+		enum class Type { kPlay, kStop, kSetVolume, kSetPan };
+		Type type = Type::kPlay;
+		uint32_t handle = 0;
+		uint32_t sound = 0;
+		float volume = 1.0f;
+		float pan = 0.0f;
+		bool loop = false;
+	};
+
+	/// <summary>
+	/// 書き込み1本・読み出し1本のロックの無いキュー
+	/// </summary>
+	class CommandQueue {
+	public:
+		// 積めたか（一杯なら false）
+		bool Push(const Command& command);
+		// 取り出せたか（空なら false）
+		bool Pop(Command& command);
+		// 積む側から見た空きがあるか
+		bool CanPush() const;
+		void Clear();
+
+	private:
+		std::array<Command, kCommandQueueSize> commands_;
+		// 次に読む位置（読む側だけが進める）
+		std::atomic<uint32_t> head_ = 0;
+		// 次に書く位置（書く側だけが進める）
+		std::atomic<uint32_t> tail_ = 0;
+	};
+
+private: // 静的メンバ関数
+	/// <summary>
+	/// モノラルを左右のゲインを掛けて加算する
+	/// </summary>
+	static void MixMono(
+	    const float* src, float* dst, uint32_t frameCount, float gainL, float gainR, bool useSimd);
+
+	/// <summary>
+	/// ステレオを左右のゲインを掛けて加算する
+	/// </summary>
+	static void MixStereo(
+	    const float* src, float* dst, uint32_t frameCount, float gainL, float gainR, bool useSimd);
+
+	/// <summary>
+	/// [-1, 1] に収める
+	/// </summary>
+	static void Clip(float* samples, uint32_t sampleCount, bool useSimd);
+
+private: // メンバ関数
+	/// <summary>
+	/// 届いた操作をボイスに反映する（ミックス側）
+	/// </summary>
+	void ProcessCommands();
+
+	/// <summary>
+	/// 1ブロックのミックス（ミックス側）
+	/// </summary>
+	void MixBlock(uint32_t frameCount);
+
+	/// <summary>
+	/// 再生中のハンドルなら枠を返す（O(1)）
+	/// </summary>
+	VoiceSlot* FindSlot(uint32_t voiceHandle);
+	const VoiceSlot* FindSlot(uint32_t voiceHandle) const;
+
+	/// <summary>
+	/// 操作を積む（一杯なら捨てて数える）
+	/// </summary>
+	void PushCommand(const Command& command);
+
+private: // メンバ変数
+	// 出力先
+	AudioOutput* output_ = nullptr;
+	// サウンドデータ（kMaxSoundCount 個を確保済み）
+	std::vector<Sound> sounds_;
+	// 読み込んだサウンドデータの数
+	uint32_t soundCount_ = 0;
+	// ボイスの枠（ゲームスレッド側）
+	std::vector<VoiceSlot> slots_;
+	// ボイス（ミックス側）
+	std::vector<Voice> voices_;
+	// ゲームスレッドからミックス側への操作
+	CommandQueue commandQueue_;
+	// ミックス先（kBlockFrameCount * kChannelCount）
+	std::vector<float> mixBuffer_;
+	// 再生を始めた順番
+	uint64_t startOrder_ = 0;
+	// SIMDを使うか
+	bool useSimd_ = true;
+	// 統計（ゲームスレッド側）
+	Stats stats_;
+	// ミックスしたフレーム数（ミックス側）
+	std::atomic<uint64_t> mixedFrameCount_ = 0;
+	// ミックス用スレッド
+	std::thread thread_;
+	// ミックス用スレッドを動かすか
+	std::atomic<bool> running_ = false;
+};
@@ -0,0 +1,176 @@
+#include "StreamingVoice.h"
+#include <algorithm>
+#include <cassert>
+
+StreamingVoice::~StreamingVoice() { Finalize(); }
+
+bool StreamingVoice::Initialize(IXAudio2* xAudio2, const std::string& filePath) {
+	assert(xAudio2);
+	Finalize();
+	if (!waveFile_.Open(filePath)) {
+		return false;
+	}
+	xAudio2_ = xAudio2;
+	loopBegin_ = waveFile_.GetLoopBegin();
+	loopEnd_ = waveFile_.GetLoopEnd();
+	buffers_.resize(size_t(kBufferCount) * kBufferFrameCount * waveFile_.GetFormat().blockAlign);
+	return true;
+}
+
+void StreamingVoice::Finalize() {
+	Stop();
+	waveFile_.Close();
+	buffers_.clear();
+	buffers_.shrink_to_fit();
+	xAudio2_ = nullptr;
+}
+
+void StreamingVoice::Play(bool loopFlag, float volume) {
+	assert(xAudio2_);
+	Stop();
+
+	// ファイルと同じ形式のソースボイス
+	const WaveFile::Format& format = waveFile_.GetFormat();
+	WAVEFORMATEX wfex = {};
+	wfex.wFormatTag = format.formatTag;
+	wfex.nChannels = format.channels;
+	wfex.nSamplesPerSec = format.samplesPerSec;
+	wfex.nAvgBytesPerSec = format.avgBytesPerSec;
+	wfex.nBlockAlign = format.blockAlign;
+	wfex.wBitsPerSample = format.bitsPerSample;
+	HRESULT result = xAudio2_->CreateSourceVoice(&sourceVoice_, &wfex, 0, 2.0f, &callback_);
+	assert(SUCCEEDED(result));
+
+	// 先に全てのバッファを埋めてから鳴らす
+	loop_ = loopFlag;
+	cursor_ = 0;
+	nextBuffer_ = 0;
+	freeBufferCount_ = 0;
+	stopRequested_ = false;
+	endOfStream_ = false;
+	for (uint32_t i = 0; i < kBufferCount; i++) {
+		if (!SubmitNextBuffer()) {
+			break;
+		}
+	}
+	sourceVoice_->SetVolume(volume);
+	result = sourceVoice_->Start();
+	assert(SUCCEEDED(result));
+
+	thread_ = std::thread(&StreamingVoice::StreamThread, this);
+}
+
+void StreamingVoice::Stop() {
+	if (thread_.joinable()) {
+		stopRequested_ = true;
+		freeBufferCount_.fetch_add(1);
+		freeBufferCount_.notify_one();
+		thread_.join();
+	}
+	// 破棄はオーディオスレッドがバッファを使い終わるまで待つので、以後バッファを書き換えてよい
+	if (sourceVoice_) {
+		sourceVoice_->DestroyVoice();
+		sourceVoice_ = nullptr;
+	}
+}
+
+void StreamingVoice::Pause() {
+	if (sourceVoice_) {
+		sourceVoice_->Stop();
+	}
+}
+
+void StreamingVoice::Resume() {
+	if (sourceVoice_) {
+		sourceVoice_->Start();
+	}
+}
+
+bool StreamingVoice::IsPlaying() const {
+	if (!sourceVoice_) {
+		return false;
+	}
+	if (!endOfStream_) {
+		return true;
+	}
+	// 末尾まで送った後は、キューが空になったら終わり
+	XAUDIO2_VOICE_STATE state = {};
+	sourceVoice_->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+	return state.BuffersQueued > 0;
+}
+
+void StreamingVoice::SetVolume(float volume) {
+	if (sourceVoice_) {
+		sourceVoice_->SetVolume(volume);
+	}
+}
+
+void StreamingVoice::SetLoopPoints(uint64_t loopBegin, uint64_t loopEnd) {
+	assert(loopBegin < loopEnd && loopEnd <= waveFile_.GetFrameCount());
+	loopBegin_ = loopBegin;
+	loopEnd_ = loopEnd;
+}
+
+void StreamingVoice::VoiceCallback::OnBufferEnd([[maybe_unused]] void* pBufferContext) {
+	owner_->freeBufferCount_.fetch_add(1);
+	owner_->freeBufferCount_.notify_one();
+}
+
+void StreamingVoice::StreamThread() {
+	while (true) {
+		// 空きが出るまで待つ
+		freeBufferCount_.wait(0);
+		if (stopRequested_) {
+			break;
+		}
+		freeBufferCount_.fetch_sub(1);
+		if (!SubmitNextBuffer()) {
+			break;
+		}
+	}
+}
+
+bool StreamingVoice::SubmitNextBuffer() {
+	const uint32_t blockAlign = waveFile_.GetFormat().blockAlign;
+	uint8_t* buffer = &buffers_[size_t(nextBuffer_) * kBufferFrameCount * blockAlign];
+
+	// ループ時は末尾に達したらループ先頭から読み足す
+	uint64_t end = loop_ ? loopEnd_ : waveFile_.GetFrameCount();
+	uint32_t frameCount = 0;
+	while (frameCount < kBufferFrameCount) {
+		if (cursor_ >= end) {
+			if (!loop_) {
+				break;
+			}
+			cursor_ = loopBegin_;
+		}
+		uint64_t remaining = end - cursor_;
+		uint32_t request =
+		    static_cast<uint32_t>(std::min<uint64_t>(kBufferFrameCount - frameCount, remaining));
+		uint32_t read = waveFile_.Read(cursor_, request, buffer + frameCount * blockAlign);
+		if (read == 0) {
+			// 読めなければ（途中で切れたファイル）そこで終わりにする
+			end = cursor_;
+			loop_ = false;
+			break;
+		}
+		cursor_ += read;
+		frameCount += read;
+	}
+
+	bool ended = !loop_ && cursor_ >= end;
+	endOfStream_ = ended;
+	if (frameCount == 0) {
+		return false;
+	}
+
+	XAUDIO2_BUFFER xaudio2Buffer = {};
+	xaudio2Buffer.AudioBytes = frameCount * blockAlign;
+	xaudio2Buffer.pAudioData = buffer;
+	xaudio2Buffer.Flags = ended ? XAUDIO2_END_OF_STREAM : 0;
+	HRESULT result = sourceVoice_->SubmitSourceBuffer(&xaudio2Buffer);
+	assert(SUCCEEDED(result));
+
+	nextBuffer_ = (nextBuffer_ + 1) % kBufferCount;
+	return !ended;
+}
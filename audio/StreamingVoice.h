@@ -0,0 +1,147 @@
+#pragma once
+
+#include "WaveFile.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <xaudio2.h>
+
+/// <summary>
+/// ストリーミング再生（WAVを少しずつ読んでリングバッファで XAudio2 に渡す。BGM向け）
+/// </summary>
+class StreamingVoice {
+public: // 定数
+	// リングバッファの数（再生中・待機中・読み込み中の3つ）
+	static const uint32_t kBufferCount = 3;
+	// 1バッファのフレーム数（44.1kHz で約0.19秒）
+	static const uint32_t kBufferFrameCount = 8192;
+
+public: // メンバ関数
+	StreamingVoice() = default;
+	~StreamingVoice();
+	StreamingVoice(const StreamingVoice&) = delete;
+	StreamingVoice& operator=(const StreamingVoice&) = delete;
+
+	/// <summary>
+	/// 初期化（ファイルを開くだけで、波形データは再生しながら読む）
+	/// </summary>
+	/// <param name="xAudio2">XAudio2のインスタンス</param>
+	/// <param name="filePath">WAVファイルパス</param>
+	/// <returns>開けたらtrue</returns>
+	bool Initialize(IXAudio2* xAudio2, const std::string& filePath);
+
+	/// <summary>
+	/// 終了処理
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 再生（先頭から。バッファを全て埋めてから鳴らし始める）
+	/// </summary>
+	/// <param name="loopFlag">ループ再生フラグ（ループ範囲の末尾から先頭へ戻る）</param>
+	/// <param name="volume">ボリューム</param>
+	void Play(bool loopFlag = false, float volume = 1.0f);
+
+	/// <summary>
+	/// 停止
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// 一時停止
+	/// </summary>
+	void Pause();
+
+	/// <summary>
+	/// 一時停止からの再開
+	/// </summary>
+	void Resume();
+
+	/// <summary>
+	/// 再生中か（一時停止中も含む）
+	/// </summary>
+	bool IsPlaying() const;
+
+	/// <summary>
+	/// 音量設定
+	/// </summary>
+	void SetVolume(float volume);
+
+	/// <summary>
+	/// ループ範囲の設定（フレーム番号。既定は smpl チャンクのループ、無ければ全体）
+	/// </summary>
+	/// <param name="loopBegin">ループの先頭</param>
+	/// <param name="loopEnd">ループの末尾（含まない）</param>
+	void SetLoopPoints(uint64_t loopBegin, uint64_t loopEnd);
+
+	/// <summary>
+	/// 常駐する波形データのバイト数（リングバッファ分）
+	/// </summary>
+	size_t GetResidentBytes() const { return buffers_.size(); }
+
+	const WaveFile::Format& GetFormat() const { return waveFile_.GetFormat(); }
+
+private: // サブクラス
+	/// <summary>
+	/// バッファの再生終了を読み込みスレッドへ知らせる（オーディオスレッドで呼ばれるので待たない）
+	/// </summary>
+	class VoiceCallback : public IXAudio2VoiceCallback {
+	public:
+		explicit VoiceCallback(StreamingVoice* owner) : owner_(owner) {}
+		STDMETHOD_(void, OnVoiceProcessingPassStart)
+		([[maybe_unused]] THIS_ UINT32 BytesRequired){};
+		STDMETHOD_(void, OnVoiceProcessingPassEnd)(THIS){};
+		STDMETHOD_(void, OnStreamEnd)(THIS){};
+		STDMETHOD_(void, OnBufferStart)([[maybe_unused]] THIS_ void* pBufferContext){};
+		STDMETHOD_(void, OnBufferEnd)([[maybe_unused]] THIS_ void* pBufferContext);
+		STDMETHOD_(void, OnLoopEnd)([[maybe_unused]] THIS_ void* pBufferContext){};
+		STDMETHOD_(void, OnVoiceError)
+		([[maybe_unused]] THIS_ void* pBufferContext, [[maybe_unused]] HRESULT Error){};
+
+	private:
+		StreamingVoice* owner_;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 読み込みスレッド（空いたバッファを埋めて送る）
+	/// </summary>
+	void StreamThread();
+
+	/// <summary>
+	/// 次のバッファを埋めて送る
+	/// </summary>
+	/// <returns>まだ続きがあるならtrue</returns>
+	bool SubmitNextBuffer();
+
+private: // メンバ変数
+	// XAudio2のインスタンス
+	IXAudio2* xAudio2_ = nullptr;
+	// ソースボイス（再生中のみ）
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+	// WAVファイル
+	WaveFile waveFile_;
+	// リングバッファ（kBufferCount 個を連続して確保）
+	std::vector<uint8_t> buffers_;
+	// 次に埋めるバッファの番号
+	uint32_t nextBuffer_ = 0;
+	// 次に読むフレーム番号
+	uint64_t cursor_ = 0;
+	// ループ再生するか
+	bool loop_ = false;
+	// ループ範囲 [loopBegin_, loopEnd_)
+	uint64_t loopBegin_ = 0;
+	uint64_t loopEnd_ = 0;
+	// 読み込みスレッド
+	std::thread thread_;
+	// 再生が終わって空いたバッファの数
+	std::atomic<uint32_t> freeBufferCount_ = 0;
+	// 読み込みスレッドの停止要求
+	std::atomic<bool> stopRequested_ = false;
+	// 末尾まで送り終えたか
+	std::atomic<bool> endOfStream_ = false;
+	// コールバック
+	VoiceCallback callback_{this};
+};
@@ -0,0 +1,213 @@
+#include "WaveFile.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+// チャンクヘッダ
+struct ChunkHeader {
+	char id[4];
+	uint32_t size;
+};
+
+// RIFFヘッダ
+struct RiffHeader {
+	ChunkHeader chunk; // "RIFF"
+	char type[4];      // "WAVE"
+};
+
+// smpl チャンクの固定部（ループ情報の前まで）
+struct SampleChunk {
+	uint32_t manufacturer;
+	uint32_t product;
+	uint32_t samplePeriod;
+	uint32_t midiUnityNote;
+	uint32_t midiPitchFraction;
+	uint32_t smpteFormat;
+	uint32_t smpteOffset;
+	uint32_t sampleLoopCount;
+	uint32_t samplerData;
+};
+
+// smpl チャンクのループ情報
+struct SampleLoop {
+	uint32_t cuePointId;
+	uint32_t type;
+	uint32_t start;
+	uint32_t end; // 最後のサンプルを含む
+	uint32_t fraction;
+	uint32_t playCount;
+};
+
+bool IsChunk(const ChunkHeader& header, const char* id) {
+	return std::strncmp(header.id, id, 4) == 0;
+}
+
+// 1サンプルを [-1, 1] の浮動小数にする
+float DecodeSample(const uint8_t* sample, const WaveFile::Format& format) {
+	if (format.formatTag == WaveFile::kFormatIeeeFloat) {
+		float value = 0.0f;
+		std::memcpy(&value, sample, sizeof(value));
+		return value;
+	}
+	switch (format.bitsPerSample) {
+	case 8:
+		// 8bitのみ符号なし
+		return (float(sample[0]) - 128.0f) / 128.0f;
+	case 16: {
+		int16_t value = 0;
+		std::memcpy(&value, sample, sizeof(value));
+		return float(value) / 32768.0f;
+	}
+	case 24: {
+		int32_t value = int32_t(uint32_t(sample[0]) << 8 | uint32_t(sample[1]) << 16 |
+		                        uint32_t(sample[2]) << 24) >>
+		                8;
+		return float(value) / 8388608.0f;
+	}
+	case 32: {
+		int32_t value = 0;
+		std::memcpy(&value, sample, sizeof(value));
+		return float(value) / 2147483648.0f;
+	}
+	default:
+		return 0.0f;
+	}
+}
+
+} // namespace
+
+bool WaveFile::Load(const std::string& filePath, Format& format, std::vector<uint8_t>& data) {
+	WaveFile waveFile;
+	if (!waveFile.Open(filePath)) {
+		return false;
+	}
+	format = waveFile.GetFormat();
+	data.resize(size_t(waveFile.GetFrameCount()) * format.blockAlign);
+	uint32_t frameCount = static_cast<uint32_t>(waveFile.GetFrameCount());
+	return waveFile.Read(0, frameCount, data.data()) == frameCount;
+}
+
+uint32_t WaveFile::Decode(
+    const Format& format, const std::vector<uint8_t>& data, uint32_t maxChannelCount,
+    std::vector<float>& samples) {
+	uint32_t channelCount = std::min<uint32_t>(format.channels, maxChannelCount);
+	uint32_t frameCount = static_cast<uint32_t>(data.size() / format.blockAlign);
+	uint32_t bytesPerSample = format.bitsPerSample / 8;
+	samples.resize(size_t(frameCount) * channelCount);
+	for (uint32_t i = 0; i < frameCount; i++) {
+		const uint8_t* frame = &data[size_t(i) * format.blockAlign];
+		for (uint32_t c = 0; c < channelCount; c++) {
+			samples[size_t(i) * channelCount + c] =
+			    DecodeSample(frame + c * bytesPerSample, format);
+		}
+	}
+	return channelCount;
+}
+
+bool WaveFile::Open(const std::string& filePath) {
+	Close();
+	file_.open(filePath, std::ios_base::binary);
+	if (!file_.is_open()) {
+		return false;
+	}
+
+	RiffHeader riff = {};
+	file_.read(reinterpret_cast<char*>(&riff), sizeof(riff));
+	if (!file_ || !IsChunk(riff.chunk, "RIFF") || std::strncmp(riff.type, "WAVE", 4) != 0) {
+		Close();
+		return false;
+	}
+
+	// チャンクを順に見て、fmt・data・smpl の位置と中身を拾う
+	bool hasFormat = false;
+	bool hasData = false;
+	uint64_t dataSize = 0;
+	ChunkHeader chunk = {};
+	while (file_.read(reinterpret_cast<char*>(&chunk), sizeof(chunk))) {
+		uint64_t chunkBegin = static_cast<uint64_t>(file_.tellg());
+		if (IsChunk(chunk, "fmt ")) {
+			// WAVEFORMATEXTENSIBLE まで読み、拡張形式ならサブフォーマットの先頭2バイトがタグ
+			uint8_t bytes[40] = {};
+			file_.read(reinterpret_cast<char*>(bytes), std::min<uint32_t>(chunk.size, 40));
+			std::memcpy(&format_.formatTag, bytes + 0, 2);
+			std::memcpy(&format_.channels, bytes + 2, 2);
+			std::memcpy(&format_.samplesPerSec, bytes + 4, 4);
+			std::memcpy(&format_.avgBytesPerSec, bytes + 8, 4);
+			std::memcpy(&format_.blockAlign, bytes + 12, 2);
+			std::memcpy(&format_.bitsPerSample, bytes + 14, 2);
+			if (format_.formatTag == kFormatExtensible && chunk.size >= 40) {
+				std::memcpy(&format_.formatTag, bytes + 24, 2);
+			}
+			hasFormat = true;
+		} else if (IsChunk(chunk, "data")) {
+			dataOffset_ = chunkBegin;
+			dataSize = chunk.size;
+			hasData = true;
+		} else if (
+		    IsChunk(chunk, "smpl") && chunk.size >= sizeof(SampleChunk) + sizeof(SampleLoop)) {
+			SampleChunk sample = {};
+			SampleLoop loop = {};
+			file_.read(reinterpret_cast<char*>(&sample), sizeof(sample));
+			file_.read(reinterpret_cast<char*>(&loop), sizeof(loop));
+			if (sample.sampleLoopCount > 0 && loop.start <= loop.end) {
+				hasLoop_ = true;
+				loopBegin_ = loop.start;
+				loopEnd_ = uint64_t(loop.end) + 1;
+			}
+		}
+		// チャンクは2バイト境界に揃っている
+		file_.clear();
+		file_.seekg(std::streamoff(chunkBegin + chunk.size + (chunk.size & 1)));
+	}
+	file_.clear();
+
+	// 整数PCM・32bit浮動小数のみ扱う
+	bool supported =
+	    hasFormat && hasData && format_.channels > 0 && format_.blockAlign > 0 &&
+	    ((format_.formatTag == kFormatPcm &&
+	      (format_.bitsPerSample == 8 || format_.bitsPerSample == 16 ||
+	       format_.bitsPerSample == 24 || format_.bitsPerSample == 32)) ||
+	     (format_.formatTag == kFormatIeeeFloat && format_.bitsPerSample == 32));
+	if (!supported) {
+		Close();
+		return false;
+	}
+
+	frameCount_ = dataSize / format_.blockAlign;
+	if (hasLoop_) {
+		loopEnd_ = std::min(loopEnd_, frameCount_);
+		hasLoop_ = loopBegin_ < loopEnd_;
+	}
+	if (!hasLoop_) {
+		loopBegin_ = 0;
+		loopEnd_ = frameCount_;
+	}
+	return true;
+}
+
+void WaveFile::Close() {
+	if (file_.is_open()) {
+		file_.close();
+	}
+	file_.clear();
+	format_ = Format();
+	dataOffset_ = 0;
+	frameCount_ = 0;
+	hasLoop_ = false;
+	loopBegin_ = 0;
+	loopEnd_ = 0;
+}
+
+uint32_t WaveFile::Read(uint64_t frame, uint32_t frameCount, uint8_t* buffer) {
+	assert(IsOpen());
+	if (frame >= frameCount_) {
+		return 0;
+	}
+	frameCount = static_cast<uint32_t>(std::min<uint64_t>(frameCount, frameCount_ - frame));
+	file_.clear();
+	file_.seekg(std::streamoff(dataOffset_ + frame * format_.blockAlign));
+	file_.read(reinterpret_cast<char*>(buffer), std::streamsize(frameCount) * format_.blockAlign);
+	return static_cast<uint32_t>(file_.gcount() / format_.blockAlign);
+}
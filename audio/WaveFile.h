@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// WAVファイル（RIFFのチャンクを解析し、波形データを必要な分だけ読む）
+/// </summary>
+class WaveFile {
+public: // 定数
+	// フォーマットタグ
+	static const uint16_t kFormatPcm = 0x0001;
+	static const uint16_t kFormatIeeeFloat = 0x0003;
+	static const uint16_t kFormatExtensible = 0xFFFE;
+
+public: // サブクラス
+	// 波形フォーマット（WAVEFORMATEX と同じ意味。拡張形式は元のタグに直して持つ）
+	struct Format {
+		uint16_t formatTag = 0;
+		uint16_t channels = 0;
+		uint32_t samplesPerSec = 0;
+		uint32_t avgBytesPerSec = 0;
+		uint16_t blockAlign = 0;
+		uint16_t bitsPerSample = 0;
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 波形データ全体の読み込み
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="format">波形フォーマット</param>
+	/// <param name="data">波形データ</param>
+	/// <returns>読めたらtrue</returns>
+	static bool Load(const std::string& filePath, Format& format, std::vector<uint8_t>& data);
+
+	/// <summary>
+	/// 波形データを [-1, 1] の浮動小数に直す（8/16/24/32bit整数と32bit浮動小数に対応）
+	/// </summary>
+	/// <param name="format">波形フォーマット</param>
+	/// <param name="data">波形データ</param>
+	/// <param name="maxChannelCount">使うチャンネル数の上限（先頭から使う）</param>
+	/// <param name="samples">チャンネルを交互に並べたサンプル</param>
+	/// <returns>samples のチャンネル数</returns>
+	static uint32_t Decode(
+	    const Format& format, const std::vector<uint8_t>& data, uint32_t maxChannelCount,
+	    std::vector<float>& samples);
+
+public: // メンバ関数
+	/// <summary>
+	/// ファイルを開いてチャンクを解析する（波形データは読まない）
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>対応する形式ならtrue</returns>
+	bool Open(const std::string& filePath);
+
+	/// <summary>
+	/// ファイルを閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// 波形データの読み込み
+	/// </summary>
+	/// <param name="frame">先頭フレーム番号（1フレーム = 全チャンネルの1サンプル）</param>
+	/// <param name="frameCount">フレーム数</param>
+	/// <param name="buffer">書き込み先（frameCount * blockAlign バイト）</param>
+	/// <returns>読んだフレーム数（末尾なら少なくなる）</returns>
+	uint32_t Read(uint64_t frame, uint32_t frameCount, uint8_t* buffer);
+
+	bool IsOpen() const { return file_.is_open(); }
+	const Format& GetFormat() const { return format_; }
+	uint64_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// ループ位置（smpl チャンクの1つ目のループ。無ければ全体）
+	/// </summary>
+	bool HasLoop() const { return hasLoop_; }
+	uint64_t GetLoopBegin() const { return loopBegin_; }
+	uint64_t GetLoopEnd() const { return loopEnd_; }
+
+private: // メンバ変数
+	// ファイル
+	std::ifstream file_;
+	// 波形フォーマット
+	Format format_;
+	// data チャンクの中身のファイル内位置
+	uint64_t dataOffset_ = 0;
+	// 総フレーム数
+	uint64_t frameCount_ = 0;
+	// smpl チャンクにループがあったか
+	bool hasLoop_ = false;
+	// ループ範囲 [loopBegin_, loopEnd_)（フレーム番号）
+	uint64_t loopBegin_ = 0;
+	uint64_t loopEnd_ = 0;
+};
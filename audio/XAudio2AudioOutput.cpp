@@ -0,0 +1,77 @@
+#include "XAudio2AudioOutput.h"
+#include <algorithm>
+#include <cassert>
+
+XAudio2AudioOutput::~XAudio2AudioOutput() { Finalize(); }
+
+void XAudio2AudioOutput::Initialize(
+    IXAudio2* xAudio2, uint32_t sampleRate, uint32_t maxFrameCount) {
+	assert(xAudio2);
+	Finalize();
+	sampleRate_ = sampleRate;
+	maxFrameCount_ = maxFrameCount;
+	buffers_.resize(size_t(kBufferCount) * maxFrameCount_ * kChannelCount);
+	nextBuffer_ = 0;
+	freeBufferCount_ = kBufferCount;
+	closed_ = false;
+
+	// 32bit浮動小数・ステレオのソースボイス
+	WAVEFORMATEX wfex = {};
+	wfex.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+	wfex.nChannels = kChannelCount;
+	wfex.nSamplesPerSec = sampleRate_;
+	wfex.wBitsPerSample = 32;
+	wfex.nBlockAlign = wfex.nChannels * wfex.wBitsPerSample / 8;
+	wfex.nAvgBytesPerSec = wfex.nSamplesPerSec * wfex.nBlockAlign;
+	HRESULT result = xAudio2->CreateSourceVoice(&sourceVoice_, &wfex, 0, 2.0f, &callback_);
+	assert(SUCCEEDED(result));
+	result = sourceVoice_->Start();
+	assert(SUCCEEDED(result));
+}
+
+void XAudio2AudioOutput::Finalize() {
+	{
+		// 送信中の Submit が終わるのを待ってから閉じる
+		std::lock_guard<std::mutex> lock(voiceMutex_);
+		closed_ = true;
+	}
+	// 空きを待っている Submit を起こす（ソースボイスを止めると OnBufferEnd はもう来ない）
+	freeBufferCount_.fetch_add(1);
+	freeBufferCount_.notify_all();
+
+	// 破棄はオーディオスレッドがバッファを使い終わるまで待つ
+	if (sourceVoice_) {
+		sourceVoice_->DestroyVoice();
+		sourceVoice_ = nullptr;
+	}
+	buffers_.clear();
+}
+
+void XAudio2AudioOutput::Submit(const float* samples, uint32_t frameCount) {
+	assert(frameCount <= maxFrameCount_);
+
+	// 空きが出るまで待つ（ミキサーのスレッドはここで再生の速さに合わせられる）
+	freeBufferCount_.wait(0);
+	std::lock_guard<std::mutex> lock(voiceMutex_);
+	// 閉じた後は捨てる（ミキサーのスレッドが止まるまでの分）
+	if (closed_) {
+		return;
+	}
+	assert(sourceVoice_);
+	freeBufferCount_.fetch_sub(1);
+
+	float* buffer = &buffers_[size_t(nextBuffer_) * maxFrameCount_ * kChannelCount];
+	std::copy(samples, samples + size_t(frameCount) * kChannelCount, buffer);
+	XAUDIO2_BUFFER xaudio2Buffer = {};
+	xaudio2Buffer.AudioBytes = static_cast<UINT32>(sizeof(float) * kChannelCount * frameCount);
+	xaudio2Buffer.pAudioData = reinterpret_cast<const BYTE*>(buffer);
+	HRESULT result = sourceVoice_->SubmitSourceBuffer(&xaudio2Buffer);
+	assert(SUCCEEDED(result));
+
+	nextBuffer_ = (nextBuffer_ + 1) % kBufferCount;
+}
+
+void XAudio2AudioOutput::VoiceCallback::OnBufferEnd([[maybe_unused]] void* pBufferContext) {
+	owner_->freeBufferCount_.fetch_add(1);
+	owner_->freeBufferCount_.notify_one();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AudioOutput.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <xaudio2.h>
+
+/// <summary>
+/// XAudio2 への出力（ミックス結果を1つのソースボイスに順に送る）
+/// </summary>
+class XAudio2AudioOutput : public AudioOutput {
+public: // 定数
+	// 送り先バッファの数
+	static const uint32_t kBufferCount = 3;
+
+public: // メンバ関数
+	XAudio2AudioOutput() = default;
+	~XAudio2AudioOutput() override;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="xAudio2">XAudio2のインスタンス</param>
+	/// <param name="sampleRate">サンプリングレート</param>
+	/// <param name="maxFrameCount">1回の Submit の最大フレーム数</param>
+	void Initialize(IXAudio2* xAudio2, uint32_t sampleRate, uint32_t maxFrameCount);
+
+	/// <summary>
+	/// 終了処理（Submit で空きを待っているミキサーのスレッドも起こし、以後の Submit は捨てる）
+	/// </summary>
+	void Finalize();
+
+	uint32_t GetSampleRate() const override { return sampleRate_; }
+	void Submit(const float* samples, uint32_t frameCount) override;
+
+private: // サブクラス
+	/// <summary>
+	/// バッファの再生終了を数える（オーディオスレッドで呼ばれるので待たない）
+	/// </summary>
+	class VoiceCallback : public IXAudio2VoiceCallback {
+	public:
+		explicit VoiceCallback(XAudio2AudioOutput* owner) : owner_(owner) {}
+		STDMETHOD_(void, OnVoiceProcessingPassStart)
+		([[maybe_unused]] THIS_ UINT32 BytesRequired){};
+		STDMETHOD_(void, OnVoiceProcessingPassEnd)(THIS){};
+		STDMETHOD_(void, OnStreamEnd)(THIS){};
+		STDMETHOD_(void, OnBufferStart)([[maybe_unused]] THIS_ void* pBufferContext){};
+		STDMETHOD_(void, OnBufferEnd)([[maybe_unused]] THIS_ void* pBufferContext);
+		STDMETHOD_(void, OnLoopEnd)([[maybe_unused]] THIS_ void* pBufferContext){};
+		STDMETHOD_(void, OnVoiceError)
+		([[maybe_unused]] THIS_ void* pBufferContext, [[maybe_unused]] HRESULT Error){};
+
+	private:
+		XAudio2AudioOutput* owner_;
+	};
+
+private: // メンバ変数
+	// サンプリングレート
+	uint32_t sampleRate_ = 0;
+	// 1バッファのフレーム数
+	uint32_t maxFrameCount_ = 0;
+	// ソースボイス
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+	// 送り先バッファ（kBufferCount 個を連続して確保）
+	std::vector<float> buffers_;
+	// 次に使うバッファの番号
+	uint32_t nextBuffer_ = 0;
+	// 空いているバッファの数
+	std::atomic<uint32_t> freeBufferCount_ = 0;
+	// 閉じたか（Submit はこれを見て、待ちから起きたらソースボイスに触らずに戻る）
+	std::atomic<bool> closed_ = false;
+	// Submit のソースボイスへの送信と Finalize の破棄を排他する
+	std::mutex voiceMutex_;
+	// コールバック
+	VoiceCallback callback_{this};
+};
@@ -0,0 +1,33 @@
+#include "ShaderCompiler.h"
+#include <algorithm>
+#include <d3dcompiler.h>
+#include <string>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+Microsoft::WRL::ComPtr<ID3DBlob> CompileShaderFromFile(
+    const wchar_t* fileName, const char* target, const D3D_SHADER_MACRO* defines) {
+	Microsoft::WRL::ComPtr<ID3DBlob> blob;      // シェーダオブジェクト
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob; // エラーオブジェクト
+
+#ifdef _DEBUG
+	UINT flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	UINT flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif // _DEBUG
+	HRESULT result = D3DCompileFromFile(
+	    fileName, defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", target, flags, 0, &blob,
+	    &errorBlob);
+
+	// シェーダーのエラー内容を出力して終了する
+	if (FAILED(result)) {
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+		std::copy_n(
+		    (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+		OutputDebugStringA(errstr.c_str());
+		exit(1);
+	}
+	return blob;
+}
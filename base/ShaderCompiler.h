@@ -0,0 +1,15 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl.h>
+
+/// <summary>
+/// シェーダーファイルのコンパイル（失敗したらエラー内容を出力して終了する。
+/// デバッグビルドはデバッグ情報付き・最適化なし、リリースビルドは最適化する）
+/// </summary>
+/// <param name="fileName">シェーダーファイルパス</param>
+/// <param name="target">シェーダーモデル</param>
+/// <param name="defines">マクロ定義</param>
+/// <returns>シェーダオブジェクト</returns>
+Microsoft::WRL::ComPtr<ID3DBlob> CompileShaderFromFile(
+    const wchar_t* fileName, const char* target, const D3D_SHADER_MACRO* defines = nullptr);
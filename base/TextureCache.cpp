@@ -0,0 +1,308 @@
+#include "TextureCache.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <d3dx12.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace DirectX;
+using namespace std::chrono;
+
+const std::string TextureCache::kExtension = ".texcache";
+
+namespace {
+
+// キャッシュファイルヘッダ
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipLevels;
+	uint64_t sourceSize;
+	int64_t sourceWriteTime;
+	uint64_t sourceHash;
+};
+
+// ミップ毎の情報
+struct MipHeader {
+	uint32_t rowPitch;
+	uint32_t slicePitch;
+};
+
+// 壊れたヘッダを弾くための上限（D3D12の2Dテクスチャの最大サイズ）
+const uint32_t kMaxDimension = D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+const uint32_t kMaxMipLevels = D3D12_REQ_MIP_LEVELS;
+
+size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// そのまま2Dテクスチャにできる形式か（壊れた値や型なし・ビデオ・深度の形式を弾く）
+bool IsSupportedFormat(DXGI_FORMAT format) {
+	return IsValid(format) && !IsTypeless(format) && !IsVideo(format) && !IsPalettized(format) &&
+	       !IsDepthStencil(format);
+}
+
+// 幅・高さから作れるミップの最大数
+uint32_t GetMaxMipLevels(uint32_t width, uint32_t height) {
+	uint32_t mipLevels = 1;
+	for (uint32_t size = (std::max)(width, height); 1 < size; size >>= 1) {
+		mipLevels++;
+	}
+	return mipLevels;
+}
+
+} // namespace
+
+bool TextureCache::IsImageFile(const std::string& path) {
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+		return static_cast<char>(std::tolower(c));
+	});
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+	       extension == ".bmp";
+}
+
+bool TextureCache::Reader::Open(const std::string& cachePath, const std::string& sourcePath) {
+	subresources_.clear();
+	resourceDesc_ = {};
+
+	if (!file_.Open(cachePath)) {
+		return false;
+	}
+	const uint8_t* data = file_.GetData();
+	size_t fileSize = file_.GetSize();
+
+	// ヘッダ検証
+	FileHeader header{};
+	if (fileSize < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != kMagic || header.version != kVersion) {
+		return false;
+	}
+	if (header.width == 0 || header.height == 0 || kMaxDimension < header.width ||
+	    kMaxDimension < header.height || header.mipLevels == 0 ||
+	    kMaxMipLevels < header.mipLevels ||
+	    GetMaxMipLevels(header.width, header.height) < header.mipLevels) {
+		return false;
+	}
+	// 形式の検証（テクスチャにできない値なら、書いた後で形式の扱いが変わったものとみなす）
+	DXGI_FORMAT format = static_cast<DXGI_FORMAT>(header.format);
+	if (!IsSupportedFormat(format)) {
+		return false;
+	}
+
+	// キャッシュ元ファイルの検証（MeshCache と同じく、更新時刻が違えば内容ハッシュで判定する）
+	MeshCache::SourceFile source;
+	if (!MeshCache::GetSourceFile(sourcePath, source) || source.size != header.sourceSize) {
+		return false;
+	}
+	if (source.writeTime != header.sourceWriteTime &&
+	    MeshCache::HashSources({source}) != header.sourceHash) {
+		return false;
+	}
+
+	// ミップ情報と各ミップのデータ（マッピング領域を直接参照する）
+	size_t offset = sizeof(header);
+	size_t mipTableSize = sizeof(MipHeader) * header.mipLevels;
+	if (fileSize - offset < mipTableSize) {
+		return false;
+	}
+	std::vector<MipHeader> mips(header.mipLevels);
+	std::memcpy(mips.data(), data + offset, mipTableSize);
+	offset += mipTableSize;
+
+	subresources_.resize(header.mipLevels);
+	for (uint32_t i = 0; i < header.mipLevels; i++) {
+		// ピッチは形式とミップの大きさで決まる値と一致しなければならない
+		size_t rowPitch = 0;
+		size_t slicePitch = 0;
+		ComputePitch(
+		    format, (std::max)(header.width >> i, 1u), (std::max)(header.height >> i, 1u),
+		    rowPitch, slicePitch);
+		offset = AlignUp(offset, kDataAlignment);
+		if (mips[i].rowPitch != rowPitch || mips[i].slicePitch != slicePitch ||
+		    fileSize < offset || fileSize - offset < mips[i].slicePitch) {
+			subresources_.clear();
+			return false;
+		}
+		subresources_[i].data = data + offset;
+		subresources_[i].rowPitch = mips[i].rowPitch;
+		subresources_[i].slicePitch = mips[i].slicePitch;
+		offset += mips[i].slicePitch;
+	}
+
+	resourceDesc_ = CD3DX12_RESOURCE_DESC::Tex2D(
+	    format, header.width, header.height, 1, static_cast<UINT16>(header.mipLevels));
+	return true;
+}
+
+std::string TextureCache::GetCachePath(const std::string& sourcePath) {
+	return sourcePath + kExtension;
+}
+
+HRESULT TextureCache::Decode(const std::string& sourcePath, ScratchImage& image) {
+	std::filesystem::path filePath(sourcePath);
+
+	// WICテクスチャのロード
+	TexMetadata metadata{};
+	ScratchImage scratchImg{};
+	HRESULT result =
+	    LoadFromWICFile(filePath.wstring().c_str(), WIC_FLAGS_NONE, &metadata, scratchImg);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// ミップマップ生成（1x1など生成できない場合は元のまま）
+	ScratchImage mipChain{};
+	result = GenerateMipMaps(
+	    scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
+	    TEX_FILTER_DEFAULT, 0, mipChain);
+	if (SUCCEEDED(result)) {
+		scratchImg = std::move(mipChain);
+	}
+
+	// 読み込んだディフューズテクスチャをSRGBとして扱う
+	scratchImg.OverrideFormat(MakeSRGB(scratchImg.GetMetadata().format));
+
+	image = std::move(scratchImg);
+	return S_OK;
+}
+
+HRESULT TextureCache::Compress(ScratchImage& image, Compression compression) {
+	const TexMetadata& metadata = image.GetMetadata();
+	if (compression == Compression::kNone || IsCompressed(metadata.format)) {
+		return S_OK;
+	}
+	// BC形式は最上位ミップの幅・高さが4の倍数でなければならない
+	if (metadata.width % 4 != 0 || metadata.height % 4 != 0) {
+		return S_OK;
+	}
+
+	// 元がSRGB扱いなら圧縮後もSRGB扱いにする
+	DXGI_FORMAT format =
+	    IsSRGB(metadata.format) ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+
+	ScratchImage compressed{};
+	HRESULT result = DirectX::Compress(
+	    image.GetImages(), image.GetImageCount(), metadata, format, TEX_COMPRESS_PARALLEL,
+	    TEX_THRESHOLD_DEFAULT, compressed);
+	if (FAILED(result)) {
+		return result;
+	}
+	image = std::move(compressed);
+	return S_OK;
+}
+
+TextureCache::CookStats
+    TextureCache::CookDirectory(const std::string& directoryPath, Compression compression) {
+	CookStats stats;
+
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(directoryPath, ec)) {
+		if (!entry.is_regular_file() || !IsImageFile(entry.path().string())) {
+			continue;
+		}
+		std::string sourcePath = entry.path().generic_string();
+		std::string cachePath = GetCachePath(sourcePath);
+
+		// 有効なキャッシュがあれば飛ばす
+		{
+			Reader reader;
+			if (reader.Open(cachePath, sourcePath)) {
+				stats.skippedCount++;
+				continue;
+			}
+		}
+
+		// キャッシュを使わない読み込みと同じ処理の時間を計る
+		auto start = steady_clock::now();
+		ScratchImage image;
+		HRESULT result = Decode(sourcePath, image);
+		stats.decodeTime += duration_cast<microseconds>(steady_clock::now() - start);
+		if (FAILED(result) || FAILED(Compress(image, compression)) ||
+		    !Write(cachePath, sourcePath, image)) {
+			stats.failedCount++;
+			continue;
+		}
+
+		// キャッシュからの読み込み（実行時と同じく各ミップを1回コピーするまで）の時間を計る
+		start = steady_clock::now();
+		Reader reader;
+		if (!reader.Open(cachePath, sourcePath)) {
+			stats.failedCount++;
+			continue;
+		}
+		std::vector<uint8_t> staging;
+		for (const Subresource& subresource : reader.GetSubresources()) {
+			const uint8_t* bytes = static_cast<const uint8_t*>(subresource.data);
+			staging.assign(bytes, bytes + subresource.slicePitch);
+		}
+		stats.cacheReadTime += duration_cast<microseconds>(steady_clock::now() - start);
+
+		stats.cookedCount++;
+		stats.sourceBytes += entry.file_size(ec);
+		stats.cacheBytes += std::filesystem::file_size(cachePath, ec);
+	}
+
+	return stats;
+}
+
+bool TextureCache::Write(
+    const std::string& cachePath, const std::string& sourcePath, const ScratchImage& image) {
+	MeshCache::SourceFile source;
+	if (!MeshCache::GetSourceFile(sourcePath, source)) {
+		return false;
+	}
+
+	const TexMetadata& metadata = image.GetMetadata();
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.format = static_cast<uint32_t>(metadata.format);
+	header.width = static_cast<uint32_t>(metadata.width);
+	header.height = static_cast<uint32_t>(metadata.height);
+	header.mipLevels = static_cast<uint32_t>(metadata.mipLevels);
+	header.sourceSize = source.size;
+	header.sourceWriteTime = source.writeTime;
+	header.sourceHash = MeshCache::HashSources({source});
+
+	std::vector<MipHeader> mips(metadata.mipLevels);
+	for (size_t i = 0; i < metadata.mipLevels; i++) {
+		const Image* img = image.GetImage(i, 0, 0);
+		mips[i].rowPitch = static_cast<uint32_t>(img->rowPitch);
+		mips[i].slicePitch = static_cast<uint32_t>(img->slicePitch);
+	}
+
+	// 書きかけのキャッシュを読まないよう、一時ファイルに書いてから置き換える
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(mips.data()), sizeof(MipHeader) * mips.size());
+		size_t offset = sizeof(header) + sizeof(MipHeader) * mips.size();
+		const char padding[kDataAlignment] = {};
+		for (size_t i = 0; i < metadata.mipLevels; i++) {
+			size_t aligned = AlignUp(offset, kDataAlignment);
+			file.write(padding, aligned - offset);
+			const Image* img = image.GetImage(i, 0, 0);
+			file.write(reinterpret_cast<const char*>(img->pixels), img->slicePitch);
+			offset = aligned + img->slicePitch;
+		}
+		if (!file) {
+			return false;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::rename(tempPath, cachePath, ec);
+	return !ec;
+}
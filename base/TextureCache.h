@@ -0,0 +1,147 @@
+#pragma once
+
+#include "MeshCache.h"
+#include <chrono>
+#include <cstdint>
+#include <d3d12.h>
+#include <string>
+#include <vector>
+
+namespace DirectX {
+class ScratchImage;
+}
+
+/// <summary>
+/// ミップマップ生成済みテクスチャのバイナリキャッシュ
+/// </summary>
+class TextureCache {
+public: // 定数
+	// ファイル識別子 'KTEX'
+	static const uint32_t kMagic = 0x5845544B;
+	// フォーマットバージョン（レイアウトを変えたら上げる）
+	static const uint32_t kVersion = 1;
+	// ミップデータのファイル内アライメント
+	static const size_t kDataAlignment = 16;
+	// キャッシュファイルの拡張子（元ファイル名の後ろに付ける）
+	static const std::string kExtension;
+
+public: // 列挙子
+	/// <summary>
+	/// 圧縮形式
+	/// </summary>
+	enum class Compression {
+		kNone, // 非圧縮（読み込んだ形式のまま）
+		kBC7,  // BC7（幅・高さが4の倍数のときのみ。それ以外は非圧縮）
+	};
+
+public: // サブクラス
+	// サブリソース参照（マッピングしたファイルを直接指す）
+	struct Subresource {
+		// 先頭アドレス
+		const void* data = nullptr;
+		// 1ライン（BC形式では1ブロック行）のバイト数
+		uint32_t rowPitch = 0;
+		// 1枚のバイト数
+		uint32_t slicePitch = 0;
+	};
+
+	/// <summary>
+	/// キャッシュ読み取り
+	/// </summary>
+	class Reader {
+	public:
+		/// <summary>
+		/// キャッシュを開いて検証する（元ファイル・形式・ミップのピッチが合わなければ無効）
+		/// </summary>
+		/// <param name="cachePath">キャッシュファイルパス</param>
+		/// <param name="sourcePath">キャッシュ元画像ファイルパス</param>
+		/// <returns>有効なキャッシュならtrue</returns>
+		bool Open(const std::string& cachePath, const std::string& sourcePath);
+
+		/// <summary>
+		/// テクスチャバッファのリソース設定を取得
+		/// </summary>
+		const D3D12_RESOURCE_DESC& GetResourceDesc() const { return resourceDesc_; }
+
+		/// <summary>
+		/// サブリソース配列を取得（Readerが生きている間のみ有効）
+		/// </summary>
+		const std::vector<Subresource>& GetSubresources() const { return subresources_; }
+
+	private:
+		// マッピングしたキャッシュファイル
+		MeshCache::MappedFile file_;
+		// リソース設定
+		D3D12_RESOURCE_DESC resourceDesc_ = {};
+		// サブリソース配列
+		std::vector<Subresource> subresources_;
+	};
+
+	// 調理統計
+	struct CookStats {
+		// 調理したファイル数
+		uint32_t cookedCount = 0;
+		// キャッシュが有効だったので飛ばしたファイル数
+		uint32_t skippedCount = 0;
+		// 失敗したファイル数
+		uint32_t failedCount = 0;
+		// 調理前の画像ファイルの合計バイト数
+		uint64_t sourceBytes = 0;
+		// 調理後のキャッシュファイルの合計バイト数
+		uint64_t cacheBytes = 0;
+		// 画像のデコードとミップマップ生成にかかった時間（キャッシュを使わない読み込みの時間）
+		std::chrono::microseconds decodeTime{};
+		// キャッシュの読み込みにかかった時間（キャッシュを使う読み込みの時間）
+		std::chrono::microseconds cacheReadTime{};
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// 調理対象の画像ファイルか（WICで読める拡張子）
+	/// </summary>
+	/// <param name="path">ファイルパス</param>
+	/// <returns>画像ファイルならtrue</returns>
+	static bool IsImageFile(const std::string& path);
+
+	/// <summary>
+	/// 画像ファイルに対応するキャッシュファイルパス
+	/// </summary>
+	/// <param name="sourcePath">画像ファイルパス</param>
+	/// <returns>キャッシュファイルパス</returns>
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	/// <summary>
+	/// 画像ファイルのデコードとミップマップ生成（SRGBとして扱う）
+	/// </summary>
+	/// <param name="sourcePath">画像ファイルパス</param>
+	/// <param name="image">生成したイメージ</param>
+	/// <returns>結果</returns>
+	static HRESULT Decode(const std::string& sourcePath, DirectX::ScratchImage& image);
+
+	/// <summary>
+	/// ブロック圧縮（圧縮できない大きさならそのまま）
+	/// </summary>
+	/// <param name="image">ミップマップ生成済みイメージ</param>
+	/// <param name="compression">圧縮形式</param>
+	/// <returns>結果</returns>
+	static HRESULT Compress(DirectX::ScratchImage& image, Compression compression);
+
+	/// <summary>
+	/// ディレクトリ以下の画像ファイルをまとめて調理する（キャッシュが有効なものは飛ばす）
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリパス</param>
+	/// <param name="compression">圧縮形式</param>
+	/// <returns>調理統計</returns>
+	static CookStats CookDirectory(const std::string& directoryPath, Compression compression);
+
+	/// <summary>
+	/// キャッシュ書き込み
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルパス</param>
+	/// <param name="sourcePath">キャッシュ元画像ファイルパス</param>
+	/// <param name="image">ミップマップ生成済みイメージ</param>
+	/// <returns>成否</returns>
+	static bool Write(
+	    const std::string& cachePath, const std::string& sourcePath,
+	    const DirectX::ScratchImage& image);
+};
@@ -0,0 +1,687 @@
+#include "TextureStreamer.h"
+#include "StringUtility.h"
+#include "TextureCache.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+using namespace std::chrono;
+
+const std::string TextureStreamer::kPlaceholderFileName = "white1x1.png";
+
+namespace {
+
+// 読み込み失敗を通知して終了する
+void NotifyLoadFailure(const std::string& fileName) {
+	std::wstring message = L"テクスチャ「" + ConvertStringMultiByteToWide(fileName) +
+	                       L"」の読み込みに失敗しました。\n指定したパスが正しいか、"
+	                       L"必須リソースのコピーを忘れていないか確認してください。";
+	MessageBoxW(nullptr, message.c_str(), L"Not found texture", 0);
+	assert(false);
+	exit(1);
+}
+
+} // namespace
+
+uint32_t TextureStreamer::Load(const std::string& fileName) {
+	return TextureStreamer::GetInstance()->LoadInternal(fileName);
+}
+
+uint32_t TextureStreamer::LoadAsync(
+    const std::string& fileName, std::function<void(uint32_t)> onLoaded) {
+	return TextureStreamer::GetInstance()->LoadAsyncInternal(fileName, std::move(onLoaded));
+}
+
+uint32_t TextureStreamer::LoadFromImage(const std::string& name, const ScratchImage& image) {
+	TextureStreamer* instance = TextureStreamer::GetInstance();
+
+	// 登録済みなら同じハンドルを返す
+	uint32_t found = instance->FindAndAcquire(name);
+	if (found != UINT32_MAX) {
+		return found;
+	}
+
+	const TexMetadata& metadata = image.GetMetadata();
+	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+	    metadata.format, metadata.width, (UINT)metadata.height, (UINT16)metadata.arraySize,
+	    (UINT16)metadata.mipLevels);
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	for (size_t i = 0; i < metadata.mipLevels; i++) {
+		const Image* img = image.GetImage(i, 0, 0);
+		subresources.push_back({img->pixels, (LONG_PTR)img->rowPitch, (LONG_PTR)img->slicePitch});
+	}
+
+	// メモリ上のイメージは読み直せないので追い出さない
+	uint32_t handle = instance->AllocateHandle(name);
+	Texture& texture = instance->textures_[handle];
+	texture.reloadable = false;
+	HRESULT result = instance->UploadTexture(texresDesc, subresources, texture.resource);
+	if (FAILED(result)) {
+		NotifyLoadFailure(name);
+	}
+
+	instance->CreateShaderResourceView(handle);
+	texture.loaded = true;
+	instance->SetResident(handle, true);
+	return handle;
+}
+
+bool TextureStreamer::IsLoaded(uint32_t textureHandle) {
+	TextureStreamer* instance = TextureStreamer::GetInstance();
+	return textureHandle < instance->textures_.size() && instance->textures_[textureHandle].loaded;
+}
+
+bool TextureStreamer::Unload(uint32_t textureHandle) {
+	return TextureStreamer::GetInstance()->UnloadInternal(textureHandle);
+}
+
+void TextureStreamer::AddRef(uint32_t textureHandle) {
+	TextureStreamer* instance = TextureStreamer::GetInstance();
+	assert(textureHandle < instance->textures_.size());
+	Texture& texture = instance->textures_[textureHandle];
+	assert(!texture.name.empty());
+	texture.refCount++;
+}
+
+void TextureStreamer::Release(uint32_t textureHandle) {
+	TextureStreamer* instance = TextureStreamer::GetInstance();
+	assert(textureHandle < instance->textures_.size());
+	Texture& texture = instance->textures_[textureHandle];
+	assert(texture.refCount > 0);
+	texture.refCount--;
+}
+
+TextureStreamer* TextureStreamer::GetInstance() {
+	static TextureStreamer instance;
+	return &instance;
+}
+
+TextureStreamer::~TextureStreamer() { Finalize(); }
+
+void TextureStreamer::Initialize(ID3D12Device* device, std::string directoryPath) {
+	assert(device);
+
+	device_ = device;
+	directoryPath_ = directoryPath;
+
+	// デスクリプタサイズを取得
+	sDescriptorHandleIncrementSize_ =
+	    device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	// ヒープ全体をテーブルにするには、未使用のデスクリプタを許す Tier2 以上が要る
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+	HRESULT result =
+	    device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+	bindlessSupported_ =
+	    SUCCEEDED(result) && options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_2;
+
+	// 全テクスチャリセット
+	ResetAll();
+}
+
+void TextureStreamer::ResetAll() {
+	[[maybe_unused]] HRESULT result = S_FALSE;
+
+	// デスクリプタヒープを生成
+	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
+	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE; // シェーダから見えるように
+	descHeapDesc.NumDescriptors = kNumDescriptors; // シェーダーリソースビュー1つ
+	result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&descriptorHeap_)); // 生成
+	assert(SUCCEEDED(result));
+
+	// 全テクスチャを初期化（読み込み中の結果は世代を進めて捨てる）
+	for (size_t i = 0; i < kNumDescriptors; i++) {
+		textures_[i].resource.Reset();
+		textures_[i].cpuDescHandleSRV.ptr = 0;
+		textures_[i].gpuDescHandleSRV.ptr = 0;
+		textures_[i].name.clear();
+		textures_[i].loaded = false;
+		textures_[i].generation++;
+		textures_[i].callbacks.clear();
+		textures_[i].refCount = 0;
+		textures_[i].residentBytes = 0;
+		textures_[i].evicted = false;
+	}
+	useTable_.reset();
+	placeholderHandle_ = UINT32_MAX;
+	memoryStats_.residentBytes = 0;
+}
+
+void TextureStreamer::Update() {
+	// 描画統計を締める
+	lastFrameStats_ = frameStats_;
+	frameStats_ = FrameStats();
+	lastBoundHandle_ = UINT32_MAX;
+	frameIndex_++;
+
+	std::vector<AsyncResult> results;
+	{
+		std::lock_guard<std::mutex> lock(resultMutex_);
+		results.swap(results_);
+	}
+
+	for (AsyncResult& result : results) {
+		pendingCount_--;
+
+		// 読み込み中に解除・再利用された枠なら捨てる
+		Texture& texture = textures_[result.handle];
+		if (texture.generation != result.generation || texture.loaded) {
+			continue;
+		}
+		if (FAILED(result.result)) {
+			NotifyLoadFailure(texture.name);
+		}
+
+		// プレースホルダーから読み込んだテクスチャへ差し替え
+		texture.resource = std::move(result.resource);
+		CreateShaderResourceView(result.handle);
+		texture.loaded = true;
+		SetResident(result.handle, true);
+
+		// コールバック内で読み込みが追加されても良いように取り出してから呼ぶ
+		std::vector<std::function<void(uint32_t)>> callbacks = std::move(texture.callbacks);
+		texture.callbacks.clear();
+		for (auto& callback : callbacks) {
+			callback(result.handle);
+		}
+	}
+
+	// 前フレームまでのGPU処理は完了しているので、ここで予算超過分を解放する
+	EvictToBudget();
+}
+
+void TextureStreamer::Finalize() {
+	{
+		std::lock_guard<std::mutex> lock(requestMutex_);
+		stopWorkers_ = true;
+	}
+	requestCondition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+	requests_.clear();
+	results_.clear();
+	pendingCount_ = 0;
+	stopWorkers_ = false;
+}
+
+TextureStreamer::LoadStats TextureStreamer::GetLoadStats() {
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	return loadStats_;
+}
+
+void TextureStreamer::ResetLoadStats() {
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	loadStats_ = LoadStats();
+}
+
+TextureStreamer::MemoryStats TextureStreamer::GetMemoryStats() const {
+	MemoryStats stats = memoryStats_;
+	stats.budgetBytes = memoryBudget_;
+	for (const Texture& texture : textures_) {
+		if (texture.residentBytes > 0) {
+			stats.residentCount++;
+		}
+		if (texture.evicted) {
+			stats.evictedCount++;
+		}
+	}
+	return stats;
+}
+
+const D3D12_RESOURCE_DESC TextureStreamer::GetResourceDesc(uint32_t textureHandle) {
+
+	assert(textureHandle < textures_.size());
+	Touch(textureHandle);
+	Texture& texture = textures_.at(textureHandle);
+	return texture.resource->GetDesc();
+}
+
+void TextureStreamer::SetGraphicsRootDescriptorTable(
+    ID3D12GraphicsCommandList* commandList, UINT rootParamIndex,
+    uint32_t textureHandle) { // デスクリプタヒープの配列
+	assert(textureHandle < textures_.size());
+	Touch(textureHandle);
+	frameStats_.bindCount++;
+	if (textureHandle != lastBoundHandle_) {
+		frameStats_.switchCount++;
+		lastBoundHandle_ = textureHandle;
+	}
+
+	SetDescriptorHeap(commandList);
+
+	// シェーダリソースビューをセット
+	commandList->SetGraphicsRootDescriptorTable(
+	    rootParamIndex, textures_[textureHandle].gpuDescHandleSRV);
+}
+
+void TextureStreamer::SetDescriptorHeap(ID3D12GraphicsCommandList* commandList) {
+	frameStats_.heapBindCount++;
+	ID3D12DescriptorHeap* ppHeaps[] = {descriptorHeap_.Get()};
+	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
+
+void TextureStreamer::SetGraphicsRootDescriptorTableBindless(
+    ID3D12GraphicsCommandList* commandList, UINT rootParamIndex) {
+	assert(bindlessSupported_);
+	frameStats_.bindCount++;
+	lastBoundHandle_ = UINT32_MAX;
+	commandList->SetGraphicsRootDescriptorTable(
+	    rootParamIndex, descriptorHeap_->GetGPUDescriptorHandleForHeapStart());
+}
+
+uint32_t TextureStreamer::GetDescriptorIndex(uint32_t textureHandle) {
+	assert(textureHandle < textures_.size());
+	// 追い出されていれば読み直す（デスクリプタの位置はハンドルと同じなので変わらない）
+	Touch(textureHandle);
+	frameStats_.indexCount++;
+	return textureHandle;
+}
+
+uint32_t TextureStreamer::LoadInternal(const std::string& fileName) {
+
+	// 読み込み済みテクスチャを検索（追い出されていれば読み直す）
+	uint32_t found = FindAndAcquire(fileName);
+	if (found != UINT32_MAX) {
+		Touch(found);
+		return found;
+	}
+
+	// 書き込むテクスチャの参照
+	uint32_t handle = AllocateHandle(fileName);
+	Texture& texture = textures_.at(handle);
+	memoryStats_.missCount++;
+
+	HRESULT result = CreateTextureResource(GetFullPath(fileName), texture.resource);
+	if (FAILED(result)) {
+		NotifyLoadFailure(fileName);
+	}
+
+	// シェーダリソースビュー作成
+	CreateShaderResourceView(handle);
+	texture.loaded = true;
+	SetResident(handle, true);
+
+	return handle;
+}
+
+uint32_t TextureStreamer::LoadAsyncInternal(
+    const std::string& fileName, std::function<void(uint32_t)> onLoaded) {
+
+	// 読み込み済み・読み込み中のテクスチャを検索
+	uint32_t found = FindAndAcquire(fileName);
+	if (found != UINT32_MAX) {
+		Texture& texture = textures_[found];
+		texture.lastUsedFrame = frameIndex_;
+		// 追い出されていれば読み直す
+		if (texture.evicted) {
+			texture.evicted = false;
+			memoryStats_.missCount++;
+			RequestAsyncLoad(found);
+		}
+		if (onLoaded) {
+			if (texture.loaded) {
+				onLoaded(found);
+			} else {
+				texture.callbacks.push_back(std::move(onLoaded));
+			}
+		}
+		return found;
+	}
+
+	// 書き込むテクスチャの参照
+	uint32_t handle = AllocateHandle(fileName);
+	memoryStats_.missCount++;
+	if (onLoaded) {
+		textures_[handle].callbacks.push_back(std::move(onLoaded));
+	}
+	RequestAsyncLoad(handle);
+
+	return handle;
+}
+
+bool TextureStreamer::UnloadInternal(uint32_t textureHandle) {
+	// 範囲外
+	if (textures_.size() <= textureHandle) {
+		return false;
+	}
+
+	auto& texture = textures_[textureHandle];
+	// 範囲内だけど読んでない場所
+	assert(!texture.name.empty());
+
+	// テクスチャ設定を解除
+	SetResident(textureHandle, false);
+	texture.resource.Reset();
+	texture.cpuDescHandleSRV.ptr = 0;
+	texture.gpuDescHandleSRV.ptr = 0;
+	texture.name.clear();
+	texture.loaded = false;
+	texture.generation++;
+	texture.callbacks.clear();
+	texture.refCount = 0;
+	texture.evicted = false;
+	useTable_.reset(textureHandle);
+	return true;
+}
+
+uint32_t TextureStreamer::FindAndAcquire(const std::string& name) {
+	auto it = std::find_if(textures_.begin(), textures_.end(), [&](const auto& texture) {
+		return texture.name == name;
+	});
+	if (it == textures_.end()) {
+		return UINT32_MAX;
+	}
+	it->refCount++;
+	if (!it->evicted) {
+		memoryStats_.hitCount++;
+	}
+	return static_cast<uint32_t>(std::distance(textures_.begin(), it));
+}
+
+void TextureStreamer::Touch(uint32_t handle) {
+	Texture& texture = textures_[handle];
+	texture.lastUsedFrame = frameIndex_;
+	if (texture.evicted) {
+		Reload(handle);
+	}
+}
+
+void TextureStreamer::Reload(uint32_t handle) {
+	Texture& texture = textures_[handle];
+	assert(texture.evicted);
+
+	HRESULT result = CreateTextureResource(GetFullPath(texture.name), texture.resource);
+	if (FAILED(result)) {
+		NotifyLoadFailure(texture.name);
+	}
+
+	texture.evicted = false;
+	CreateShaderResourceView(handle);
+	texture.loaded = true;
+	SetResident(handle, true);
+	memoryStats_.missCount++;
+}
+
+void TextureStreamer::RequestAsyncLoad(uint32_t handle) {
+	// プレースホルダーは同期読み込みしておく
+	if (placeholderHandle_ == UINT32_MAX) {
+		placeholderHandle_ = LoadInternal(kPlaceholderFileName);
+	}
+
+	// 読み込み完了まではプレースホルダーを指す
+	Texture& texture = textures_[handle];
+	texture.loaded = false;
+	texture.resource = textures_[placeholderHandle_].resource;
+	CreateShaderResourceView(handle);
+
+	// ワーカースレッドは初回に起動する
+	if (workers_.empty()) {
+		// メインスレッドの分を残す
+		uint32_t workerCount =
+		    std::clamp(std::thread::hardware_concurrency(), 2u, kMaxWorkerCount + 1) - 1;
+		for (uint32_t i = 0; i < workerCount; i++) {
+			workers_.emplace_back(&TextureStreamer::WorkerMain, this);
+		}
+	}
+
+	// 読み込み要求
+	pendingCount_++;
+	{
+		std::lock_guard<std::mutex> lock(requestMutex_);
+		requests_.push_back({handle, texture.generation, GetFullPath(texture.name)});
+	}
+	requestCondition_.notify_one();
+}
+
+void TextureStreamer::SetResident(uint32_t handle, bool resident) {
+	Texture& texture = textures_[handle];
+	memoryStats_.residentBytes -= texture.residentBytes;
+	texture.residentBytes = 0;
+	if (resident) {
+		D3D12_RESOURCE_DESC desc = texture.resource->GetDesc();
+		texture.residentBytes = device_->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+		memoryStats_.residentBytes += texture.residentBytes;
+	}
+}
+
+void TextureStreamer::Evict(uint32_t handle) {
+	// デスクリプタは解放したリソースを指したままになるが、使う前に Touch で読み直す
+	Texture& texture = textures_[handle];
+	SetResident(handle, false);
+	texture.resource.Reset();
+	texture.loaded = false;
+	texture.evicted = true;
+	memoryStats_.evictionCount++;
+}
+
+void TextureStreamer::EvictToBudget() {
+	if (memoryStats_.residentBytes <= memoryBudget_) {
+		return;
+	}
+
+	// 最後に使ったのが古い順に追い出す
+	std::vector<uint32_t> candidates;
+	for (uint32_t i = 0; i < kNumDescriptors; i++) {
+		if (IsEvictable(i)) {
+			candidates.push_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+		return textures_[a].lastUsedFrame < textures_[b].lastUsedFrame;
+	});
+	for (uint32_t handle : candidates) {
+		if (memoryStats_.residentBytes <= memoryBudget_) {
+			break;
+		}
+		Evict(handle);
+	}
+}
+
+bool TextureStreamer::IsEvictable(uint32_t handle) const {
+	const Texture& texture = textures_[handle];
+	return useTable_.test(handle) && handle != placeholderHandle_ && texture.refCount == 0 &&
+	       texture.loaded && texture.reloadable && texture.lastUsedFrame < frameIndex_;
+}
+
+uint32_t TextureStreamer::FindFreeHandle() const {
+	for (uint32_t i = 0; i < kNumDescriptors; i++) {
+		if (!useTable_.test(i)) {
+			return i;
+		}
+	}
+	return kNumDescriptors;
+}
+
+uint32_t TextureStreamer::AllocateHandle(const std::string& name) {
+	uint32_t handle = FindFreeHandle();
+	if (kNumDescriptors <= handle) {
+		// 満杯なら参照されていない枠を空ける（追い出し済みを優先し、次に最後に使ったのが古いもの）
+		for (uint32_t i = 0; i < kNumDescriptors; i++) {
+			const Texture& texture = textures_[i];
+			if (!texture.evicted && !IsEvictable(i)) {
+				continue;
+			}
+			if (texture.refCount != 0 || frameIndex_ <= texture.lastUsedFrame) {
+				continue;
+			}
+			if (kNumDescriptors <= handle ||
+			    (texture.evicted && !textures_[handle].evicted) ||
+			    (texture.evicted == textures_[handle].evicted &&
+			     texture.lastUsedFrame < textures_[handle].lastUsedFrame)) {
+				handle = i;
+			}
+		}
+		assert(handle < kNumDescriptors);
+		UnloadInternal(handle);
+	}
+
+	Texture& texture = textures_.at(handle);
+	texture.name = name;
+	texture.loaded = false;
+	texture.evicted = false;
+	texture.reloadable = true;
+	texture.refCount = 1;
+	texture.lastUsedFrame = frameIndex_;
+	useTable_.set(handle);
+	return handle;
+}
+
+std::string TextureStreamer::GetFullPath(const std::string& fileName) const {
+	// ディレクトリパスとファイル名を連結してフルパスを得る
+	bool currentRelative = false;
+	if (2 < fileName.size()) {
+		currentRelative = (fileName[0] == '.') && (fileName[1] == '/');
+	}
+	return currentRelative ? fileName : directoryPath_ + fileName;
+}
+
+HRESULT TextureStreamer::CreateTextureResource(
+    const std::string& fullPath, Microsoft::WRL::ComPtr<ID3D12Resource>& resource) {
+	HRESULT result;
+	LoadStats stats;
+	stats.loadCount = 1;
+
+	// 転送元（キャッシュならマッピングしたファイル、無ければデコードしたイメージを指す）
+	D3D12_RESOURCE_DESC texresDesc{};
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	TextureCache::Reader reader;
+	ScratchImage scratchImg{};
+
+	auto start = steady_clock::now();
+	std::string cachePath = TextureCache::GetCachePath(fullPath);
+	if (useCache_ && reader.Open(cachePath, fullPath)) {
+		// ミップマップ生成済みのデータをそのまま転送する
+		texresDesc = reader.GetResourceDesc();
+		for (const TextureCache::Subresource& subresource : reader.GetSubresources()) {
+			subresources.push_back(
+			    {subresource.data, subresource.rowPitch, subresource.slicePitch});
+		}
+		stats.cacheHitCount = 1;
+		stats.cacheReadTime = duration_cast<microseconds>(steady_clock::now() - start);
+	} else {
+		// デコードとミップマップ生成
+		result = TextureCache::Decode(fullPath, scratchImg);
+		if (FAILED(result)) {
+			return result;
+		}
+		stats.decodeTime = duration_cast<microseconds>(steady_clock::now() - start);
+		// 次回からキャッシュを使う（書き込めなくても読み込みは続ける）
+		if (useCache_) {
+			TextureCache::Write(cachePath, fullPath, scratchImg);
+		}
+
+		const TexMetadata& metadata = scratchImg.GetMetadata();
+		texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		    metadata.format, metadata.width, (UINT)metadata.height, (UINT16)metadata.arraySize,
+		    (UINT16)metadata.mipLevels);
+		for (size_t i = 0; i < metadata.mipLevels; i++) {
+			const Image* img = scratchImg.GetImage(i, 0, 0); // 生データ抽出
+			subresources.push_back(
+			    {img->pixels, (LONG_PTR)img->rowPitch, (LONG_PTR)img->slicePitch});
+		}
+	}
+
+	start = steady_clock::now();
+	result = UploadTexture(texresDesc, subresources, resource);
+	if (FAILED(result)) {
+		return result;
+	}
+	stats.uploadTime = duration_cast<microseconds>(steady_clock::now() - start);
+
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	loadStats_.loadCount += stats.loadCount;
+	loadStats_.cacheHitCount += stats.cacheHitCount;
+	loadStats_.decodeTime += stats.decodeTime;
+	loadStats_.cacheReadTime += stats.cacheReadTime;
+	loadStats_.uploadTime += stats.uploadTime;
+
+	return S_OK;
+}
+
+HRESULT TextureStreamer::UploadTexture(
+    const D3D12_RESOURCE_DESC& desc, const std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
+    Microsoft::WRL::ComPtr<ID3D12Resource>& resource) {
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps =
+	    CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0);
+
+	// テクスチャ用バッファの生成
+	HRESULT result = device_->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &desc,
+	    D3D12_RESOURCE_STATE_GENERIC_READ, // テクスチャ用指定
+	    nullptr, IID_PPV_ARGS(&resource));
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// テクスチャバッファにデータ転送
+	for (size_t i = 0; i < subresources.size(); i++) {
+		result = resource->WriteToSubresource(
+		    (UINT)i,
+		    nullptr,                           // 全領域へコピー
+		    subresources[i].pData,             // 元データアドレス
+		    (UINT)subresources[i].RowPitch,    // 1ラインサイズ
+		    (UINT)subresources[i].SlicePitch); // 1枚サイズ
+		if (FAILED(result)) {
+			return result;
+		}
+	}
+	return S_OK;
+}
+
+void TextureStreamer::CreateShaderResourceView(uint32_t handle) {
+	Texture& texture = textures_.at(handle);
+
+	// シェーダリソースビュー作成
+	texture.cpuDescHandleSRV = CD3DX12_CPU_DESCRIPTOR_HANDLE(
+	    descriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle,
+	    sDescriptorHandleIncrementSize_);
+	texture.gpuDescHandleSRV = CD3DX12_GPU_DESCRIPTOR_HANDLE(
+	    descriptorHeap_->GetGPUDescriptorHandleForHeapStart(), handle,
+	    sDescriptorHandleIncrementSize_);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{}; // 設定構造体
+	D3D12_RESOURCE_DESC resDesc = texture.resource->GetDesc();
+
+	srvDesc.Format = resDesc.Format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
+	srvDesc.Texture2D.MipLevels = resDesc.MipLevels;
+
+	device_->CreateShaderResourceView(
+	    texture.resource.Get(), // ビューと関連付けるバッファ
+	    &srvDesc,               // テクスチャ設定情報
+	    texture.cpuDescHandleSRV);
+}
+
+void TextureStreamer::WorkerMain() {
+	// WICを使うのでスレッド毎にCOMを初期化する
+	[[maybe_unused]] HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	assert(SUCCEEDED(result));
+
+	while (true) {
+		AsyncRequest request;
+		{
+			std::unique_lock<std::mutex> lock(requestMutex_);
+			requestCondition_.wait(lock, [this] { return stopWorkers_ || !requests_.empty(); });
+			if (stopWorkers_) {
+				break;
+			}
+			request = std::move(requests_.front());
+			requests_.pop_front();
+		}
+
+		// デコードから転送までをこのスレッドで行い、デスクリプタの差し替えは Update に任せる
+		AsyncResult asyncResult{request.handle, request.generation, S_OK, nullptr};
+		asyncResult.result = CreateTextureResource(request.fullPath, asyncResult.resource);
+
+		std::lock_guard<std::mutex> lock(resultMutex_);
+		results_.push_back(std::move(asyncResult));
+	}
+
+	CoUninitialize();
+}
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <d3dx12.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h>
+
+namespace DirectX {
+class ScratchImage;
+}
+
+/// <summary>
+/// テクスチャストリーマー（非同期読み込み・キャッシュ・参照カウントと予算による追い出し・
+/// メモリ上のイメージの登録・描画統計・バインドレス描画）。
+/// TextureManager とは別のデスクリプタヒープとハンドルを持つので、ハンドルは混ぜて使わない
+/// </summary>
+class TextureStreamer {
+public:
+	// デスクリプターの数
+	static constexpr size_t kNumDescriptors = 1024;
+	// 非同期読み込みのワーカースレッド数の上限
+	static constexpr uint32_t kMaxWorkerCount = 4;
+	// 非同期読み込み中に表示するテクスチャ
+	static const std::string kPlaceholderFileName;
+	// 既定のテクスチャメモリ予算（バイト）
+	static constexpr size_t kDefaultMemoryBudget = 256 * 1024 * 1024;
+
+	/// <summary>
+	/// テクスチャ
+	/// </summary>
+	struct Texture {
+		// テクスチャリソース
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		// シェーダリソースビューのハンドル(CPU)
+		CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescHandleSRV;
+		// シェーダリソースビューのハンドル(CPU)
+		CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescHandleSRV;
+		// 名前
+		std::string name;
+		// 読み込み完了しているか（非同期読み込み中はプレースホルダーを指す）
+		bool loaded = false;
+		// 世代（解除・再利用された枠に古い非同期読み込み結果を反映しないため）
+		uint32_t generation = 0;
+		// 読み込み完了コールバック
+		std::vector<std::function<void(uint32_t)>> callbacks;
+		// 参照カウント（0なら予算超過時の追い出し対象）
+		uint32_t refCount = 0;
+		// 最後に使ったフレーム
+		uint64_t lastUsedFrame = 0;
+		// 常駐しているバイト数（プレースホルダーを指している間は0）
+		size_t residentBytes = 0;
+		// 追い出し済みか（名前は残し、次に使うときに読み直す）
+		bool evicted = false;
+		// ファイルから読み直せるか（LoadFromImage で登録したものは追い出さない）
+		bool reloadable = false;
+	};
+
+	/// <summary>
+	/// メモリ統計
+	/// </summary>
+	struct MemoryStats {
+		// 常駐しているバイト数
+		size_t residentBytes = 0;
+		// 予算（バイト）
+		size_t budgetBytes = 0;
+		// 常駐しているテクスチャ数
+		uint32_t residentCount = 0;
+		// 追い出されているテクスチャ数
+		uint32_t evictedCount = 0;
+		// 追い出した回数（累計）
+		uint32_t evictionCount = 0;
+		// 読み込み要求が常駐テクスチャで済んだ回数
+		uint32_t hitCount = 0;
+		// 読み込み要求や使用時にファイルから読んだ回数（追い出し後の読み直しを含む）
+		uint32_t missCount = 0;
+	};
+
+	/// <summary>
+	/// 読み込み統計
+	/// </summary>
+	struct LoadStats {
+		// 読み込んだテクスチャ数
+		uint32_t loadCount = 0;
+		// そのうちキャッシュから読み込んだ数
+		uint32_t cacheHitCount = 0;
+		// 画像のデコードとミップマップ生成の時間（キャッシュなし）
+		std::chrono::microseconds decodeTime{};
+		// キャッシュ読み込みの時間
+		std::chrono::microseconds cacheReadTime{};
+		// テクスチャバッファ生成と転送の時間
+		std::chrono::microseconds uploadTime{};
+	};
+
+	/// <summary>
+	/// 1フレームの描画統計
+	/// </summary>
+	struct FrameStats {
+		// デスクリプタテーブルをセットした回数
+		uint32_t bindCount = 0;
+		// 直前と違うテクスチャのテーブルをセットした回数
+		uint32_t switchCount = 0;
+		// デスクリプタヒープをセットした回数
+		uint32_t heapBindCount = 0;
+		// テーブルをセットせずにデスクリプタ番号で参照させた回数（bindCount, switchCount とは別）
+		uint32_t indexCount = 0;
+	};
+
+	/// <summary>
+	/// 読み込み
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t Load(const std::string& fileName);
+
+	/// <summary>
+	/// 非同期読み込み（プレースホルダーを指すハンドルをすぐに返し、読み込み完了後に差し替える）
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="onLoaded">読み込み完了コールバック（Update 内で呼ばれる）</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t
+	    LoadAsync(const std::string& fileName, std::function<void(uint32_t)> onLoaded = nullptr);
+
+	/// <summary>
+	/// メモリ上のイメージから登録（アトラスなど）
+	/// </summary>
+	/// <param name="name">名前（同じ名前なら登録済みのハンドルを返す）</param>
+	/// <param name="image">イメージ（SRGB扱いにするなら呼び出し側で設定しておく）</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t LoadFromImage(const std::string& name, const DirectX::ScratchImage& image);
+
+	/// <summary>
+	/// 読み込み完了しているか
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>読み込み完了していればtrue</returns>
+	static bool IsLoaded(uint32_t textureHandle);
+
+	/// <summary>
+	/// 読み込み解除（参照カウントに関係なく解放する）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	static bool Unload(uint32_t textureHandle);
+
+	/// <summary>
+	/// 参照を増やす（Load/LoadAsync/LoadFromImage も1つ増やす）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	static void AddRef(uint32_t textureHandle);
+
+	/// <summary>
+	/// 参照を減らす（0になっても解放せず、予算を超えたら古いものから追い出す）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	static void Release(uint32_t textureHandle);
+
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static TextureStreamer* GetInstance();
+
+	/// <summary>
+	/// システム初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	void Initialize(ID3D12Device* device, std::string directoryPath = "Resources/");
+
+	/// <summary>
+	/// 毎フレーム処理（非同期読み込みの反映と描画統計の集計。GPUが描画していない間に呼ぶ）
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 終了処理（ワーカースレッドを停止する）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 全テクスチャリセット
+	/// </summary>
+	void ResetAll();
+
+	/// <summary>
+	/// 反映待ちの非同期読み込み数
+	/// </summary>
+	/// <returns>読み込み数</returns>
+	uint32_t GetPendingCount() const { return pendingCount_; }
+
+	/// <summary>
+	/// ミップマップ生成済みキャッシュ（TextureCache）を使うか。
+	/// 有効なら読み込み時にキャッシュを探し、無ければ作る
+	/// </summary>
+	/// <param name="useCache">使うならtrue</param>
+	void SetUseCache(bool useCache) { useCache_ = useCache; }
+
+	/// <summary>
+	/// 読み込み統計を取得（ワーカースレッドの分も含む）
+	/// </summary>
+	/// <returns>読み込み統計</returns>
+	LoadStats GetLoadStats();
+
+	/// <summary>
+	/// 読み込み統計をリセット
+	/// </summary>
+	void ResetLoadStats();
+
+	/// <summary>
+	/// テクスチャメモリ予算の設定（毎フレームの Update で超過分を追い出す）
+	/// </summary>
+	/// <param name="budgetBytes">予算（バイト）</param>
+	void SetMemoryBudget(size_t budgetBytes) { memoryBudget_ = budgetBytes; }
+
+	/// <summary>
+	/// メモリ統計を取得
+	/// </summary>
+	/// <returns>メモリ統計</returns>
+	MemoryStats GetMemoryStats() const;
+
+	/// <summary>
+	/// 前フレームの描画統計を取得
+	/// </summary>
+	/// <returns>描画統計</returns>
+	const FrameStats& GetLastFrameStats() const { return lastFrameStats_; }
+
+	/// <summary>
+	/// ファイル名からフルパスを得る
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>フルパス</returns>
+	std::string GetFullPath(const std::string& fileName) const;
+
+	/// <summary>
+	/// リソース情報取得
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>リソース情報</returns>
+	const D3D12_RESOURCE_DESC GetResourceDesc(uint32_t textureHandle);
+
+	/// <summary>
+	/// デスクリプタテーブルをセット
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="rootParamIndex">ルートパラメータ番号</param>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void SetGraphicsRootDescriptorTable(
+	    ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle);
+
+	/// <summary>
+	/// バインドレス描画に対応しているか（リソースバインディング Tier2 以上）
+	/// </summary>
+	bool IsBindlessSupported() const { return bindlessSupported_; }
+
+	/// <summary>
+	/// デスクリプタヒープをセット（バインドレス描画の前に1回だけ呼ぶ）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	void SetDescriptorHeap(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// ヒープ全体を指すデスクリプタテーブルをセット（バインドレス描画の前に1回だけ呼ぶ）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="rootParamIndex">ルートパラメータ番号</param>
+	void SetGraphicsRootDescriptorTableBindless(
+	    ID3D12GraphicsCommandList* commandList, UINT rootParamIndex);
+
+	/// <summary>
+	/// シェーダーがヒープ全体のテーブルから引くデスクリプタ番号を取得（コマンドは積まない）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>デスクリプタ番号</returns>
+	uint32_t GetDescriptorIndex(uint32_t textureHandle);
+
+private:
+	TextureStreamer() = default;
+	~TextureStreamer();
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// 非同期読み込み要求
+	struct AsyncRequest {
+		uint32_t handle;
+		uint32_t generation;
+		std::string fullPath;
+	};
+
+	// 非同期読み込み結果
+	struct AsyncResult {
+		uint32_t handle;
+		uint32_t generation;
+		HRESULT result;
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	};
+
+	// デバイス
+	ID3D12Device* device_;
+	// デスクリプタサイズ
+	UINT sDescriptorHandleIncrementSize_ = 0u;
+	// ディレクトリパス
+	std::string directoryPath_;
+	// デスクリプタヒープ
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap_;
+	// テクスチャコンテナ
+	std::array<Texture, kNumDescriptors> textures_;
+	std::bitset<kNumDescriptors> useTable_;
+	// プレースホルダーのテクスチャハンドル
+	uint32_t placeholderHandle_ = UINT32_MAX;
+	// ミップマップ生成済みキャッシュを使うか
+	std::atomic<bool> useCache_ = true;
+	// 読み込み統計
+	LoadStats loadStats_;
+	std::mutex statsMutex_;
+	// 描画統計（集計中と前フレーム）
+	FrameStats frameStats_;
+	// バインドレス描画に対応しているか
+	bool bindlessSupported_ = false;
+	FrameStats lastFrameStats_;
+	// 直前にセットしたテクスチャハンドル
+	uint32_t lastBoundHandle_ = UINT32_MAX;
+	// フレーム番号（0は未使用を表す）
+	uint64_t frameIndex_ = 1;
+	// テクスチャメモリ予算
+	size_t memoryBudget_ = kDefaultMemoryBudget;
+	// メモリ統計（個数は GetMemoryStats で数える）
+	MemoryStats memoryStats_;
+
+	// ワーカースレッド
+	std::vector<std::thread> workers_;
+	// 読み込み要求キュー
+	std::deque<AsyncRequest> requests_;
+	std::mutex requestMutex_;
+	std::condition_variable requestCondition_;
+	// ワーカースレッド停止フラグ
+	bool stopWorkers_ = false;
+	// 読み込み結果
+	std::vector<AsyncResult> results_;
+	std::mutex resultMutex_;
+	// 反映待ちの非同期読み込み数
+	std::atomic<uint32_t> pendingCount_ = 0;
+
+	/// <summary>
+	/// 読み込み
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	uint32_t LoadInternal(const std::string& fileName);
+
+	/// <summary>
+	/// 非同期読み込み
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="onLoaded">読み込み完了コールバック</param>
+	uint32_t LoadAsyncInternal(const std::string& fileName, std::function<void(uint32_t)> onLoaded);
+
+	/// <summary>
+	/// 読み込み解除
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	bool UnloadInternal(uint32_t textureHandle);
+
+	/// <summary>
+	/// 読み込み済みテクスチャを名前で検索し、見つかれば参照を増やして常駐させる
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <returns>テクスチャハンドル。見つからなければ UINT32_MAX</returns>
+	uint32_t FindAndAcquire(const std::string& name);
+
+	/// <summary>
+	/// 使用の記録（追い出されていれば読み直す）
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void Touch(uint32_t handle);
+
+	/// <summary>
+	/// 追い出したテクスチャの同期読み直し
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void Reload(uint32_t handle);
+
+	/// <summary>
+	/// 非同期読み込み要求（完了までプレースホルダーを指す）
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void RequestAsyncLoad(uint32_t handle);
+
+	/// <summary>
+	/// 常駐バイト数の記録
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	/// <param name="resident">リソースを持っているならtrue</param>
+	void SetResident(uint32_t handle, bool resident);
+
+	/// <summary>
+	/// 追い出し（リソースを解放し、名前とデスクリプタ枠は残す）
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void Evict(uint32_t handle);
+
+	/// <summary>
+	/// 予算を超えている分を、参照されていない古いテクスチャから追い出す
+	/// </summary>
+	void EvictToBudget();
+
+	/// <summary>
+	/// 追い出し対象か（参照されておらず、今フレーム使っておらず、読み直せる）
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	bool IsEvictable(uint32_t handle) const;
+
+	/// <summary>
+	/// 空いているテクスチャ枠を探す
+	/// </summary>
+	/// <returns>テクスチャハンドル。空きが無ければ kNumDescriptors</returns>
+	uint32_t FindFreeHandle() const;
+
+	/// <summary>
+	/// テクスチャ枠の確保（名前を設定して使用中にする。満杯なら参照されていない枠を空ける）
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t AllocateHandle(const std::string& name);
+
+	/// <summary>
+	/// キャッシュ読み込みかデコード・ミップマップ生成をして、テクスチャバッファ生成と転送
+	/// （ワーカースレッドからも呼ぶ）
+	/// </summary>
+	/// <param name="fullPath">フルパス</param>
+	/// <param name="resource">生成したテクスチャバッファ</param>
+	/// <returns>結果</returns>
+	HRESULT CreateTextureResource(
+	    const std::string& fullPath, Microsoft::WRL::ComPtr<ID3D12Resource>& resource);
+
+	/// <summary>
+	/// テクスチャバッファ生成と転送
+	/// </summary>
+	/// <param name="desc">リソース設定</param>
+	/// <param name="subresources">サブリソース配列（ミップ順）</param>
+	/// <param name="resource">生成したテクスチャバッファ</param>
+	/// <returns>結果</returns>
+	HRESULT UploadTexture(
+	    const D3D12_RESOURCE_DESC& desc, const std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
+	    Microsoft::WRL::ComPtr<ID3D12Resource>& resource);
+
+	/// <summary>
+	/// シェーダリソースビュー作成
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void CreateShaderResourceView(uint32_t handle);
+
+	/// <summary>
+	/// ワーカースレッドの処理
+	/// </summary>
+	void WorkerMain();
+};
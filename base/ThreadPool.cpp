@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+ThreadPool* ThreadPool::GetInstance() {
+	static ThreadPool instance;
+	return &instance;
+}
+
+ThreadPool::ThreadPool() {
+	uint32_t workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	workers_.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++) {
+		workers_.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	workCondition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Run(Job& job) {
+	assert(job.bandCount > 0);
+	job.remainingBandCount = job.bandCount;
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	// 1帯だけか、ワーカーがいなければ積まずに全部自分で処理する
+	if (job.bandCount > 1 && !workers_.empty()) {
+		jobs_.push_back(&job);
+		workCondition_.notify_all();
+	}
+	while (job.nextBand < job.bandCount) {
+		RunBand(job, ClaimBand(job), lock);
+	}
+	doneCondition_.wait(lock, [&job] { return job.remainingBandCount == 0; });
+}
+
+uint32_t ThreadPool::ClaimBand(Job& job) {
+	uint32_t band = job.nextBand++;
+	if (job.nextBand == job.bandCount) {
+		auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+		if (it != jobs_.end()) {
+			jobs_.erase(it);
+		}
+	}
+	return band;
+}
+
+void ThreadPool::RunBand(Job& job, uint32_t band, std::unique_lock<std::mutex>& lock) {
+	lock.unlock();
+	size_t begin = size_t(uint64_t(job.count) * band / job.bandCount);
+	size_t end = size_t(uint64_t(job.count) * (band + 1) / job.bandCount);
+	job.invoke(job.context, begin, end, band);
+	lock.lock();
+
+	// 最後の帯なら呼び出し元を起こす（以降 job は解放されうるので触らない）
+	if (--job.remainingBandCount == 0) {
+		doneCondition_.notify_all();
+	}
+}
+
+void ThreadPool::WorkerMain() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		workCondition_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+		if (stop_) {
+			return;
+		}
+		Job& job = *jobs_.front();
+		RunBand(job, ClaimBand(job), lock);
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// 常駐ワーカースレッドで範囲を帯に分けて並列に処理する
+/// </summary>
+class ThreadPool {
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得（初回にハードウェアスレッド数-1個のワーカーを起こす）
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ThreadPool* GetInstance();
+
+public: // メンバ関数
+	/// <summary>
+	/// 並列に動けるスレッド数（ワーカー＋呼び出し元）
+	/// </summary>
+	/// <returns>スレッド数</returns>
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+	/// <summary>
+	/// [0, count) を bandCount 個の帯に等分して並列に処理し、全部終わるまで待つ
+	/// （帯の境目は bandCount だけで決まる。呼び出し元も帯を受け持つので入れ子で呼んでもよい）
+	/// </summary>
+	/// <param name="bandCount">帯の数（0ならスレッド数）</param>
+	/// <param name="count">要素数</param>
+	/// <param name="func">帯の処理 func(begin, end, band)</param>
+	template<class Func> void ParallelFor(uint32_t bandCount, size_t count, Func&& func) {
+		Job job;
+		job.invoke = [](void* context, size_t begin, size_t end, uint32_t band) {
+			(*static_cast<std::remove_reference_t<Func>*>(context))(begin, end, band);
+		};
+		job.context = const_cast<void*>(static_cast<const void*>(&func));
+		job.count = count;
+		job.bandCount = bandCount == 0 ? GetThreadCount() : bandCount;
+		Run(job);
+	}
+
+private: // サブクラス
+	// 帯に分けた1回分の処理
+	struct Job {
+		// 帯の処理の呼び出し
+		void (*invoke)(void* context, size_t begin, size_t end, uint32_t band) = nullptr;
+		void* context = nullptr;
+		// 要素数と帯の数
+		size_t count = 0;
+		uint32_t bandCount = 0;
+		// 次に受け持つ帯と、終わっていない帯の数（mutex_ で守る）
+		uint32_t nextBand = 0;
+		uint32_t remainingBandCount = 0;
+	};
+
+private: // メンバ関数
+	ThreadPool();
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// 処理を積んで呼び出し元も帯を受け持ち、全部終わるまで待つ
+	/// </summary>
+	/// <param name="job">処理</param>
+	void Run(Job& job);
+
+	/// <summary>
+	/// 帯を1つ受け持つ（最後の帯なら待ち行列から外す。mutex_ を持って呼ぶ）
+	/// </summary>
+	/// <param name="job">処理</param>
+	/// <returns>帯の番号</returns>
+	uint32_t ClaimBand(Job& job);
+
+	/// <summary>
+	/// 帯を1つ処理して終わった数を数える（ロックを外して処理し、戻るときは持っている）
+	/// </summary>
+	/// <param name="job">処理</param>
+	/// <param name="band">帯の番号</param>
+	/// <param name="lock">mutex_ のロック</param>
+	void RunBand(Job& job, uint32_t band, std::unique_lock<std::mutex>& lock);
+
+	/// <summary>
+	/// ワーカースレッドの処理
+	/// </summary>
+	void WorkerMain();
+
+private: // メンバ変数
+	// ワーカースレッド
+	std::vector<std::thread> workers_;
+	// 帯の残っている処理の待ち行列
+	std::deque<Job*> jobs_;
+	std::mutex mutex_;
+	// 処理が積まれた / 帯が終わった通知
+	std::condition_variable workCondition_;
+	std::condition_variable doneCondition_;
+	// 終了要求
+	bool stop_ = false;
+};
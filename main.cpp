@@ -1,14 +1,51 @@
 #include "Audio.h"
+#include "AudioEngine.h"
 #include "AxisIndicator.h"
+#include "Benchmark.h"
 #include "DirectXCommon.h"
 #include "GameScene.h"
 #include "ImGuiManager.h"
 #include "PrimitiveDrawer.h"
+#include "SpriteBatch.h"
+#include "DebugTextBatch.h"
+#include "StaticMesh.h"
+#include "TextureCache.h"
 #include "TextureManager.h"
+#include "TextureStreamer.h"
 #include "WinApp.h"
+#include <cassert>
+#include <cstring>
+#include <format>
+
+// アセット調理（Resources 以下のテクスチャのミップマップ生成・BC7圧縮済みキャッシュを作る）
+int CookAssets() {
+	HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	assert(SUCCEEDED(result));
+
+	TextureCache::CookStats stats =
+	    TextureCache::CookDirectory("Resources/", TextureCache::Compression::kBC7);
+	std::string report = std::format(
+	    "cook: {} cooked, {} skipped, {} failed, {} -> {} bytes, "
+	    "decode+mips {} us -> cache read {} us\n",
+	    stats.cookedCount, stats.skippedCount, stats.failedCount, stats.sourceBytes,
+	    stats.cacheBytes, stats.decodeTime.count(), stats.cacheReadTime.count());
+	OutputDebugStringA(report.c_str());
+
+	CoUninitialize();
+	return stats.failedCount == 0 ? 0 : 1;
+}
 
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int) {
+	// -cook で起動したらアセットを調理して終了する
+	if (std::strstr(lpCmdLine, "-cook")) {
+		return CookAssets();
+	}
+	// -bench で起動したらベンチマークを実行して終了する
+	if (std::strstr(lpCmdLine, "-bench")) {
+		return Benchmark::RunAll();
+	}
+
 	WinApp* win = nullptr;
 	DirectXCommon* dxCommon = nullptr;
 	// 汎用機能
@@ -38,16 +75,25 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// オーディオの初期化
 	audio = Audio::GetInstance();
 	audio->Initialize();
+	// ミキサー方式のオーディオ（効果音・BGM）の初期化
+	AudioEngine::GetInstance()->Initialize();
 
 	// テクスチャマネージャの初期化
 	TextureManager::GetInstance()->Initialize(dxCommon->GetDevice());
 	TextureManager::Load("white1x1.png");
+	// テクスチャストリーマーの初期化（一括描画・静的メッシュ・アトラスのテクスチャ）
+	TextureStreamer::GetInstance()->Initialize(dxCommon->GetDevice());
 
 	// スプライト静的初期化
 	Sprite::StaticInitialize(dxCommon->GetDevice(), WinApp::kWindowWidth, WinApp::kWindowHeight);
+	// スプライト一括描画の初期化
+	SpriteBatch::GetInstance()->Initialize(WinApp::kWindowWidth, WinApp::kWindowHeight);
+	// デバッグ文字表示の初期化
+	DebugTextBatch::GetInstance()->Initialize(WinApp::kWindowWidth, WinApp::kWindowHeight);
 
 	// 3Dモデル静的初期化
 	Model::StaticInitialize();
+	StaticMesh::StaticInitialize();
 
 	// 軸方向表示初期化
 	axisIndicator = AxisIndicator::GetInstance();
@@ -72,6 +118,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		imguiManager->Begin();
 		// 入力関連の毎フレーム処理
 		input->Update();
+		// 非同期読み込みしたテクスチャの反映（前フレームのGPU処理は完了済み）
+		TextureStreamer::GetInstance()->Update();
 		// ゲームシーンの毎フレーム処理
 		gameScene->Update();
 		// 軸表示の更新
@@ -87,6 +135,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		axisIndicator->Draw();
 		// プリミティブ描画のリセット
 		primitiveDrawer->Reset();
+		// スプライト一括描画のリセット
+		SpriteBatch::GetInstance()->Reset();
+		// デバッグ文字表示のリセット
+		DebugTextBatch::GetInstance()->Reset();
 		// ImGui描画
 		imguiManager->Draw();
 		// 描画終了
@@ -95,6 +147,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 	// 各種解放
 	SafeDelete(gameScene);
+	DebugTextBatch::GetInstance()->Finalize();
+	SpriteBatch::GetInstance()->Finalize();
+	StaticMesh::StaticFinalize();
+	TextureStreamer::GetInstance()->Finalize();
+	AudioEngine::GetInstance()->Finalize();
 	audio->Finalize();
 	// ImGui解放
 	imguiManager->Finalize();
@@ -5,6 +5,9 @@
 //#include <random>
 //#include <sstream>
 #include "AxisIndicator.h"
+#include "DebugTextBatch.h"
+#include "SpriteBatch.h"
+#include "TextureStreamer.h"
 
 GameScene::GameScene() {}
 
@@ -25,6 +28,7 @@ GameScene::~GameScene() {
 	delete skydome_;
 	delete debugCamera_;
 	delete player_;
+	delete uiAtlas_;
 	delete model_; 
 }
 
@@ -50,6 +54,9 @@ void GameScene::Initialize() {
 
 	// ファイル名を指定してテクスチャを読み込む
 	textureHandle_ = TextureManager::Load("mario.jpg");
+	// 前景のレティクルとデバッグ文字を1枚にまとめ、テクスチャを切り替えずに描く
+	uiAtlas_ = TextureAtlas::Create("ui_atlas", {"reticle.png", "debugfont.png"});
+	DebugTextBatch::GetInstance()->SetFont(*uiAtlas_, "debugfont.png");
 
 	// 3Dモデルの生成
 	model_ = Model::Create();
@@ -59,12 +66,12 @@ void GameScene::Initialize() {
 	player_ = new Player();
 	// 自キャラの初期化
 	Vector3 playerPosition(0, 0, 30.0f);
-	player_->Initialize(model_, textureHandle_, playerPosition);
+	player_->Initialize(model_, textureHandle_, playerPosition, uiAtlas_);
 
 
 
 	// 3Dモデルの生成
-	modelSkydome_ = Model::CreateFromOBJ("skydome", true);
+	modelSkydome_ = StaticModel::CreateFromOBJ("skydome", true);
 	// 天球の生成
 	skydome_ = new Skydome();
 	skydome_->Initialize(modelSkydome_);
@@ -194,8 +201,8 @@ void GameScene::Draw() {
 #pragma endregion
 
 #pragma region 前景スプライト描画
-	// 前景スプライト描画前処理
-	Sprite::PreDraw(commandList);
+	// 前景スプライト描画前処理（UIアトラスのスプライトは一括描画する）
+	SpriteBatch::GetInstance()->PreDraw(commandList);
 
 	/// <summary>
 	/// ここに前景スプライトの描画処理を追加できる
@@ -204,7 +211,19 @@ void GameScene::Draw() {
 	player_->DrawUI();
 
 	// スプライト描画後処理
-	Sprite::PostDraw();
+	SpriteBatch::GetInstance()->PostDraw();
+
+#ifdef _DEBUG
+	// 前フレームのテクスチャ（TextureStreamer）のセット回数と切り替え回数、番号で引いた回数
+	const TextureStreamer::FrameStats& textureStats =
+	    TextureStreamer::GetInstance()->GetLastFrameStats();
+	DebugTextBatch* debugText = DebugTextBatch::GetInstance();
+	debugText->SetPos(8.0f, 8.0f);
+	debugText->Printf(
+	    "texture bind %u, switch %u, index %u", textureStats.bindCount, textureStats.switchCount,
+	    textureStats.indexCount);
+	debugText->DrawAll(commandList);
+#endif // _DEBUG
 
 #pragma endregion
 }
@@ -13,6 +13,7 @@
 #include "Enemy.h"
 #include "Skydome.h"
 #include "RailCamera.h"
+#include "TextureAtlas.h"
 
 /// <summary>
 /// ゲームシーン
@@ -91,6 +92,8 @@ private: // メンバ変数
 	ViewProjection viewProjection_;
 	// テクスチャハンドル
 	uint32_t textureHandle_ = 0u;
+	// UIアトラス（レティクルとデバッグ文字のフォント）
+	TextureAtlas* uiAtlas_ = nullptr;
 	// モデルデータ
 	Model* model_ = nullptr;
 
@@ -106,7 +109,7 @@ private: // メンバ変数
 	// 天球
 	Skydome* skydome_ = nullptr;
 	// 3Dモデル
-	Model* modelSkydome_ = nullptr;
+	StaticModel* modelSkydome_ = nullptr;
 	// レールカメラ
 	RailCamera* railCamera_ = nullptr;
 	// 弾
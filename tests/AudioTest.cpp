@@ -0,0 +1,192 @@
+#include "Resampler.h"
+#include "SoftwareMixer.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <vector>
+
+namespace {
+
+const uint32_t kSampleRate = 48000;
+
+// 受け取ったサンプルを全部とっておく出力
+class CaptureAudioOutput : public AudioOutput {
+public:
+	uint32_t GetSampleRate() const override { return kSampleRate; }
+	void Submit(const float* samples, uint32_t frameCount) override {
+		samples_.insert(samples_.end(), samples, samples + frameCount * kChannelCount);
+	}
+	const std::vector<float>& GetSamples() const { return samples_; }
+
+private:
+	std::vector<float> samples_;
+};
+
+// 正弦波（モノラル）
+std::vector<float> MakeSine(uint32_t sampleRate, float frequency, float amplitude, size_t count) {
+	std::vector<float> samples(count);
+	for (size_t i = 0; i < count; i++) {
+		samples[i] = amplitude * std::sin(2.0f * std::numbers::pi_v<float> * frequency *
+		                                  float(i) / float(sampleRate));
+	}
+	return samples;
+}
+
+// 16bit PCM モノラルのサウンドを登録する
+uint32_t AddSineSound(SoftwareMixer& mixer, uint32_t frameCount) {
+	WaveFile::Format format;
+	format.formatTag = WaveFile::kFormatPcm;
+	format.channels = 1;
+	format.samplesPerSec = kSampleRate;
+	format.bitsPerSample = 16;
+	format.blockAlign = 2;
+	format.avgBytesPerSec = kSampleRate * format.blockAlign;
+	std::vector<float> sine = MakeSine(kSampleRate, 440.0f, 0.25f, frameCount);
+	std::vector<uint8_t> data(frameCount * sizeof(int16_t));
+	for (uint32_t i = 0; i < frameCount; i++) {
+		int16_t sample = static_cast<int16_t>(std::lround(sine[i] * 32767.0f));
+		std::memcpy(&data[i * sizeof(int16_t)], &sample, sizeof(sample));
+	}
+	return mixer.AddSound(format, data);
+}
+
+// 44.1kHz から 48kHz への変換で、長さ・周波数・振幅が保たれ、SIMDの有無で結果が変わらない
+void TestResamplerPreservesTone() {
+	const uint32_t kSourceRate = 44100;
+	std::vector<float> source = MakeSine(kSourceRate, 1000.0f, 0.5f, kSourceRate);
+	Resampler resampler;
+	resampler.Initialize(kSourceRate, kSampleRate);
+	std::vector<float> converted = resampler.Convert(source, 1, true);
+	std::vector<float> scalar = resampler.Convert(source, 1, false);
+
+	TEST_CHECK(converted.size() + resampler.GetTapCount() >= kSampleRate);
+	TEST_CHECK(converted.size() <= kSampleRate + resampler.GetTapCount());
+	TEST_CHECK(converted == scalar);
+
+	// 端を除いた区間で、ゼロ交差の数と実効値を見る
+	size_t begin = resampler.GetTapCount() * 4;
+	size_t end = std::min<size_t>(converted.size(), kSampleRate) - resampler.GetTapCount() * 4;
+	uint32_t crossingCount = 0;
+	double energy = 0.0;
+	for (size_t i = begin; i < end; i++) {
+		if ((converted[i - 1] < 0.0f) != (converted[i] < 0.0f)) {
+			crossingCount++;
+		}
+		energy += double(converted[i]) * converted[i];
+	}
+	double seconds = double(end - begin) / kSampleRate;
+	TEST_CHECK(std::abs(crossingCount / seconds - 2000.0) < 5.0);
+	double rms = std::sqrt(energy / double(end - begin));
+	TEST_CHECK(std::abs(rms - 0.5 / std::numbers::sqrt2) < 0.005);
+}
+
+// 音量は出力にそのまま掛かり、SIMDの有無でミックス結果が変わらない
+void TestMixerVolumeAndSimd() {
+	const uint32_t kFrameCount = 4800;
+	std::vector<float> outputs[3];
+	const float volumes[3] = {1.0f, 0.5f, 1.0f};
+	for (int i = 0; i < 3; i++) {
+		CaptureAudioOutput output;
+		SoftwareMixer mixer;
+		mixer.Initialize(&output, 8);
+		mixer.SetUseSimd(i != 2);
+		uint32_t sound = AddSineSound(mixer, kFrameCount);
+		uint32_t voice = mixer.PlayWave(sound, false, volumes[i]);
+		TEST_CHECK(voice != 0);
+		mixer.Render(kFrameCount / 2);
+		TEST_CHECK(mixer.IsPlaying(voice));
+		mixer.Render(kFrameCount);
+		TEST_CHECK(!mixer.IsPlaying(voice));
+		outputs[i] = output.GetSamples();
+	}
+
+	float peak = 0.0f;
+	float maxVolumeError = 0.0f;
+	float maxSimdError = 0.0f;
+	for (size_t i = 0; i < outputs[0].size(); i++) {
+		peak = std::max(peak, std::abs(outputs[0][i]));
+		maxVolumeError = std::max(maxVolumeError, std::abs(outputs[0][i] * 0.5f - outputs[1][i]));
+		maxSimdError = std::max(maxSimdError, std::abs(outputs[0][i] - outputs[2][i]));
+	}
+	TEST_CHECK(peak > 0.1f);
+	TEST_CHECK(maxVolumeError < 1e-6f);
+	TEST_CHECK(maxSimdError < 1e-6f);
+}
+
+// 止めたボイスは次のブロックから鳴らない
+void TestMixerStop() {
+	CaptureAudioOutput output;
+	SoftwareMixer mixer;
+	mixer.Initialize(&output, 8);
+	uint32_t sound = AddSineSound(mixer, 4800);
+	uint32_t voice = mixer.PlayWave(sound, true);
+	mixer.Render(SoftwareMixer::kBlockFrameCount * 4);
+	TEST_CHECK(mixer.IsPlaying(voice));
+
+	mixer.StopWave(voice);
+	size_t stoppedAt = output.GetSamples().size();
+	mixer.Render(SoftwareMixer::kBlockFrameCount * 4);
+	TEST_CHECK(!mixer.IsPlaying(voice));
+	const std::vector<float>& samples = output.GetSamples();
+	TEST_CHECK(std::all_of(
+	    samples.begin() + stoppedAt, samples.end(), [](float sample) { return sample == 0.0f; }));
+}
+
+// 命令キューが一杯のときの停止は捨てたと数え、ボイスは鳴り続ける（後から止められる）
+void TestStopWithFullQueue() {
+	CaptureAudioOutput output;
+	SoftwareMixer mixer;
+	mixer.Initialize(&output, 8);
+	uint32_t sound = AddSineSound(mixer, 4800);
+	uint32_t voice = mixer.PlayWave(sound, true, 0.5f);
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+
+	for (uint32_t i = 0; i < SoftwareMixer::kCommandQueueSize; i++) {
+		mixer.SetVolume(voice, 0.5f);
+	}
+	uint64_t droppedBefore = mixer.GetStats().droppedCommandCount;
+	mixer.StopWave(voice);
+	TEST_CHECK(mixer.GetStats().droppedCommandCount == droppedBefore + 1);
+	TEST_CHECK(mixer.IsPlaying(voice));
+
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+	mixer.StopWave(voice);
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+	TEST_CHECK(!mixer.IsPlaying(voice));
+}
+
+// 同時再生数の上限に達したら、同じサウンドの最も古いボイスを鳴らし直す
+void TestSoundLimit() {
+	CaptureAudioOutput output;
+	SoftwareMixer mixer;
+	mixer.Initialize(&output, 8);
+	uint32_t sound = AddSineSound(mixer, 4800);
+	mixer.SetSoundLimit(sound, 2);
+
+	uint32_t first = mixer.PlayWave(sound);
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+	uint32_t second = mixer.PlayWave(sound);
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+	uint32_t third = mixer.PlayWave(sound);
+	mixer.Render(SoftwareMixer::kBlockFrameCount);
+
+	TEST_CHECK(!mixer.IsPlaying(first));
+	TEST_CHECK(mixer.IsPlaying(second));
+	TEST_CHECK(mixer.IsPlaying(third));
+	SoftwareMixer::Stats stats = mixer.GetStats();
+	TEST_CHECK(stats.instanceLimitCount == 1);
+	TEST_CHECK(stats.activeVoiceCount == 2);
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestResamplerPreservesTone);
+	TEST_RUN(TestMixerVolumeAndSimd);
+	TEST_RUN(TestMixerStop);
+	TEST_RUN(TestStopWithFullQueue);
+	TEST_RUN(TestSoundLimit);
+	return TestResult();
+}
@@ -0,0 +1,165 @@
+#include "ClusteredLighting.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int kWindowWidth = 1280;
+const int kWindowHeight = 720;
+const float kNearZ = 0.1f;
+const float kFarZ = 1000.0f;
+const float kFovY = 45.0f * 3.14159265f / 180.0f;
+
+// 単位行列のビューと左手系の透視投影
+void SetUpViewProjection(ViewProjection& viewProjection) {
+	std::memset(&viewProjection.matView, 0, sizeof(Matrix4x4));
+	for (int i = 0; i < 4; i++) {
+		viewProjection.matView.m[i][i] = 1.0f;
+	}
+	float scaleY = 1.0f / std::tan(kFovY / 2.0f);
+	float aspect = float(kWindowWidth) / float(kWindowHeight);
+	std::memset(&viewProjection.matProjection, 0, sizeof(Matrix4x4));
+	viewProjection.matProjection.m[0][0] = scaleY / aspect;
+	viewProjection.matProjection.m[1][1] = scaleY;
+	viewProjection.matProjection.m[2][2] = kFarZ / (kFarZ - kNearZ);
+	viewProjection.matProjection.m[2][3] = 1.0f;
+	viewProjection.matProjection.m[3][2] = -kNearZ * kFarZ / (kFarZ - kNearZ);
+}
+
+// ライトを乱数で並べる（視錐台の外に出るものも混ぜる）
+void AddRandomLights(ClusteredLighting& lighting) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (int i = 0; i < 700; i++) {
+		PointLight light;
+		light.SetLightPos({unit(random) * 200 - 100, unit(random) * 40 - 20, unit(random) * 200});
+		light.SetLightAtten({1.0f, 0.0f, 2.0f + 4.0f * unit(random)});
+		light.SetActive(true);
+		lighting.GetPointLights().push_back(light);
+	}
+	for (int i = 0; i < 200; i++) {
+		SpotLight light;
+		light.SetLightPos({unit(random) * 200 - 100, 10.0f, unit(random) * 200});
+		light.SetLightDir({0.0f, -1.0f, 0.0f});
+		light.SetLightAtten({1.0f, 0.0f, 2.0f});
+		light.SetLightFactorAngle({0.3f, 0.6f});
+		light.SetActive(true);
+		lighting.GetSpotLights().push_back(light);
+	}
+	for (int i = 0; i < 100; i++) {
+		CircleShadow shadow;
+		shadow.SetCasterPos({unit(random) * 200 - 100, 1.0f, unit(random) * 200});
+		shadow.SetDir({0.0f, -1.0f, 0.0f});
+		shadow.SetAtten({1.0f, 1.0f, 1.0f});
+		shadow.SetDistanceCasterLight(10.0f);
+		shadow.SetFactorAngle({0.1f, 0.2f});
+		shadow.SetActive(true);
+		lighting.GetCircleShadows().push_back(shadow);
+	}
+}
+
+// SIMDの有無・スレッド数によらず区画分けの結果が同じ
+void TestBuildModesMatch() {
+	ViewProjection viewProjection;
+	SetUpViewProjection(viewProjection);
+	ClusteredLighting lighting;
+	lighting.Initialize(kWindowWidth, kWindowHeight);
+	AddRandomLights(lighting);
+
+	lighting.SetUseSimd(false);
+	lighting.SetThreadCount(1);
+	lighting.Build(viewProjection);
+	std::vector<ClusteredLighting::ClusterHeader> headers = lighting.GetClusterHeaders();
+	std::vector<uint32_t> indices = lighting.GetLightIndices();
+	TEST_CHECK(headers.size() == ClusteredLighting::kClusterCount);
+	TEST_CHECK(lighting.GetStats().lightCount > 0);
+	TEST_CHECK(lighting.GetStats().culledLightCount > 0);
+
+	for (bool useSimd : {false, true}) {
+		for (uint32_t threadCount : {1u, 4u, 0u}) {
+			lighting.SetUseSimd(useSimd);
+			lighting.SetThreadCount(threadCount);
+			lighting.Build(viewProjection);
+			TEST_CHECK(
+			    std::memcmp(
+			        headers.data(), lighting.GetClusterHeaders().data(),
+			        headers.size() * sizeof(ClusteredLighting::ClusterHeader)) == 0);
+			TEST_CHECK(lighting.GetLightIndices() == indices);
+		}
+	}
+}
+
+// 画面上の点に届く点光源は、その点が属する区画の一覧に必ず入っている
+void TestPointLightsCovered() {
+	ViewProjection viewProjection;
+	SetUpViewProjection(viewProjection);
+	ClusteredLighting lighting;
+	lighting.Initialize(kWindowWidth, kWindowHeight);
+	AddRandomLights(lighting);
+	lighting.Build(viewProjection);
+
+	const std::vector<ClusteredLighting::ClusterHeader>& headers = lighting.GetClusterHeaders();
+	const std::vector<uint32_t>& indices = lighting.GetLightIndices();
+	const std::vector<PointLight>& pointLights = lighting.GetPointLights();
+	const float scaleX = viewProjection.matProjection.m[0][0];
+	const float scaleY = viewProjection.matProjection.m[1][1];
+	const float logRatio = std::log(kFarZ / kNearZ);
+
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	int checkCount = 0;
+	int missCount = 0;
+	for (int i = 0; i < 50000; i++) {
+		// 画面上の位置と奥行きから、ビュー空間の点と区画を求める
+		float pixelX = unit(random) * kWindowWidth;
+		float pixelY = unit(random) * kWindowHeight;
+		float z = kNearZ * std::pow(kFarZ / kNearZ, unit(random));
+		float x = (pixelX / kWindowWidth * 2.0f - 1.0f) * z / scaleX;
+		float y = (1.0f - pixelY / kWindowHeight * 2.0f) * z / scaleY;
+		uint32_t tileX = std::min(
+		    ClusteredLighting::kClusterCountX - 1,
+		    uint32_t(pixelX * ClusteredLighting::kClusterCountX / kWindowWidth));
+		uint32_t tileY = std::min(
+		    ClusteredLighting::kClusterCountY - 1,
+		    uint32_t(pixelY * ClusteredLighting::kClusterCountY / kWindowHeight));
+		int slice = std::clamp(
+		    int(std::floor(
+		        std::log(z / kNearZ) / logRatio * float(ClusteredLighting::kClusterCountZ))),
+		    0, int(ClusteredLighting::kClusterCountZ) - 1);
+		const ClusteredLighting::ClusterHeader& header =
+		    headers[(slice * ClusteredLighting::kClusterCountY + tileY) *
+		                ClusteredLighting::kClusterCountX +
+		            tileX];
+
+		for (uint32_t light = 0; light < pointLights.size(); light++) {
+			const Vector3& position = pointLights[light].GetLightPos();
+			float dx = position.x - x;
+			float dy = position.y - y;
+			float dz = position.z - z;
+			float range =
+			    ClusteredLighting::CalculateRange(pointLights[light].GetLightAtten(), 1.0f);
+			if (dx * dx + dy * dy + dz * dz > range * range) {
+				continue;
+			}
+			checkCount++;
+			const uint32_t* begin = indices.data() + header.offset;
+			if (std::find(begin, begin + header.pointCount, light) == begin + header.pointCount) {
+				missCount++;
+			}
+		}
+	}
+	TEST_CHECK(checkCount > 0);
+	TEST_CHECK(missCount == 0);
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestBuildModesMatch);
+	TEST_RUN(TestPointLightsCovered);
+	return TestResult();
+}
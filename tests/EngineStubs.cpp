@@ -0,0 +1,33 @@
+#include "CircleShadow.h"
+#include "DirectXCommon.h"
+#include "Material.h"
+#include "MathUtilityForText.h"
+#include "Mesh.h"
+#include "SpotLight.h"
+#include "StringUtility.h"
+
+///
+/// エンジンライブラリの関数のうち、テスト対象が参照するものの代わり。
+/// テストでは GPU リソースを作らないので、呼ばれない前提の関数は何もしない。
+///
+
+Material* Material::Create() { return new Material(); }
+void Material::LoadTexture(const std::string&) {}
+void Material::Update() {}
+
+void Mesh::SetName(const std::string&) {}
+void Mesh::AddVertex(const VertexPosNormalUv&) {}
+void Mesh::AddIndex(unsigned short) {}
+void Mesh::SetMaterial(Material*) {}
+void Mesh::CreateBuffers() {}
+
+DirectXCommon* DirectXCommon::GetInstance() { return nullptr; }
+
+// 読み込み失敗のメッセージにしか使わないので、1バイトずつ広げるだけにする
+std::wstring ConvertStringMultiByteToWide(const std::string& str) {
+	return std::wstring(str.begin(), str.end());
+}
+
+// ライトの向きはエンジンと同じく正規化して持つ
+void SpotLight::SetLightDir(const Vector3& lightdir) { lightDir_ = Normalize(lightdir); }
+void CircleShadow::SetDir(const Vector3& dir) { dir_ = Normalize(dir); }
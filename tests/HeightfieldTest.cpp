@@ -0,0 +1,164 @@
+#include "Heightfield.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 試験用の地形（幅200・奥行150・高さ30、301x257頂点）
+void InitializeField(Heightfield& heightfield, uint32_t seed) {
+	heightfield.Initialize(200.0f, 150.0f, 30.0f, 301, 257);
+	heightfield.SetSeed(seed);
+	heightfield.DeformRandom(20);
+}
+
+// AVX2 の Perlin ノイズが1サンプルずつの計算と一致する
+void TestPerlinSimdMatchesScalar() {
+	if (!Heightfield::IsAvx2Supported()) {
+		std::printf("AVX2 not supported, skipped\n");
+		return;
+	}
+	Heightfield heightfield;
+	InitializeField(heightfield, 1);
+
+	// X座標の計算も含めて比べるため、どちらも PerlinRow で求める（地形の生成と同じ経路）
+	const uint32_t kCount = 203;
+	std::vector<float> row(kCount);
+	std::vector<float> scalarRow(kCount);
+	float maxError = 0.0f;
+	for (float y = 0.0f; y < 19.0f; y += 0.37f) {
+		heightfield.SetUseSimd(true);
+		heightfield.PerlinRow(0.01f, 0.093f, y, kCount, row.data());
+		heightfield.SetUseSimd(false);
+		heightfield.PerlinRow(0.01f, 0.093f, y, kCount, scalarRow.data());
+		for (uint32_t i = 0; i < kCount; i++) {
+			maxError = std::max(maxError, std::abs(row[i] - scalarRow[i]));
+		}
+	}
+	TEST_CHECK(maxError < 1e-5f);
+}
+
+// 生成結果はスレッド数によらず同じ
+void TestDeformIndependentOfThreadCount() {
+	Heightfield single;
+	single.SetThreadCount(1);
+	InitializeField(single, 7);
+	Heightfield parallel;
+	parallel.SetThreadCount(0);
+	InitializeField(parallel, 7);
+
+	TEST_CHECK(single.GetVertices().size() == parallel.GetVertices().size());
+	TEST_CHECK(
+	    std::memcmp(
+	        single.GetVertices().data(), parallel.GetVertices().data(),
+	        single.GetVertices().size() * sizeof(Heightfield::VertexPosNormalUv)) == 0);
+	TEST_CHECK(single.GetIndices() == parallel.GetIndices());
+}
+
+// 頂点上の高さは頂点の高さと一致する（ブラシで書き換えた後も）
+void TestGetHeightAtVertices() {
+	Heightfield heightfield;
+	InitializeField(heightfield, 9);
+	heightfield.ApplyBrush(Heightfield::BrushMode::kRaise, 10.0f, 10.0f, 15.0f, 10.0f);
+
+	int mismatchCount = 0;
+	for (uint32_t z = 0; z < heightfield.GetVertexCountVertical(); z += 7) {
+		for (uint32_t x = 0; x < heightfield.GetVertexCountHorizontal(); x += 5) {
+			const Vector3& pos = heightfield.GetVertex(x, z).pos;
+			if (std::abs(heightfield.GetHeight(pos.x, pos.z) - pos.y) > 1e-4f) {
+				mismatchCount++;
+			}
+		}
+	}
+	TEST_CHECK(mismatchCount == 0);
+}
+
+// 当たった点が線分上にあり、そのマスの四隅の高さの範囲に収まるか
+bool IsOnCell(
+    const Heightfield& heightfield, const Heightfield::Ray& ray,
+    const Heightfield::RaycastHit& hit) {
+	const Vector3& position = hit.position;
+	if (std::abs(ray.origin.x + ray.delta.x * hit.t - position.x) > 1e-3f ||
+	    std::abs(ray.origin.y + ray.delta.y * hit.t - position.y) > 1e-3f ||
+	    std::abs(ray.origin.z + ray.delta.z * hit.t - position.z) > 1e-3f) {
+		return false;
+	}
+	uint32_t countX = heightfield.GetVertexCountHorizontal();
+	uint32_t countZ = heightfield.GetVertexCountVertical();
+	const Vector3& first = heightfield.GetVertex(0, 0).pos;
+	const Vector3& last = heightfield.GetVertex(countX - 1, countZ - 1).pos;
+	float gx = (position.x - first.x) / (last.x - first.x) * float(countX - 1);
+	float gz = (position.z - first.z) / (last.z - first.z) * float(countZ - 1);
+	uint32_t cx = std::min(uint32_t(std::clamp(gx, 0.0f, float(countX - 1))), countX - 2);
+	uint32_t cz = std::min(uint32_t(std::clamp(gz, 0.0f, float(countZ - 1))), countZ - 2);
+	float heights[4] = {
+	    heightfield.GetVertex(cx, cz).pos.y, heightfield.GetVertex(cx + 1, cz).pos.y,
+	    heightfield.GetVertex(cx, cz + 1).pos.y, heightfield.GetVertex(cx + 1, cz + 1).pos.y};
+	auto [low, high] = std::minmax_element(std::begin(heights), std::end(heights));
+	return *low - 1e-3f <= position.y && position.y <= *high + 1e-3f;
+}
+
+// まとめたレイキャスト（並列）は1本ずつの結果と一致し、高さピラミッドを使っても変わらない
+void TestRaycastBatch() {
+	Heightfield heightfield;
+	InitializeField(heightfield, 9);
+
+	const uint32_t kRayCount = 5000;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> rangeX(-120.0f, 120.0f);
+	std::uniform_real_distribution<float> rangeY(-10.0f, 60.0f);
+	std::uniform_real_distribution<float> rangeZ(-90.0f, 90.0f);
+	std::vector<Heightfield::Ray> rays(kRayCount);
+	for (Heightfield::Ray& ray : rays) {
+		ray.origin = {rangeX(random), rangeY(random), rangeZ(random)};
+		Vector3 end = {rangeX(random), rangeY(random) - 20.0f, rangeZ(random)};
+		ray.delta = {end.x - ray.origin.x, end.y - ray.origin.y, end.z - ray.origin.z};
+	}
+
+	std::vector<Heightfield::RaycastHit> batchHits(kRayCount);
+	uint32_t hitCount = heightfield.RaycastBatch(rays.data(), batchHits.data(), kRayCount);
+	TEST_CHECK(hitCount > 0);
+	TEST_CHECK(hitCount < kRayCount);
+
+	int mismatchCount = 0;
+	int offSurfaceCount = 0;
+	for (uint32_t i = 0; i < kRayCount; i++) {
+		Heightfield::RaycastHit hit;
+		bool isHit = heightfield.Raycast(rays[i], &hit);
+		if (isHit != batchHits[i].hit || (isHit && hit.t != batchHits[i].t)) {
+			mismatchCount++;
+		}
+		// 当たった点は線分上にあり、高さはそのマスの四隅の高さの範囲に収まる
+		// （GetHeight は双線形補間なので三角形の面とは一致しない）
+		if (batchHits[i].hit && !IsOnCell(heightfield, rays[i], batchHits[i])) {
+			offSurfaceCount++;
+		}
+	}
+	TEST_CHECK(mismatchCount == 0);
+	TEST_CHECK(offSurfaceCount == 0);
+
+	heightfield.SetUseHeightPyramid(true);
+	std::vector<Heightfield::RaycastHit> pyramidHits(kRayCount);
+	TEST_CHECK(heightfield.RaycastBatch(rays.data(), pyramidHits.data(), kRayCount) == hitCount);
+	mismatchCount = 0;
+	for (uint32_t i = 0; i < kRayCount; i++) {
+		if (pyramidHits[i].hit != batchHits[i].hit ||
+		    (pyramidHits[i].hit && std::abs(pyramidHits[i].t - batchHits[i].t) > 1e-5f)) {
+			mismatchCount++;
+		}
+	}
+	TEST_CHECK(mismatchCount == 0);
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestPerlinSimdMatchesScalar);
+	TEST_RUN(TestDeformIndependentOfThreadCount);
+	TEST_RUN(TestGetHeightAtVertices);
+	TEST_RUN(TestRaycastBatch);
+	return TestResult();
+}
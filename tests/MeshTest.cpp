@@ -0,0 +1,332 @@
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// 三角形を頂点座標の組で表す（頂点の統合・並べ替えの前後で比べるため、回転を正規化する）
+using TriangleKey = std::array<float, 9>;
+
+std::vector<TriangleKey> MakeTriangleKeys(
+    const std::vector<Mesh::VertexPosNormalUv>& vertices, const std::vector<uint32_t>& indices) {
+	std::vector<TriangleKey> keys;
+	keys.reserve(indices.size() / 3);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		std::array<std::array<float, 3>, 3> corners;
+		for (size_t k = 0; k < 3; k++) {
+			const Vector3& pos = vertices[indices[i + k]].pos;
+			corners[k] = {pos.x, pos.y, pos.z};
+		}
+		// 向きを保ったまま、最小の頂点が先頭に来るよう回す
+		size_t first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+		TriangleKey key;
+		for (size_t k = 0; k < 3; k++) {
+			std::copy(corners[(first + k) % 3].begin(), corners[(first + k) % 3].end(),
+			          key.begin() + k * 3);
+		}
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+// 格子状のOBJを書き出す（division×division 四角形、(division+1)^2 頂点）
+bool WriteGridObj(const std::string& modelname, uint32_t division) {
+	const std::string directoryPath = ObjLoader::GetDirectoryPath(modelname);
+	std::filesystem::create_directories(directoryPath);
+	std::ofstream file(directoryPath + modelname + ".obj");
+	if (!file) {
+		return false;
+	}
+	for (uint32_t z = 0; z <= division; z++) {
+		for (uint32_t x = 0; x <= division; x++) {
+			float u = float(x) / division;
+			float v = float(z) / division;
+			file << "v " << u * 100.0f << " " << std::sin(u * 20.0f) * std::cos(v * 20.0f) << " "
+			     << v * 100.0f << "\nvt " << u << " " << v << "\n";
+		}
+	}
+	file << "vn 0 1 0\n";
+	for (uint32_t z = 0; z < division; z++) {
+		for (uint32_t x = 0; x < division; x++) {
+			uint32_t i = z * (division + 1) + x + 1;
+			uint32_t j = i + division + 1;
+			file << "f " << i << "/" << i << "/1 " << j << "/" << j << "/1 " << j + 1 << "/"
+			     << j + 1 << "/1 " << i + 1 << "/" << i + 1 << "/1\n";
+		}
+	}
+	return bool(file);
+}
+
+// 面毎に頂点を持つ格子（並びはシャッフル）を統合・並べ替えしても三角形が変わらず、ACMRが下がる
+void TestOptimizeGrid() {
+	const uint32_t kDivision = 100;
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y < kDivision; y++) {
+		for (uint32_t x = 0; x < kDivision; x++) {
+			uint32_t a = y * (kDivision + 1) + x;
+			uint32_t c = a + kDivision + 1;
+			triangles.push_back({a, a + 1, c});
+			triangles.push_back({a + 1, c + 1, c});
+		}
+	}
+	std::mt19937 random(1);
+	std::shuffle(triangles.begin(), triangles.end(), random);
+
+	std::vector<Mesh::VertexPosNormalUv> vertices;
+	std::vector<uint32_t> indices;
+	for (const std::array<uint32_t, 3>& triangle : triangles) {
+		for (uint32_t corner : triangle) {
+			Mesh::VertexPosNormalUv vertex{};
+			vertex.pos = {float(corner % (kDivision + 1)), float(corner / (kDivision + 1)), 0.0f};
+			vertex.normal = {0.0f, 0.0f, 1.0f};
+			indices.push_back(static_cast<uint32_t>(vertices.size()));
+			vertices.push_back(vertex);
+		}
+	}
+	std::vector<TriangleKey> before = MakeTriangleKeys(vertices, indices);
+
+	MeshOptimizer::Stats stats = MeshOptimizer::Optimize(vertices, indices);
+	TEST_CHECK(stats.triangleCount == triangles.size());
+	TEST_CHECK(stats.vertexCountAfter == size_t(kDivision + 1) * (kDivision + 1));
+	TEST_CHECK(vertices.size() == stats.vertexCountAfter);
+	TEST_CHECK(stats.GetACMRAfter() < stats.GetACMRBefore());
+	TEST_CHECK(stats.GetACMRAfter() < 1.0f);
+	TEST_CHECK(std::all_of(
+	    indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); }));
+	TEST_CHECK(MakeTriangleKeys(vertices, indices) == before);
+}
+
+// 基数ソートによる法線の平均が、座標番号毎に足し合わせた結果と一致する（スレッド数によらない）
+void TestSmoothNormals() {
+	const size_t kVertexCount = 300000;
+	std::mt19937 random(3);
+	std::uniform_int_distribution<uint32_t> positionDistribution(0, 50000);
+	std::uniform_real_distribution<float> normalDistribution(-1.0f, 1.0f);
+	std::vector<Mesh::VertexPosNormalUv> vertices(kVertexCount);
+	std::vector<uint32_t> positionIndices(kVertexCount);
+	for (size_t i = 0; i < kVertexCount; i++) {
+		positionIndices[i] = positionDistribution(random);
+		vertices[i].normal = {
+		    normalDistribution(random), normalDistribution(random), normalDistribution(random)};
+	}
+
+	std::unordered_map<uint32_t, Vector3> sums;
+	for (size_t i = 0; i < kVertexCount; i++) {
+		Vector3& sum = sums[positionIndices[i]];
+		sum.x += vertices[i].normal.x;
+		sum.y += vertices[i].normal.y;
+		sum.z += vertices[i].normal.z;
+	}
+
+	for (uint32_t threadCount : {1u, 0u}) {
+		std::vector<Mesh::VertexPosNormalUv> smoothed = vertices;
+		MeshOptimizer::SmoothNormals(smoothed, positionIndices, threadCount);
+		float maxError = 0.0f;
+		for (size_t i = 0; i < kVertexCount; i++) {
+			const Vector3& sum = sums[positionIndices[i]];
+			float length = std::sqrt(sum.x * sum.x + sum.y * sum.y + sum.z * sum.z);
+			if (length == 0.0f) {
+				continue;
+			}
+			maxError = std::max(
+			    {maxError, std::abs(smoothed[i].normal.x - sum.x / length),
+			     std::abs(smoothed[i].normal.y - sum.y / length),
+			     std::abs(smoothed[i].normal.z - sum.z / length)});
+		}
+		TEST_CHECK(maxError < 1e-4f);
+	}
+}
+
+// 100万頂点のOBJを読み込んで、32bitインデックスのままキャッシュを往復できる
+void TestLargeMesh() {
+	const std::string kModelname = "test_large_grid";
+	const uint32_t kDivision = 999;
+	const size_t kVertexCount = size_t(kDivision + 1) * (kDivision + 1);
+	TEST_CHECK(WriteGridObj(kModelname, kDivision));
+
+	ObjLoader::ModelData modelData;
+	TEST_CHECK(ObjLoader::LoadFromSource(kModelname, false, modelData));
+	TEST_CHECK(modelData.meshes.size() == 1);
+	if (modelData.meshes.size() != 1) {
+		return;
+	}
+	const ObjLoader::MeshData& mesh = modelData.meshes[0];
+	TEST_CHECK(mesh.vertices.size() == kVertexCount);
+	TEST_CHECK(mesh.indices.size() == size_t(kDivision) * kDivision * 6);
+	TEST_CHECK(std::all_of(mesh.indices.begin(), mesh.indices.end(), [&](uint32_t index) {
+		return index < mesh.vertices.size();
+	}));
+	// 16bitで折り返していれば 0x10000 以上の番号は現れない
+	TEST_CHECK(*std::max_element(mesh.indices.begin(), mesh.indices.end()) == kVertexCount - 1);
+
+	// マッピングしたままでは消せないので、読み取りはブロックの中で閉じる
+	{
+		MeshCache::Reader reader;
+		TEST_CHECK(reader.Open(ObjLoader::GetCachePath(kModelname), false));
+		TEST_CHECK(reader.GetMeshes().size() == 1);
+		if (reader.GetMeshes().size() == 1) {
+			const MeshCache::MeshView& view = reader.GetMeshes()[0];
+			TEST_CHECK(view.vertexCount == kVertexCount);
+			TEST_CHECK(view.indexSize == sizeof(uint32_t));
+			TEST_CHECK(view.indexCount == mesh.indices.size());
+			TEST_CHECK(std::equal(
+			    mesh.indices.begin(), mesh.indices.end(),
+			    static_cast<const uint32_t*>(view.indices)));
+		}
+		// 平滑化フラグが違うキャッシュは使わない
+		MeshCache::Reader smoothingReader;
+		TEST_CHECK(!smoothingReader.Open(ObjLoader::GetCachePath(kModelname), true));
+	}
+
+	std::filesystem::remove_all(ObjLoader::GetDirectoryPath(kModelname));
+}
+
+// 小さいメッシュは16bitインデックスでキャッシュされ、読み戻すと元と一致する
+void TestSmallMeshCache() {
+	const std::string kModelname = "test_small_grid";
+	TEST_CHECK(WriteGridObj(kModelname, 10));
+
+	ObjLoader::ModelData modelData;
+	TEST_CHECK(ObjLoader::LoadFromSource(kModelname, true, modelData));
+	{
+		MeshCache::Reader reader;
+		TEST_CHECK(reader.Open(ObjLoader::GetCachePath(kModelname), true));
+		if (reader.GetMeshes().size() == 1 && modelData.meshes.size() == 1) {
+			TEST_CHECK(reader.GetMeshes()[0].indexSize == sizeof(uint16_t));
+			ObjLoader::ModelData copied;
+			reader.CopyTo(copied);
+			TEST_CHECK(copied.meshes[0].indices == modelData.meshes[0].indices);
+			TEST_CHECK(
+			    std::memcmp(
+			        copied.meshes[0].vertices.data(), modelData.meshes[0].vertices.data(),
+			        modelData.meshes[0].vertices.size() * sizeof(Mesh::VertexPosNormalUv)) == 0);
+		}
+	}
+
+	std::filesystem::remove_all(ObjLoader::GetDirectoryPath(kModelname));
+}
+
+// 更新時刻だけが変わった場合はハッシュで有効と判定し、記録を書き直して次回は時刻で判定する
+void TestCacheStampRewrite() {
+	const std::string kModelname = "test_stamp_grid";
+	TEST_CHECK(WriteGridObj(kModelname, 10));
+	const std::string objPath = ObjLoader::GetDirectoryPath(kModelname) + kModelname + ".obj";
+	const std::string cachePath = ObjLoader::GetCachePath(kModelname);
+
+	ObjLoader::ModelData modelData;
+	TEST_CHECK(ObjLoader::LoadFromSource(kModelname, false, modelData));
+	std::filesystem::last_write_time(
+	    objPath, std::filesystem::last_write_time(objPath) + std::chrono::seconds(10));
+
+	MeshCache::SourceFile source;
+	TEST_CHECK(MeshCache::GetSourceFile(objPath, source));
+	{
+		MeshCache::Reader reader;
+		TEST_CHECK(reader.Open(cachePath, false));
+	}
+	// 書き直した記録を直接読んで確かめる（ヘッダの直後に size, writeTime の順で並ぶ）
+	std::vector<char> bytes;
+	{
+		std::ifstream cache(cachePath, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(cache), std::istreambuf_iterator<char>());
+	}
+	bool stampFound = false;
+	for (size_t i = 0; i + sizeof(uint64_t) + sizeof(int64_t) <= bytes.size(); i++) {
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		std::memcpy(&size, bytes.data() + i, sizeof(size));
+		std::memcpy(&writeTime, bytes.data() + i + sizeof(size), sizeof(writeTime));
+		if (size == source.size && writeTime == source.writeTime) {
+			stampFound = true;
+			break;
+		}
+	}
+	TEST_CHECK(stampFound);
+
+	// 内容が変われば無効
+	{
+		std::ofstream file(objPath, std::ios::app);
+		file << "v 0 0 0\n";
+	}
+	{
+		MeshCache::Reader reader;
+		TEST_CHECK(!reader.Open(cachePath, false));
+	}
+
+	std::filesystem::remove_all(ObjLoader::GetDirectoryPath(kModelname));
+}
+
+// 2頂点しかない面を含むOBJは読み込みに失敗する（後の面の三角形がずれたまま使われない）
+void TestShortFaceRejected() {
+	const std::string kModelname = "test_short_face";
+	const std::string directoryPath = ObjLoader::GetDirectoryPath(kModelname);
+	std::filesystem::create_directories(directoryPath);
+	{
+		std::ofstream file(directoryPath + kModelname + ".obj");
+		file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n"
+		     << "f 1/1/1 2/1/1\nf 1/1/1 2/1/1 3/1/1\n";
+	}
+
+	ObjLoader::ModelData modelData;
+	TEST_CHECK(!ObjLoader::LoadFromSource(kModelname, false, modelData));
+	TEST_CHECK(!std::filesystem::exists(ObjLoader::GetCachePath(kModelname)));
+
+	std::filesystem::remove_all(directoryPath);
+}
+
+// 頂点数以上のインデックスを含むキャッシュは使わず、OBJから読み直す
+void TestCorruptCacheIndexRejected() {
+	const std::string kModelname = "test_corrupt_grid";
+	TEST_CHECK(WriteGridObj(kModelname, 10));
+	const std::string cachePath = ObjLoader::GetCachePath(kModelname);
+
+	ObjLoader::ModelData modelData;
+	TEST_CHECK(ObjLoader::LoadFromSource(kModelname, false, modelData));
+	// 1メッシュの16bitインデックスはファイルの末尾に並ぶので、最後の番号を範囲外にする
+	{
+		std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(-static_cast<std::streamoff>(sizeof(uint16_t)), std::ios::end);
+		const uint16_t kOutOfRange = 0xFFFF;
+		file.write(reinterpret_cast<const char*>(&kOutOfRange), sizeof(kOutOfRange));
+		TEST_CHECK(bool(file));
+	}
+	{
+		MeshCache::Reader reader;
+		TEST_CHECK(!reader.Open(cachePath, false));
+	}
+
+	ObjLoader::ModelData reloaded;
+	TEST_CHECK(ObjLoader::Load(kModelname, false, reloaded));
+	TEST_CHECK(!ObjLoader::GetLastLoadStats().cacheHit);
+	if (reloaded.meshes.size() == 1 && modelData.meshes.size() == 1) {
+		TEST_CHECK(reloaded.meshes[0].indices == modelData.meshes[0].indices);
+	}
+
+	std::filesystem::remove_all(ObjLoader::GetDirectoryPath(kModelname));
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestOptimizeGrid);
+	TEST_RUN(TestSmoothNormals);
+	TEST_RUN(TestLargeMesh);
+	TEST_RUN(TestSmallMeshCache);
+	TEST_RUN(TestCacheStampRewrite);
+	TEST_RUN(TestShortFaceRejected);
+	TEST_RUN(TestCorruptCacheIndexRejected);
+	return TestResult();
+}
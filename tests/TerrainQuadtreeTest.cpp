@@ -0,0 +1,226 @@
+#include "MathUtilityForText.h"
+#include "TerrainQuadtree.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 2のべき乗でない大きさにして、地形外の子を持つノードも通す
+const uint32_t kChunkCountX = 37;
+const uint32_t kChunkCountZ = 23;
+const float kChunkWidth = 64.0f;
+const float kNearZ = 0.1f;
+const float kFarZ = 1000.0f;
+const float kFovY = 45.0f * 3.14159265f / 180.0f;
+const float kAspect = 16.0f / 9.0f;
+
+// チャンクのAABB（テスト側の正解）
+struct Bounds {
+	Vector3 min;
+	Vector3 max;
+};
+
+// 左手系の透視投影
+Matrix4x4 MakeProjection() {
+	Matrix4x4 matrix;
+	std::memset(&matrix, 0, sizeof(Matrix4x4));
+	float scaleY = 1.0f / std::tan(kFovY / 2.0f);
+	matrix.m[0][0] = scaleY / kAspect;
+	matrix.m[1][1] = scaleY;
+	matrix.m[2][2] = kFarZ / (kFarZ - kNearZ);
+	matrix.m[2][3] = 1.0f;
+	matrix.m[3][2] = -kNearZ * kFarZ / (kFarZ - kNearZ);
+	return matrix;
+}
+
+// 平らな格子に乱数の高さを持たせて四分木に設定する
+std::vector<Bounds> SetUpRandomBounds(TerrainQuadtree& quadtree, std::mt19937& random) {
+	std::uniform_real_distribution<float> height(-40.0f, 40.0f);
+	quadtree.Initialize(kChunkCountX, kChunkCountZ);
+	std::vector<Bounds> bounds(size_t(kChunkCountX) * kChunkCountZ);
+	for (uint32_t cz = 0; cz < kChunkCountZ; cz++) {
+		for (uint32_t cx = 0; cx < kChunkCountX; cx++) {
+			float y0 = height(random);
+			float y1 = height(random);
+			Bounds& chunk = bounds[size_t(cz) * kChunkCountX + cx];
+			chunk.min = {cx * kChunkWidth, std::min(y0, y1), cz * kChunkWidth};
+			chunk.max = {(cx + 1) * kChunkWidth, std::max(y0, y1), (cz + 1) * kChunkWidth};
+			quadtree.SetChunkBounds(cx, cz, chunk.min, chunk.max);
+		}
+	}
+	return bounds;
+}
+
+// 全チャンクのAABBを合わせたもの
+Bounds UnionBounds(const std::vector<Bounds>& bounds) {
+	Bounds result = bounds[0];
+	for (const Bounds& chunk : bounds) {
+		result.min = {
+		    std::min(result.min.x, chunk.min.x), std::min(result.min.y, chunk.min.y),
+		    std::min(result.min.z, chunk.min.z)};
+		result.max = {
+		    std::max(result.max.x, chunk.max.x), std::max(result.max.y, chunk.max.y),
+		    std::max(result.max.z, chunk.max.z)};
+	}
+	return result;
+}
+
+bool operator==(const Vector3& lhs, const Vector3& rhs) {
+	return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+}
+
+// 見えるチャンク・LOD・辺のつなぎ方が全チャンクを1つずつ調べた結果と同じ
+void TestSelectMatchesBruteForce() {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	TerrainQuadtree quadtree;
+	std::vector<Bounds> bounds = SetUpRandomBounds(quadtree, random);
+	Matrix4x4 matProjection = MakeProjection();
+
+	std::vector<TerrainQuadtree::VisibleChunk> visibleChunks;
+	int visibleTotal = 0;
+	for (int i = 0; i < 200; i++) {
+		// 地形の上や外から、乱数の向きで見る（切り替え距離はチャンクの幅より短いものも混ぜる）
+		Vector3 eye = {
+		    (unit(random) * 1.4f - 0.2f) * kChunkCountX * kChunkWidth,
+		    unit(random) * 300.0f - 50.0f,
+		    (unit(random) * 1.4f - 0.2f) * kChunkCountZ * kChunkWidth};
+		Vector3 rotation = {unit(random) * 1.5f - 0.2f, unit(random) * 6.28f, 0.0f};
+		Matrix4x4 matView = Inverse(MakeAffineMatrix({1.0f, 1.0f, 1.0f}, rotation, eye));
+		const float lodDistances[] = {1.0f, 32.0f, 64.0f, 100.0f, 300.0f};
+		float lodDistance = lodDistances[i % 5];
+
+		TerrainQuadtree::Frustum frustum = TerrainQuadtree::ExtractFrustum(matView * matProjection);
+		uint32_t visitedNodeCount = quadtree.Select(frustum, eye, lodDistance, visibleChunks);
+		TEST_CHECK(visitedNodeCount <= quadtree.GetNodeCount());
+
+		// 全チャンクのLOD（隣との差は切り替え距離によらず1段以内）
+		std::vector<uint32_t> lods(bounds.size());
+		for (uint32_t cz = 0; cz < kChunkCountZ; cz++) {
+			for (uint32_t cx = 0; cx < kChunkCountX; cx++) {
+				lods[size_t(cz) * kChunkCountX + cx] =
+				    quadtree.CalculateLod(cx, cz, eye, lodDistance);
+			}
+		}
+		for (uint32_t cz = 0; cz < kChunkCountZ; cz++) {
+			for (uint32_t cx = 0; cx < kChunkCountX; cx++) {
+				uint32_t lod = lods[size_t(cz) * kChunkCountX + cx];
+				TEST_CHECK(lod < TerrainQuadtree::kLodCount);
+				if (cx + 1 < kChunkCountX) {
+					uint32_t right = lods[size_t(cz) * kChunkCountX + cx + 1];
+					TEST_CHECK(std::max(lod, right) - std::min(lod, right) <= 1);
+				}
+				if (cz + 1 < kChunkCountZ) {
+					uint32_t up = lods[size_t(cz + 1) * kChunkCountX + cx];
+					TEST_CHECK(std::max(lod, up) - std::min(lod, up) <= 1);
+				}
+			}
+		}
+
+		// 1つずつ調べた結果と突き合わせる
+		std::vector<bool> selected(bounds.size(), false);
+		for (const TerrainQuadtree::VisibleChunk& chunk : visibleChunks) {
+			size_t index = size_t(chunk.cz) * kChunkCountX + chunk.cx;
+			TEST_CHECK(!selected[index]);
+			selected[index] = true;
+			TEST_CHECK(chunk.lod == lods[index]);
+
+			uint32_t stitchMask = 0;
+			if (chunk.cx > 0 && lods[index - 1] > chunk.lod) {
+				stitchMask |= TerrainQuadtree::kEdgeNegativeX;
+			}
+			if (chunk.cx + 1 < kChunkCountX && lods[index + 1] > chunk.lod) {
+				stitchMask |= TerrainQuadtree::kEdgePositiveX;
+			}
+			if (chunk.cz > 0 && lods[index - kChunkCountX] > chunk.lod) {
+				stitchMask |= TerrainQuadtree::kEdgeNegativeZ;
+			}
+			if (chunk.cz + 1 < kChunkCountZ && lods[index + kChunkCountX] > chunk.lod) {
+				stitchMask |= TerrainQuadtree::kEdgePositiveZ;
+			}
+			TEST_CHECK(chunk.stitchMask == stitchMask);
+		}
+		for (size_t index = 0; index < bounds.size(); index++) {
+			bool visible =
+			    TerrainQuadtree::IsAabbVisible(frustum, bounds[index].min, bounds[index].max);
+			TEST_CHECK(selected[index] == visible);
+		}
+		visibleTotal += static_cast<int>(visibleChunks.size());
+	}
+	// カメラを乱数で置いても何かしら見えている
+	TEST_CHECK(visibleTotal > 0);
+}
+
+// 地形から目を逸らすと根だけ調べて終わる
+void TestCulledAtRoot() {
+	std::mt19937 random(2);
+	TerrainQuadtree quadtree;
+	SetUpRandomBounds(quadtree, random);
+
+	// 地形の外から外向きに見る
+	Vector3 eye = {-100.0f, 10.0f, -100.0f};
+	Vector3 rotation = {0.0f, 3.14159265f * 1.25f, 0.0f};
+	Matrix4x4 matView = Inverse(MakeAffineMatrix({1.0f, 1.0f, 1.0f}, rotation, eye));
+	TerrainQuadtree::Frustum frustum =
+	    TerrainQuadtree::ExtractFrustum(matView * MakeProjection());
+	std::vector<TerrainQuadtree::VisibleChunk> visibleChunks;
+	TEST_CHECK(quadtree.Select(frustum, eye, 64.0f, visibleChunks) == 1);
+	TEST_CHECK(visibleChunks.empty());
+}
+
+// 高さを上げて戻すと、祖先のAABBも元の大きさまで縮む
+void TestBoundsShrinkAfterEdit() {
+	std::mt19937 random(3);
+	TerrainQuadtree quadtree;
+	std::vector<Bounds> bounds = SetUpRandomBounds(quadtree, random);
+	Bounds original = UnionBounds(bounds);
+	TEST_CHECK(quadtree.GetBoundsMin() == original.min);
+	TEST_CHECK(quadtree.GetBoundsMax() == original.max);
+
+	// 1チャンクだけ高く・深くする
+	Bounds& edited = bounds[size_t(7) * kChunkCountX + 5];
+	Bounds saved = edited;
+	edited.min.y = -500.0f;
+	edited.max.y = 500.0f;
+	quadtree.SetChunkBounds(5, 7, edited.min, edited.max);
+	TEST_CHECK(quadtree.GetBoundsMin().y == -500.0f);
+	TEST_CHECK(quadtree.GetBoundsMax().y == 500.0f);
+
+	// 元に戻すと全体も戻る
+	edited = saved;
+	quadtree.SetChunkBounds(5, 7, edited.min, edited.max);
+	TEST_CHECK(quadtree.GetBoundsMin() == original.min);
+	TEST_CHECK(quadtree.GetBoundsMax() == original.max);
+
+	// 上の空から真下を見て、戻したチャンクの高さで判定されている
+	Vector3 eye = {5.5f * kChunkWidth, 600.0f, 7.5f * kChunkWidth};
+	Vector3 rotation = {3.14159265f / 2.0f, 0.0f, 0.0f};
+	Matrix4x4 matView = Inverse(MakeAffineMatrix({1.0f, 1.0f, 1.0f}, rotation, eye));
+	TerrainQuadtree::Frustum frustum =
+	    TerrainQuadtree::ExtractFrustum(matView * MakeProjection());
+	std::vector<TerrainQuadtree::VisibleChunk> visibleChunks;
+	quadtree.Select(frustum, eye, 64.0f, visibleChunks);
+	for (size_t index = 0; index < bounds.size(); index++) {
+		bool visible =
+		    TerrainQuadtree::IsAabbVisible(frustum, bounds[index].min, bounds[index].max);
+		bool selected = std::any_of(
+		    visibleChunks.begin(), visibleChunks.end(),
+		    [&](const TerrainQuadtree::VisibleChunk& chunk) {
+			    return size_t(chunk.cz) * kChunkCountX + chunk.cx == index;
+		    });
+		TEST_CHECK(selected == visible);
+	}
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestSelectMatchesBruteForce);
+	TEST_RUN(TestCulledAtRoot);
+	TEST_RUN(TestBoundsShrinkAfterEdit);
+	return TestResult();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdio>
+
+///
+/// ホスト側テストの共通処理。GPUを使わずに CPU 側の処理だけを検査する。
+/// 各テストは失敗を数えて続け、main は失敗が1つでもあれば1を返す。
+///
+
+/// <summary>
+/// 失敗した検査の数
+/// </summary>
+inline int& TestFailureCount() {
+	static int count = 0;
+	return count;
+}
+
+/// <summary>
+/// 条件を検査して、偽なら場所と式を出力する
+/// </summary>
+#define TEST_CHECK(condition)                                                                      \
+	do {                                                                                           \
+		if (!(condition)) {                                                                        \
+			std::printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition);             \
+			TestFailureCount()++;                                                                  \
+		}                                                                                          \
+	} while (false)
+
+/// <summary>
+/// テスト関数を実行して名前を出力する
+/// </summary>
+#define TEST_RUN(function)                                                                         \
+	do {                                                                                           \
+		std::printf("[ RUN  ] %s\n", #function);                                                   \
+		int failureCountBefore = TestFailureCount();                                               \
+		function();                                                                                \
+		std::printf(                                                                               \
+		    "[ %s ] %s\n", TestFailureCount() == failureCountBefore ? " OK " : "FAIL", #function); \
+	} while (false)
+
+/// <summary>
+/// 結果を出力して終了コードを返す
+/// </summary>
+inline int TestResult() {
+	if (TestFailureCount() > 0) {
+		std::printf("%d check(s) failed\n", TestFailureCount());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,535 @@
+#include "TestCommon.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+///
+/// TextureStreamer を偽のデバイスで動かし、ワーカースレッドでの読み込みと
+/// デスクリプタの差し替え・解除・追い出しが食い違わないことを検査する。
+/// 画像は TextureCache::Decode の代わりにファイル名の番号で塗りつぶして作る。
+///
+
+namespace {
+
+// 画像の一辺とミップ数
+const size_t kTextureSize = 64;
+const size_t kTextureMipLevels = 4;
+// プレースホルダーの画素
+const uint32_t kPlaceholderPixel = 0xFFFFFFFF;
+
+// 偽のテクスチャバッファ（転送された先頭画素を覚える）
+class FakeResource : public ID3D12Resource {
+public:
+	explicit FakeResource(const D3D12_RESOURCE_DESC& desc) : desc_(desc) {}
+
+	HRESULT Map(UINT, const D3D12_RANGE*, void**) override { return S_FALSE; }
+	void Unmap(UINT, const D3D12_RANGE*) override {}
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() override { return 0; }
+	D3D12_RESOURCE_DESC GetDesc() override { return desc_; }
+	HRESULT WriteToSubresource(UINT dstSubresource, const D3D12_BOX*, const void* srcData, UINT,
+	                           UINT) override {
+		if (dstSubresource == 0) {
+			std::memcpy(&pixel_, srcData, sizeof(pixel_));
+		}
+		return S_OK;
+	}
+
+	uint32_t GetPixel() const { return pixel_; }
+
+private:
+	D3D12_RESOURCE_DESC desc_;
+	uint32_t pixel_ = 0;
+};
+
+// 偽のデスクリプタヒープ（デスクリプタ毎にビューを張ったバッファを覚える）
+class FakeDescriptorHeap : public ID3D12DescriptorHeap {
+public:
+	FakeDescriptorHeap(UINT64 start, UINT numDescriptors)
+	    : start_(start), descriptors_(numDescriptors, nullptr) {}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandleForHeapStart() override {
+		return {static_cast<SIZE_T>(start_)};
+	}
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandleForHeapStart() override { return {start_}; }
+
+	UINT64 GetStart() const { return start_; }
+	std::vector<ID3D12Resource*>& GetDescriptors() { return descriptors_; }
+
+private:
+	UINT64 start_;
+	std::vector<ID3D12Resource*> descriptors_;
+};
+
+// 偽のデバイス（生成したオブジェクトはテストの終わりまで持っておく）
+class FakeDevice : public ID3D12Device {
+public:
+	// デスクリプタの間隔
+	static const UINT kIncrementSize = 32;
+
+	HRESULT CreateCommittedResource(
+	    const D3D12_HEAP_PROPERTIES*, D3D12_HEAP_FLAGS, const D3D12_RESOURCE_DESC* desc,
+	    D3D12_RESOURCE_STATES, const D3D12_CLEAR_VALUE*, const void*, void** resource) override {
+		// ワーカースレッドから呼ばれる
+		std::lock_guard<std::mutex> lock(mutex_);
+		resources_.push_back(std::make_unique<FakeResource>(*desc));
+		*resource = static_cast<ID3D12Resource*>(resources_.back().get());
+		return S_OK;
+	}
+
+	HRESULT CreateDescriptorHeap(
+	    const D3D12_DESCRIPTOR_HEAP_DESC* desc, const void*, void** heap) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		// ヒープ毎にアドレスの範囲をずらす
+		UINT64 start = 0x10000000ull * (heaps_.size() + 1);
+		heaps_.push_back(std::make_unique<FakeDescriptorHeap>(start, desc->NumDescriptors));
+		*heap = static_cast<ID3D12DescriptorHeap*>(heaps_.back().get());
+		return S_OK;
+	}
+
+	UINT GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE) override {
+		return kIncrementSize;
+	}
+
+	void CreateShaderResourceView(
+	    ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC*,
+	    D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		ID3D12Resource** descriptor = FindDescriptor(destDescriptor.ptr);
+		TEST_CHECK(descriptor != nullptr);
+		if (descriptor) {
+			*descriptor = resource;
+		}
+	}
+
+	D3D12_RESOURCE_ALLOCATION_INFO
+	GetResourceAllocationInfo(UINT, UINT, const D3D12_RESOURCE_DESC* descs) override {
+		UINT64 size = 0;
+		for (UINT16 mip = 0; mip < descs[0].MipLevels; mip++) {
+			size += (descs[0].Width >> mip) * (descs[0].Height >> mip) * 4;
+		}
+		return {size, 65536};
+	}
+
+	HRESULT CheckFeatureSupport(D3D12_FEATURE, void* data, UINT) override {
+		static_cast<D3D12_FEATURE_DATA_D3D12_OPTIONS*>(data)->ResourceBindingTier =
+		    D3D12_RESOURCE_BINDING_TIER_3;
+		return S_OK;
+	}
+
+	/// <summary>
+	/// GPUデスクリプタハンドルが指すバッファの先頭画素（ビューが無ければ0）
+	/// </summary>
+	uint32_t GetBoundPixel(UINT64 gpuDescriptor) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		ID3D12Resource** descriptor = FindDescriptor(gpuDescriptor);
+		if (!descriptor || !*descriptor) {
+			return 0;
+		}
+		return static_cast<FakeResource*>(*descriptor)->GetPixel();
+	}
+
+private:
+	// アドレスからデスクリプタを探す（mutex_ を持って呼ぶ）
+	ID3D12Resource** FindDescriptor(UINT64 address) {
+		for (auto& heap : heaps_) {
+			std::vector<ID3D12Resource*>& descriptors = heap->GetDescriptors();
+			UINT64 index = (address - heap->GetStart()) / kIncrementSize;
+			if (heap->GetStart() <= address && index < descriptors.size()) {
+				return &descriptors[index];
+			}
+		}
+		return nullptr;
+	}
+
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<FakeResource>> resources_;
+	std::vector<std::unique_ptr<FakeDescriptorHeap>> heaps_;
+};
+
+// 偽のコマンドリスト（積まれたコマンドを順に記録する）
+class FakeCommandList : public ID3D12GraphicsCommandList {
+public:
+	// コマンドの種類
+	enum class CommandType {
+		kSetDescriptorHeaps,
+		kSetGraphicsRootDescriptorTable,
+		kSetGraphicsRoot32BitConstant,
+		kSetGraphicsRoot32BitConstants,
+		kSetGraphicsRootShaderResourceView,
+	};
+
+	// 記録したコマンド
+	struct Command {
+		CommandType type;
+		// ルートパラメータ番号（ヒープのセットでは0）
+		UINT rootParameterIndex;
+		// ヒープのGPU先頭アドレス / テーブルの先頭 / 最初の定数 / バッファのアドレス
+		UINT64 value;
+	};
+
+	void SetDescriptorHeaps(
+	    UINT numDescriptorHeaps, ID3D12DescriptorHeap* const* descriptorHeaps) override {
+		TEST_CHECK(numDescriptorHeaps == 1);
+		UINT64 heapStart = descriptorHeaps[0]->GetGPUDescriptorHandleForHeapStart().ptr;
+		commands_.push_back({CommandType::kSetDescriptorHeaps, 0, heapStart});
+	}
+	void SetGraphicsRootDescriptorTable(
+	    UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) override {
+		commands_.push_back(
+		    {CommandType::kSetGraphicsRootDescriptorTable, rootParameterIndex, baseDescriptor.ptr});
+	}
+	void SetGraphicsRoot32BitConstant(UINT rootParameterIndex, UINT srcData, UINT) override {
+		commands_.push_back(
+		    {CommandType::kSetGraphicsRoot32BitConstant, rootParameterIndex, srcData});
+	}
+	void SetGraphicsRoot32BitConstants(
+	    UINT rootParameterIndex, UINT, const void* srcData, UINT) override {
+		commands_.push_back(
+		    {CommandType::kSetGraphicsRoot32BitConstants, rootParameterIndex,
+		     *static_cast<const uint32_t*>(srcData)});
+	}
+	void SetGraphicsRootShaderResourceView(
+	    UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation) override {
+		commands_.push_back(
+		    {CommandType::kSetGraphicsRootShaderResourceView, rootParameterIndex, bufferLocation});
+	}
+
+	const std::vector<Command>& GetCommands() const { return commands_; }
+
+	/// <summary>
+	/// 最後にセットしたデスクリプタテーブル（無ければ0）
+	/// </summary>
+	UINT64 GetTable() const {
+		for (auto it = commands_.rbegin(); it != commands_.rend(); ++it) {
+			if (it->type == CommandType::kSetGraphicsRootDescriptorTable) {
+				return it->value;
+			}
+		}
+		return 0;
+	}
+
+private:
+	std::vector<Command> commands_;
+};
+
+FakeDevice device;
+
+// テスト用のファイル名
+std::string TextureName(uint32_t index) { return "stress/tex" + std::to_string(index) + ".png"; }
+
+// 描画と同じ経路でテクスチャをセットし、GPUから見える先頭画素を得る
+uint32_t GetDrawnPixel(uint32_t textureHandle) {
+	FakeCommandList commandList;
+	TextureStreamer::GetInstance()->SetGraphicsRootDescriptorTable(&commandList, 0, textureHandle);
+	return device.GetBoundPixel(commandList.GetTable());
+}
+
+// 非同期読み込みが全部反映されるまでフレームを進める
+void WaitForPending() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	auto start = std::chrono::steady_clock::now();
+	while (streamer->GetPendingCount() > 0 &&
+	       std::chrono::steady_clock::now() - start < std::chrono::seconds(30)) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		streamer->Update();
+	}
+	TEST_CHECK(streamer->GetPendingCount() == 0);
+}
+
+// 大量の非同期読み込みを同時に走らせても、全部のデスクリプタが自分の画像を指す
+void TestConcurrentLoads() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+	streamer->ResetLoadStats();
+
+	const uint32_t kTextureCount = 600;
+	std::vector<uint32_t> handles(kTextureCount);
+	std::vector<int> callbackCounts(kTextureCount, 0);
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		handles[i] = TextureStreamer::LoadAsync(TextureName(i), [&, i](uint32_t handle) {
+			TEST_CHECK(handle == handles[i]);
+			callbackCounts[i]++;
+		});
+		// 読み込み中はプレースホルダーを指す
+		TEST_CHECK(!TextureStreamer::IsLoaded(handles[i]));
+	}
+	TEST_CHECK(GetDrawnPixel(handles[0]) == kPlaceholderPixel);
+
+	// 読み込み中の同じファイルの要求は同じハンドルにまとまる
+	for (uint32_t i = 0; i < kTextureCount; i += 3) {
+		uint32_t handle = TextureStreamer::LoadAsync(TextureName(i), [&, i](uint32_t) {
+			callbackCounts[i]++;
+		});
+		TEST_CHECK(handle == handles[i]);
+	}
+	WaitForPending();
+
+	std::vector<uint32_t> sorted = handles;
+	std::sort(sorted.begin(), sorted.end());
+	TEST_CHECK(std::unique(sorted.begin(), sorted.end()) == sorted.end());
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		TEST_CHECK(TextureStreamer::IsLoaded(handles[i]));
+		TEST_CHECK(callbackCounts[i] == (i % 3 == 0 ? 2 : 1));
+		TEST_CHECK(GetDrawnPixel(handles[i]) == i + 1);
+	}
+	// 重複した要求は読み込まない（プレースホルダーの分だけ多い）
+	TEST_CHECK(streamer->GetLoadStats().loadCount == kTextureCount + 1);
+	std::printf("  %u textures loaded on worker threads\n", kTextureCount);
+}
+
+// 読み込み中に解除した枠を再利用しても、古い読み込み結果で上書きされない
+void TestUnloadWhileLoading() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+
+	const uint32_t kTextureCount = 300;
+	std::vector<uint32_t> handles(kTextureCount);
+	std::vector<int> callbackCounts(kTextureCount * 2, 0);
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		handles[i] = TextureStreamer::LoadAsync(
+		    TextureName(i), [&, i](uint32_t) { callbackCounts[i]++; });
+	}
+	// 半分を読み込み完了前に解除し、空いた枠へ別のファイルを読む
+	for (uint32_t i = 0; i < kTextureCount; i += 2) {
+		TEST_CHECK(TextureStreamer::Unload(handles[i]));
+	}
+	std::vector<uint32_t> reusedHandles;
+	for (uint32_t i = kTextureCount; i < kTextureCount + kTextureCount / 2; i++) {
+		reusedHandles.push_back(TextureStreamer::LoadAsync(
+		    TextureName(i), [&, i](uint32_t) { callbackCounts[i]++; }));
+	}
+	WaitForPending();
+
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		if (i % 2 == 0) {
+			TEST_CHECK(callbackCounts[i] == 0);
+		} else {
+			TEST_CHECK(callbackCounts[i] == 1);
+			TEST_CHECK(GetDrawnPixel(handles[i]) == i + 1);
+		}
+	}
+	uint32_t reusedCount = 0;
+	for (uint32_t i = 0; i < reusedHandles.size(); i++) {
+		uint32_t index = kTextureCount + i;
+		TEST_CHECK(callbackCounts[index] == 1);
+		TEST_CHECK(GetDrawnPixel(reusedHandles[i]) == index + 1);
+		if (std::find(handles.begin(), handles.end(), reusedHandles[i]) != handles.end()) {
+			reusedCount++;
+		}
+	}
+	// 解除した枠は全部再利用されている
+	TEST_CHECK(reusedCount == kTextureCount / 2);
+}
+
+// 予算を超えたら参照されていない古いものから追い出し、次に使うときに読み直す
+void TestEvictionUnderBudget() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+
+	const uint32_t kTextureCount = 200;
+	const uint32_t kHeldCount = 10;
+	D3D12_RESOURCE_DESC desc{};
+	desc.Width = kTextureSize;
+	desc.Height = kTextureSize;
+	desc.MipLevels = kTextureMipLevels;
+	const size_t textureBytes = device.GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+	const size_t budget = textureBytes * 50;
+
+	// 1フレームに1枚ずつ読んで、最後に使ったフレームを番号順にする
+	std::vector<uint32_t> handles(kTextureCount);
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		handles[i] = TextureStreamer::Load(TextureName(i));
+		streamer->Update();
+	}
+	// 最後の数枚は参照を持ったまま、残りは手放す
+	for (uint32_t i = 0; i < kTextureCount - kHeldCount; i++) {
+		TextureStreamer::Release(handles[i]);
+	}
+	streamer->SetMemoryBudget(budget);
+	streamer->Update();
+
+	TextureStreamer::MemoryStats stats = streamer->GetMemoryStats();
+	TEST_CHECK(stats.residentBytes <= budget);
+	TEST_CHECK(stats.evictedCount == kTextureCount - 50);
+	for (uint32_t i = 0; i < kTextureCount; i++) {
+		// 古い方から追い出され、参照を持っているものは残る
+		bool evicted = i < kTextureCount - 50;
+		TEST_CHECK(TextureStreamer::IsLoaded(handles[i]) == !evicted);
+	}
+
+	// 追い出されたものは描画に使うときに読み直す
+	uint32_t missCount = stats.missCount;
+	TEST_CHECK(GetDrawnPixel(handles[0]) == 1);
+	TEST_CHECK(TextureStreamer::IsLoaded(handles[0]));
+	TEST_CHECK(streamer->GetMemoryStats().missCount == missCount + 1);
+
+	streamer->SetMemoryBudget(TextureStreamer::kDefaultMemoryBudget);
+}
+
+// 枠が満杯なら参照されていない枠を空けて読み込む
+void TestSlotReuseWhenFull() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+
+	for (uint32_t i = 0; i < TextureStreamer::kNumDescriptors; i++) {
+		TextureStreamer::Release(TextureStreamer::Load(TextureName(i)));
+	}
+	streamer->Update();
+
+	const uint32_t kExtraCount = 100;
+	for (uint32_t i = 0; i < kExtraCount; i++) {
+		uint32_t index = TextureStreamer::kNumDescriptors + i;
+		uint32_t handle = TextureStreamer::LoadAsync(TextureName(index));
+		TEST_CHECK(handle < TextureStreamer::kNumDescriptors);
+	}
+	WaitForPending();
+	for (uint32_t i = 0; i < kExtraCount; i++) {
+		uint32_t index = TextureStreamer::kNumDescriptors + i;
+		uint32_t handle = TextureStreamer::Load(TextureName(index));
+		TEST_CHECK(GetDrawnPixel(handle) == index + 1);
+	}
+}
+
+// ゲームの1フレーム分のテクスチャのセット（天球、レティクル、デバッグ文字の順）
+TextureStreamer::FrameStats DrawGameFrame(uint32_t skydome, uint32_t reticle, uint32_t font) {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	FakeCommandList commandList;
+	streamer->SetGraphicsRootDescriptorTable(&commandList, 0, skydome);
+	streamer->SetGraphicsRootDescriptorTable(&commandList, 0, reticle);
+	streamer->SetGraphicsRootDescriptorTable(&commandList, 0, font);
+	streamer->Update();
+	return streamer->GetLastFrameStats();
+}
+
+// レティクルとフォントをアトラスにまとめると、1フレームの切り替えが1回減る
+void TestFrameStatsWithAtlas() {
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+
+	uint32_t skydome = TextureStreamer::Load(TextureName(1));
+	uint32_t reticle = TextureStreamer::Load(TextureName(2));
+	uint32_t font = TextureStreamer::Load(TextureName(3));
+	uint32_t atlas = TextureStreamer::Load(TextureName(4));
+	streamer->Update();
+
+	TextureStreamer::FrameStats before = DrawGameFrame(skydome, reticle, font);
+	TextureStreamer::FrameStats after = DrawGameFrame(skydome, atlas, atlas);
+	TEST_CHECK(before.bindCount == 3 && before.switchCount == 3);
+	TEST_CHECK(after.bindCount == 3 && after.switchCount == 2);
+	std::printf(
+	    "  switches per frame: %u -> %u (binds %u)\n", before.switchCount, after.switchCount,
+	    after.bindCount);
+}
+
+// バインドレス描画はヒープとヒープ全体のテーブルを1回ずつ積み、描画毎のテクスチャは
+// デスクリプタ番号で引く（番号の取得はコマンドを積まず、切り替えにも数えない）
+void TestBindlessCommandRecording() {
+	using CommandType = FakeCommandList::CommandType;
+	TextureStreamer* streamer = TextureStreamer::GetInstance();
+	streamer->ResetAll();
+	TEST_CHECK(streamer->IsBindlessSupported());
+
+	uint32_t handles[] = {
+	    TextureStreamer::Load(TextureName(10)), TextureStreamer::Load(TextureName(11)),
+	    TextureStreamer::Load(TextureName(12))};
+	streamer->Update();
+
+	// StaticMesh::PreDrawBindless と DrawBindless と同じ積み方（描画毎に番号をルート定数で渡す）
+	const UINT kTextureTable = 3;
+	const UINT kTextureIndex = 4;
+	FakeCommandList commandList;
+	streamer->SetDescriptorHeap(&commandList);
+	streamer->SetGraphicsRootDescriptorTableBindless(&commandList, kTextureTable);
+	for (uint32_t i = 0; i < 9; i++) {
+		uint32_t index = streamer->GetDescriptorIndex(handles[i % 3]);
+		commandList.SetGraphicsRoot32BitConstant(kTextureIndex, index, 0);
+	}
+
+	const std::vector<FakeCommandList::Command>& commands = commandList.GetCommands();
+	TEST_CHECK(commands.size() == 2 + 9);
+	if (commands.size() == 2 + 9) {
+		UINT64 heapStart = commands[0].value;
+		TEST_CHECK(commands[0].type == CommandType::kSetDescriptorHeaps);
+		TEST_CHECK(commands[1].type == CommandType::kSetGraphicsRootDescriptorTable);
+		TEST_CHECK(commands[1].rootParameterIndex == kTextureTable);
+		TEST_CHECK(commands[1].value == heapStart);
+		for (uint32_t i = 0; i < 9; i++) {
+			const FakeCommandList::Command& command = commands[2 + i];
+			TEST_CHECK(command.type == CommandType::kSetGraphicsRoot32BitConstant);
+			// シェーダーがヒープの先頭から番号分進めて引くデスクリプタが、そのテクスチャを指す
+			UINT64 descriptor = heapStart + command.value * FakeDevice::kIncrementSize;
+			TEST_CHECK(device.GetBoundPixel(descriptor) == 10 + i % 3 + 1);
+		}
+	}
+
+	// テーブルを差し替える描画も混ぜる（同じテクスチャが続けば切り替えに数えない）
+	FakeCommandList tableCommandList;
+	streamer->SetGraphicsRootDescriptorTable(&tableCommandList, 2, handles[0]);
+	streamer->SetGraphicsRootDescriptorTable(&tableCommandList, 2, handles[1]);
+	streamer->SetGraphicsRootDescriptorTable(&tableCommandList, 2, handles[1]);
+	TEST_CHECK(tableCommandList.GetCommands().size() == 3 * 2);
+
+	streamer->Update();
+	const TextureStreamer::FrameStats& stats = streamer->GetLastFrameStats();
+	TEST_CHECK(stats.bindCount == 1 + 3);
+	TEST_CHECK(stats.switchCount == 2);
+	TEST_CHECK(stats.heapBindCount == 1 + 3);
+	TEST_CHECK(stats.indexCount == 9);
+	std::printf(
+	    "  bind %u, switch %u, heap %u, index %u\n", stats.bindCount, stats.switchCount,
+	    stats.heapBindCount, stats.indexCount);
+}
+
+} // namespace
+
+// テクスチャキャッシュの代わり（キャッシュは無く、ファイル名の番号で塗った画像を返す）
+std::string TextureCache::GetCachePath(const std::string& sourcePath) {
+	return sourcePath + ".ktex";
+}
+
+bool TextureCache::Reader::Open(const std::string&, const std::string&) { return false; }
+
+bool TextureCache::Write(const std::string&, const std::string&, const DirectX::ScratchImage&) {
+	return true;
+}
+
+HRESULT TextureCache::Decode(const std::string& sourcePath, DirectX::ScratchImage& image) {
+	uint32_t pixel = kPlaceholderPixel;
+	size_t position = sourcePath.rfind("tex");
+	if (position != std::string::npos) {
+		pixel = static_cast<uint32_t>(std::stoul(sourcePath.substr(position + 3))) + 1;
+	}
+	image.Initialize2D(
+	    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, kTextureSize, kTextureSize, 1, kTextureMipLevels);
+	for (size_t mip = 0; mip < kTextureMipLevels; mip++) {
+		const DirectX::Image* mipImage = image.GetImage(mip, 0, 0);
+		std::fill_n(
+		    reinterpret_cast<uint32_t*>(mipImage->pixels), mipImage->slicePitch / 4, pixel);
+	}
+
+	// デコード時間のばらつきで完了順を入れ替える
+	thread_local std::mt19937 random(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	std::this_thread::sleep_for(std::chrono::microseconds(random() % 500));
+	return S_OK;
+}
+
+int main() {
+	TextureStreamer::GetInstance()->Initialize(&device);
+	TEST_RUN(TestConcurrentLoads);
+	TEST_RUN(TestUnloadWhileLoading);
+	TEST_RUN(TestEvictionUnderBudget);
+	TEST_RUN(TestSlotReuseWhenFull);
+	TEST_RUN(TestFrameStatsWithAtlas);
+	TEST_RUN(TestBindlessCommandRecording);
+	TextureStreamer::GetInstance()->Finalize();
+	return TestResult();
+}
@@ -0,0 +1,114 @@
+#include "TestCommon.h"
+#include "VertexQuantizer.h"
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 乱数の頂点（座標は軸ごとに大きさを変え、法線には軸方向のものも混ぜる）
+std::vector<Mesh::VertexPosNormalUv> MakeRandomVertices(size_t count) {
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<Mesh::VertexPosNormalUv> vertices(count);
+	for (Mesh::VertexPosNormalUv& vertex : vertices) {
+		vertex.pos = {unit(random) * 50.0f, unit(random) * 3.0f + 10.0f, unit(random) * 200.0f};
+		Vector3 normal = {unit(random), unit(random), unit(random)};
+		float length =
+		    std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		vertex.normal = {normal.x / length, normal.y / length, normal.z / length};
+		vertex.uv = {unit(random) * 4.0f, unit(random) + 0.5f};
+	}
+	const Vector3 axes[] = {{0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {0, -1, 0}, {-1, 0, 0}, {0, 1, 0}};
+	for (size_t i = 0; i < std::size(axes); i++) {
+		vertices[i].normal = axes[i];
+	}
+	return vertices;
+}
+
+// 量子化誤差は理論上限に収まる
+void TestErrorWithinBounds() {
+	std::vector<Mesh::VertexPosNormalUv> vertices = MakeRandomVertices(200000);
+	VertexQuantizer::DequantizeParams params =
+	    VertexQuantizer::CalculateParams(vertices.data(), vertices.size());
+	std::vector<VertexQuantizer::VertexPacked> packed(vertices.size());
+	VertexQuantizer::Encode(vertices.data(), vertices.size(), params, packed.data());
+
+	VertexQuantizer::ErrorStats stats =
+	    VertexQuantizer::MeasureError(vertices.data(), packed.data(), vertices.size(), params);
+	std::printf(
+	    "position %g (bound %g), normal %g deg (bound %g), uv %g (bound %g)\n",
+	    stats.maxPositionError, stats.positionErrorBound, stats.maxNormalErrorDegrees,
+	    VertexQuantizer::kNormalErrorBoundDegrees, stats.maxUvError, stats.uvErrorBound);
+	TEST_CHECK(stats.positionErrorBound > 0.0f);
+	TEST_CHECK(stats.maxPositionError <= stats.positionErrorBound);
+	TEST_CHECK(stats.maxNormalErrorDegrees <= VertexQuantizer::kNormalErrorBoundDegrees);
+	TEST_CHECK(stats.maxUvError <= stats.uvErrorBound);
+}
+
+// 軸方向の法線は八面体符号化で向きが変わらない
+void TestAxisNormals() {
+	const Vector3 axes[] = {{0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {0, -1, 0}, {-1, 0, 0}, {0, 1, 0}};
+	for (const Vector3& axis : axes) {
+		int16_t encoded[2];
+		VertexQuantizer::EncodeOctahedral(axis, encoded);
+		Vector3 decoded = VertexQuantizer::DecodeOctahedral(encoded);
+		TEST_CHECK(axis.x * decoded.x + axis.y * decoded.y + axis.z * decoded.z > 0.99999f);
+	}
+}
+
+// 復元した頂点は元の頂点と誤差の範囲で一致し、地形の頂点でも同じ結果になる
+void TestDecodeRoundTrip() {
+	std::vector<Mesh::VertexPosNormalUv> vertices = MakeRandomVertices(1000);
+	VertexQuantizer::DequantizeParams params =
+	    VertexQuantizer::CalculateParams(vertices.data(), vertices.size());
+	std::vector<VertexQuantizer::VertexPacked> packed(vertices.size());
+	VertexQuantizer::Encode(vertices.data(), vertices.size(), params, packed.data());
+	std::vector<Mesh::VertexPosNormalUv> decoded(vertices.size());
+	VertexQuantizer::Decode(packed.data(), packed.size(), params, decoded.data());
+
+	VertexQuantizer::ErrorStats stats =
+	    VertexQuantizer::MeasureError(vertices.data(), packed.data(), vertices.size(), params);
+	int outOfBoundCount = 0;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		if (std::abs(decoded[i].pos.x - vertices[i].pos.x) > stats.positionErrorBound ||
+		    std::abs(decoded[i].pos.y - vertices[i].pos.y) > stats.positionErrorBound ||
+		    std::abs(decoded[i].pos.z - vertices[i].pos.z) > stats.positionErrorBound) {
+			outOfBoundCount++;
+		}
+	}
+	TEST_CHECK(outOfBoundCount == 0);
+
+	std::vector<Terrain::VertexPosNormalUv> terrainVertices(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		terrainVertices[i] = {vertices[i].pos, vertices[i].normal, vertices[i].uv};
+	}
+	std::vector<VertexQuantizer::VertexPacked> terrainPacked(vertices.size());
+	VertexQuantizer::Encode(
+	    terrainVertices.data(), terrainVertices.size(), params, terrainPacked.data());
+	TEST_CHECK(
+	    std::memcmp(
+	        packed.data(), terrainPacked.data(),
+	        packed.size() * sizeof(VertexQuantizer::VertexPacked)) == 0);
+}
+
+// 16バイトに詰めて半分になる
+void TestMemoryReport() {
+	TEST_CHECK(sizeof(VertexQuantizer::VertexPacked) == 16);
+	VertexQuantizer::MemoryReport report = VertexQuantizer::GetMemoryReport(1000);
+	TEST_CHECK(report.sourceBytes == 1000 * sizeof(Mesh::VertexPosNormalUv));
+	TEST_CHECK(report.packedBytes == 1000 * sizeof(VertexQuantizer::VertexPacked));
+	TEST_CHECK(report.GetRatio() == 0.5f);
+}
+
+} // namespace
+
+int main() {
+	TEST_RUN(TestErrorWithinBounds);
+	TEST_RUN(TestAxisNormals);
+	TEST_RUN(TestDecodeRoundTrip);
+	TEST_RUN(TestMemoryReport);
+	return TestResult();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための DirectXCommon 代替（デバイスは持たない）。
+///
+
+#include <d3d12.h>
+
+class DirectXCommon {
+public:
+	static DirectXCommon* GetInstance();
+	ID3D12Device* GetDevice() const { return device_; }
+	ID3D12GraphicsCommandList* GetCommandList() const { return commandList_; }
+
+private:
+	ID3D12Device* device_ = nullptr;
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための空の DirectXMath.h（参照するだけで使わない）。
+///
@@ -0,0 +1,65 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための DirectXTex 代替。
+/// テスト対象が使うイメージの入れ物だけを用意する（1画素4バイトの形式のみ、ミップは縮小しない）。
+///
+
+#include <d3d12.h>
+#include <memory>
+#include <vector>
+
+namespace DirectX {
+
+struct TexMetadata {
+	size_t width = 0;
+	size_t height = 0;
+	size_t depth = 1;
+	size_t arraySize = 1;
+	size_t mipLevels = 1;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+};
+
+struct Image {
+	size_t width = 0;
+	size_t height = 0;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+	size_t rowPitch = 0;
+	size_t slicePitch = 0;
+	uint8_t* pixels = nullptr;
+};
+
+class ScratchImage {
+public:
+	HRESULT Initialize2D(
+	    DXGI_FORMAT format, size_t width, size_t height, size_t arraySize, size_t mipLevels) {
+		metadata_ = {width, height, 1, arraySize, mipLevels, format};
+		images_.clear();
+		pixels_.clear();
+		for (size_t mip = 0; mip < mipLevels; mip++) {
+			Image image;
+			image.width = width > 1 ? width >> mip : 1;
+			image.height = height > 1 ? height >> mip : 1;
+			image.format = format;
+			image.rowPitch = image.width * 4;
+			image.slicePitch = image.rowPitch * image.height;
+			pixels_.push_back(std::make_unique<uint8_t[]>(image.slicePitch));
+			image.pixels = pixels_.back().get();
+			images_.push_back(image);
+		}
+		return S_OK;
+	}
+
+	const TexMetadata& GetMetadata() const { return metadata_; }
+
+	const Image* GetImage(size_t mip, size_t, size_t) const {
+		return mip < images_.size() ? &images_[mip] : nullptr;
+	}
+
+private:
+	TexMetadata metadata_;
+	std::vector<Image> images_;
+	std::vector<std::unique_ptr<uint8_t[]>> pixels_;
+};
+
+} // namespace DirectX
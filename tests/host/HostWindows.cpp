@@ -0,0 +1,97 @@
+#include <Windows.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+// ハンドルの実体（ファイルもマッピングも同じ形で持ち、ファイルだけが記述子を閉じる）
+struct HostHandle {
+	int descriptor = -1;
+	size_t size = 0;
+	bool ownsDescriptor = false;
+};
+
+// マッピング中のビューとそのサイズ（munmap に要る）
+std::mutex viewMutex;
+std::unordered_map<const void*, size_t> viewSizes;
+
+} // namespace
+
+HANDLE CreateFileW(LPCWSTR fileName, DWORD, DWORD, void*, DWORD, DWORD, HANDLE) {
+	// テストで使うパスはASCIIのみ
+	std::string path;
+	for (const wchar_t* p = fileName; *p; p++) {
+		path.push_back(static_cast<char>(*p));
+	}
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		return INVALID_HANDLE_VALUE;
+	}
+	struct stat status {};
+	if (fstat(descriptor, &status) != 0) {
+		close(descriptor);
+		return INVALID_HANDLE_VALUE;
+	}
+	return new HostHandle{descriptor, static_cast<size_t>(status.st_size), true};
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* fileSize) {
+	fileSize->QuadPart = static_cast<int64_t>(static_cast<HostHandle*>(file)->size);
+	return 1;
+}
+
+HANDLE CreateFileMappingW(HANDLE file, void*, DWORD, DWORD, DWORD, LPCWSTR) {
+	HostHandle* source = static_cast<HostHandle*>(file);
+	// 空のファイルはマッピングできない
+	if (source->size == 0) {
+		return nullptr;
+	}
+	return new HostHandle{source->descriptor, source->size, false};
+}
+
+void* MapViewOfFile(HANDLE mapping, DWORD, DWORD, DWORD, SIZE_T) {
+	HostHandle* handle = static_cast<HostHandle*>(mapping);
+	void* view = mmap(nullptr, handle->size, PROT_READ, MAP_SHARED, handle->descriptor, 0);
+	if (view == MAP_FAILED) {
+		return nullptr;
+	}
+	std::lock_guard<std::mutex> lock(viewMutex);
+	viewSizes[view] = handle->size;
+	return view;
+}
+
+BOOL UnmapViewOfFile(const void* baseAddress) {
+	std::lock_guard<std::mutex> lock(viewMutex);
+	auto it = viewSizes.find(baseAddress);
+	if (it == viewSizes.end()) {
+		return 0;
+	}
+	munmap(const_cast<void*>(baseAddress), it->second);
+	viewSizes.erase(it);
+	return 1;
+}
+
+BOOL CloseHandle(HANDLE object) {
+	HostHandle* handle = static_cast<HostHandle*>(object);
+	if (handle->ownsDescriptor) {
+		close(handle->descriptor);
+	}
+	delete handle;
+	return 1;
+}
+
+HRESULT CoInitializeEx(void*, DWORD) { return S_OK; }
+
+void CoUninitialize() {}
+
+// テストではダイアログを出さず、本文をそのまま標準エラーに出す
+int MessageBoxW(HWND, LPCWSTR text, LPCWSTR, UINT) {
+	std::fprintf(stderr, "%ls\n", text);
+	return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための最小限の Win32 宣言。
+/// テスト対象が使う型とファイルマッピング、COM初期化とメッセージボックスだけを用意する
+/// （実装は HostWindows.cpp）。
+///
+
+#include <cstddef>
+#include <cstdint>
+
+typedef void* HANDLE;
+typedef long HRESULT;
+typedef int BOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef uint8_t BYTE;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+typedef int64_t INT64;
+typedef unsigned long DWORD;
+typedef size_t SIZE_T;
+typedef intptr_t LONG_PTR;
+typedef const wchar_t* LPCWSTR;
+typedef void* HWND;
+
+union LARGE_INTEGER {
+	struct {
+		DWORD LowPart;
+		long HighPart;
+	};
+	int64_t QuadPart;
+};
+
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define GENERIC_READ 0x80000000
+#define FILE_SHARE_READ 0x00000001
+#define FILE_SHARE_WRITE 0x00000002
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY 0x02
+#define FILE_MAP_READ 0x0004
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+#define _countof(array) (sizeof(array) / sizeof((array)[0]))
+
+#define COINIT_MULTITHREADED 0x0
+
+HANDLE CreateFileW(
+    LPCWSTR fileName, DWORD desiredAccess, DWORD shareMode, void* securityAttributes,
+    DWORD creationDisposition, DWORD flagsAndAttributes, HANDLE templateFile);
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* fileSize);
+HANDLE CreateFileMappingW(
+    HANDLE file, void* attributes, DWORD protect, DWORD maximumSizeHigh, DWORD maximumSizeLow,
+    LPCWSTR name);
+void* MapViewOfFile(
+    HANDLE mapping, DWORD desiredAccess, DWORD fileOffsetHigh, DWORD fileOffsetLow,
+    SIZE_T numberOfBytesToMap);
+BOOL UnmapViewOfFile(const void* baseAddress);
+BOOL CloseHandle(HANDLE object);
+
+HRESULT CoInitializeEx(void* reserved, DWORD coInit);
+void CoUninitialize();
+int MessageBoxW(HWND window, LPCWSTR text, LPCWSTR caption, UINT type);
@@ -0,0 +1,216 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための最小限の Direct3D 12 宣言。
+/// テスト対象のヘッダが参照する型だけを用意し、GPUの処理は呼ばない。
+///
+
+#include <Windows.h>
+
+typedef uint64_t D3D12_GPU_VIRTUAL_ADDRESS;
+
+enum DXGI_FORMAT {
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+	DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+	DXGI_FORMAT_R16_UINT = 57,
+	DXGI_FORMAT_R32_UINT = 42,
+};
+
+struct DXGI_SAMPLE_DESC {
+	UINT Count;
+	UINT Quality;
+};
+
+struct D3D12_VERTEX_BUFFER_VIEW {
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	UINT StrideInBytes;
+};
+
+struct D3D12_INDEX_BUFFER_VIEW {
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	DXGI_FORMAT Format;
+};
+
+struct D3D12_CPU_DESCRIPTOR_HANDLE {
+	SIZE_T ptr;
+};
+
+struct D3D12_GPU_DESCRIPTOR_HANDLE {
+	UINT64 ptr;
+};
+
+struct D3D12_RANGE {
+	SIZE_T Begin;
+	SIZE_T End;
+};
+
+struct D3D12_BOX {
+	UINT left;
+	UINT top;
+	UINT front;
+	UINT right;
+	UINT bottom;
+	UINT back;
+};
+
+enum D3D12_HEAP_TYPE {
+	D3D12_HEAP_TYPE_DEFAULT = 1,
+	D3D12_HEAP_TYPE_UPLOAD = 2,
+	D3D12_HEAP_TYPE_CUSTOM = 4,
+};
+
+enum D3D12_CPU_PAGE_PROPERTY {
+	D3D12_CPU_PAGE_PROPERTY_UNKNOWN = 0,
+	D3D12_CPU_PAGE_PROPERTY_WRITE_BACK = 3,
+};
+
+enum D3D12_MEMORY_POOL {
+	D3D12_MEMORY_POOL_UNKNOWN = 0,
+	D3D12_MEMORY_POOL_L0 = 1,
+};
+
+enum D3D12_HEAP_FLAGS {
+	D3D12_HEAP_FLAG_NONE = 0,
+};
+
+enum D3D12_RESOURCE_STATES {
+	D3D12_RESOURCE_STATE_GENERIC_READ = 0xac3,
+};
+
+enum D3D12_RESOURCE_DIMENSION {
+	D3D12_RESOURCE_DIMENSION_BUFFER = 1,
+	D3D12_RESOURCE_DIMENSION_TEXTURE2D = 3,
+};
+
+struct D3D12_HEAP_PROPERTIES {
+	D3D12_HEAP_TYPE Type;
+	D3D12_CPU_PAGE_PROPERTY CPUPageProperty;
+	D3D12_MEMORY_POOL MemoryPoolPreference;
+};
+
+struct D3D12_RESOURCE_DESC {
+	D3D12_RESOURCE_DIMENSION Dimension;
+	UINT64 Alignment;
+	UINT64 Width;
+	UINT Height;
+	UINT16 DepthOrArraySize;
+	UINT16 MipLevels;
+	DXGI_FORMAT Format;
+	DXGI_SAMPLE_DESC SampleDesc;
+	UINT Layout;
+	UINT Flags;
+};
+
+struct D3D12_RESOURCE_ALLOCATION_INFO {
+	UINT64 SizeInBytes;
+	UINT64 Alignment;
+};
+
+struct D3D12_SUBRESOURCE_DATA {
+	const void* pData;
+	LONG_PTR RowPitch;
+	LONG_PTR SlicePitch;
+};
+
+enum D3D12_DESCRIPTOR_HEAP_TYPE {
+	D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV = 0,
+};
+
+enum D3D12_DESCRIPTOR_HEAP_FLAGS {
+	D3D12_DESCRIPTOR_HEAP_FLAG_NONE = 0,
+	D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE = 1,
+};
+
+struct D3D12_DESCRIPTOR_HEAP_DESC {
+	D3D12_DESCRIPTOR_HEAP_TYPE Type;
+	UINT NumDescriptors;
+	D3D12_DESCRIPTOR_HEAP_FLAGS Flags;
+	UINT NodeMask;
+};
+
+enum D3D12_SRV_DIMENSION {
+	D3D12_SRV_DIMENSION_TEXTURE2D = 4,
+};
+
+#define D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING 0x1688
+
+struct D3D12_TEX2D_SRV {
+	UINT MostDetailedMip;
+	UINT MipLevels;
+	UINT PlaneSlice;
+	float ResourceMinLODClamp;
+};
+
+struct D3D12_SHADER_RESOURCE_VIEW_DESC {
+	DXGI_FORMAT Format;
+	D3D12_SRV_DIMENSION ViewDimension;
+	UINT Shader4ComponentMapping;
+	D3D12_TEX2D_SRV Texture2D;
+};
+
+enum D3D12_FEATURE {
+	D3D12_FEATURE_D3D12_OPTIONS = 0,
+};
+
+enum D3D12_RESOURCE_BINDING_TIER {
+	D3D12_RESOURCE_BINDING_TIER_1 = 1,
+	D3D12_RESOURCE_BINDING_TIER_2 = 2,
+	D3D12_RESOURCE_BINDING_TIER_3 = 3,
+};
+
+struct D3D12_FEATURE_DATA_D3D12_OPTIONS {
+	D3D12_RESOURCE_BINDING_TIER ResourceBindingTier;
+};
+
+struct D3D12_CLEAR_VALUE;
+
+// COMインターフェースと同じく純粋仮想にして、リンク時に実体を要らなくする
+// （GPUの代わりが要るテストは派生クラスで実装する）
+struct ID3D12Resource {
+	virtual HRESULT Map(UINT subresource, const D3D12_RANGE* readRange, void** data) = 0;
+	virtual void Unmap(UINT subresource, const D3D12_RANGE* writtenRange) = 0;
+	virtual D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() = 0;
+	virtual D3D12_RESOURCE_DESC GetDesc() = 0;
+	virtual HRESULT WriteToSubresource(
+	    UINT dstSubresource, const D3D12_BOX* dstBox, const void* srcData, UINT srcRowPitch,
+	    UINT srcDepthPitch) = 0;
+};
+
+struct ID3D12DescriptorHeap {
+	virtual D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandleForHeapStart() = 0;
+	virtual D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandleForHeapStart() = 0;
+};
+
+struct ID3D12GraphicsCommandList {
+	virtual void SetDescriptorHeaps(
+	    UINT numDescriptorHeaps, ID3D12DescriptorHeap* const* descriptorHeaps) = 0;
+	virtual void SetGraphicsRootDescriptorTable(
+	    UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) = 0;
+	virtual void SetGraphicsRoot32BitConstant(
+	    UINT rootParameterIndex, UINT srcData, UINT destOffsetIn32BitValues) = 0;
+	virtual void SetGraphicsRoot32BitConstants(
+	    UINT rootParameterIndex, UINT num32BitValuesToSet, const void* srcData,
+	    UINT destOffsetIn32BitValues) = 0;
+	virtual void SetGraphicsRootShaderResourceView(
+	    UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation) = 0;
+};
+
+struct ID3D12Device {
+	virtual HRESULT CreateCommittedResource(
+	    const D3D12_HEAP_PROPERTIES* heapProperties, D3D12_HEAP_FLAGS heapFlags,
+	    const D3D12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES initialResourceState,
+	    const D3D12_CLEAR_VALUE* optimizedClearValue, const void* riid, void** resource) = 0;
+	virtual HRESULT CreateDescriptorHeap(
+	    const D3D12_DESCRIPTOR_HEAP_DESC* descriptorHeapDesc, const void* riid, void** heap) = 0;
+	virtual UINT GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE heapType) = 0;
+	virtual void CreateShaderResourceView(
+	    ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc,
+	    D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) = 0;
+	virtual D3D12_RESOURCE_ALLOCATION_INFO GetResourceAllocationInfo(
+	    UINT visibleMask, UINT numResourceDescs, const D3D12_RESOURCE_DESC* resourceDescs) = 0;
+	virtual HRESULT CheckFeatureSupport(
+	    D3D12_FEATURE feature, void* featureSupportData, UINT featureSupportDataSize) = 0;
+};
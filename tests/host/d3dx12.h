@@ -0,0 +1,47 @@
+#pragma once
+
+#include "d3d12.h"
+
+struct CD3DX12_HEAP_PROPERTIES : D3D12_HEAP_PROPERTIES {
+	explicit CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE type)
+	    : D3D12_HEAP_PROPERTIES{type, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN} {}
+	CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY cpuPageProperty, D3D12_MEMORY_POOL memoryPool)
+	    : D3D12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_CUSTOM, cpuPageProperty, memoryPool} {}
+};
+
+struct CD3DX12_RESOURCE_DESC : D3D12_RESOURCE_DESC {
+	static CD3DX12_RESOURCE_DESC Buffer(UINT64 width) {
+		CD3DX12_RESOURCE_DESC desc{};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Width = width;
+		return desc;
+	}
+	static CD3DX12_RESOURCE_DESC
+	    Tex2D(DXGI_FORMAT format, UINT64 width, UINT height, UINT16 arraySize, UINT16 mipLevels) {
+		CD3DX12_RESOURCE_DESC desc{};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		desc.Width = width;
+		desc.Height = height;
+		desc.DepthOrArraySize = arraySize;
+		desc.MipLevels = mipLevels;
+		desc.Format = format;
+		desc.SampleDesc = {1, 0};
+		return desc;
+	}
+};
+
+struct CD3DX12_CPU_DESCRIPTOR_HANDLE : D3D12_CPU_DESCRIPTOR_HANDLE {
+	CD3DX12_CPU_DESCRIPTOR_HANDLE() : D3D12_CPU_DESCRIPTOR_HANDLE{0} {}
+	CD3DX12_CPU_DESCRIPTOR_HANDLE(
+	    D3D12_CPU_DESCRIPTOR_HANDLE base, INT offsetInDescriptors, UINT descriptorIncrementSize)
+	    : D3D12_CPU_DESCRIPTOR_HANDLE{
+	          base.ptr + SIZE_T(INT64(offsetInDescriptors) * descriptorIncrementSize)} {}
+};
+
+struct CD3DX12_GPU_DESCRIPTOR_HANDLE : D3D12_GPU_DESCRIPTOR_HANDLE {
+	CD3DX12_GPU_DESCRIPTOR_HANDLE() : D3D12_GPU_DESCRIPTOR_HANDLE{0} {}
+	CD3DX12_GPU_DESCRIPTOR_HANDLE(
+	    D3D12_GPU_DESCRIPTOR_HANDLE base, INT offsetInDescriptors, UINT descriptorIncrementSize)
+	    : D3D12_GPU_DESCRIPTOR_HANDLE{
+	          base.ptr + UINT64(INT64(offsetInDescriptors) * descriptorIncrementSize)} {}
+};
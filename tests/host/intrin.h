@@ -0,0 +1,19 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための MSVC 組み込み関数の代替。
+///
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+// __cpuidex は <cpuid.h> にある
+#undef __cpuid
+inline void __cpuid(int info[4], int leaf) { __cpuidex(info, leaf, 0); }
+
+inline unsigned long long HostXgetbv(unsigned int index) {
+	unsigned int eax = 0, edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+	return (static_cast<unsigned long long>(edx) << 32) | eax;
+}
+#define _xgetbv HostXgetbv
@@ -0,0 +1,33 @@
+#pragma once
+
+///
+/// Windows 以外でホスト側テストをビルドするための Microsoft::WRL::ComPtr 代替。
+/// 参照カウントは持たず、ポインタを保持するだけ（GPUの代わりのオブジェクトはテスト側が持つ）。
+///
+
+#include <cstddef>
+
+namespace Microsoft {
+namespace WRL {
+
+template<class T> class ComPtr {
+public:
+	ComPtr() = default;
+	ComPtr(std::nullptr_t) {}
+
+	T* Get() const { return ptr_; }
+	T* operator->() const { return ptr_; }
+	T** operator&() { return &ptr_; }
+	T** GetAddressOf() { return &ptr_; }
+	T** ReleaseAndGetAddressOf() { return &ptr_; }
+	void Reset() { ptr_ = nullptr; }
+	explicit operator bool() const { return ptr_ != nullptr; }
+
+private:
+	T* ptr_ = nullptr;
+};
+
+} // namespace WRL
+} // namespace Microsoft
+
+#define IID_PPV_ARGS(pp) nullptr, reinterpret_cast<void**>(pp)